@@ -0,0 +1,104 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+
+#include "common.h"
+#include "controls.h"
+
+// The servo of a control surface, in the -1 to +1 units of CONTROL_SURFACES_DATA
+struct ActuatorLimits
+{
+	double rate; // Travel per second the servo can move at most
+	double time_constant; // Seconds of the first order lag behind the command
+};
+
+// Moves a surface towards its command as its servo would: lagging behind it, and no faster than the rate limit
+class SurfaceActuator
+{
+private:
+	ActuatorLimits limits;
+	double position = 0;
+
+	// The lag coefficient for the last dt, which only changes with the frame time
+	double lag_dt = 0;
+	double lag = 1;
+public:
+	SurfaceActuator(const ActuatorLimits& limits) : limits(limits) {};
+
+	double Update(const double command, const double dt)
+	{
+		if (!(dt > 0)) return position;
+		if (dt != lag_dt)
+		{
+			lag_dt = dt;
+			lag = limits.time_constant > 0 ? 1 - exp(-dt / limits.time_constant) : 1;
+		}
+		const auto max_change = limits.rate * dt;
+		position += clamp((command - position) * lag, -max_change, max_change);
+		return position;
+	}
+
+	double Position() const { return position; }
+	const ActuatorLimits& Limits() const { return limits; }
+	void SetLimits(const ActuatorLimits& value) { limits = value; lag_dt = 0; }
+};
+
+// Turns the surfaces the control laws command into the positions the simulator is given: through the actuator of
+// each surface, and only when a surface moved by more than epsilon since the last write
+class SurfaceOutputStage
+{
+private:
+	// An A320's servos move the surfaces at 30 to 45 degrees/second, i.e. about full travel in a second
+	SurfaceActuator elevator = SurfaceActuator({ 1.6, 0.05 });
+	SurfaceActuator ailerons = SurfaceActuator({ 2.0, 0.05 });
+	SurfaceActuator rudder = SurfaceActuator({ 1.2, 0.08 });
+	// Whether the actuators are modelled; the positions are the commands otherwise. Off by default, as the gains of
+	// the control laws were tuned against surfaces that follow their command instantly.
+	bool enabled = false;
+
+	double epsilon = 1e-4;
+	CONTROL_SURFACES_DATA written; // As the simulator last got it
+	bool changed = false;
+	bool started = false;
+	uint64_t writes = 0;
+	uint64_t skipped_writes = 0;
+public:
+	// Runs the actuators for a frame lasting dt, and returns the positions to present to the simulator
+	const CONTROL_SURFACES_DATA& Update(const CONTROL_SURFACES_DATA& command, const double dt)
+	{
+		CONTROL_SURFACES_DATA position = command;
+		if (enabled)
+		{
+			position.elevator = elevator.Update(command.elevator, dt);
+			position.ailerons = ailerons.Update(command.ailerons, dt);
+			position.rudder = rudder.Update(command.rudder, dt);
+		}
+
+		changed = !started
+			|| fabs(position.elevator - written.elevator) > epsilon
+			|| fabs(position.ailerons - written.ailerons) > epsilon
+			|| fabs(position.rudder - written.rudder) > epsilon;
+		started = true;
+		if (changed)
+		{
+			written = position;
+			writes++;
+		}
+		else skipped_writes++;
+		return written;
+	}
+
+	// Whether the last update moved a surface by more than epsilon, so that the positions need writing
+	bool Changed() const { return changed; }
+	const CONTROL_SURFACES_DATA& Written() const { return written; }
+	uint64_t Writes() const { return writes; }
+	uint64_t SkippedWrites() const { return skipped_writes; }
+
+	double Epsilon() const { return epsilon; }
+	void SetEpsilon(const double value) { epsilon = value; }
+	bool Enabled() const { return enabled; }
+	void SetEnabled(const bool value) { enabled = value; }
+	SurfaceActuator& Elevator() { return elevator; }
+	SurfaceActuator& Ailerons() { return ailerons; }
+	SurfaceActuator& Rudder() { return rudder; }
+};
\ No newline at end of file
@@ -1,137 +1,243 @@
 #pragma once
 #include <cmath>
+#include <cstdint>
 
 #include "common.h"
+#include "estimator.h"
+#include "flight_envelope_tables.h"
+
+// One frame of raw simulation variables, as acquired by SimData (see sim_data.h)
+// Values are in the simulator's units and sign conventions; AircraftData converts them
+struct AircraftDataSample
+{
+	double altitude = 0; // PLANE ALTITUDE in feet
+	double aoa = 0; // INCIDENCE ALPHA in degrees
+	double autopilot = FALSE; // AUTOPILOT MASTER as a bool
+	double flaps = 0; // FLAPS HANDLE INDEX
+	double gforce = 0; // G FORCE in gforce
+	double ias = 0; // AIRSPEED INDICATED in knots
+	double lateral_acceleration = 0; // ACCELERATION WORLD Z in feet/second^2
+	double lateral_speed = 0; // VELOCITY WORLD Z in feet/second
+	double longitudinal_acceleration = 0; // ACCELERATION WORLD X in feet/second^2
+	double longitudinal_speed = 0; // VELOCITY WORLD X in feet/second
+	double mach = 0; // AIRSPEED MACH in mach
+	double mmo = DBL_MAX; // BARBER POLE MACH in mach
+	double on_ground = FALSE; // SIM ON GROUND as a bool
+	double pitch = 0; // PLANE PITCH DEGREES in degrees (+ is down, - is up)
+	double pitch_velocity = 0; // ROTATION VELOCITY BODY X in degrees/second (+ is nose down)
+	double radio_height = 0; // RADIO HEIGHT in feet
+	double roll = 0; // PLANE BANK DEGREES in degrees (+ is left, - is right)
+	double vertical_acceleration = 0; // ACCELERATION WORLD Y in feet/second^2
+	double vertical_speed = 0; // VELOCITY WORLD Y in feet/second
+	double vmo = DBL_MAX; // AIRSPEED BARBER POLE in knots
+	double weight = 141096; // TOTAL WEIGHT in pounds (64 t until the simulator reports it)
+	double yaw_velocity = 0; // ROTATION VELOCITY BODY Y in degrees/second (+ is nose right)
+};
+
+// Estimates the sample between two frames (fraction 0 = from, 1 = to)
+// Discrete values, the speed limits and the weight are taken from the nearer sample
+inline AircraftDataSample Interpolate(const AircraftDataSample& from, const AircraftDataSample& to, const double fraction)
+{
+	const auto blend = [fraction](const double a, const double b) { return a + (b - a) * fraction; };
+	const auto& nearer = fraction < 0.5 ? from : to;
+
+	AircraftDataSample sample = nearer;
+	sample.altitude = blend(from.altitude, to.altitude);
+	sample.aoa = blend(from.aoa, to.aoa);
+	sample.gforce = blend(from.gforce, to.gforce);
+	sample.ias = blend(from.ias, to.ias);
+	sample.lateral_acceleration = blend(from.lateral_acceleration, to.lateral_acceleration);
+	sample.lateral_speed = blend(from.lateral_speed, to.lateral_speed);
+	sample.longitudinal_acceleration = blend(from.longitudinal_acceleration, to.longitudinal_acceleration);
+	sample.longitudinal_speed = blend(from.longitudinal_speed, to.longitudinal_speed);
+	sample.mach = blend(from.mach, to.mach);
+	sample.pitch = blend(from.pitch, to.pitch);
+	sample.pitch_velocity = blend(from.pitch_velocity, to.pitch_velocity);
+	sample.radio_height = blend(from.radio_height, to.radio_height);
+	// Bank wraps at +-180 degrees: blend the shortest way round and wrap the result back
+	sample.roll = remainder(from.roll + remainder(to.roll - from.roll, 360.0) * fraction, 360.0);
+	sample.vertical_acceleration = blend(from.vertical_acceleration, to.vertical_acceleration);
+	sample.vertical_speed = blend(from.vertical_speed, to.vertical_speed);
+	sample.yaw_velocity = blend(from.yaw_velocity, to.yaw_velocity);
+	return sample;
+}
+
+// A value derived from the aircraft data, computed at most once per AircraftData::Update (one generation)
+template <typename T>
+class DerivedValue
+{
+private:
+	uint32_t generation = UINT32_MAX; // The generation value belongs to; never a valid one at first
+	T value = T();
+public:
+	template <typename Compute>
+	T Get(const uint32_t current_generation, Compute compute)
+	{
+		if (generation != current_generation)
+		{
+			value = compute();
+			generation = current_generation;
+		}
+		return value;
+	}
+};
 
 class AircraftData
 {
 private:
 
+	double altitude = 0; // Altitude above sea level in feet
 	double aoa = 0; // The angle of attack in degrees
 	bool autopilot = false; // True if the autopilot is on
 	int flaps = 0; // The current position of the flaps handle (0 = Clean CONF, 4 = CONF FULL)
 	double gforce = 0; // The current gforce (load factor)
 	double ias = 0; // The indicated airspeed in knots
+	double lateral_acceleration = 0; // Acceleration relative to the earth in a north/south direction in feet/second^2
 	double lateral_speed = 0; // Lateral speed (relative to the earth in a north/south direction) in feet/second
+	double longitudinal_acceleration = 0; // Acceleration relative to the earth in an east/west direction in feet/second^2
 	double longitudinal_speed = 0; // Longitudinal speed (relative to the earth in an east/west direction) in feet/second
 	double mach = 0; // The current speed in mach
 	double mmo = DBL_MAX; // The Mmo speed in mach
 	bool on_ground = true; // True if the plane is on the ground
 	double pitch = 0; // Pitch attitude in degrees (+ is up, - is down)
 	double pitch_rate = 0; // Pitch attitude rate in degrees/sec (+ is up, - is down)
+	double body_pitch_rate = 0; // Rotation about the wing axis in degrees/sec (+ is nose up)
+	double body_yaw_rate = 0; // Rotation about the vertical body axis in degrees/sec (+ is nose right)
 	double radio_height = 0; // Radio altimeter in feet
 	double roll = 0; // Roll attitude in degrees (+ is right, - is left)
+	double vertical_acceleration = 0; // Vertical acceleration (relative to the earth) in feet/second^2
 	double vertical_speed = 0; // Vertical speed (relative to the earth) in feet/second
 	double vfpa_rate = 0; // Vertical flight path angle rate in degrees/second
 	double vmo = DBL_MAX; // The Vmo speed in knots
+	double weight = 64000; // The gross weight in kilograms
 
 	double last_pitch = 0;
 	double last_vfpa = 0;
 
-	double FetchSimVar(const char * name, const char * units, const int index, const double fallback)
+	// How pitch_rate and vfpa_rate are derived
+	ESTIMATOR_MODE estimator_mode = ESTIMATOR_FINITE_DIFFERENCE;
+	// Whether the angles of attack of the envelope come from the swept tables rather than the FCOM (see flight_envelope.h)
+	bool swept_alpha = false;
+	StateEstimator estimator;
+
+	uint32_t generation = 0; // Incremented by every Update(), which invalidates the derived values
+	DerivedValue<EnvelopePoint> envelope;
+	DerivedValue<double> normal_load_factor;
+	DerivedValue<double> vfpa;
+
+	double ComputeVFPA()
 	{
-		const auto value = aircraft_varget(get_aircraft_var_enum(name), get_units_enum(units), index);
-		return isnan(value) ? fallback : value;
+		const auto horizontal_speed = sqrt(lateral_speed * lateral_speed + longitudinal_speed * longitudinal_speed);
+		if (horizontal_speed == 0 && vertical_speed == 0) return 0; // Neutral FPA
+		if (horizontal_speed == 0 && vertical_speed < 0) return -90; // Straight down
+		if (horizontal_speed == 0 && vertical_speed > 0) return 90; // Straight up
+		return degrees(atan(vertical_speed / horizontal_speed));
 	}
 public:
 
 	double Alpha() { return aoa; }
-	double AlphaFloor()
-	{
-		// These values are hardcoded in the FCOM in 1.27.20 under "High Angle of Attack Protection"
-		// Note: 2. a.floor is activated through A/THR system when:
-		// - a > a floor (9.5 degrees in configuration 0; 15 degrees in configuration 1, 2; 14 degrees in
-		//   configuration 3; 13 degrees in configuration FULL), or,...
-		// TODO: These values don't seem to mesh well with how the A320 is actually modeled, even though
-		//       they come from the manual directly.
-		switch (flaps)
-		{
-		case 0: // Clean CONF
-			return 9.5;
-			break;
-		case 1: // CONF 1
-		case 2: // CONF 2
-			return 15;
-			break;
-		case 3: // CONF 3
-			return 14;
-			break;
-		case 4: // 
-			return 13;
-			break;
-		default: // Unreachable
-			return 9.5;
-			break;
-		}
-	}
-	double AlphaProt()
-	{
-		// This ratio was estimated using the graph in the FCOM in 1.27.20 under "High Angle of Attack Protection"
-		// The graph plots CL (lift coefficient) to alpha.
-		// The ratio was guesstimated using a ruler and hoping the graph was accurate.
-		const auto ratio_with_alpha_floor = 19.0 / 21.0;
-		return ratio_with_alpha_floor * AlphaFloor();
-	}
-	double AlphaMax()
-	{
-		// This ratio was estimated using the graph in the FCOM in 1.27.20 under "High Angle of Attack Protection"
-		// The graph plots CL (lift coefficient) to alpha.
-		// The ratio was guesstimated using a ruler and hoping the graph was accurate.
-		const auto ratio_with_alpha_floor = 7.0 / 6.0;
-		return ratio_with_alpha_floor * AlphaFloor();
-	}
+	double AlphaFloor() { return Envelope().alpha_floor; }
+	double AlphaProt() { return Envelope().alpha_prot; }
+	double AlphaMax() { return Envelope().alpha_max; }
+	double Altitude() { return altitude; }
 	bool Autopilot() { return autopilot; }
 	int Flaps() { return flaps; }
 	double GForce() { return gforce;  }
+	uint32_t Generation() { return generation; }
 	double IAS() { return ias; }
 	double Mach() { return mach; }
 	double Mmo() { return mmo; }
+	// The high angle of attack protection and pitch attitude limits at the current flaps, weight and Mach, from the
+	// tables of flight_envelope_tables.h, with the angles of attack of the FCOM unless SetSweptAlpha
+	EnvelopePoint Envelope()
+	{
+		return envelope.Get(generation, [this]()
+		{
+			const auto point = LookUpEnvelope(default_envelope_table, flaps, weight, mach);
+			return swept_alpha ? point : WithFcomAlpha(point, flaps);
+		});
+	}
+	// The load factor that holds the altitude at the current bank angle
+	double NormalLoadFactor()
+	{
+		return normal_load_factor.Get(generation, [this]() { return 1 / cos(radians(roll)); });
+	}
 	bool OnGround() { return on_ground; }
 	double Pitch() { return pitch; }
 	double PitchRate() { return pitch_rate; }
 	double RadioHeight() { return radio_height; }
 	double Roll() { return roll;  }
+	// Speed relative to the earth in feet/second, which is the true airspeed in still air
+	double Speed() { return sqrt(lateral_speed * lateral_speed + longitudinal_speed * longitudinal_speed + vertical_speed * vertical_speed); }
 	double VFPA()
 	{
-		const auto horizontal_speed = sqrt(lateral_speed * lateral_speed + longitudinal_speed * longitudinal_speed);
-		if (horizontal_speed == 0 && vertical_speed == 0) return 0; // Neutral FPA
-		if (horizontal_speed == 0 && vertical_speed < 0) return -90; // Straight down
-		if (horizontal_speed == 0 && vertical_speed > 0) return 90; // Straight up
-		return degrees(atan(vertical_speed / horizontal_speed));
+		return vfpa.Get(generation, [this]() { return ComputeVFPA(); });
 	}
 	double VFPARate()
 	{
 		return vfpa_rate;
 	}
 	double Vmo() { return vmo; }
+	double VAlphaMax() { return Envelope().v_alpha_max; }
+	double VAlphaProt() { return Envelope().v_alpha_prot; }
+	double Weight() { return weight; }
+
+	bool SweptAlpha() { return swept_alpha; }
+	void SetSweptAlpha(const bool value) { swept_alpha = value; }
+	ESTIMATOR_MODE EstimatorMode() { return estimator_mode; }
+	void SetEstimatorMode(const ESTIMATOR_MODE mode)
+	{
+		estimator_mode = mode;
+		estimator.Reset();
+	}
 	
-	void Update(const double t, const double dt)
+	void Update(const AircraftDataSample& sample, const double t, const double dt)
 	{
 		// Pre-update (for derived values)
 		last_pitch = pitch;
 		last_vfpa = VFPA();
 
 		// Update
-		aoa = FetchSimVar("INCIDENCE ALPHA", "Degrees", 0, 0);
-		autopilot = FetchSimVar("AUTOPILOT MASTER", "Bool", 0, FALSE) == TRUE;
-		flaps = static_cast<int>(FetchSimVar("FLAPS HANDLE INDEX", "Number", 0, 0));
-		gforce = FetchSimVar("G FORCE", "GForce", 0, 0);
-		ias = FetchSimVar("AIRSPEED INDICATED", "Knots", 0, 0);
-		lateral_speed = FetchSimVar("VELOCITY WORLD Z", "Feet per second", 0, 0);
-		longitudinal_speed = FetchSimVar("VELOCITY WORLD X", "Feet per second", 0, 0);
-		mach = FetchSimVar("AIRSPEED MACH", "Mach", 0, 0);
-		mmo = FetchSimVar("BARBER POLE MACH", "Mach", 0, DBL_MAX); // TODO: Get this data from the FCOM instead of the SimVar
-		on_ground = FetchSimVar("SIM ON GROUND", "Bool", 0, FALSE) == TRUE;
-		pitch = -FetchSimVar("PLANE PITCH DEGREES", "Degrees", 0, 0);
-		radio_height = FetchSimVar("RADIO HEIGHT", "Feet", 0, 0);
-		roll = -FetchSimVar("PLANE BANK DEGREES", "Degrees", 0, 0);
-		vertical_speed = FetchSimVar("VELOCITY WORLD Y", "Feet per second", 0, 0);
-		vmo = FetchSimVar("AIRSPEED BARBER POLE", "Knots", 0, DBL_MAX); // TODO: Get this data from the FCOM instead of the SimVar
+		altitude = sample.altitude;
+		aoa = sample.aoa;
+		autopilot = sample.autopilot == TRUE;
+		flaps = static_cast<int>(sample.flaps);
+		gforce = sample.gforce;
+		ias = sample.ias;
+		lateral_acceleration = sample.lateral_acceleration;
+		lateral_speed = sample.lateral_speed;
+		longitudinal_acceleration = sample.longitudinal_acceleration;
+		longitudinal_speed = sample.longitudinal_speed;
+		mach = sample.mach;
+		mmo = sample.mmo; // TODO: Get this data from the FCOM instead of the SimVar
+		on_ground = sample.on_ground == TRUE;
+		pitch = -sample.pitch;
+		body_pitch_rate = -sample.pitch_velocity;
+		body_yaw_rate = sample.yaw_velocity;
+		radio_height = sample.radio_height;
+		roll = -sample.roll;
+		vertical_acceleration = sample.vertical_acceleration;
+		vertical_speed = sample.vertical_speed;
+		vmo = sample.vmo; // TODO: Get this data from the FCOM instead of the SimVar
+		weight = sample.weight / 2.20462;
+		generation++;
 
 		// Derived values
-		pitch_rate = (pitch - last_pitch) / dt;
-		vfpa_rate = (VFPA() - last_vfpa) / dt;
+		if (estimator_mode == ESTIMATOR_COMPLEMENTARY)
+		{
+			const auto horizontal_speed = sqrt(lateral_speed * lateral_speed + longitudinal_speed * longitudinal_speed);
+			const auto horizontal_acceleration = horizontal_speed > 0
+				? (lateral_speed * lateral_acceleration + longitudinal_speed * longitudinal_acceleration) / horizontal_speed
+				: 0;
+			estimator.Update(pitch, body_pitch_rate, body_yaw_rate, roll, VFPA(),
+				horizontal_speed, horizontal_acceleration, vertical_speed, vertical_acceleration, dt);
+			pitch_rate = estimator.PitchRate();
+			vfpa_rate = estimator.VFPARate();
+		}
+		else if (dt > 0)
+		{
+			pitch_rate = (pitch - last_pitch) / dt;
+			vfpa_rate = (VFPA() - last_vfpa) / dt;
+		}
 	}
-};
-
-AircraftData aircraft_data;
\ No newline at end of file
+};
\ No newline at end of file
@@ -6,7 +6,17 @@
 #include <SimConnect.h>
 #include <cmath>
 
-HANDLE hSimConnect = 0;
+// SimConnect data definition and request IDs are shared by the whole client, so they are all declared here
+enum DEFINITION_ID
+{
+	CONTROL_SURFACES_DEFINITION,
+	AIRCRAFT_DATA_DEFINITION
+};
+
+enum REQUEST_ID
+{
+	AIRCRAFT_DATA_REQUEST
+};
 
 constexpr double clamp(const double value, const double min, const double max)
 {
@@ -1,36 +1,56 @@
 #pragma once
 #include "common.h"
 #include "aircraft_data.h"
+#include "gain_tables.h"
 #include "input.h"
 #include "roll.h"
 #include "pitch.h"
 
+// Laid out as the CONTROL_SURFACES_DEFINITION data definition
+struct CONTROL_SURFACES_DATA
+{
+	double elevator = 0; // -1 is full down, and +1 is full up
+	double ailerons = 0; // -1 is full left, and +1 is full right
+	double rudder = 0; // -1 is full left, and +1 is full right
+};
+
 class ControlSurfaces
 {
 private:
-	struct CONTROL_SURFACES_DATA
-	{
-		double elevator = 0; // -1 is full down, and +1 is full up
-		double ailerons = 0; // -1 is full left, and +1 is full right
-		double rudder = 0; // -1 is full left, and +1 is full right
-	} control_surfaces;
+	AircraftData& aircraft_data;
+	InputCapture& input_capture;
+
+	CONTROL_SURFACES_DATA control_surfaces; // Output of the latest control step
+	CONTROL_SURFACES_DATA previous_control_surfaces; // Output of the step before
 
-	enum DEFINITION_ID
+	GainScheduler gain_scheduler = GainScheduler(default_gain_table);
+	RollController roll_controller;
+	PitchController pitch_controller;
+public:
+	ControlSurfaces(AircraftData& aircraft_data, InputCapture& input_capture, PitchControlMode& pitch_control_mode, NormalLawProtections& normal_law_protections, PitchTelemetry& pitch_telemetry)
+		: aircraft_data(aircraft_data), input_capture(input_capture),
+		roll_controller(aircraft_data, input_capture, pitch_control_mode, normal_law_protections),
+		pitch_controller(aircraft_data, input_capture, pitch_control_mode, normal_law_protections, pitch_telemetry)
 	{
-		CONTROL_SURFACES_DEFINITION
+		// The gains at the lowest point of the table, until the first step schedules them
+		roll_controller.SetGains(gain_scheduler);
+		pitch_controller.SetGains(gain_scheduler);
 	};
 
-	RollController roll_controller = RollController();
-	PitchController pitch_controller = PitchController();
-public:
-	void Init()
+	PitchController& Pitch() { return pitch_controller; }
+	RollController& Roll() { return roll_controller; }
+	GainScheduler& Gains() { return gain_scheduler; }
+
+	void Init(HANDLE hSimConnect)
 	{
 		SimConnect_AddToDataDefinition(hSimConnect, CONTROL_SURFACES_DEFINITION, "ELEVATOR POSITION", "Position");
 		SimConnect_AddToDataDefinition(hSimConnect, CONTROL_SURFACES_DEFINITION, "AILERON POSITION", "Position");
 		SimConnect_AddToDataDefinition(hSimConnect, CONTROL_SURFACES_DEFINITION, "RUDDER POSITION", "Position");
 	}
+	// Runs one control step
 	void Update(const double t, const double dt)
 	{
+		previous_control_surfaces = control_surfaces;
 		if (aircraft_data.Autopilot())
 		{
 			// Allow the user's raw flight control inputs to go through if the autopilot is on
@@ -40,13 +60,23 @@ public:
 		}
 		else
 		{
-			// We are controlling the plane through FBW
+			// We are controlling the plane through FBW, with the gains for the current flight conditions
+			gain_scheduler.Update(aircraft_data.IAS(), aircraft_data.Mach(), aircraft_data.Altitude(), aircraft_data.Flaps());
+			roll_controller.SetGains(gain_scheduler);
+			pitch_controller.SetGains(gain_scheduler);
 			control_surfaces.ailerons = roll_controller.Calculate(control_surfaces.ailerons, t, dt);
 			control_surfaces.elevator = pitch_controller.Calculate(control_surfaces.elevator, t, dt);
 			control_surfaces.rudder = input_capture.RawRudder(); // TODO: Create yaw FBW
 		}
-		SimConnect_SetDataOnSimObject(hSimConnect, CONTROL_SURFACES_DEFINITION, SIMCONNECT_OBJECT_ID_USER, 0, 0, sizeof(control_surfaces), &control_surfaces);
 	}
-};
 
-ControlSurfaces control_surfaces;
\ No newline at end of file
+	// The surfaces blended between the previous (0) and the latest (1) control step
+	CONTROL_SURFACES_DATA Output(const double blend)
+	{
+		CONTROL_SURFACES_DATA output;
+		output.elevator = previous_control_surfaces.elevator + (control_surfaces.elevator - previous_control_surfaces.elevator) * blend;
+		output.ailerons = previous_control_surfaces.ailerons + (control_surfaces.ailerons - previous_control_surfaces.ailerons) * blend;
+		output.rudder = previous_control_surfaces.rudder + (control_surfaces.rudder - previous_control_surfaces.rudder) * blend;
+		return output;
+	}
+};
\ No newline at end of file
@@ -0,0 +1,146 @@
+#pragma once
+#include <cmath>
+
+#include "aircraft_data.h"
+
+// Tracks the level and rate of change of a signal from its samples, in O(1) per sample: a critically damped
+// alpha-beta filter, which follows a ramp without lag once settled, and forgets older samples with time_constant
+class TrendEstimator
+{
+private:
+	double time_constant;
+	double level = 0;
+	double rate = 0; // Per second
+	bool started = false;
+
+	// The gains for the last dt, which only changes with the control rate
+	double gains_dt = 0;
+	double level_gain = 0;
+	double rate_gain = 0; // Per second
+public:
+	TrendEstimator(const double time_constant) : time_constant(time_constant) {};
+
+	void Update(const double value, const double dt)
+	{
+		if (!started || dt <= 0)
+		{
+			if (!started) level = value;
+			started = true;
+			return;
+		}
+		if (dt != gains_dt)
+		{
+			const auto decay = exp(-dt / time_constant);
+			gains_dt = dt;
+			level_gain = 1 - decay * decay;
+			rate_gain = (1 - decay) * (1 - decay) / dt;
+		}
+
+		const auto predicted = level + rate * dt;
+		const auto residual = value - predicted;
+		level = predicted + level_gain * residual;
+		rate += rate_gain * residual;
+	}
+	void Reset()
+	{
+		level = 0;
+		rate = 0;
+		started = false;
+	}
+
+	double Level() const { return level; }
+	double Rate() const { return rate; }
+
+	// Seconds until the trend crosses upper going up (or lower going down); 0 once beyond it, infinite if heading away
+	double TimeAbove(const double upper) const
+	{
+		if (level >= upper) return 0;
+		return rate > 0 ? (upper - level) / rate : INFINITY;
+	}
+	double TimeBelow(const double lower) const
+	{
+		if (level <= lower) return 0;
+		return rate < 0 ? (lower - level) / rate : INFINITY;
+	}
+};
+
+enum ENVELOPE_SIGNAL
+{
+	SIGNAL_ALPHA,
+	SIGNAL_IAS,
+	SIGNAL_MACH,
+	SIGNAL_PITCH,
+	SIGNAL_GFORCE,
+	SIGNAL_COUNT
+};
+
+enum ENVELOPE_LIMIT
+{
+	LIMIT_ALPHA_PROT,
+	LIMIT_VMO,
+	LIMIT_MMO,
+	LIMIT_MAX_PITCH,
+	LIMIT_MIN_PITCH,
+	LIMIT_MAX_LOAD_FACTOR,
+	LIMIT_MIN_LOAD_FACTOR,
+	LIMIT_COUNT
+};
+
+// The limits of the protections, which the predictor measures the time to
+struct EnvelopeLimits
+{
+	double alpha_prot;
+	double vmo;
+	double mmo;
+	double max_pitch;
+	double min_pitch;
+	double max_load_factor;
+	double min_load_factor;
+};
+
+// Predicts how soon the aircraft reaches the limit of each protection, if the signals keep their current trend, so
+// that a protection can engage before its limit rather than after
+class EnvelopePredictor
+{
+private:
+	TrendEstimator trends[SIGNAL_COUNT] = {
+		TrendEstimator(0.3), // Alpha
+		TrendEstimator(1.0), // IAS, which the simulator only gives to the nearest tenth of a knot or so
+		TrendEstimator(1.0), // Mach
+		TrendEstimator(0.3), // Pitch
+		TrendEstimator(0.2), // G force
+	};
+	double time_to_limit[LIMIT_COUNT];
+public:
+	EnvelopePredictor()
+	{
+		for (auto& time : time_to_limit) time = INFINITY;
+	}
+
+	// Adds the current values of the signals, then measures the time to each limit
+	void Update(AircraftData& aircraft_data, const EnvelopeLimits& limits, const double dt)
+	{
+		trends[SIGNAL_ALPHA].Update(aircraft_data.Alpha(), dt);
+		trends[SIGNAL_IAS].Update(aircraft_data.IAS(), dt);
+		trends[SIGNAL_MACH].Update(aircraft_data.Mach(), dt);
+		trends[SIGNAL_PITCH].Update(aircraft_data.Pitch(), dt);
+		trends[SIGNAL_GFORCE].Update(aircraft_data.GForce(), dt);
+
+		time_to_limit[LIMIT_ALPHA_PROT] = trends[SIGNAL_ALPHA].TimeAbove(limits.alpha_prot);
+		time_to_limit[LIMIT_VMO] = trends[SIGNAL_IAS].TimeAbove(limits.vmo);
+		time_to_limit[LIMIT_MMO] = trends[SIGNAL_MACH].TimeAbove(limits.mmo);
+		time_to_limit[LIMIT_MAX_PITCH] = trends[SIGNAL_PITCH].TimeAbove(limits.max_pitch);
+		time_to_limit[LIMIT_MIN_PITCH] = trends[SIGNAL_PITCH].TimeBelow(limits.min_pitch);
+		time_to_limit[LIMIT_MAX_LOAD_FACTOR] = trends[SIGNAL_GFORCE].TimeAbove(limits.max_load_factor);
+		time_to_limit[LIMIT_MIN_LOAD_FACTOR] = trends[SIGNAL_GFORCE].TimeBelow(limits.min_load_factor);
+	}
+	void Reset()
+	{
+		for (auto& trend : trends) trend.Reset();
+		for (auto& time : time_to_limit) time = INFINITY;
+	}
+
+	// Seconds until the limit is reached (0 once beyond it, infinite if the aircraft is moving away from it)
+	double TimeToLimit(const ENVELOPE_LIMIT limit) const { return time_to_limit[limit]; }
+	const TrendEstimator& Trend(const ENVELOPE_SIGNAL signal) const { return trends[signal]; }
+};
\ No newline at end of file
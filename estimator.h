@@ -0,0 +1,92 @@
+#pragma once
+#include <cmath>
+
+#include "common.h"
+
+// How AircraftData derives the pitch rate and the vertical flight path angle rate
+enum ESTIMATOR_MODE
+{
+	ESTIMATOR_FINITE_DIFFERENCE, // The change of the angle since the last update, over dt
+	ESTIMATOR_COMPLEMENTARY, // The rate the rotation and acceleration SimVars give, corrected by the angle (see below)
+};
+
+// Fuses an angle with a measurement of its rate: the rate has no lag, and the angle keeps any bias of the rate
+// measurement from accumulating. A second order complementary filter, whose angle follows the measured angle below
+// 1 / time_constant rad/s and integrates the measured rate above.
+class ComplementaryFilter
+{
+private:
+	double time_constant;
+	double angle = 0;
+	double bias = 0; // Estimated error of the measured rate
+	double rate = 0;
+	double last_measured_rate = 0;
+	bool started = false;
+public:
+	ComplementaryFilter(const double time_constant) : time_constant(time_constant) {};
+
+	void Update(const double measured_angle, const double measured_rate, const double dt)
+	{
+		if (!started)
+		{
+			angle = measured_angle;
+			started = true;
+		}
+		else if (dt > 0)
+		{
+			const auto bandwidth = 1 / time_constant;
+			angle += ((measured_rate + last_measured_rate) / 2 - bias) * dt; // Trapezoidal, as the rate is sampled at the ends
+			const auto error = measured_angle - angle;
+			angle += 1.4 * bandwidth * dt * error; // Damping ratio 0.7
+			bias -= bandwidth * bandwidth * dt * error;
+		}
+		rate = measured_rate - bias;
+		last_measured_rate = measured_rate;
+	}
+	void Reset()
+	{
+		angle = 0;
+		bias = 0;
+		rate = 0;
+		last_measured_rate = 0;
+		started = false;
+	}
+
+	double Angle() const { return angle; }
+	double Rate() const { return rate; }
+};
+
+// The pitch rate from the body rotation rates, and the flight path angle rate from the earth-relative velocity and
+// acceleration, each fused with its angle. A fixed cost per update, and defined when dt is 0.
+class StateEstimator
+{
+private:
+	ComplementaryFilter pitch = ComplementaryFilter(2);
+	ComplementaryFilter vertical_fpa = ComplementaryFilter(2);
+public:
+	// Angles in degrees (+ is up), body rates in degrees/second (+ is nose up, nose right), bank in degrees (+ is
+	// right), and speeds and accelerations in feet/second (squared) along the horizontal and the vertical (+ is up)
+	void Update(const double pitch_angle, const double body_pitch_rate, const double body_yaw_rate, const double bank,
+		const double vfpa, const double horizontal_speed, const double horizontal_acceleration,
+		const double vertical_speed, const double vertical_acceleration, const double dt)
+	{
+		// Euler pitch rate
+		const auto phi = radians(bank);
+		pitch.Update(pitch_angle, body_pitch_rate * cos(phi) - body_yaw_rate * sin(phi), dt);
+
+		// Derivative of atan(vertical / horizontal)
+		const auto speed_squared = horizontal_speed * horizontal_speed + vertical_speed * vertical_speed;
+		const auto vfpa_rate = speed_squared > 0
+			? degrees((horizontal_speed * vertical_acceleration - vertical_speed * horizontal_acceleration) / speed_squared)
+			: 0;
+		vertical_fpa.Update(vfpa, vfpa_rate, dt);
+	}
+	void Reset()
+	{
+		pitch.Reset();
+		vertical_fpa.Reset();
+	}
+
+	double PitchRate() const { return pitch.Rate(); }
+	double VFPARate() const { return vertical_fpa.Rate(); }
+};
\ No newline at end of file
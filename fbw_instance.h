@@ -0,0 +1,87 @@
+#pragma once
+#include "common.h"
+#include "actuators.h"
+#include "aircraft_data.h"
+#include "input.h"
+#include "pitch_control_mode.h"
+#include "protections.h"
+#include "telemetry.h"
+#include "controls.h"
+#include "scheduler.h"
+#include "stage_timing.h"
+
+// One complete fly-by-wire system.
+// It owns all of its state and only talks to the outside world through Update(), so any number of instances can be
+// run side by side, each on its own thread. The gauge (fbw_sys.cpp) runs a single instance against the simulator.
+class FbwInstance
+{
+private:
+	AircraftData aircraft_data;
+	InputCapture input_capture;
+	PitchControlMode pitch_control_mode;
+	NormalLawProtections normal_law_protections;
+	PitchTelemetry pitch_telemetry;
+	ControlSurfaces control_surfaces;
+	SurfaceOutputStage output_stage;
+	FixedRateScheduler scheduler;
+	StageTimings stage_timings; // Empty unless FBW_STAGE_TIMING is defined
+
+	AircraftDataSample previous_sample; // The sample of the previous frame
+	bool started = false; // True once the first frame has been run
+public:
+	FbwInstance(const double control_rate = 60, const int max_control_steps = 4)
+		: pitch_control_mode(aircraft_data),
+		normal_law_protections(aircraft_data, input_capture),
+		control_surfaces(aircraft_data, input_capture, pitch_control_mode, normal_law_protections, pitch_telemetry),
+		scheduler(control_rate, max_control_steps) {};
+
+	// The components refer to each other, so an instance cannot be copied or moved
+	FbwInstance(const FbwInstance&) = delete;
+	FbwInstance& operator=(const FbwInstance&) = delete;
+
+	AircraftData& Aircraft() { return aircraft_data; }
+	InputCapture& Input() { return input_capture; }
+	PitchControlMode& PitchMode() { return pitch_control_mode; }
+	NormalLawProtections& Protections() { return normal_law_protections; }
+	PitchTelemetry& Telemetry() { return pitch_telemetry; }
+	ControlSurfaces& Surfaces() { return control_surfaces; }
+	SurfaceOutputStage& Output() { return output_stage; }
+	FixedRateScheduler& Scheduler() { return scheduler; }
+	StageTimings& Timings() { return stage_timings; }
+
+	// Runs the control steps due at the end of a frame lasting dt and ending at time t, in which the aircraft
+	// reached the state in sample. Returns the control surface positions to apply for this frame, which only need
+	// writing if Output().Changed().
+	// Input events for the frame must have been applied to Input() beforehand.
+	CONTROL_SURFACES_DATA Update(const AircraftDataSample& sample, const double t, const double dt)
+	{
+		if (!started) previous_sample = sample;
+		started = true;
+		input_capture.StampEvents(t, dt);
+
+		scheduler.Advance(t, dt, [this, &sample](const double step_t, const double step_dt, const double frame_fraction)
+		{
+			input_capture.Update(step_t);
+			{
+				FBW_STAGE_TIMER(stage_timings, STAGE_AIRCRAFT_DATA);
+				aircraft_data.Update(Interpolate(previous_sample, sample, frame_fraction), step_t, step_dt);
+			}
+			{
+				FBW_STAGE_TIMER(stage_timings, STAGE_PITCH_MODE);
+				pitch_control_mode.Update(step_t, step_dt);
+			}
+			{
+				FBW_STAGE_TIMER(stage_timings, STAGE_PROTECTIONS);
+				normal_law_protections.Update(step_t, step_dt);
+			}
+			{
+				FBW_STAGE_TIMER(stage_timings, STAGE_CONTROL_SURFACES);
+				control_surfaces.Update(step_t, step_dt); // Calls the FBW logic internally
+			}
+		});
+		previous_sample = sample;
+		const auto surfaces = output_stage.Update(control_surfaces.Output(scheduler.Blend()), dt);
+		input_capture.MeasureLatency();
+		return surfaces;
+	}
+};
\ No newline at end of file
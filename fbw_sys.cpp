@@ -1,10 +1,53 @@
-#include "pitch_control_mode.h"
-#include "input.h"
-#include "protections.h"
-#include "controls.h"
+#include "fbw_instance.h"
+#include "recorder.h"
+#include "sim_data.h"
+#include "telemetry.h"
 
 #define ENABLE_FBW_SYSTEM TRUE
 
+// The control logic runs at this fixed rate (in Hz) whatever the frame rate is
+#ifndef FBW_CONTROL_RATE
+#define FBW_CONTROL_RATE 60
+#endif
+// Control steps run in a single frame at most, to bound the cost of catching up after a hitch
+#ifndef FBW_MAX_CONTROL_STEPS
+#define FBW_MAX_CONTROL_STEPS 4
+#endif
+
+HANDLE hSimConnect = 0;
+SimData sim_data;
+FbwInstance fbw(FBW_CONTROL_RATE, FBW_MAX_CONTROL_STEPS);
+PitchTraceWriter pitch_trace_writer(fbw.Telemetry());
+FlightRecorder flight_recorder(FBW_CONTROL_RATE, FBW_MAX_CONTROL_STEPS);
+#ifdef FBW_STAGE_TIMING
+StageTimingPublisher stage_timing_publisher(fbw.Timings(), fbw.Input());
+#endif
+
+// Routes everything SimConnect delivered since the last frame
+void CALLBACK OnSimConnectDispatch(SIMCONNECT_RECV* pData, DWORD cbData, void* pContext)
+{
+	switch (pData->dwID)
+	{
+	case SIMCONNECT_RECV_ID_EVENT:
+	{
+		const auto* evt = static_cast<SIMCONNECT_RECV_EVENT*>(pData);
+		flight_recorder.OnEvent(static_cast<EVENT_ID>(evt->uEventID), static_cast<int32_t>(evt->dwData));
+		OnInputCaptureEvent(pData, cbData, &fbw.Input());
+	}
+	break;
+	case SIMCONNECT_RECV_ID_SIMOBJECT_DATA:
+	{
+		const auto* data = static_cast<SIMCONNECT_RECV_SIMOBJECT_DATA*>(pData);
+		if (data->dwRequestID == AIRCRAFT_DATA_REQUEST)
+		{
+			sim_data.OnSimObjectData(data, cbData);
+		}
+	}
+	break;
+	default: break;
+	}
+}
+
 extern "C"
 {
 	MSFS_CALLBACK bool FBW_gauge_callback(FsContext ctx, const int service_id, void* pData)
@@ -21,8 +64,22 @@ extern "C"
 		{
 			if (ENABLE_FBW_SYSTEM)
 			{
-				input_capture.Init();
-				control_surfaces.Init();
+				sim_data.Init(hSimConnect);
+				fbw.Input().Init(hSimConnect);
+				fbw.Surfaces().Init(hSimConnect);
+				pitch_trace_writer.Init();
+				// The pitch law, the estimator and the actuators are chosen once, when the gauge is installed
+				const auto model_predictive = get_named_variable_value(register_named_variable("A32NX_FBW_PITCH_MPC")) != 0;
+				const auto complementary = get_named_variable_value(register_named_variable("A32NX_FBW_COMPLEMENTARY_ESTIMATOR")) != 0;
+				const auto actuators = get_named_variable_value(register_named_variable("A32NX_FBW_ACTUATORS")) != 0;
+				fbw.Surfaces().Pitch().SetModelPredictive(model_predictive);
+				fbw.Aircraft().SetEstimatorMode(complementary ? ESTIMATOR_COMPLEMENTARY : ESTIMATOR_FINITE_DIFFERENCE);
+				fbw.Output().SetEnabled(actuators);
+				flight_recorder.Init((model_predictive ? RECORDING_PITCH_MPC : 0) | (complementary ? 0 : RECORDING_FINITE_DIFFERENCE)
+					| (actuators ? RECORDING_ACTUATORS : 0));
+#ifdef FBW_STAGE_TIMING
+				stage_timing_publisher.Init();
+#endif
 			}
 		}
 		break;
@@ -36,16 +93,37 @@ extern "C"
 			const auto dt = p_draw_data->dt;
 			if (ENABLE_FBW_SYSTEM)
 			{
-				aircraft_data.Update(t, dt);
-				pitch_control_mode.Update(t, dt);
-				normal_law_protections.Update(t, dt);
-				input_capture.Update(t, dt);
-				control_surfaces.Update(t, dt); // Calls the FBW logic internally
+				{
+					FBW_STAGE_TIMER(fbw.Timings(), STAGE_FRAME);
+					{
+						FBW_STAGE_TIMER(fbw.Timings(), STAGE_DISPATCH);
+						SimConnect_CallDispatch(hSimConnect, OnSimConnectDispatch, nullptr); // Input events and the aircraft data sample
+					}
+					{
+						FBW_STAGE_TIMER(fbw.Timings(), STAGE_SIM_DATA);
+						sim_data.Update(t, dt);
+					}
+					flight_recorder.OnFrame(sim_data.Sample(), t, dt);
+					auto surfaces = fbw.Update(sim_data.Sample(), t, dt); // Calls the FBW logic internally
+					{
+						FBW_STAGE_TIMER(fbw.Timings(), STAGE_OUTPUT);
+						if (fbw.Output().Changed())
+						{
+							SimConnect_SetDataOnSimObject(hSimConnect, CONTROL_SURFACES_DEFINITION, SIMCONNECT_OBJECT_ID_USER, 0, 0, sizeof(surfaces), &surfaces);
+						}
+					}
+					pitch_trace_writer.Update(t, dt);
+				}
+#ifdef FBW_STAGE_TIMING
+				stage_timing_publisher.Update(t, dt); // Outside of the frame's timing, as it occasionally prints
+#endif
 			}
 		}
 		break;
 		case PANEL_SERVICE_PRE_KILL:
 		{
+			pitch_trace_writer.Destroy();
+			flight_recorder.Destroy();
 			ret &= SUCCEEDED(SimConnect_Close(hSimConnect));
 		}
 		break;
@@ -53,4 +131,4 @@ extern "C"
 		}
 		return ret;
 	}
-}
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#pragma once
+#include "common.h"
+
+// The flight envelope of the high angle of attack protection and the pitch attitude limits at one flight condition
+struct EnvelopePoint
+{
+	double alpha_prot; // Degrees
+	double alpha_floor; // Degrees
+	double alpha_max; // Degrees
+	double v_alpha_prot; // Indicated airspeed in knots at which alpha_prot holds 1g
+	double v_alpha_max; // Indicated airspeed in knots at which alpha_max holds 1g
+	double max_pitch; // Maximum pitch attitude in degrees at v_alpha_prot and faster
+	double low_speed_max_pitch; // Maximum pitch attitude in degrees at v_alpha_max and slower
+};
+
+// Interpolated field by field
+constexpr double EnvelopePoint::* envelope_fields[] = {
+	&EnvelopePoint::alpha_prot, &EnvelopePoint::alpha_floor, &EnvelopePoint::alpha_max, &EnvelopePoint::v_alpha_prot,
+	&EnvelopePoint::v_alpha_max, &EnvelopePoint::max_pitch, &EnvelopePoint::low_speed_max_pitch,
+};
+
+// Envelope points over a grid of flaps handle positions, weights and Mach numbers, which are constexpr in the gauge
+// (see flight_envelope_tables.h). The weights and Mach numbers are evenly spaced, so that the cell of a flight
+// condition is found by a division rather than a search.
+struct EnvelopeTable
+{
+	int flaps_count;
+	double weight_start; // Kilograms
+	double weight_step;
+	int weight_count;
+	double mach_start;
+	double mach_step;
+	int mach_count;
+	const EnvelopePoint* points; // Ordered by flaps, then weight, then Mach varying fastest
+};
+
+// The lower breakpoint of the cell of value on an evenly spaced axis, and how far value is along the cell; values
+// beyond the axis are held at its ends
+inline void EnvelopeCell(const double start, const double step, const int count, const double value, int& index, double& fraction)
+{
+	const auto position = clamp((value - start) / step, 0, count - 1);
+	index = static_cast<int>(position);
+	if (index > count - 2) index = count > 1 ? count - 2 : 0;
+	fraction = count > 1 ? position - index : 0;
+}
+
+// The envelope at flaps, weight (kilograms) and mach, interpolated bilinearly in the cell of weight and mach
+inline EnvelopePoint LookUpEnvelope(const EnvelopeTable& table, const int flaps, const double weight, const double mach)
+{
+	int w, m;
+	double fw, fm;
+	EnvelopeCell(table.weight_start, table.weight_step, table.weight_count, weight, w, fw);
+	EnvelopeCell(table.mach_start, table.mach_step, table.mach_count, mach, m, fm);
+	const auto* low = table.points + (static_cast<int>(clamp(flaps, 0, table.flaps_count - 1)) * table.weight_count + w) * table.mach_count + m;
+	const auto* high = table.weight_count > 1 ? low + table.mach_count : low;
+	const auto next = table.mach_count > 1 ? 1 : 0;
+
+	EnvelopePoint point;
+	for (const auto field : envelope_fields)
+	{
+		const auto light = low->*field + (low[next].*field - low->*field) * fm;
+		const auto heavy = high->*field + (high[next].*field - high->*field) * fm;
+		point.*field = light + (heavy - light) * fw;
+	}
+	return point;
+}
+
+// The alpha floor of the FCOM, in 1.27.20 under "High Angle of Attack Protection": 9.5 degrees in configuration 0;
+// 15 degrees in configuration 1, 2; 14 degrees in configuration 3; 13 degrees in configuration FULL
+inline double FcomAlphaFloor(const int flaps)
+{
+	switch (flaps)
+	{
+	case 1: // CONF 1
+	case 2: // CONF 2
+		return 15;
+	case 3: // CONF 3
+		return 14;
+	case 4: // CONF FULL
+		return 13;
+	default: // Clean CONF
+		return 9.5;
+	}
+}
+
+// point with the angles of attack of the FCOM in place of the swept ones, which the gauge flies with until the sweep is
+// calibrated against the simulator's flight model. Alpha prot and alpha max are at ratios to alpha floor estimated from
+// the graph of CL to alpha in the FCOM, with a ruler.
+inline EnvelopePoint WithFcomAlpha(EnvelopePoint point, const int flaps)
+{
+	point.alpha_floor = FcomAlphaFloor(flaps);
+	point.alpha_prot = 19.0 / 21.0 * point.alpha_floor;
+	point.alpha_max = 7.0 / 6.0 * point.alpha_floor;
+	return point;
+}
+
+// The maximum pitch attitude of point at ias: max_pitch down to v_alpha_prot, then progressively reduced to
+// low_speed_max_pitch at v_alpha_max
+inline double MaxPitchAttitude(const EnvelopePoint& point, const double ias)
+{
+	const auto span = point.v_alpha_prot - point.v_alpha_max;
+	const auto fraction = span > 0 ? clamp((ias - point.v_alpha_max) / span, 0, 1) : ias >= point.v_alpha_prot ? 1 : 0;
+	return point.low_speed_max_pitch + (point.max_pitch - point.low_speed_max_pitch) * fraction;
+}
\ No newline at end of file
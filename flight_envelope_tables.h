@@ -0,0 +1,690 @@
+#pragma once
+#include "flight_envelope.h"
+
+// Generated by envelope_sweep (see tools/envelope_sweep.cpp) from the host plant model, which stands in for
+// the simulator's flight model; regenerate it when the aerodynamic tables of host/aero_data.h change.
+namespace default_envelope
+{
+	// alpha_prot, alpha_floor, alpha_max, v_alpha_prot, v_alpha_max, max_pitch, low_speed_max_pitch
+	constexpr EnvelopePoint points[] = {
+		// CONF 0, 40000 kg, Mach 0.20 to 0.85
+		{ 9.5910, 10.4178, 11.5752, 133.68, 124.16, 30, 25 },
+		{ 8.9987, 9.7819, 11.0701, 135.91, 126.19, 30, 25 },
+		{ 8.4312, 9.1727, 10.3248, 138.20, 128.32, 30, 25 },
+		{ 7.8871, 8.5887, 9.5708, 140.62, 130.56, 30, 25 },
+		{ 7.4668, 8.1367, 9.0746, 142.44, 132.25, 30, 25 },
+		{ 7.1952, 7.8435, 8.7513, 143.34, 133.09, 30, 25 },
+		{ 6.9341, 7.5618, 8.4405, 144.27, 133.95, 30, 25 },
+		{ 6.2202, 6.8073, 7.6952, 147.62, 137.06, 30, 25 },
+		{ 5.5875, 6.1392, 6.9115, 150.73, 139.95, 30, 25 },
+		{ 4.9816, 5.4976, 6.2223, 154.05, 143.03, 30, 25 },
+		{ 4.9155, 5.4244, 6.1509, 152.36, 141.46, 30, 25 },
+		{ 4.4990, 4.9337, 5.8106, 156.44, 145.25, 30, 25 },
+		{ 4.1202, 4.5285, 5.2155, 160.79, 149.29, 30, 25 },
+		{ 3.7849, 4.1709, 4.7113, 165.38, 153.55, 30, 25 },
+		// CONF 0, 45000 kg, Mach 0.20 to 0.85
+		{ 9.5910, 10.4178, 11.5752, 141.51, 131.69, 30, 25 },
+		{ 8.9987, 9.7819, 11.0701, 144.15, 133.84, 30, 25 },
+		{ 8.4312, 9.1727, 10.3248, 146.59, 136.10, 30, 25 },
+		{ 7.8871, 8.5887, 9.5708, 149.15, 138.48, 30, 25 },
+		{ 7.4668, 8.1367, 9.0746, 151.08, 140.27, 30, 25 },
+		{ 7.1952, 7.8435, 8.7513, 152.04, 141.16, 30, 25 },
+		{ 6.9341, 7.5618, 8.4405, 153.02, 142.08, 30, 25 },
+		{ 6.2202, 6.8073, 7.6952, 156.57, 145.37, 30, 25 },
+		{ 5.5875, 6.1392, 6.9115, 159.87, 148.44, 30, 25 },
+		{ 4.9816, 5.4976, 6.2223, 163.40, 151.71, 30, 25 },
+		{ 4.9155, 5.4244, 6.1509, 161.60, 150.04, 30, 25 },
+		{ 4.4990, 4.9337, 5.8106, 165.93, 154.07, 30, 25 },
+		{ 4.1202, 4.5285, 5.2155, 170.54, 158.35, 30, 25 },
+		{ 3.7849, 4.1709, 4.7113, 175.41, 162.87, 30, 25 },
+		// CONF 0, 50000 kg, Mach 0.20 to 0.85
+		{ 9.5910, 10.4178, 11.5752, 148.88, 138.85, 30, 25 },
+		{ 8.9987, 9.7819, 11.0701, 151.95, 141.08, 30, 25 },
+		{ 8.4312, 9.1727, 10.3248, 154.52, 143.47, 30, 25 },
+		{ 7.8871, 8.5887, 9.5708, 157.22, 145.97, 30, 25 },
+		{ 7.4668, 8.1367, 9.0746, 159.25, 147.86, 30, 25 },
+		{ 7.1952, 7.8435, 8.7513, 160.26, 148.80, 30, 25 },
+		{ 6.9341, 7.5618, 8.4405, 161.30, 149.76, 30, 25 },
+		{ 6.2202, 6.8073, 7.6952, 165.04, 153.24, 30, 25 },
+		{ 5.5875, 6.1392, 6.9115, 168.52, 156.47, 30, 25 },
+		{ 4.9816, 5.4976, 6.2223, 172.24, 159.92, 30, 25 },
+		{ 4.9155, 5.4244, 6.1509, 170.34, 158.16, 30, 25 },
+		{ 4.4990, 4.9337, 5.8106, 174.91, 162.40, 30, 25 },
+		{ 4.1202, 4.5285, 5.2155, 179.77, 166.91, 30, 25 },
+		{ 3.7849, 4.1709, 4.7113, 184.90, 171.68, 30, 25 },
+		// CONF 0, 55000 kg, Mach 0.20 to 0.85
+		{ 9.5910, 10.4178, 11.5752, 155.87, 145.66, 30, 25 },
+		{ 8.9987, 9.7819, 11.0701, 159.37, 147.97, 30, 25 },
+		{ 8.4312, 9.1727, 10.3248, 162.06, 150.47, 30, 25 },
+		{ 7.8871, 8.5887, 9.5708, 164.89, 153.10, 30, 25 },
+		{ 7.4668, 8.1367, 9.0746, 167.02, 155.08, 30, 25 },
+		{ 7.1952, 7.8435, 8.7513, 168.09, 156.06, 30, 25 },
+		{ 6.9341, 7.5618, 8.4405, 169.17, 157.07, 30, 25 },
+		{ 6.2202, 6.8073, 7.6952, 173.10, 160.72, 30, 25 },
+		{ 5.5875, 6.1392, 6.9115, 176.75, 164.11, 30, 25 },
+		{ 4.9816, 5.4976, 6.2223, 180.64, 167.72, 30, 25 },
+		{ 4.9155, 5.4244, 6.1509, 178.66, 165.88, 30, 25 },
+		{ 4.4990, 4.9337, 5.8106, 183.45, 170.33, 30, 25 },
+		{ 4.1202, 4.5285, 5.2155, 188.54, 175.06, 30, 25 },
+		{ 3.7849, 4.1709, 4.7113, 193.92, 180.05, 30, 25 },
+		// CONF 0, 60000 kg, Mach 0.20 to 0.85
+		{ 9.5910, 10.4178, 11.5752, 162.53, 152.18, 30, 25 },
+		{ 8.9987, 9.7819, 11.0701, 166.41, 154.55, 30, 25 },
+		{ 8.4312, 9.1727, 10.3248, 169.26, 157.16, 30, 25 },
+		{ 7.8871, 8.5887, 9.5708, 172.22, 159.90, 30, 25 },
+		{ 7.4668, 8.1367, 9.0746, 174.45, 161.97, 30, 25 },
+		{ 7.1952, 7.8435, 8.7513, 175.56, 163.00, 30, 25 },
+		{ 6.9341, 7.5618, 8.4405, 176.69, 164.05, 30, 25 },
+		{ 6.2202, 6.8073, 7.6952, 180.79, 167.86, 30, 25 },
+		{ 5.5875, 6.1392, 6.9115, 184.61, 171.40, 30, 25 },
+		{ 4.9816, 5.4976, 6.2223, 188.67, 175.18, 30, 25 },
+		{ 4.9155, 5.4244, 6.1509, 186.60, 173.25, 30, 25 },
+		{ 4.4990, 4.9337, 5.8106, 191.60, 177.90, 30, 25 },
+		{ 4.1202, 4.5285, 5.2155, 196.93, 182.84, 30, 25 },
+		{ 3.7849, 4.1709, 4.7113, 202.55, 188.06, 30, 25 },
+		// CONF 0, 65000 kg, Mach 0.20 to 0.85
+		{ 9.5910, 10.4178, 11.5752, 168.89, 158.43, 30, 25 },
+		{ 8.9987, 9.7819, 11.0701, 172.93, 160.86, 30, 25 },
+		{ 8.4312, 9.1727, 10.3248, 176.18, 163.58, 30, 25 },
+		{ 7.8871, 8.5887, 9.5708, 179.25, 166.43, 30, 25 },
+		{ 7.4668, 8.1367, 9.0746, 181.57, 168.59, 30, 25 },
+		{ 7.1952, 7.8435, 8.7513, 182.73, 169.66, 30, 25 },
+		{ 6.9341, 7.5618, 8.4405, 183.91, 170.75, 30, 25 },
+		{ 6.2202, 6.8073, 7.6952, 188.17, 174.72, 30, 25 },
+		{ 5.5875, 6.1392, 6.9115, 192.15, 178.40, 30, 25 },
+		{ 4.9816, 5.4976, 6.2223, 196.38, 182.33, 30, 25 },
+		{ 4.9155, 5.4244, 6.1509, 194.22, 180.33, 30, 25 },
+		{ 4.4990, 4.9337, 5.8106, 199.43, 185.16, 30, 25 },
+		{ 4.1202, 4.5285, 5.2155, 204.97, 190.31, 30, 25 },
+		{ 3.7849, 4.1709, 4.7113, 210.82, 195.74, 30, 25 },
+		// CONF 0, 70000 kg, Mach 0.20 to 0.85
+		{ 9.5910, 10.4178, 11.5752, 175.00, 164.45, 30, 25 },
+		{ 8.9987, 9.7819, 11.0701, 179.18, 166.92, 30, 25 },
+		{ 8.4312, 9.1727, 10.3248, 182.83, 169.75, 30, 25 },
+		{ 7.8871, 8.5887, 9.5708, 186.02, 172.72, 30, 25 },
+		{ 7.4668, 8.1367, 9.0746, 188.43, 174.95, 30, 25 },
+		{ 7.1952, 7.8435, 8.7513, 189.63, 176.06, 30, 25 },
+		{ 6.9341, 7.5618, 8.4405, 190.85, 177.20, 30, 25 },
+		{ 6.2202, 6.8073, 7.6952, 195.28, 181.31, 30, 25 },
+		{ 5.5875, 6.1392, 6.9115, 199.40, 185.14, 30, 25 },
+		{ 4.9816, 5.4976, 6.2223, 203.79, 189.22, 30, 25 },
+		{ 4.9155, 5.4244, 6.1509, 201.55, 187.14, 30, 25 },
+		{ 4.4990, 4.9337, 5.8106, 206.96, 192.15, 30, 25 },
+		{ 4.1202, 4.5285, 5.2155, 212.71, 197.49, 30, 25 },
+		{ 3.7849, 4.1709, 4.7113, 218.78, 203.13, 30, 25 },
+		// CONF 0, 75000 kg, Mach 0.20 to 0.85
+		{ 9.5910, 10.4178, 11.5752, 180.88, 170.25, 30, 25 },
+		{ 8.9987, 9.7819, 11.0701, 185.19, 172.73, 30, 25 },
+		{ 8.4312, 9.1727, 10.3248, 189.24, 175.71, 30, 25 },
+		{ 7.8871, 8.5887, 9.5708, 192.55, 178.78, 30, 25 },
+		{ 7.4668, 8.1367, 9.0746, 195.04, 181.09, 30, 25 },
+		{ 7.1952, 7.8435, 8.7513, 196.28, 182.24, 30, 25 },
+		{ 6.9341, 7.5618, 8.4405, 197.55, 183.42, 30, 25 },
+		{ 6.2202, 6.8073, 7.6952, 202.13, 187.68, 30, 25 },
+		{ 5.5875, 6.1392, 6.9115, 206.40, 191.64, 30, 25 },
+		{ 4.9816, 5.4976, 6.2223, 210.94, 195.86, 30, 25 },
+		{ 4.9155, 5.4244, 6.1509, 208.62, 193.70, 30, 25 },
+		{ 4.4990, 4.9337, 5.8106, 214.22, 198.90, 30, 25 },
+		{ 4.1202, 4.5285, 5.2155, 220.17, 204.42, 30, 25 },
+		{ 3.7849, 4.1709, 4.7113, 226.46, 210.26, 30, 25 },
+		// CONF 0, 80000 kg, Mach 0.20 to 0.85
+		{ 9.5910, 10.4178, 11.5752, 186.54, 175.87, 30, 25 },
+		{ 8.9987, 9.7819, 11.0701, 191.00, 178.34, 30, 25 },
+		{ 8.4312, 9.1727, 10.3248, 195.45, 181.47, 30, 25 },
+		{ 7.8871, 8.5887, 9.5708, 198.86, 184.64, 30, 25 },
+		{ 7.4668, 8.1367, 9.0746, 201.44, 187.03, 30, 25 },
+		{ 7.1952, 7.8435, 8.7513, 202.72, 188.22, 30, 25 },
+		{ 6.9341, 7.5618, 8.4405, 204.03, 189.43, 30, 25 },
+		{ 6.2202, 6.8073, 7.6952, 208.76, 193.83, 30, 25 },
+		{ 5.5875, 6.1392, 6.9115, 213.17, 197.92, 30, 25 },
+		{ 4.9816, 5.4976, 6.2223, 217.86, 202.28, 30, 25 },
+		{ 4.9155, 5.4244, 6.1509, 215.47, 200.06, 30, 25 },
+		{ 4.4990, 4.9337, 5.8106, 221.24, 205.42, 30, 25 },
+		{ 4.1202, 4.5285, 5.2155, 227.39, 211.13, 30, 25 },
+		{ 3.7849, 4.1709, 4.7113, 233.88, 217.15, 30, 25 },
+		// CONF 1, 40000 kg, Mach 0.20 to 0.85
+		{ 9.7056, 10.7647, 12.2475, 118.15, 109.70, 30, 25 },
+		{ 9.0472, 10.0615, 11.6807, 119.90, 111.32, 30, 25 },
+		{ 8.4164, 9.3722, 10.9525, 121.73, 113.02, 30, 25 },
+		{ 7.8116, 8.7190, 9.9892, 123.65, 114.80, 30, 25 },
+		{ 7.2313, 8.0921, 9.2972, 125.66, 116.67, 30, 25 },
+		{ 6.8617, 7.6903, 8.8504, 126.80, 117.73, 30, 25 },
+		{ 6.6906, 7.5006, 8.6346, 127.00, 117.91, 30, 25 },
+		{ 5.7691, 6.5172, 7.5980, 130.45, 121.12, 30, 25 },
+		{ 4.8986, 5.5827, 6.5477, 134.21, 124.61, 30, 25 },
+		{ 4.3633, 4.9683, 5.8764, 136.49, 126.73, 30, 25 },
+		{ 4.3320, 4.9211, 5.8187, 135.25, 125.57, 30, 25 },
+		{ 3.8328, 4.3848, 5.2472, 138.83, 128.90, 30, 25 },
+		{ 3.3695, 3.8883, 4.6146, 142.65, 132.67, 30, 25 },
+		{ 2.9449, 3.4353, 4.1220, 146.71, 136.27, 30, 25 },
+		// CONF 1, 45000 kg, Mach 0.20 to 0.85
+		{ 9.7056, 10.7647, 12.2475, 125.32, 116.35, 30, 25 },
+		{ 9.0472, 10.0615, 11.6807, 127.17, 118.08, 30, 25 },
+		{ 8.4164, 9.3722, 10.9525, 129.11, 119.88, 30, 25 },
+		{ 7.8116, 8.7190, 9.9892, 131.15, 121.77, 30, 25 },
+		{ 7.2313, 8.0921, 9.2972, 133.28, 123.75, 30, 25 },
+		{ 6.8617, 7.6903, 8.8504, 134.49, 124.87, 30, 25 },
+		{ 6.6906, 7.5006, 8.6346, 134.70, 125.07, 30, 25 },
+		{ 5.7691, 6.5172, 7.5980, 138.37, 128.47, 30, 25 },
+		{ 4.8986, 5.5827, 6.5477, 142.35, 132.17, 30, 25 },
+		{ 4.3633, 4.9683, 5.8764, 144.77, 134.41, 30, 25 },
+		{ 4.3320, 4.9211, 5.8187, 143.45, 133.19, 30, 25 },
+		{ 3.8328, 4.3848, 5.2472, 147.25, 136.72, 30, 25 },
+		{ 3.3695, 3.8883, 4.6146, 151.31, 140.49, 30, 25 },
+		{ 2.9449, 3.4353, 4.1220, 155.61, 144.48, 30, 25 },
+		// CONF 1, 50000 kg, Mach 0.20 to 0.85
+		{ 9.7056, 10.7647, 12.2475, 132.10, 122.65, 30, 25 },
+		{ 9.0472, 10.0615, 11.6807, 134.05, 124.46, 30, 25 },
+		{ 8.4164, 9.3722, 10.9525, 136.10, 126.36, 30, 25 },
+		{ 7.8116, 8.7190, 9.9892, 138.24, 128.35, 30, 25 },
+		{ 7.2313, 8.0921, 9.2972, 140.49, 130.44, 30, 25 },
+		{ 6.8617, 7.6903, 8.8504, 141.76, 131.62, 30, 25 },
+		{ 6.6906, 7.5006, 8.6346, 141.99, 131.83, 30, 25 },
+		{ 5.7691, 6.5172, 7.5980, 145.85, 135.42, 30, 25 },
+		{ 4.8986, 5.5827, 6.5477, 150.05, 139.32, 30, 25 },
+		{ 4.3633, 4.9683, 5.8764, 152.60, 141.68, 30, 25 },
+		{ 4.3320, 4.9211, 5.8187, 151.21, 140.40, 30, 25 },
+		{ 3.8328, 4.3848, 5.2472, 155.22, 144.12, 30, 25 },
+		{ 3.3695, 3.8883, 4.6146, 159.49, 148.09, 30, 25 },
+		{ 2.9449, 3.4353, 4.1220, 164.03, 152.30, 30, 25 },
+		// CONF 1, 55000 kg, Mach 0.20 to 0.85
+		{ 9.7056, 10.7647, 12.2475, 138.37, 128.63, 30, 25 },
+		{ 9.0472, 10.0615, 11.6807, 140.60, 130.54, 30, 25 },
+		{ 8.4164, 9.3722, 10.9525, 142.74, 132.53, 30, 25 },
+		{ 7.8116, 8.7190, 9.9892, 144.99, 134.62, 30, 25 },
+		{ 7.2313, 8.0921, 9.2972, 147.34, 136.81, 30, 25 },
+		{ 6.8617, 7.6903, 8.8504, 148.68, 138.05, 30, 25 },
+		{ 6.6906, 7.5006, 8.6346, 148.92, 138.27, 30, 25 },
+		{ 5.7691, 6.5172, 7.5980, 152.97, 142.03, 30, 25 },
+		{ 4.8986, 5.5827, 6.5477, 157.38, 146.12, 30, 25 },
+		{ 4.3633, 4.9683, 5.8764, 160.05, 148.60, 30, 25 },
+		{ 4.3320, 4.9211, 5.8187, 158.59, 147.25, 30, 25 },
+		{ 3.8328, 4.3848, 5.2472, 162.79, 151.15, 30, 25 },
+		{ 3.3695, 3.8883, 4.6146, 167.28, 155.31, 30, 25 },
+		{ 2.9449, 3.4353, 4.1220, 172.04, 159.73, 30, 25 },
+		// CONF 1, 60000 kg, Mach 0.20 to 0.85
+		{ 9.7056, 10.7647, 12.2475, 144.35, 134.36, 30, 25 },
+		{ 9.0472, 10.0615, 11.6807, 146.85, 136.34, 30, 25 },
+		{ 8.4164, 9.3722, 10.9525, 149.09, 138.42, 30, 25 },
+		{ 7.8116, 8.7190, 9.9892, 151.43, 140.60, 30, 25 },
+		{ 7.2313, 8.0921, 9.2972, 153.90, 142.89, 30, 25 },
+		{ 6.8617, 7.6903, 8.8504, 155.29, 144.19, 30, 25 },
+		{ 6.6906, 7.5006, 8.6346, 155.54, 144.41, 30, 25 },
+		{ 5.7691, 6.5172, 7.5980, 159.77, 148.35, 30, 25 },
+		{ 4.8986, 5.5827, 6.5477, 164.37, 152.62, 30, 25 },
+		{ 4.3633, 4.9683, 5.8764, 167.16, 155.21, 30, 25 },
+		{ 4.3320, 4.9211, 5.8187, 165.64, 153.80, 30, 25 },
+		{ 3.8328, 4.3848, 5.2472, 170.03, 157.87, 30, 25 },
+		{ 3.3695, 3.8883, 4.6146, 174.72, 162.22, 30, 25 },
+		{ 2.9449, 3.4353, 4.1220, 179.69, 166.84, 30, 25 },
+		// CONF 1, 65000 kg, Mach 0.20 to 0.85
+		{ 9.7056, 10.7647, 12.2475, 150.07, 139.87, 30, 25 },
+		{ 9.0472, 10.0615, 11.6807, 152.84, 141.91, 30, 25 },
+		{ 8.4164, 9.3722, 10.9525, 155.18, 144.08, 30, 25 },
+		{ 7.8116, 8.7190, 9.9892, 157.62, 146.34, 30, 25 },
+		{ 7.2313, 8.0921, 9.2972, 160.18, 148.72, 30, 25 },
+		{ 6.8617, 7.6903, 8.8504, 161.64, 150.07, 30, 25 },
+		{ 6.6906, 7.5006, 8.6346, 161.89, 150.31, 30, 25 },
+		{ 5.7691, 6.5172, 7.5980, 166.30, 154.40, 30, 25 },
+		{ 4.8986, 5.5827, 6.5477, 171.09, 158.85, 30, 25 },
+		{ 4.3633, 4.9683, 5.8764, 173.99, 161.55, 30, 25 },
+		{ 4.3320, 4.9211, 5.8187, 172.41, 160.08, 30, 25 },
+		{ 3.8328, 4.3848, 5.2472, 176.98, 164.32, 30, 25 },
+		{ 3.3695, 3.8883, 4.6146, 181.85, 168.84, 30, 25 },
+		{ 2.9449, 3.4353, 4.1220, 187.02, 173.65, 30, 25 },
+		// CONF 1, 70000 kg, Mach 0.20 to 0.85
+		{ 9.7056, 10.7647, 12.2475, 155.57, 145.17, 30, 25 },
+		{ 9.0472, 10.0615, 11.6807, 158.61, 147.27, 30, 25 },
+		{ 8.4164, 9.3722, 10.9525, 161.03, 149.52, 30, 25 },
+		{ 7.8116, 8.7190, 9.9892, 163.57, 151.87, 30, 25 },
+		{ 7.2313, 8.0921, 9.2972, 166.23, 154.34, 30, 25 },
+		{ 6.8617, 7.6903, 8.8504, 167.74, 155.74, 30, 25 },
+		{ 6.6906, 7.5006, 8.6346, 168.00, 155.99, 30, 25 },
+		{ 5.7691, 6.5172, 7.5980, 172.58, 160.23, 30, 25 },
+		{ 4.8986, 5.5827, 6.5477, 177.55, 164.85, 30, 25 },
+		{ 4.3633, 4.9683, 5.8764, 180.56, 167.64, 30, 25 },
+		{ 4.3320, 4.9211, 5.8187, 178.92, 166.12, 30, 25 },
+		{ 3.8328, 4.3848, 5.2472, 183.66, 170.52, 30, 25 },
+		{ 3.3695, 3.8883, 4.6146, 188.71, 175.22, 30, 25 },
+		{ 2.9449, 3.4353, 4.1220, 194.08, 180.20, 30, 25 },
+		// CONF 1, 75000 kg, Mach 0.20 to 0.85
+		{ 9.7056, 10.7647, 12.2475, 160.86, 150.28, 30, 25 },
+		{ 9.0472, 10.0615, 11.6807, 164.18, 152.44, 30, 25 },
+		{ 8.4164, 9.3722, 10.9525, 166.69, 154.76, 30, 25 },
+		{ 7.8116, 8.7190, 9.9892, 169.31, 157.20, 30, 25 },
+		{ 7.2313, 8.0921, 9.2972, 172.06, 159.75, 30, 25 },
+		{ 6.8617, 7.6903, 8.8504, 173.62, 161.21, 30, 25 },
+		{ 6.6906, 7.5006, 8.6346, 173.90, 161.46, 30, 25 },
+		{ 5.7691, 6.5172, 7.5980, 178.63, 165.86, 30, 25 },
+		{ 4.8986, 5.5827, 6.5477, 183.78, 170.63, 30, 25 },
+		{ 4.3633, 4.9683, 5.8764, 186.90, 173.53, 30, 25 },
+		{ 4.3320, 4.9211, 5.8187, 185.20, 171.95, 30, 25 },
+		{ 3.8328, 4.3848, 5.2472, 190.10, 176.51, 30, 25 },
+		{ 3.3695, 3.8883, 4.6146, 195.34, 181.37, 30, 25 },
+		{ 2.9449, 3.4353, 4.1220, 200.90, 186.53, 30, 25 },
+		// CONF 1, 80000 kg, Mach 0.20 to 0.85
+		{ 9.7056, 10.7647, 12.2475, 165.96, 155.23, 30, 25 },
+		{ 9.0472, 10.0615, 11.6807, 169.43, 157.44, 30, 25 },
+		{ 8.4164, 9.3722, 10.9525, 172.15, 159.84, 30, 25 },
+		{ 7.8116, 8.7190, 9.9892, 174.86, 162.36, 30, 25 },
+		{ 7.2313, 8.0921, 9.2972, 177.70, 164.99, 30, 25 },
+		{ 6.8617, 7.6903, 8.8504, 179.32, 166.49, 30, 25 },
+		{ 6.6906, 7.5006, 8.6346, 179.60, 166.76, 30, 25 },
+		{ 5.7691, 6.5172, 7.5980, 184.49, 171.30, 30, 25 },
+		{ 4.8986, 5.5827, 6.5477, 189.80, 176.23, 30, 25 },
+		{ 4.3633, 4.9683, 5.8764, 193.02, 179.22, 30, 25 },
+		{ 4.3320, 4.9211, 5.8187, 191.27, 177.59, 30, 25 },
+		{ 3.8328, 4.3848, 5.2472, 196.34, 182.29, 30, 25 },
+		{ 3.3695, 3.8883, 4.6146, 201.74, 187.32, 30, 25 },
+		{ 2.9449, 3.4353, 4.1220, 207.49, 192.65, 30, 25 },
+		// CONF 2, 40000 kg, Mach 0.20 to 0.85
+		{ 9.8087, 11.0245, 12.7265, 110.27, 102.39, 30, 25 },
+		{ 9.0516, 10.2200, 11.9545, 112.00, 103.99, 30, 25 },
+		{ 8.3263, 9.4196, 11.0991, 113.82, 105.68, 30, 25 },
+		{ 7.6309, 8.6667, 10.1458, 115.72, 107.45, 30, 25 },
+		{ 7.1430, 8.1356, 9.5253, 117.01, 108.64, 30, 25 },
+		{ 6.8794, 7.8442, 9.1950, 117.51, 109.10, 30, 25 },
+		{ 6.8107, 7.7611, 9.0917, 117.24, 108.86, 30, 25 },
+		{ 5.7786, 6.6352, 8.0150, 120.34, 111.74, 30, 25 },
+		{ 4.8456, 5.6174, 6.6979, 123.70, 114.85, 30, 25 },
+		{ 4.1028, 4.8045, 5.7869, 126.72, 117.66, 30, 25 },
+		{ 4.0896, 4.7717, 5.7266, 125.69, 117.50, 30, 25 },
+		{ 3.5545, 4.1957, 5.1325, 128.91, 120.15, 30, 25 },
+		{ 3.0433, 3.6472, 4.4928, 132.36, 123.28, 30, 25 },
+		{ 2.5515, 3.1228, 3.9224, 135.99, 126.60, 30, 25 },
+		// CONF 2, 45000 kg, Mach 0.20 to 0.85
+		{ 9.8087, 11.0245, 12.7265, 116.96, 108.60, 30, 25 },
+		{ 9.0516, 10.2200, 11.9545, 118.80, 110.30, 30, 25 },
+		{ 8.3263, 9.4196, 11.0991, 120.72, 112.09, 30, 25 },
+		{ 7.6309, 8.6667, 10.1458, 122.74, 113.96, 30, 25 },
+		{ 7.1430, 8.1356, 9.5253, 124.11, 115.24, 30, 25 },
+		{ 6.8794, 7.8442, 9.1950, 124.64, 115.72, 30, 25 },
+		{ 6.8107, 7.7611, 9.0917, 124.35, 115.46, 30, 25 },
+		{ 5.7786, 6.6352, 8.0150, 127.64, 118.51, 30, 25 },
+		{ 4.8456, 5.6174, 6.6979, 131.21, 121.82, 30, 25 },
+		{ 4.1028, 4.8045, 5.7869, 134.41, 124.80, 30, 25 },
+		{ 4.0896, 4.7717, 5.7266, 133.31, 123.78, 30, 25 },
+		{ 3.5545, 4.1957, 5.1325, 136.62, 126.93, 30, 25 },
+		{ 3.0433, 3.6472, 4.4928, 140.23, 130.47, 30, 25 },
+		{ 2.5515, 3.1228, 3.9224, 144.20, 134.00, 30, 25 },
+		// CONF 2, 50000 kg, Mach 0.20 to 0.85
+		{ 9.8087, 11.0245, 12.7265, 123.29, 114.47, 30, 25 },
+		{ 9.0516, 10.2200, 11.9545, 125.22, 116.27, 30, 25 },
+		{ 8.3263, 9.4196, 11.0991, 127.25, 118.15, 30, 25 },
+		{ 7.6309, 8.6667, 10.1458, 129.38, 120.13, 30, 25 },
+		{ 7.1430, 8.1356, 9.5253, 130.83, 121.47, 30, 25 },
+		{ 6.8794, 7.8442, 9.1950, 131.38, 121.98, 30, 25 },
+		{ 6.8107, 7.7611, 9.0917, 131.08, 121.71, 30, 25 },
+		{ 5.7786, 6.6352, 8.0150, 134.55, 124.92, 30, 25 },
+		{ 4.8456, 5.6174, 6.6979, 138.30, 128.41, 30, 25 },
+		{ 4.1028, 4.8045, 5.7869, 141.68, 131.55, 30, 25 },
+		{ 4.0896, 4.7717, 5.7266, 140.52, 130.47, 30, 25 },
+		{ 3.5545, 4.1957, 5.1325, 144.01, 133.71, 30, 25 },
+		{ 3.0433, 3.6472, 4.4928, 147.81, 137.24, 30, 25 },
+		{ 2.5515, 3.1228, 3.9224, 152.00, 141.12, 30, 25 },
+		// CONF 2, 55000 kg, Mach 0.20 to 0.85
+		{ 9.8087, 11.0245, 12.7265, 129.31, 120.06, 30, 25 },
+		{ 9.0516, 10.2200, 11.9545, 131.34, 121.94, 30, 25 },
+		{ 8.3263, 9.4196, 11.0991, 133.46, 123.92, 30, 25 },
+		{ 7.6309, 8.6667, 10.1458, 135.70, 125.99, 30, 25 },
+		{ 7.1430, 8.1356, 9.5253, 137.21, 127.40, 30, 25 },
+		{ 6.8794, 7.8442, 9.1950, 137.79, 127.94, 30, 25 },
+		{ 6.8107, 7.7611, 9.0917, 137.48, 127.65, 30, 25 },
+		{ 5.7786, 6.6352, 8.0150, 141.11, 131.02, 30, 25 },
+		{ 4.8456, 5.6174, 6.6979, 145.05, 134.68, 30, 25 },
+		{ 4.1028, 4.8045, 5.7869, 148.60, 137.97, 30, 25 },
+		{ 4.0896, 4.7717, 5.7266, 147.38, 136.84, 30, 25 },
+		{ 3.5545, 4.1957, 5.1325, 151.04, 140.24, 30, 25 },
+		{ 3.0433, 3.6472, 4.4928, 155.03, 143.94, 30, 25 },
+		{ 2.5515, 3.1228, 3.9224, 159.41, 148.01, 30, 25 },
+		// CONF 2, 60000 kg, Mach 0.20 to 0.85
+		{ 9.8087, 11.0245, 12.7265, 134.99, 125.40, 30, 25 },
+		{ 9.0516, 10.2200, 11.9545, 137.18, 127.37, 30, 25 },
+		{ 8.3263, 9.4196, 11.0991, 139.40, 129.43, 30, 25 },
+		{ 7.6309, 8.6667, 10.1458, 141.73, 131.59, 30, 25 },
+		{ 7.1430, 8.1356, 9.5253, 143.31, 133.06, 30, 25 },
+		{ 6.8794, 7.8442, 9.1950, 143.92, 133.62, 30, 25 },
+		{ 6.8107, 7.7611, 9.0917, 143.59, 133.32, 30, 25 },
+		{ 5.7786, 6.6352, 8.0150, 147.39, 136.85, 30, 25 },
+		{ 4.8456, 5.6174, 6.6979, 151.50, 140.67, 30, 25 },
+		{ 4.1028, 4.8045, 5.7869, 155.20, 144.10, 30, 25 },
+		{ 4.0896, 4.7717, 5.7266, 153.93, 142.92, 30, 25 },
+		{ 3.5545, 4.1957, 5.1325, 157.76, 146.47, 30, 25 },
+		{ 3.0433, 3.6472, 4.4928, 161.92, 150.34, 30, 25 },
+		{ 2.5515, 3.1228, 3.9224, 166.50, 154.59, 30, 25 },
+		// CONF 2, 65000 kg, Mach 0.20 to 0.85
+		{ 9.8087, 11.0245, 12.7265, 140.37, 130.52, 30, 25 },
+		{ 9.0516, 10.2200, 11.9545, 142.78, 132.57, 30, 25 },
+		{ 8.3263, 9.4196, 11.0991, 145.09, 134.71, 30, 25 },
+		{ 7.6309, 8.6667, 10.1458, 147.52, 136.97, 30, 25 },
+		{ 7.1430, 8.1356, 9.5253, 149.16, 138.50, 30, 25 },
+		{ 6.8794, 7.8442, 9.1950, 149.79, 139.08, 30, 25 },
+		{ 6.8107, 7.7611, 9.0917, 149.46, 138.77, 30, 25 },
+		{ 5.7786, 6.6352, 8.0150, 153.41, 142.44, 30, 25 },
+		{ 4.8456, 5.6174, 6.6979, 157.69, 146.41, 30, 25 },
+		{ 4.1028, 4.8045, 5.7869, 161.54, 149.99, 30, 25 },
+		{ 4.0896, 4.7717, 5.7266, 160.22, 148.76, 30, 25 },
+		{ 3.5545, 4.1957, 5.1325, 164.20, 152.45, 30, 25 },
+		{ 3.0433, 3.6472, 4.4928, 168.53, 156.48, 30, 25 },
+		{ 2.5515, 3.1228, 3.9224, 173.30, 160.91, 30, 25 },
+		// CONF 2, 70000 kg, Mach 0.20 to 0.85
+		{ 9.8087, 11.0245, 12.7265, 145.54, 135.43, 30, 25 },
+		{ 9.0516, 10.2200, 11.9545, 148.17, 137.57, 30, 25 },
+		{ 8.3263, 9.4196, 11.0991, 150.57, 139.80, 30, 25 },
+		{ 7.6309, 8.6667, 10.1458, 153.09, 142.14, 30, 25 },
+		{ 7.1430, 8.1356, 9.5253, 154.80, 143.72, 30, 25 },
+		{ 6.8794, 7.8442, 9.1950, 155.45, 144.33, 30, 25 },
+		{ 6.8107, 7.7611, 9.0917, 155.10, 144.00, 30, 25 },
+		{ 5.7786, 6.6352, 8.0150, 159.20, 147.81, 30, 25 },
+		{ 4.8456, 5.6174, 6.6979, 163.64, 151.94, 30, 25 },
+		{ 4.1028, 4.8045, 5.7869, 167.64, 155.65, 30, 25 },
+		{ 4.0896, 4.7717, 5.7266, 166.27, 154.38, 30, 25 },
+		{ 3.5545, 4.1957, 5.1325, 170.40, 158.21, 30, 25 },
+		{ 3.0433, 3.6472, 4.4928, 174.89, 162.39, 30, 25 },
+		{ 2.5515, 3.1228, 3.9224, 179.84, 166.98, 30, 25 },
+		// CONF 2, 75000 kg, Mach 0.20 to 0.85
+		{ 9.8087, 11.0245, 12.7265, 150.51, 140.16, 30, 25 },
+		{ 9.0516, 10.2200, 11.9545, 153.37, 142.40, 30, 25 },
+		{ 8.3263, 9.4196, 11.0991, 155.85, 144.70, 30, 25 },
+		{ 7.6309, 8.6667, 10.1458, 158.46, 147.13, 30, 25 },
+		{ 7.1430, 8.1356, 9.5253, 160.23, 148.77, 30, 25 },
+		{ 6.8794, 7.8442, 9.1950, 160.91, 149.40, 30, 25 },
+		{ 6.8107, 7.7611, 9.0917, 160.54, 149.06, 30, 25 },
+		{ 5.7786, 6.6352, 8.0150, 164.79, 153.00, 30, 25 },
+		{ 4.8456, 5.6174, 6.6979, 169.39, 157.27, 30, 25 },
+		{ 4.1028, 4.8045, 5.7869, 173.52, 161.11, 30, 25 },
+		{ 4.0896, 4.7717, 5.7266, 172.10, 159.79, 30, 25 },
+		{ 3.5545, 4.1957, 5.1325, 176.38, 163.76, 30, 25 },
+		{ 3.0433, 3.6472, 4.4928, 181.03, 168.09, 30, 25 },
+		{ 2.5515, 3.1228, 3.9224, 186.16, 172.84, 30, 25 },
+		// CONF 2, 80000 kg, Mach 0.20 to 0.85
+		{ 9.8087, 11.0245, 12.7265, 155.32, 144.74, 30, 25 },
+		{ 9.0516, 10.2200, 11.9545, 158.40, 147.07, 30, 25 },
+		{ 8.3263, 9.4196, 11.0991, 160.96, 149.45, 30, 25 },
+		{ 7.6309, 8.6667, 10.1458, 163.66, 151.95, 30, 25 },
+		{ 7.1430, 8.1356, 9.5253, 165.48, 153.65, 30, 25 },
+		{ 6.8794, 7.8442, 9.1950, 166.18, 154.30, 30, 25 },
+		{ 6.8107, 7.7611, 9.0917, 165.81, 153.95, 30, 25 },
+		{ 5.7786, 6.6352, 8.0150, 170.19, 158.02, 30, 25 },
+		{ 4.8456, 5.6174, 6.6979, 174.94, 162.43, 30, 25 },
+		{ 4.1028, 4.8045, 5.7869, 179.21, 166.40, 30, 25 },
+		{ 4.0896, 4.7717, 5.7266, 177.75, 165.04, 30, 25 },
+		{ 3.5545, 4.1957, 5.1325, 182.16, 169.13, 30, 25 },
+		{ 3.0433, 3.6472, 4.4928, 186.97, 173.60, 30, 25 },
+		{ 2.5515, 3.1228, 3.9224, 192.26, 178.51, 30, 25 },
+		// CONF 3, 40000 kg, Mach 0.20 to 0.85
+		{ 10.5975, 11.9782, 13.9106, 103.48, 96.08, 30, 25 },
+		{ 9.8289, 11.1440, 13.1059, 104.89, 97.39, 30, 25 },
+		{ 9.0926, 10.3447, 12.0978, 106.36, 98.75, 30, 25 },
+		{ 8.3867, 9.5783, 11.2469, 107.89, 100.17, 30, 25 },
+		{ 7.7093, 8.8429, 10.4302, 109.49, 101.66, 30, 25 },
+		{ 7.2465, 8.3371, 9.8639, 110.53, 102.62, 30, 25 },
+		{ 7.1406, 8.2123, 9.7126, 110.41, 102.51, 30, 25 },
+		{ 6.0966, 7.0687, 8.7548, 112.97, 104.89, 30, 25 },
+		{ 5.1529, 6.0349, 7.2697, 115.71, 107.44, 30, 25 },
+		{ 4.2956, 5.0959, 6.2161, 118.67, 110.66, 30, 25 },
+		{ 3.9693, 4.7252, 5.7835, 119.75, 112.21, 30, 25 },
+		{ 3.5496, 4.2713, 5.3262, 121.80, 113.94, 30, 25 },
+		{ 3.1891, 3.8831, 4.8546, 123.71, 115.83, 30, 25 },
+		{ 2.6304, 3.2871, 4.2064, 127.04, 118.65, 30, 25 },
+		// CONF 3, 45000 kg, Mach 0.20 to 0.85
+		{ 10.5975, 11.9782, 13.9106, 109.76, 101.91, 30, 25 },
+		{ 9.8289, 11.1440, 13.1059, 111.25, 103.29, 30, 25 },
+		{ 9.0926, 10.3447, 12.0978, 112.81, 104.74, 30, 25 },
+		{ 8.3867, 9.5783, 11.2469, 114.44, 106.25, 30, 25 },
+		{ 7.7093, 8.8429, 10.4302, 116.14, 107.83, 30, 25 },
+		{ 7.2465, 8.3371, 9.8639, 117.23, 108.85, 30, 25 },
+		{ 7.1406, 8.2123, 9.7126, 117.11, 108.73, 30, 25 },
+		{ 6.0966, 7.0687, 8.7548, 119.82, 111.25, 30, 25 },
+		{ 5.1529, 6.0349, 7.2697, 122.73, 113.95, 30, 25 },
+		{ 4.2956, 5.0959, 6.2161, 125.87, 116.86, 30, 25 },
+		{ 3.9693, 4.7252, 5.7835, 126.63, 118.22, 30, 25 },
+		{ 3.5496, 4.2713, 5.3262, 128.87, 120.07, 30, 25 },
+		{ 3.1891, 3.8831, 4.8546, 131.00, 122.09, 30, 25 },
+		{ 2.6304, 3.2871, 4.2064, 134.55, 125.26, 30, 25 },
+		// CONF 3, 50000 kg, Mach 0.20 to 0.85
+		{ 10.5975, 11.9782, 13.9106, 115.69, 107.42, 30, 25 },
+		{ 9.8289, 11.1440, 13.1059, 117.27, 108.88, 30, 25 },
+		{ 9.0926, 10.3447, 12.0978, 118.91, 110.41, 30, 25 },
+		{ 8.3867, 9.5783, 11.2469, 120.63, 112.00, 30, 25 },
+		{ 7.7093, 8.8429, 10.4302, 122.42, 113.66, 30, 25 },
+		{ 7.2465, 8.3371, 9.8639, 123.57, 114.74, 30, 25 },
+		{ 7.1406, 8.2123, 9.7126, 123.44, 114.61, 30, 25 },
+		{ 6.0966, 7.0687, 8.7548, 126.30, 117.27, 30, 25 },
+		{ 5.1529, 6.0349, 7.2697, 129.37, 120.12, 30, 25 },
+		{ 4.2956, 5.0959, 6.2161, 132.68, 123.19, 30, 25 },
+		{ 3.9693, 4.7252, 5.7835, 133.48, 123.93, 30, 25 },
+		{ 3.5496, 4.2713, 5.3262, 135.74, 126.11, 30, 25 },
+		{ 3.1891, 3.8831, 4.8546, 137.90, 128.36, 30, 25 },
+		{ 2.6304, 3.2871, 4.2064, 141.76, 131.81, 30, 25 },
+		// CONF 3, 55000 kg, Mach 0.20 to 0.85
+		{ 10.5975, 11.9782, 13.9106, 121.34, 112.66, 30, 25 },
+		{ 9.8289, 11.1440, 13.1059, 122.99, 114.20, 30, 25 },
+		{ 9.0926, 10.3447, 12.0978, 124.72, 115.80, 30, 25 },
+		{ 8.3867, 9.5783, 11.2469, 126.51, 117.47, 30, 25 },
+		{ 7.7093, 8.8429, 10.4302, 128.39, 119.21, 30, 25 },
+		{ 7.2465, 8.3371, 9.8639, 129.61, 120.34, 30, 25 },
+		{ 7.1406, 8.2123, 9.7126, 129.47, 120.21, 30, 25 },
+		{ 6.0966, 7.0687, 8.7548, 132.47, 122.99, 30, 25 },
+		{ 5.1529, 6.0349, 7.2697, 135.69, 125.98, 30, 25 },
+		{ 4.2956, 5.0959, 6.2161, 139.15, 129.20, 30, 25 },
+		{ 3.9693, 4.7252, 5.7835, 140.00, 129.98, 30, 25 },
+		{ 3.5496, 4.2713, 5.3262, 142.37, 132.18, 30, 25 },
+		{ 3.1891, 3.8831, 4.8546, 144.63, 134.40, 30, 25 },
+		{ 2.6304, 3.2871, 4.2064, 148.68, 138.04, 30, 25 },
+		// CONF 3, 60000 kg, Mach 0.20 to 0.85
+		{ 10.5975, 11.9782, 13.9106, 126.73, 117.67, 30, 25 },
+		{ 9.8289, 11.1440, 13.1059, 128.46, 119.27, 30, 25 },
+		{ 9.0926, 10.3447, 12.0978, 130.26, 120.95, 30, 25 },
+		{ 8.3867, 9.5783, 11.2469, 132.14, 122.69, 30, 25 },
+		{ 7.7093, 8.8429, 10.4302, 134.10, 124.51, 30, 25 },
+		{ 7.2465, 8.3371, 9.8639, 135.37, 125.69, 30, 25 },
+		{ 7.1406, 8.2123, 9.7126, 135.22, 125.55, 30, 25 },
+		{ 6.0966, 7.0687, 8.7548, 138.36, 128.46, 30, 25 },
+		{ 5.1529, 6.0349, 7.2697, 141.72, 131.58, 30, 25 },
+		{ 4.2956, 5.0959, 6.2161, 145.34, 134.94, 30, 25 },
+		{ 3.9693, 4.7252, 5.7835, 146.22, 135.76, 30, 25 },
+		{ 3.5496, 4.2713, 5.3262, 148.70, 138.06, 30, 25 },
+		{ 3.1891, 3.8831, 4.8546, 151.06, 140.26, 30, 25 },
+		{ 2.6304, 3.2871, 4.2064, 155.29, 144.18, 30, 25 },
+		// CONF 3, 65000 kg, Mach 0.20 to 0.85
+		{ 10.5975, 11.9782, 13.9106, 131.91, 122.48, 30, 25 },
+		{ 9.8289, 11.1440, 13.1059, 133.71, 124.14, 30, 25 },
+		{ 9.0926, 10.3447, 12.0978, 135.58, 125.88, 30, 25 },
+		{ 8.3867, 9.5783, 11.2469, 137.54, 127.70, 30, 25 },
+		{ 7.7093, 8.8429, 10.4302, 139.58, 129.59, 30, 25 },
+		{ 7.2465, 8.3371, 9.8639, 140.90, 130.82, 30, 25 },
+		{ 7.1406, 8.2123, 9.7126, 140.75, 130.68, 30, 25 },
+		{ 6.0966, 7.0687, 8.7548, 144.01, 133.71, 30, 25 },
+		{ 5.1529, 6.0349, 7.2697, 147.51, 136.96, 30, 25 },
+		{ 4.2956, 5.0959, 6.2161, 151.27, 140.45, 30, 25 },
+		{ 3.9693, 4.7252, 5.7835, 152.19, 141.31, 30, 25 },
+		{ 3.5496, 4.2713, 5.3262, 154.77, 143.70, 30, 25 },
+		{ 3.1891, 3.8831, 4.8546, 157.23, 145.98, 30, 25 },
+		{ 2.6304, 3.2871, 4.2064, 161.63, 150.07, 30, 25 },
+		// CONF 3, 70000 kg, Mach 0.20 to 0.85
+		{ 10.5975, 11.9782, 13.9106, 136.79, 127.10, 30, 25 },
+		{ 9.8289, 11.1440, 13.1059, 138.75, 128.83, 30, 25 },
+		{ 9.0926, 10.3447, 12.0978, 140.70, 130.64, 30, 25 },
+		{ 8.3867, 9.5783, 11.2469, 142.73, 132.52, 30, 25 },
+		{ 7.7093, 8.8429, 10.4302, 144.85, 134.49, 30, 25 },
+		{ 7.2465, 8.3371, 9.8639, 146.21, 135.76, 30, 25 },
+		{ 7.1406, 8.2123, 9.7126, 146.06, 135.61, 30, 25 },
+		{ 6.0966, 7.0687, 8.7548, 149.44, 138.75, 30, 25 },
+		{ 5.1529, 6.0349, 7.2697, 153.07, 142.13, 30, 25 },
+		{ 4.2956, 5.0959, 6.2161, 156.98, 145.76, 30, 25 },
+		{ 3.9693, 4.7252, 5.7835, 157.94, 146.64, 30, 25 },
+		{ 3.5496, 4.2713, 5.3262, 160.61, 149.12, 30, 25 },
+		{ 3.1891, 3.8831, 4.8546, 163.17, 151.50, 30, 25 },
+		{ 2.6304, 3.2871, 4.2064, 167.73, 155.73, 30, 25 },
+		// CONF 3, 75000 kg, Mach 0.20 to 0.85
+		{ 10.5975, 11.9782, 13.9106, 141.47, 131.56, 30, 25 },
+		{ 9.8289, 11.1440, 13.1059, 143.63, 133.35, 30, 25 },
+		{ 9.0926, 10.3447, 12.0978, 145.64, 135.22, 30, 25 },
+		{ 8.3867, 9.5783, 11.2469, 147.74, 137.17, 30, 25 },
+		{ 7.7093, 8.8429, 10.4302, 149.93, 139.21, 30, 25 },
+		{ 7.2465, 8.3371, 9.8639, 151.35, 140.52, 30, 25 },
+		{ 7.1406, 8.2123, 9.7126, 151.19, 140.37, 30, 25 },
+		{ 6.0966, 7.0687, 8.7548, 154.69, 143.62, 30, 25 },
+		{ 5.1529, 6.0349, 7.2697, 158.45, 147.11, 30, 25 },
+		{ 4.2956, 5.0959, 6.2161, 162.49, 150.87, 30, 25 },
+		{ 3.9693, 4.7252, 5.7835, 163.48, 151.79, 30, 25 },
+		{ 3.5496, 4.2713, 5.3262, 166.25, 154.36, 30, 25 },
+		{ 3.1891, 3.8831, 4.8546, 168.89, 156.81, 30, 25 },
+		{ 2.6304, 3.2871, 4.2064, 173.62, 161.20, 30, 25 },
+		// CONF 3, 80000 kg, Mach 0.20 to 0.85
+		{ 10.5975, 11.9782, 13.9106, 146.00, 135.87, 30, 25 },
+		{ 9.8289, 11.1440, 13.1059, 148.34, 137.73, 30, 25 },
+		{ 9.0926, 10.3447, 12.0978, 150.41, 139.66, 30, 25 },
+		{ 8.3867, 9.5783, 11.2469, 152.58, 141.67, 30, 25 },
+		{ 7.7093, 8.8429, 10.4302, 154.85, 143.77, 30, 25 },
+		{ 7.2465, 8.3371, 9.8639, 156.31, 145.13, 30, 25 },
+		{ 7.1406, 8.2123, 9.7126, 156.14, 144.98, 30, 25 },
+		{ 6.0966, 7.0687, 8.7548, 159.76, 148.33, 30, 25 },
+		{ 5.1529, 6.0349, 7.2697, 163.64, 151.94, 30, 25 },
+		{ 4.2956, 5.0959, 6.2161, 167.82, 155.82, 30, 25 },
+		{ 3.9693, 4.7252, 5.7835, 168.84, 156.77, 30, 25 },
+		{ 3.5496, 4.2713, 5.3262, 171.70, 159.42, 30, 25 },
+		{ 3.1891, 3.8831, 4.8546, 174.43, 161.96, 30, 25 },
+		{ 2.6304, 3.2871, 4.2064, 179.31, 166.49, 30, 25 },
+		// CONF FULL, 40000 kg, Mach 0.20 to 0.85
+		{ 11.0098, 12.5678, 14.7481, 97.41, 90.45, 25, 20 },
+		{ 10.0855, 11.5643, 13.8173, 98.91, 91.84, 25, 20 },
+		{ 9.2000, 10.6028, 12.5918, 100.48, 93.30, 25, 20 },
+		{ 8.3510, 9.6808, 11.5428, 102.13, 94.83, 25, 20 },
+		{ 7.6204, 8.8859, 10.6577, 103.63, 96.22, 25, 20 },
+		{ 7.2643, 8.4910, 10.2085, 104.21, 96.76, 25, 20 },
+		{ 7.1058, 8.3076, 9.9900, 104.26, 96.81, 25, 20 },
+		{ 5.8844, 6.9680, 8.7733, 107.00, 99.34, 25, 20 },
+		{ 4.8213, 5.8008, 7.1722, 109.80, 102.33, 25, 20 },
+		{ 4.0350, 4.9321, 6.1879, 112.27, 105.08, 25, 20 },
+		{ 3.7735, 4.6256, 5.8185, 113.28, 106.19, 25, 20 },
+		{ 3.2090, 4.0158, 5.1619, 115.60, 108.28, 25, 20 },
+		{ 2.8622, 3.6414, 4.7321, 117.12, 109.73, 25, 20 },
+		{ 2.2364, 2.9738, 4.0062, 120.08, 112.38, 25, 20 },
+		// CONF FULL, 45000 kg, Mach 0.20 to 0.85
+		{ 11.0098, 12.5678, 14.7481, 103.32, 95.93, 25, 20 },
+		{ 10.0855, 11.5643, 13.8173, 104.91, 97.41, 25, 20 },
+		{ 9.2000, 10.6028, 12.5918, 106.58, 98.96, 25, 20 },
+		{ 8.3510, 9.6808, 11.5428, 108.33, 100.58, 25, 20 },
+		{ 7.6204, 8.8859, 10.6577, 109.92, 102.06, 25, 20 },
+		{ 7.2643, 8.4910, 10.2085, 110.53, 102.63, 25, 20 },
+		{ 7.1058, 8.3076, 9.9900, 110.59, 102.68, 25, 20 },
+		{ 5.8844, 6.9680, 8.7733, 113.49, 105.37, 25, 20 },
+		{ 4.8213, 5.8008, 7.1722, 116.46, 108.13, 25, 20 },
+		{ 4.0350, 4.9321, 6.1879, 118.88, 110.79, 25, 20 },
+		{ 3.7735, 4.6256, 5.8185, 119.59, 111.98, 25, 20 },
+		{ 3.2090, 4.0158, 5.1619, 122.09, 114.21, 25, 20 },
+		{ 2.8622, 3.6414, 4.7321, 123.76, 115.78, 25, 20 },
+		{ 2.2364, 2.9738, 4.0062, 127.09, 118.62, 25, 20 },
+		// CONF FULL, 50000 kg, Mach 0.20 to 0.85
+		{ 11.0098, 12.5678, 14.7481, 108.91, 101.12, 25, 20 },
+		{ 10.0855, 11.5643, 13.8173, 110.59, 102.68, 25, 20 },
+		{ 9.2000, 10.6028, 12.5918, 112.34, 104.31, 25, 20 },
+		{ 8.3510, 9.6808, 11.5428, 114.19, 106.02, 25, 20 },
+		{ 7.6204, 8.8859, 10.6577, 115.87, 107.58, 25, 20 },
+		{ 7.2643, 8.4910, 10.2085, 116.51, 108.18, 25, 20 },
+		{ 7.1058, 8.3076, 9.9900, 116.57, 108.23, 25, 20 },
+		{ 5.8844, 6.9680, 8.7733, 119.62, 111.07, 25, 20 },
+		{ 4.8213, 5.8008, 7.1722, 122.76, 113.98, 25, 20 },
+		{ 4.0350, 4.9321, 6.1879, 125.31, 116.35, 25, 20 },
+		{ 3.7735, 4.6256, 5.8185, 125.73, 117.40, 25, 20 },
+		{ 3.2090, 4.0158, 5.1619, 128.47, 119.78, 25, 20 },
+		{ 2.8622, 3.6414, 4.7321, 130.30, 121.44, 25, 20 },
+		{ 2.2364, 2.9738, 4.0062, 133.84, 124.56, 25, 20 },
+		// CONF FULL, 55000 kg, Mach 0.20 to 0.85
+		{ 11.0098, 12.5678, 14.7481, 114.23, 106.06, 25, 20 },
+		{ 10.0855, 11.5643, 13.8173, 115.99, 107.69, 25, 20 },
+		{ 9.2000, 10.6028, 12.5918, 117.83, 109.40, 25, 20 },
+		{ 8.3510, 9.6808, 11.5428, 119.76, 111.20, 25, 20 },
+		{ 7.6204, 8.8859, 10.6577, 121.52, 112.83, 25, 20 },
+		{ 7.2643, 8.4910, 10.2085, 122.20, 113.46, 25, 20 },
+		{ 7.1058, 8.3076, 9.9900, 122.26, 113.52, 25, 20 },
+		{ 5.8844, 6.9680, 8.7733, 125.46, 116.49, 25, 20 },
+		{ 4.8213, 5.8008, 7.1722, 128.75, 119.54, 25, 20 },
+		{ 4.0350, 4.9321, 6.1879, 131.43, 122.03, 25, 20 },
+		{ 3.7735, 4.6256, 5.8185, 131.86, 122.51, 25, 20 },
+		{ 3.2090, 4.0158, 5.1619, 134.65, 125.19, 25, 20 },
+		{ 2.8622, 3.6414, 4.7321, 136.51, 127.06, 25, 20 },
+		{ 2.2364, 2.9738, 4.0062, 140.30, 130.47, 25, 20 },
+		// CONF FULL, 60000 kg, Mach 0.20 to 0.85
+		{ 11.0098, 12.5678, 14.7481, 119.31, 110.77, 25, 20 },
+		{ 10.0855, 11.5643, 13.8173, 121.14, 112.48, 25, 20 },
+		{ 9.2000, 10.6028, 12.5918, 123.07, 114.27, 25, 20 },
+		{ 8.3510, 9.6808, 11.5428, 125.09, 116.14, 25, 20 },
+		{ 7.6204, 8.8859, 10.6577, 126.93, 117.85, 25, 20 },
+		{ 7.2643, 8.4910, 10.2085, 127.63, 118.50, 25, 20 },
+		{ 7.1058, 8.3076, 9.9900, 127.70, 118.56, 25, 20 },
+		{ 5.8844, 6.9680, 8.7733, 131.04, 121.67, 25, 20 },
+		{ 4.8213, 5.8008, 7.1722, 134.48, 124.86, 25, 20 },
+		{ 4.0350, 4.9321, 6.1879, 137.27, 127.45, 25, 20 },
+		{ 3.7735, 4.6256, 5.8185, 137.73, 127.87, 25, 20 },
+		{ 3.2090, 4.0158, 5.1619, 140.64, 130.61, 25, 20 },
+		{ 2.8622, 3.6414, 4.7321, 142.57, 132.52, 25, 20 },
+		{ 2.2364, 2.9738, 4.0062, 146.54, 136.10, 25, 20 },
+		// CONF FULL, 65000 kg, Mach 0.20 to 0.85
+		{ 11.0098, 12.5678, 14.7481, 124.18, 115.30, 25, 20 },
+		{ 10.0855, 11.5643, 13.8173, 126.09, 117.07, 25, 20 },
+		{ 9.2000, 10.6028, 12.5918, 128.09, 118.93, 25, 20 },
+		{ 8.3510, 9.6808, 11.5428, 130.19, 120.88, 25, 20 },
+		{ 7.6204, 8.8859, 10.6577, 132.11, 122.66, 25, 20 },
+		{ 7.2643, 8.4910, 10.2085, 132.85, 123.34, 25, 20 },
+		{ 7.1058, 8.3076, 9.9900, 132.91, 123.41, 25, 20 },
+		{ 5.8844, 6.9680, 8.7733, 136.39, 126.64, 25, 20 },
+		{ 4.8213, 5.8008, 7.1722, 139.97, 129.96, 25, 20 },
+		{ 4.0350, 4.9321, 6.1879, 142.88, 132.66, 25, 20 },
+		{ 3.7735, 4.6256, 5.8185, 143.35, 133.10, 25, 20 },
+		{ 3.2090, 4.0158, 5.1619, 146.38, 135.91, 25, 20 },
+		{ 2.8622, 3.6414, 4.7321, 148.39, 137.77, 25, 20 },
+		{ 2.2364, 2.9738, 4.0062, 152.53, 141.62, 25, 20 },
+		// CONF FULL, 70000 kg, Mach 0.20 to 0.85
+		{ 11.0098, 12.5678, 14.7481, 128.87, 119.65, 25, 20 },
+		{ 10.0855, 11.5643, 13.8173, 130.85, 121.49, 25, 20 },
+		{ 9.2000, 10.6028, 12.5918, 132.93, 123.42, 25, 20 },
+		{ 8.3510, 9.6808, 11.5428, 135.11, 125.45, 25, 20 },
+		{ 7.6204, 8.8859, 10.6577, 137.10, 127.29, 25, 20 },
+		{ 7.2643, 8.4910, 10.2085, 137.86, 128.00, 25, 20 },
+		{ 7.1058, 8.3076, 9.9900, 137.93, 128.06, 25, 20 },
+		{ 5.8844, 6.9680, 8.7733, 141.54, 131.42, 25, 20 },
+		{ 4.8213, 5.8008, 7.1722, 145.25, 134.86, 25, 20 },
+		{ 4.0350, 4.9321, 6.1879, 148.27, 137.67, 25, 20 },
+		{ 3.7735, 4.6256, 5.8185, 148.76, 138.12, 25, 20 },
+		{ 3.2090, 4.0158, 5.1619, 151.90, 141.04, 25, 20 },
+		{ 2.8622, 3.6414, 4.7321, 153.99, 142.97, 25, 20 },
+		{ 2.2364, 2.9738, 4.0062, 158.28, 146.96, 25, 20 },
+		// CONF FULL, 75000 kg, Mach 0.20 to 0.85
+		{ 11.0098, 12.5678, 14.7481, 133.37, 123.85, 25, 20 },
+		{ 10.0855, 11.5643, 13.8173, 135.44, 125.75, 25, 20 },
+		{ 9.2000, 10.6028, 12.5918, 137.59, 127.75, 25, 20 },
+		{ 8.3510, 9.6808, 11.5428, 139.85, 129.85, 25, 20 },
+		{ 7.6204, 8.8859, 10.6577, 141.91, 131.76, 25, 20 },
+		{ 7.2643, 8.4910, 10.2085, 142.70, 132.49, 25, 20 },
+		{ 7.1058, 8.3076, 9.9900, 142.77, 132.56, 25, 20 },
+		{ 5.8844, 6.9680, 8.7733, 146.51, 136.03, 25, 20 },
+		{ 4.8213, 5.8008, 7.1722, 150.35, 139.60, 25, 20 },
+		{ 4.0350, 4.9321, 6.1879, 153.47, 142.50, 25, 20 },
+		{ 3.7735, 4.6256, 5.8185, 153.98, 142.97, 25, 20 },
+		{ 3.2090, 4.0158, 5.1619, 157.24, 145.99, 25, 20 },
+		{ 2.8622, 3.6414, 4.7321, 159.39, 147.99, 25, 20 },
+		{ 2.2364, 2.9738, 4.0062, 163.84, 152.12, 25, 20 },
+		// CONF FULL, 80000 kg, Mach 0.20 to 0.85
+		{ 11.0098, 12.5678, 14.7481, 137.65, 127.91, 25, 20 },
+		{ 10.0855, 11.5643, 13.8173, 139.88, 129.88, 25, 20 },
+		{ 9.2000, 10.6028, 12.5918, 142.11, 131.94, 25, 20 },
+		{ 8.3510, 9.6808, 11.5428, 144.44, 134.11, 25, 20 },
+		{ 7.6204, 8.8859, 10.6577, 146.56, 136.08, 25, 20 },
+		{ 7.2643, 8.4910, 10.2085, 147.38, 136.84, 25, 20 },
+		{ 7.1058, 8.3076, 9.9900, 147.45, 136.91, 25, 20 },
+		{ 5.8844, 6.9680, 8.7733, 151.31, 140.49, 25, 20 },
+		{ 4.8213, 5.8008, 7.1722, 155.28, 144.17, 25, 20 },
+		{ 4.0350, 4.9321, 6.1879, 158.51, 147.17, 25, 20 },
+		{ 3.7735, 4.6256, 5.8185, 159.03, 147.66, 25, 20 },
+		{ 3.2090, 4.0158, 5.1619, 162.39, 150.78, 25, 20 },
+		{ 2.8622, 3.6414, 4.7321, 164.62, 152.85, 25, 20 },
+		{ 2.2364, 2.9738, 4.0062, 169.21, 157.11, 25, 20 },
+	};
+}
+
+constexpr EnvelopeTable default_envelope_table = {
+	5, 40000, 5000, 9, 0.2, 0.05, 14, default_envelope::points,
+};
\ No newline at end of file
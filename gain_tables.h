@@ -0,0 +1,22 @@
+#pragma once
+#include "gains.h"
+
+// The gains the gauge flies with. The control laws were tuned at a single flight condition, so for now every axis has a
+// single breakpoint and the gains are the same everywhere; a file of the same layout can be tried on the host with
+// monte_carlo --gains (see host/gain_file.h).
+namespace default_gains
+{
+	constexpr double ias[] = { 250 };
+	constexpr double mach[] = { 0.45 };
+	constexpr double altitude[] = { 10000 };
+	constexpr double flaps[] = { 0 };
+	constexpr PIDGains points[][GAIN_CONTROLLER_COUNT] = {
+		{ { 0.002, 0, 0.0002 }, { 0.008, 0.008, 0.001 }, { 0.0015, 0.0020, 0.002 }, { 0.01, 0.015, 0.0025 }, { 0.10, 0, 0.02 } },
+	};
+}
+
+constexpr GainTable default_gain_table = {
+	{ default_gains::ias, default_gains::mach, default_gains::altitude, default_gains::flaps },
+	{ 1, 1, 1, 1 },
+	default_gains::points[0],
+};
\ No newline at end of file
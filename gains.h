@@ -0,0 +1,127 @@
+#pragma once
+#include <cstdint>
+
+#include "common.h"
+
+// The flight conditions the gains are scheduled by
+enum GAIN_AXIS
+{
+	GAIN_AXIS_IAS, // Knots
+	GAIN_AXIS_MACH,
+	GAIN_AXIS_ALTITUDE, // Feet
+	GAIN_AXIS_FLAPS, // Flaps handle index
+	GAIN_AXIS_COUNT,
+};
+
+// The scheduled PID controllers of the pitch and roll laws
+enum GAIN_CONTROLLER
+{
+	GAIN_AOA, // PitchController's AoA error -> elevator handle movement rate
+	GAIN_GFORCE, // PitchController's GForce error -> elevator handle movement rate
+	GAIN_VERTICAL_FPA, // PitchController's vertical FPA error -> elevator handle movement rate
+	GAIN_PITCH_RATE, // PitchController's pitch rate error -> elevator handle movement rate
+	GAIN_ROLL, // RollController's bank error -> ailerons
+	GAIN_CONTROLLER_COUNT,
+};
+
+struct PIDGains
+{
+	double kp;
+	double ki;
+	double kd;
+};
+static_assert(sizeof(PIDGains) == 3 * sizeof(double), "GainScheduler sums the gains of a point as an array of doubles");
+
+// Gains at every point of a grid of flight conditions. The table only refers to its arrays, which are constexpr in the
+// gauge (see gain_tables.h) and loaded from a file on the host (see host/gain_file.h).
+struct GainTable
+{
+	const double* breakpoints[GAIN_AXIS_COUNT]; // Ascending; an axis with a single breakpoint does not vary the gains
+	int sizes[GAIN_AXIS_COUNT];
+	// GAIN_CONTROLLER_COUNT gains per grid point, the points ordered with the last axis varying fastest
+	const PIDGains* points;
+};
+
+// Interpolates the gains of a GainTable multilinearly at the current flight conditions.
+// The cell of each axis is kept from one update to the next and walked from there, as the flight conditions hardly
+// move between control steps; the interpolation itself runs over every corner of the cell without branching.
+class GainScheduler
+{
+private:
+	const GainTable* table;
+	int strides[GAIN_AXIS_COUNT]; // Between neighbouring points along each axis
+	int cells[GAIN_AXIS_COUNT] = {}; // Lower breakpoint of the cell of the last update
+	uint64_t cell_moves = 0; // Breakpoints walked over since the table was set
+	PIDGains gains[GAIN_CONTROLLER_COUNT];
+public:
+	GainScheduler(const GainTable& table) { SetTable(table); }
+
+	// The gains at the lowest point of the table until the first update
+	void SetTable(const GainTable& value)
+	{
+		table = &value;
+		auto stride = 1;
+		for (auto axis = GAIN_AXIS_COUNT - 1; axis >= 0; axis--)
+		{
+			strides[axis] = stride;
+			stride *= table->sizes[axis];
+			cells[axis] = 0;
+		}
+		cell_moves = 0;
+		for (auto controller = 0; controller < GAIN_CONTROLLER_COUNT; controller++) gains[controller] = table->points[controller];
+	}
+	const GainTable& Table() const { return *table; }
+
+	void Update(const double ias, const double mach, const double altitude, const int flaps)
+	{
+		const double conditions[GAIN_AXIS_COUNT] = { ias, mach, altitude, static_cast<double>(flaps) };
+
+		// The weight and the offset of the lower (0) and upper (1) side of the cell along each axis
+		double weights[GAIN_AXIS_COUNT][2];
+		int offsets[GAIN_AXIS_COUNT][2];
+		for (auto axis = 0; axis < GAIN_AXIS_COUNT; axis++)
+		{
+			const auto* breakpoints = table->breakpoints[axis];
+			const auto last_cell = table->sizes[axis] > 1 ? table->sizes[axis] - 2 : 0;
+			const auto x = conditions[axis];
+			auto cell = cells[axis];
+			while (cell > 0 && x < breakpoints[cell]) cell--;
+			while (cell < last_cell && x >= breakpoints[cell + 1]) cell++;
+			cell_moves += cell > cells[axis] ? cell - cells[axis] : cells[axis] - cell;
+			cells[axis] = cell;
+
+			// Beyond the table the gains at its edge hold
+			const auto upper = table->sizes[axis] > 1 ? cell + 1 : cell;
+			const auto span = breakpoints[upper] - breakpoints[cell];
+			const auto fraction = span > 0 ? clamp((x - breakpoints[cell]) / span, 0, 1) : 0;
+			weights[axis][0] = 1 - fraction;
+			weights[axis][1] = fraction;
+			offsets[axis][0] = cell * strides[axis];
+			offsets[axis][1] = upper * strides[axis];
+		}
+
+		// The gains of a point are contiguous doubles, summed as one vector
+		constexpr auto values = 3 * GAIN_CONTROLLER_COUNT;
+		double sum[values] = {};
+		for (auto corner = 0; corner < 1 << GAIN_AXIS_COUNT; corner++)
+		{
+			auto weight = 1.0;
+			auto point = 0;
+			for (auto axis = 0; axis < GAIN_AXIS_COUNT; axis++)
+			{
+				const auto side = (corner >> axis) & 1;
+				weight *= weights[axis][side];
+				point += offsets[axis][side];
+			}
+			const auto* corner_values = &table->points[point * GAIN_CONTROLLER_COUNT].kp;
+			for (auto i = 0; i < values; i++) sum[i] += weight * corner_values[i];
+		}
+		for (auto controller = 0; controller < GAIN_CONTROLLER_COUNT; controller++)
+		{
+			gains[controller] = { sum[3 * controller], sum[3 * controller + 1], sum[3 * controller + 2] };
+		}
+	}
+
+	const PIDGains& Gains(const GAIN_CONTROLLER controller) const { return gains[controller]; }
+	uint64_t CellMoves() const { return cell_moves; }
+};
\ No newline at end of file
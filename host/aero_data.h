@@ -0,0 +1,157 @@
+#pragma once
+// Aerodynamic data of the host plant model (see plant_model.h)
+// Approximate A320 figures, fitted to published performance rather than taken from manufacturer data. The coefficients
+// are in stability axes, for the whole aircraft with neutral controls, around the reference center of gravity.
+
+namespace aero
+{
+	constexpr int alpha_count = 15;
+	constexpr int mach_count = 5;
+	constexpr int flap_count = 5; // Indexed by the flaps handle index, as AircraftData::Flaps()
+
+	constexpr double alpha_breakpoints[alpha_count] = { -10, -7.5, -5, -2.5, 0, 2.5, 5, 7.5, 10, 12.5, 15, 17.5, 20, 22.5, 25 }; // Degrees
+	constexpr double mach_breakpoints[mach_count] = { 0.2, 0.5, 0.7, 0.78, 0.85 };
+
+	// Lift coefficient [flaps][mach][alpha]
+	constexpr double lift[flap_count][mach_count][alpha_count] = {
+		{ // CONF 0 (clean)
+			{ -0.6401, -0.4176, -0.1951, 0.0275, 0.2500, 0.4725, 0.6951, 0.9176, 1.1401, 1.3626, 1.4716, 1.3974, 1.3233, 1.2491, 1.1749 },
+			{ -0.7571, -0.5053, -0.2535, -0.0018, 0.2500, 0.5018, 0.7535, 1.0053, 1.2571, 1.2644, 1.1902, 1.1160, 1.0418, 0.9677, 0.8935 },
+			{ -0.9712, -0.6659, -0.3606, -0.0553, 0.2500, 0.5553, 0.8606, 1.1337, 1.0595, 0.9853, 0.9112, 0.8370, 0.7628, 0.6886, 0.6145 },
+			{ -0.9962, -0.6846, -0.3731, -0.0615, 0.2500, 0.5615, 0.8731, 1.0402, 0.9661, 0.8919, 0.8177, 0.7435, 0.6693, 0.5952, 0.5210 },
+			{ -0.9962, -0.6846, -0.3731, -0.0615, 0.2500, 0.5615, 0.8731, 0.9622, 0.8881, 0.8139, 0.7397, 0.6655, 0.5913, 0.5172, 0.4430 }
+		},
+		{ // CONF 1
+			{ -0.3401, -0.1176, 0.1049, 0.3275, 0.5500, 0.7725, 0.9951, 1.2176, 1.4401, 1.6626, 1.8852, 1.8308, 1.7566, 1.6824, 1.6082 },
+			{ -0.4571, -0.2053, 0.0465, 0.2982, 0.5500, 0.8018, 1.0535, 1.3053, 1.5571, 1.6317, 1.5575, 1.4833, 1.4092, 1.3350, 1.2608 },
+			{ -0.6712, -0.3659, -0.0606, 0.2447, 0.5500, 0.8553, 1.1606, 1.4387, 1.3645, 1.2903, 1.2161, 1.1420, 1.0678, 0.9936, 0.9194 },
+			{ -0.6962, -0.3846, -0.0731, 0.2385, 0.5500, 0.8615, 1.1731, 1.3214, 1.2472, 1.1731, 1.0989, 1.0247, 0.9505, 0.8764, 0.8022 },
+			{ -0.6962, -0.3846, -0.0731, 0.2385, 0.5500, 0.8615, 1.1731, 1.2226, 1.1484, 1.0743, 1.0001, 0.9259, 0.8517, 0.7776, 0.7034 }
+		},
+		{ // CONF 2
+			{ -0.1401, 0.0824, 0.3049, 0.5275, 0.7500, 0.9725, 1.1951, 1.4176, 1.6401, 1.8626, 2.0852, 2.1641, 2.0899, 2.0157, 1.9416 },
+			{ -0.2571, -0.0053, 0.2465, 0.4982, 0.7500, 1.0018, 1.2535, 1.5053, 1.7571, 1.9145, 1.8404, 1.7662, 1.6920, 1.6178, 1.5437 },
+			{ -0.4712, -0.1659, 0.1394, 0.4447, 0.7500, 1.0553, 1.3606, 1.6659, 1.5993, 1.5251, 1.4509, 1.3768, 1.3026, 1.2284, 1.1542 },
+			{ -0.4962, -0.1846, 0.1269, 0.4385, 0.7500, 1.0615, 1.3731, 1.5383, 1.4641, 1.3899, 1.3157, 1.2415, 1.1674, 1.0932, 1.0190 },
+			{ -0.4962, -0.1846, 0.1269, 0.4385, 0.7500, 1.0615, 1.3731, 1.4239, 1.3497, 1.2755, 1.2013, 1.1271, 1.0530, 0.9788, 0.9046 }
+		},
+		{ // CONF 3
+			{ 0.0099, 0.2324, 0.4549, 0.6775, 0.9000, 1.1225, 1.3451, 1.5676, 1.7901, 2.0126, 2.2352, 2.4577, 2.4399, 2.3657, 2.2916 },
+			{ -0.1071, 0.1447, 0.3965, 0.6482, 0.9000, 1.1518, 1.4035, 1.6553, 1.9071, 2.1588, 2.1380, 2.0638, 1.9896, 1.9154, 1.8413 },
+			{ -0.3212, -0.0159, 0.2894, 0.5947, 0.9000, 1.2053, 1.5106, 1.8159, 1.8463, 1.7721, 1.6979, 1.6237, 1.5495, 1.4754, 1.4012 },
+			{ -0.3462, -0.0346, 0.2769, 0.5885, 0.9000, 1.2115, 1.5231, 1.7670, 1.6928, 1.6186, 1.5445, 1.4703, 1.3961, 1.3219, 1.2478 },
+			{ -0.3462, -0.0346, 0.2769, 0.5885, 0.9000, 1.2115, 1.5231, 1.6370, 1.5628, 1.4886, 1.4145, 1.3403, 1.2661, 1.1919, 1.1178 }
+		},
+		{ // CONF FULL
+			{ 0.2099, 0.4324, 0.6549, 0.8775, 1.1000, 1.3225, 1.5451, 1.7676, 1.9901, 2.2126, 2.4352, 2.6577, 2.7733, 2.6991, 2.6249 },
+			{ 0.0929, 0.3447, 0.5965, 0.8482, 1.1000, 1.3518, 1.6035, 1.8553, 2.1071, 2.3588, 2.4208, 2.3466, 2.2725, 2.1983, 2.1241 },
+			{ -0.1212, 0.1841, 0.4894, 0.7947, 1.1000, 1.4053, 1.7106, 2.0159, 2.0811, 2.0069, 1.9327, 1.8585, 1.7843, 1.7102, 1.6360 },
+			{ -0.1462, 0.1654, 0.4769, 0.7885, 1.1000, 1.4115, 1.7231, 1.9838, 1.9097, 1.8355, 1.7613, 1.6871, 1.6129, 1.5388, 1.4646 },
+			{ -0.1462, 0.1654, 0.4769, 0.7885, 1.1000, 1.4115, 1.7231, 1.8382, 1.7641, 1.6899, 1.6157, 1.5415, 1.4673, 1.3932, 1.3190 }
+		}
+	};
+	// Drag coefficient [flaps][mach][alpha]
+	constexpr double drag[flap_count][mach_count][alpha_count] = {
+		{ // CONF 0 (clean)
+			{ 0.0374, 0.0268, 0.0207, 0.0190, 0.0218, 0.0290, 0.0407, 0.0569, 0.0775, 0.1026, 0.1168, 0.1112, 0.1107, 0.1152, 0.1245 },
+			{ 0.0448, 0.0305, 0.0219, 0.0190, 0.0218, 0.0303, 0.0446, 0.0645, 0.0901, 0.0922, 0.0897, 0.0922, 0.0997, 0.1119, 0.1289 },
+			{ 0.0614, 0.0390, 0.0249, 0.0191, 0.0218, 0.0329, 0.0523, 0.0769, 0.0722, 0.0726, 0.0780, 0.0882, 0.1033, 0.1230, 0.1471 },
+			{ 0.0638, 0.0402, 0.0254, 0.0193, 0.0219, 0.0333, 0.0534, 0.0681, 0.0654, 0.0677, 0.0750, 0.0872, 0.1041, 0.1255, 0.1513 },
+			{ 0.0661, 0.0425, 0.0277, 0.0216, 0.0242, 0.0356, 0.0557, 0.0639, 0.0626, 0.0663, 0.0750, 0.0886, 0.1068, 0.1296, 0.1567 }
+		},
+		{ // CONF 1
+			{ 0.0352, 0.0306, 0.0305, 0.0348, 0.0436, 0.0569, 0.0746, 0.0967, 0.1233, 0.1544, 0.1899, 0.1828, 0.1774, 0.1769, 0.1814 },
+			{ 0.0394, 0.0319, 0.0301, 0.0340, 0.0436, 0.0589, 0.0799, 0.1067, 0.1391, 0.1505, 0.1446, 0.1437, 0.1478, 0.1567, 0.1704 },
+			{ 0.0503, 0.0360, 0.0302, 0.0327, 0.0436, 0.0629, 0.0906, 0.1232, 0.1164, 0.1147, 0.1180, 0.1262, 0.1391, 0.1567, 0.1787 },
+			{ 0.0519, 0.0368, 0.0304, 0.0327, 0.0437, 0.0635, 0.0920, 0.1091, 0.1047, 0.1054, 0.1110, 0.1215, 0.1367, 0.1565, 0.1806 },
+			{ 0.0542, 0.0391, 0.0327, 0.0350, 0.0460, 0.0658, 0.0944, 0.1007, 0.0982, 0.1007, 0.1081, 0.1203, 0.1373, 0.1587, 0.1845 }
+		},
+		{ // CONF 2
+			{ 0.0459, 0.0453, 0.0492, 0.0575, 0.0703, 0.0876, 0.1093, 0.1354, 0.1660, 0.2011, 0.2407, 0.2563, 0.2466, 0.2419, 0.2422 },
+			{ 0.0480, 0.0450, 0.0477, 0.0562, 0.0703, 0.0902, 0.1157, 0.1470, 0.1839, 0.2101, 0.2012, 0.1973, 0.1984, 0.2043, 0.2150 },
+			{ 0.0550, 0.0462, 0.0459, 0.0539, 0.0703, 0.0951, 0.1283, 0.1699, 0.1623, 0.1586, 0.1599, 0.1661, 0.1771, 0.1928, 0.2129 },
+			{ 0.0562, 0.0467, 0.0458, 0.0538, 0.0704, 0.0958, 0.1300, 0.1519, 0.1459, 0.1449, 0.1489, 0.1578, 0.1714, 0.1895, 0.2120 },
+			{ 0.0585, 0.0490, 0.0482, 0.0561, 0.0727, 0.0981, 0.1323, 0.1397, 0.1358, 0.1369, 0.1430, 0.1539, 0.1694, 0.1895, 0.2139 }
+		},
+		{ // CONF 3
+			{ 0.0600, 0.0624, 0.0693, 0.0807, 0.0965, 0.1167, 0.1414, 0.1706, 0.2042, 0.2423, 0.2848, 0.3318, 0.3294, 0.3193, 0.3143 },
+			{ 0.0605, 0.0609, 0.0671, 0.0789, 0.0965, 0.1197, 0.1486, 0.1833, 0.2237, 0.2697, 0.2673, 0.2594, 0.2564, 0.2584, 0.2652 },
+			{ 0.0646, 0.0600, 0.0638, 0.0759, 0.0965, 0.1254, 0.1627, 0.2084, 0.2146, 0.2081, 0.2066, 0.2101, 0.2183, 0.2313, 0.2487 },
+			{ 0.0655, 0.0602, 0.0636, 0.0757, 0.0966, 0.1262, 0.1645, 0.2007, 0.1922, 0.1888, 0.1904, 0.1968, 0.2080, 0.2238, 0.2440 },
+			{ 0.0678, 0.0625, 0.0659, 0.0780, 0.0989, 0.1285, 0.1668, 0.1836, 0.1776, 0.1765, 0.1804, 0.1892, 0.2027, 0.2207, 0.2430 }
+		},
+		{ // CONF FULL
+			{ 0.0870, 0.0934, 0.1043, 0.1196, 0.1395, 0.1637, 0.1924, 0.2256, 0.2632, 0.3053, 0.3519, 0.4029, 0.4314, 0.4171, 0.4077 },
+			{ 0.0854, 0.0903, 0.1010, 0.1174, 0.1395, 0.1672, 0.2007, 0.2399, 0.2848, 0.3354, 0.3495, 0.3385, 0.3326, 0.3315, 0.3354 },
+			{ 0.0857, 0.0865, 0.0958, 0.1134, 0.1395, 0.1739, 0.2167, 0.2679, 0.2808, 0.2723, 0.2689, 0.2703, 0.2766, 0.2877, 0.3032 },
+			{ 0.0861, 0.0864, 0.0954, 0.1131, 0.1396, 0.1748, 0.2187, 0.2623, 0.2521, 0.2471, 0.2470, 0.2518, 0.2614, 0.2755, 0.2941 },
+			{ 0.0884, 0.0887, 0.0977, 0.1154, 0.1419, 0.1771, 0.2210, 0.2401, 0.2327, 0.2303, 0.2328, 0.2402, 0.2523, 0.2690, 0.2900 }
+		}
+	};
+	// Pitching moment coefficient [flaps][mach][alpha]
+	constexpr double pitching_moment[flap_count][mach_count][alpha_count] = {
+		{ // CONF 0 (clean)
+			{ 0.2094, 0.1571, 0.1047, 0.0524, 0.0000, -0.0524, -0.1047, -0.1571, -0.2094, -0.2618, -0.3242, -0.4027, -0.4813, -0.5598, -0.6383 },
+			{ 0.2094, 0.1571, 0.1047, 0.0524, 0.0000, -0.0524, -0.1047, -0.1571, -0.2094, -0.2814, -0.3600, -0.4385, -0.5171, -0.5956, -0.6741 },
+			{ 0.2094, 0.1571, 0.1047, 0.0524, 0.0000, -0.0524, -0.1047, -0.1593, -0.2378, -0.3164, -0.3949, -0.4735, -0.5520, -0.6305, -0.7091 },
+			{ 0.1658, 0.1134, 0.0611, 0.0087, -0.0436, -0.0960, -0.1484, -0.2105, -0.2891, -0.3676, -0.4461, -0.5247, -0.6032, -0.6818, -0.7603 },
+			{ 0.0894, 0.0371, -0.0153, -0.0676, -0.1200, -0.1724, -0.2247, -0.2922, -0.3707, -0.4493, -0.5278, -0.6063, -0.6849, -0.7634, -0.8420 }
+		},
+		{ // CONF 1
+			{ 0.1594, 0.1071, 0.0547, 0.0024, -0.0500, -0.1024, -0.1547, -0.2071, -0.2594, -0.3118, -0.3642, -0.4410, -0.5195, -0.5980, -0.6766 },
+			{ 0.1594, 0.1071, 0.0547, 0.0024, -0.0500, -0.1024, -0.1547, -0.2071, -0.2594, -0.3260, -0.4046, -0.4831, -0.5616, -0.6402, -0.7187 },
+			{ 0.1594, 0.1071, 0.0547, 0.0024, -0.0500, -0.1024, -0.1547, -0.2090, -0.2875, -0.3660, -0.4446, -0.5231, -0.6017, -0.6802, -0.7587 },
+			{ 0.1158, 0.0634, 0.0111, -0.0413, -0.0936, -0.1460, -0.1984, -0.2618, -0.3403, -0.4189, -0.4974, -0.5760, -0.6545, -0.7330, -0.8116 },
+			{ 0.0394, -0.0129, -0.0653, -0.1176, -0.1700, -0.2224, -0.2747, -0.3449, -0.4234, -0.5019, -0.5805, -0.6590, -0.7376, -0.8161, -0.8946 }
+		},
+		{ // CONF 2
+			{ 0.1294, 0.0771, 0.0247, -0.0276, -0.0800, -0.1324, -0.1847, -0.2371, -0.2894, -0.3418, -0.3942, -0.4592, -0.5377, -0.6163, -0.6948 },
+			{ 0.1294, 0.0771, 0.0247, -0.0276, -0.0800, -0.1324, -0.1847, -0.2371, -0.2894, -0.3494, -0.4279, -0.5065, -0.5850, -0.6635, -0.7421 },
+			{ 0.1294, 0.0771, 0.0247, -0.0276, -0.0800, -0.1324, -0.1847, -0.2371, -0.3151, -0.3936, -0.4722, -0.5507, -0.6293, -0.7078, -0.7863 },
+			{ 0.0858, 0.0334, -0.0189, -0.0713, -0.1236, -0.1760, -0.2284, -0.2907, -0.3692, -0.4477, -0.5263, -0.6048, -0.6833, -0.7619, -0.8404 },
+			{ 0.0094, -0.0429, -0.0953, -0.1476, -0.2000, -0.2524, -0.3047, -0.3748, -0.4533, -0.5319, -0.6104, -0.6889, -0.7675, -0.8460, -0.9246 }
+		},
+		{ // CONF 3
+			{ 0.1094, 0.0571, 0.0047, -0.0476, -0.1000, -0.1524, -0.2047, -0.2571, -0.3094, -0.3618, -0.4142, -0.4665, -0.5401, -0.6186, -0.6972 },
+			{ 0.1094, 0.0571, 0.0047, -0.0476, -0.1000, -0.1524, -0.2047, -0.2571, -0.3094, -0.3618, -0.4361, -0.5146, -0.5931, -0.6717, -0.7502 },
+			{ 0.1094, 0.0571, 0.0047, -0.0476, -0.1000, -0.1524, -0.2047, -0.2571, -0.3284, -0.4069, -0.4855, -0.5640, -0.6426, -0.7211, -0.7996 },
+			{ 0.0658, 0.0134, -0.0389, -0.0913, -0.1436, -0.1960, -0.2484, -0.3053, -0.3838, -0.4624, -0.5409, -0.6195, -0.6980, -0.7765, -0.8551 },
+			{ -0.0106, -0.0629, -0.1153, -0.1676, -0.2200, -0.2724, -0.3247, -0.3905, -0.4690, -0.5476, -0.6261, -0.7047, -0.7832, -0.8617, -0.9403 }
+		},
+		{ // CONF FULL
+			{ 0.0794, 0.0271, -0.0253, -0.0776, -0.1300, -0.1824, -0.2347, -0.2871, -0.3394, -0.3918, -0.4442, -0.4965, -0.5583, -0.6369, -0.7154 },
+			{ 0.0794, 0.0271, -0.0253, -0.0776, -0.1300, -0.1824, -0.2347, -0.2871, -0.3394, -0.3918, -0.4594, -0.5379, -0.6165, -0.6950, -0.7736 },
+			{ 0.0794, 0.0271, -0.0253, -0.0776, -0.1300, -0.1824, -0.2347, -0.2871, -0.3560, -0.4345, -0.5131, -0.5916, -0.6702, -0.7487, -0.8272 },
+			{ 0.0358, -0.0166, -0.0689, -0.1213, -0.1736, -0.2260, -0.2784, -0.3342, -0.4127, -0.4912, -0.5698, -0.6483, -0.7269, -0.8054, -0.8839 },
+			{ -0.0406, -0.0929, -0.1453, -0.1976, -0.2500, -0.3024, -0.3547, -0.4204, -0.4989, -0.5775, -0.6560, -0.7346, -0.8131, -0.8916, -0.9702 }
+		}
+	};
+
+	// Dynamic derivatives and control power (per radian; rates are nondimensionalized by c/2V or b/2V)
+	// The pitch damping and the elevator derivatives are calibrated against the closed loop rather than published: the
+	// gains were tuned in the simulator, and with less damping or more elevator power they set the short period
+	// oscillating at cruise speeds (see plant_bench)
+	constexpr double lift_pitch_rate = 4.5;
+	constexpr double lift_elevator = 0.25;
+	constexpr double pitch_rate_damping = -50;
+	constexpr double pitch_elevator = 0.5; // Trailing edge up is positive
+	constexpr double side_force_sideslip = -0.8;
+	constexpr double side_force_rudder = -0.15; // Rudder deflected to yaw the nose right is positive
+	constexpr double roll_sideslip = -0.1;
+	constexpr double roll_rate_damping = -0.45;
+	constexpr double roll_yaw_rate = 0.1;
+	constexpr double roll_aileron = 0.045; // Ailerons and roll spoilers, right wing down is positive
+	constexpr double roll_rudder = -0.01;
+	constexpr double yaw_sideslip = 0.12;
+	constexpr double yaw_roll_rate = -0.03;
+	constexpr double yaw_rate_damping = -0.25;
+	constexpr double yaw_aileron = -0.005;
+	constexpr double yaw_rudder = 0.08;
+	constexpr double drag_sideslip = 0.3;
+
+	// Full control deflections in degrees
+	constexpr double elevator_up = 30;
+	constexpr double elevator_down = 17;
+	constexpr double aileron_travel = 25;
+	constexpr double rudder_travel = 30;
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+// Flies a scenario with an FbwInstance controlling the plant model
+
+#include "../fbw_instance.h"
+#include "plant_model.h"
+#include "scenario.h"
+
+// The envelope the protections are meant to keep the aircraft in, and how far it went outside of it
+struct EnvelopeExcursion
+{
+	double pitch_up = 0; // Degrees above MaxPitchAngle
+	double pitch_down = 0; // Degrees below MinPitchAngle
+	double bank = 0; // Degrees beyond MaxBankAngle
+	double load_factor_high = 0; // g above MaxLoadFactor
+	double load_factor_low = 0; // g below MinLoadFactor
+	double overspeed = 0; // Knots above Vmo
+	double overspeed_mach = 0; // Mach above Mmo
+
+	bool Any() const { return pitch_up > 0 || pitch_down > 0 || bank > 0 || load_factor_high > 0 || load_factor_low > 0 || overspeed > 0 || overspeed_mach > 0; }
+	// The largest excursion, relative to the clean configuration limit it exceeded
+	double Severity() const
+	{
+		return fmax(fmax(fmax(pitch_up / 30, pitch_down / 15), fmax(bank / 67, load_factor_high / 2.5)),
+			fmax(fmax(load_factor_low / 1, overspeed / 350), overspeed_mach / 0.82));
+	}
+
+	// Records the worst of both excursions
+	void Merge(const EnvelopeExcursion& other)
+	{
+		pitch_up = fmax(pitch_up, other.pitch_up);
+		pitch_down = fmax(pitch_down, other.pitch_down);
+		bank = fmax(bank, other.bank);
+		load_factor_high = fmax(load_factor_high, other.load_factor_high);
+		load_factor_low = fmax(load_factor_low, other.load_factor_low);
+		overspeed = fmax(overspeed, other.overspeed);
+		overspeed_mach = fmax(overspeed_mach, other.overspeed_mach);
+	}
+};
+
+class ClosedLoop
+{
+private:
+	FbwInstance fbw;
+	PlantModel plant;
+	CONTROL_SURFACES_DATA surfaces = {}; // Of the last frame
+	double t = 0;
+public:
+	static constexpr double max_warm_up = 10; // Seconds the pitch control mode gets to reach FLIGHT_MODE
+
+	FbwInstance& Fbw() { return fbw; }
+	PlantModel& Plant() { return plant; }
+	const CONTROL_SURFACES_DATA& Surfaces() const { return surfaces; }
+	double Time() const { return t; }
+
+	// Puts the plant at the scenario's initial conditions and runs the FBW, with the plant held there and the
+	// sidestick neutral, until it has blended into flight mode. Returns false if it never does.
+	bool Start(const Scenario& scenario, const double dt)
+	{
+		plant.Reset(scenario.initial);
+		for (t = 0; t < max_warm_up; t += dt)
+		{
+			fbw.Update(plant.Sample(), t, dt);
+			if (fbw.PitchMode().Mode() == FLIGHT_MODE) return true;
+		}
+		return false;
+	}
+
+	// Runs one frame of dt, at time since_start after the controls were handed over.
+	// Returns how far the aircraft went outside the envelope the protections enforced during the frame.
+	EnvelopeExcursion Step(const Scenario& scenario, const double since_start, const double dt)
+	{
+		double pitch_input, roll_input;
+		scenario.Sidestick(since_start, pitch_input, roll_input);
+		fbw.Input().SetYokeY(pitch_input);
+		fbw.Input().SetYokeX(roll_input);
+
+		t += dt;
+		surfaces = fbw.Update(plant.Sample(), t, dt);
+		plant.Step(surfaces, dt);
+
+		auto& aircraft = fbw.Aircraft();
+		auto& protections = fbw.Protections();
+		EnvelopeExcursion excursion;
+		excursion.pitch_up = fmax(aircraft.Pitch() - protections.MaxPitchAngle(), 0);
+		excursion.pitch_down = fmax(protections.MinPitchAngle() - aircraft.Pitch(), 0);
+		excursion.bank = fmax(fabs(aircraft.Roll()) - protections.MaxBankAngle(), 0);
+		excursion.load_factor_high = fmax(aircraft.GForce() - protections.MaxLoadFactor(), 0);
+		excursion.load_factor_low = fmax(protections.MinLoadFactor() - aircraft.GForce(), 0);
+		excursion.overspeed = fmax(aircraft.IAS() - aircraft.Vmo(), 0);
+		excursion.overspeed_mach = fmax(aircraft.Mach() - aircraft.Mmo(), 0);
+		return excursion;
+	}
+};
\ No newline at end of file
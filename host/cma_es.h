@@ -0,0 +1,221 @@
+#pragma once
+// Covariance matrix adaptation evolution strategy, a derivative-free minimizer for host tools that tune parameters
+// against noisy or non-smooth costs (e.g. closed loop simulations)
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// Each generation, Ask() draws a population of candidates from a multivariate normal distribution, and Tell() moves the
+// distribution towards the best of them according to their costs. Follows N. Hansen, "The CMA Evolution Strategy: A
+// Tutorial" (2016), with the default parameters it gives. Deterministic for a given seed.
+class CmaEs
+{
+private:
+	size_t n;
+	size_t lambda;
+	size_t mu;
+	std::vector<double> weights; // Of the best mu candidates, summing to 1
+	double mu_eff;
+	double c_sigma, d_sigma, c_c, c_1, c_mu;
+	double chi_n; // Expected length of a standard normal vector
+
+	std::vector<double> mean;
+	double sigma;
+	std::vector<double> covariance; // n x n, row major
+	std::vector<double> basis; // Eigenvectors of the covariance, as columns
+	std::vector<double> scales; // Square roots of its eigenvalues
+	std::vector<double> path_sigma;
+	std::vector<double> path_c;
+	size_t generation = 0;
+	size_t decomposed_generation = 0;
+
+	std::mt19937_64 generator;
+	std::normal_distribution<double> normal;
+	std::vector<std::vector<double>> candidates;
+
+	std::vector<double> best;
+	double best_cost = INFINITY;
+
+	double& C(const size_t row, const size_t column) { return covariance[row * n + column]; }
+	double& B(const size_t row, const size_t column) { return basis[row * n + column]; }
+
+	// Jacobi eigenvalue iteration; the covariance is small and symmetric
+	void Decompose()
+	{
+		std::vector<double> a = covariance;
+		std::fill(basis.begin(), basis.end(), 0.0);
+		for (size_t i = 0; i < n; i++) B(i, i) = 1;
+		for (auto sweep = 0; sweep < 50; sweep++)
+		{
+			double off_diagonal = 0;
+			for (size_t p = 0; p < n; p++) for (size_t q = p + 1; q < n; q++) off_diagonal += a[p * n + q] * a[p * n + q];
+			if (off_diagonal < 1e-30) break;
+			for (size_t p = 0; p < n; p++)
+			{
+				for (size_t q = p + 1; q < n; q++)
+				{
+					const auto apq = a[p * n + q];
+					if (fabs(apq) < 1e-300) continue;
+					const auto theta = (a[q * n + q] - a[p * n + p]) / (2 * apq);
+					const auto t = (theta >= 0 ? 1 : -1) / (fabs(theta) + sqrt(theta * theta + 1));
+					const auto c = 1 / sqrt(t * t + 1);
+					const auto s = t * c;
+					for (size_t k = 0; k < n; k++)
+					{
+						const auto akp = a[k * n + p], akq = a[k * n + q];
+						a[k * n + p] = c * akp - s * akq;
+						a[k * n + q] = s * akp + c * akq;
+					}
+					for (size_t k = 0; k < n; k++)
+					{
+						const auto apk = a[p * n + k], aqk = a[q * n + k];
+						a[p * n + k] = c * apk - s * aqk;
+						a[q * n + k] = s * apk + c * aqk;
+					}
+					for (size_t k = 0; k < n; k++)
+					{
+						const auto bkp = B(k, p), bkq = B(k, q);
+						B(k, p) = c * bkp - s * bkq;
+						B(k, q) = s * bkp + c * bkq;
+					}
+				}
+			}
+		}
+		for (size_t i = 0; i < n; i++) scales[i] = sqrt(fmax(a[i * n + i], 1e-20));
+		decomposed_generation = generation;
+	}
+public:
+	// Starts from mean with step size sigma in every direction. A population of 0 picks the default, 4 + 3 ln(n).
+	CmaEs(const std::vector<double>& initial_mean, const double initial_sigma, size_t population = 0, const uint64_t seed = 1)
+		: n(initial_mean.size()), mean(initial_mean), sigma(initial_sigma), generator(seed)
+	{
+		lambda = population > 0 ? population : 4 + static_cast<size_t>(3 * log(static_cast<double>(n)));
+		mu = lambda / 2;
+		for (size_t i = 0; i < mu; i++) weights.push_back(log(mu + 0.5) - log(i + 1.0));
+		const auto sum = std::accumulate(weights.begin(), weights.end(), 0.0);
+		double sum_squares = 0;
+		for (auto& weight : weights)
+		{
+			weight /= sum;
+			sum_squares += weight * weight;
+		}
+		mu_eff = 1 / sum_squares;
+
+		const auto dimensions = static_cast<double>(n);
+		c_sigma = (mu_eff + 2) / (dimensions + mu_eff + 5);
+		d_sigma = 1 + 2 * fmax(0, sqrt((mu_eff - 1) / (dimensions + 1)) - 1) + c_sigma;
+		c_c = (4 + mu_eff / dimensions) / (dimensions + 4 + 2 * mu_eff / dimensions);
+		c_1 = 2 / ((dimensions + 1.3) * (dimensions + 1.3) + mu_eff);
+		c_mu = fmin(1 - c_1, 2 * (mu_eff - 2 + 1 / mu_eff) / ((dimensions + 2) * (dimensions + 2) + mu_eff));
+		chi_n = sqrt(dimensions) * (1 - 1 / (4 * dimensions) + 1 / (21 * dimensions * dimensions));
+
+		covariance.assign(n * n, 0);
+		basis.assign(n * n, 0);
+		for (size_t i = 0; i < n; i++) C(i, i) = B(i, i) = 1;
+		scales.assign(n, 1);
+		path_sigma.assign(n, 0);
+		path_c.assign(n, 0);
+		candidates.assign(lambda, std::vector<double>(n));
+		best = mean;
+	}
+
+	// The candidates of the next generation
+	const std::vector<std::vector<double>>& Ask()
+	{
+		// The decomposition costs O(n^3); the covariance changes little from one generation to the next
+		if (generation - decomposed_generation > lambda / (c_1 + c_mu) / n / 10) Decompose();
+		std::vector<double> z(n);
+		for (auto& candidate : candidates)
+		{
+			for (auto& value : z) value = normal(generator);
+			for (size_t i = 0; i < n; i++)
+			{
+				double y = 0;
+				for (size_t j = 0; j < n; j++) y += B(i, j) * scales[j] * z[j];
+				candidate[i] = mean[i] + sigma * y;
+			}
+		}
+		return candidates;
+	}
+
+	// The cost of each candidate Ask() returned, in the same order
+	void Tell(const std::vector<double>& costs)
+	{
+		std::vector<size_t> order(lambda);
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [&costs](const size_t a, const size_t b) { return costs[a] < costs[b]; });
+		if (costs[order[0]] < best_cost)
+		{
+			best_cost = costs[order[0]];
+			best = candidates[order[0]];
+		}
+
+		const auto old_mean = mean;
+		std::fill(mean.begin(), mean.end(), 0.0);
+		for (size_t k = 0; k < mu; k++)
+		{
+			for (size_t i = 0; i < n; i++) mean[i] += weights[k] * candidates[order[k]][i];
+		}
+		std::vector<double> step(n); // Of the mean, in units of sigma
+		for (size_t i = 0; i < n; i++) step[i] = (mean[i] - old_mean[i]) / sigma;
+
+		// C^-1/2 step = B D^-1 B^T step
+		std::vector<double> projected(n), whitened(n);
+		for (size_t j = 0; j < n; j++)
+		{
+			double value = 0;
+			for (size_t i = 0; i < n; i++) value += B(i, j) * step[i];
+			projected[j] = value / scales[j];
+		}
+		for (size_t i = 0; i < n; i++)
+		{
+			double value = 0;
+			for (size_t j = 0; j < n; j++) value += B(i, j) * projected[j];
+			whitened[i] = value;
+		}
+
+		generation++;
+		double path_sigma_length = 0;
+		for (size_t i = 0; i < n; i++)
+		{
+			path_sigma[i] = (1 - c_sigma) * path_sigma[i] + sqrt(c_sigma * (2 - c_sigma) * mu_eff) * whitened[i];
+			path_sigma_length += path_sigma[i] * path_sigma[i];
+		}
+		path_sigma_length = sqrt(path_sigma_length);
+		// The rank one update is held back while the step size path is long, i.e. while sigma is still growing
+		const auto short_path = path_sigma_length / sqrt(1 - pow(1 - c_sigma, 2.0 * generation)) < (1.4 + 2 / (n + 1.0)) * chi_n;
+		const auto h_sigma = short_path ? 1.0 : 0.0;
+		for (size_t i = 0; i < n; i++) path_c[i] = (1 - c_c) * path_c[i] + h_sigma * sqrt(c_c * (2 - c_c) * mu_eff) * step[i];
+
+		for (size_t i = 0; i < n; i++)
+		{
+			for (size_t j = 0; j <= i; j++)
+			{
+				double rank_mu = 0;
+				for (size_t k = 0; k < mu; k++)
+				{
+					const auto& x = candidates[order[k]];
+					rank_mu += weights[k] * (x[i] - old_mean[i]) * (x[j] - old_mean[j]);
+				}
+				rank_mu /= sigma * sigma;
+				const auto value = (1 - c_1 - c_mu) * C(i, j)
+					+ c_1 * (path_c[i] * path_c[j] + (1 - h_sigma) * c_c * (2 - c_c) * C(i, j))
+					+ c_mu * rank_mu;
+				C(i, j) = C(j, i) = value;
+			}
+		}
+		sigma *= exp(c_sigma / d_sigma * (path_sigma_length / chi_n - 1));
+	}
+
+	const std::vector<double>& Mean() const { return mean; }
+	double Sigma() const { return sigma; }
+	size_t Population() const { return lambda; }
+	size_t Generation() const { return generation; }
+	// The best candidate told so far, and its cost
+	const std::vector<double>& Best() const { return best; }
+	double BestCost() const { return best_cost; }
+};
\ No newline at end of file
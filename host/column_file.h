@@ -0,0 +1,341 @@
+#pragma once
+// Column files: a table of rows stored column by column, so that a tool reading a few columns of many rows only
+// touches those. A file is a ColumnFileHeader and its ColumnDescriptors, followed by blocks of up to block_rows rows,
+// each a ColumnBlockHeader and a ColumnChunk for every column, followed by the values of every column for the block in
+// order, each column padded to 8 bytes. A column that has the same value in every row of a block stores it once, and
+// one of doubles that are all whole millionths close enough together (as text printed with %lf parses to) stores them
+// in 32 bits, both only where that is lossless. The chunks hold the range of the values of each column in the block, so that a reader can skip the blocks that cannot
+// hold a value it looks for (e.g. a range of times). Blocks are only ever appended, so a file cut short is valid up to
+// its last whole block.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "mapped_file.h"
+
+enum COLUMN_TYPE : uint32_t
+{
+	COLUMN_F64, // double
+	COLUMN_U8, // uint8_t
+	COLUMN_U64, // uint64_t
+};
+
+enum COLUMN_ENCODING : uint32_t
+{
+	COLUMN_PLAIN, // A value for every row
+	COLUMN_CONSTANT, // A single value, that of every row
+	COLUMN_MICROS, // For COLUMN_F64: a uint32_t for every row, the value in millionths above the min of the chunk
+};
+constexpr uint32_t column_micros_nan = UINT32_MAX;
+constexpr uint32_t column_micros_negative_zero = UINT32_MAX - 1;
+
+struct ColumnFileHeader
+{
+	char magic[4]; // "FBWC"
+	uint32_t version;
+	uint32_t column_count;
+	uint32_t block_rows; // Rows of every block but the last
+};
+constexpr uint32_t column_file_version = 2;
+
+struct ColumnDescriptor
+{
+	char name[24]; // NUL-terminated
+	uint32_t type; // COLUMN_TYPE
+	uint32_t reserved;
+};
+
+struct ColumnBlockHeader
+{
+	uint32_t rows;
+	uint32_t reserved;
+};
+
+// A column of a block
+struct ColumnChunk
+{
+	double min; // Of the values that are not NaN; NaN if there are none
+	double max;
+	uint32_t encoding; // COLUMN_ENCODING
+	uint32_t reserved;
+};
+
+inline size_t ColumnValueSize(const uint32_t type) { return type == COLUMN_U8 ? 1 : 8; }
+inline size_t ColumnPadding(const size_t bytes) { return (8 - bytes % 8) % 8; }
+inline size_t ColumnChunkBytes(const uint32_t type, const ColumnChunk& chunk, const uint32_t rows)
+{
+	const auto bytes = chunk.encoding == COLUMN_MICROS ? rows * sizeof(uint32_t) : (chunk.encoding == COLUMN_CONSTANT ? 1 : rows) * ColumnValueSize(type);
+	return bytes + ColumnPadding(bytes);
+}
+
+// The nearest whole number of millionths to value, which must be well within the range of int64_t
+inline int64_t ColumnMicros(const double value) { return static_cast<int64_t>(value < 0 ? value * 1e6 - 0.5 : value * 1e6 + 0.5); }
+
+// The value of micros in a COLUMN_MICROS chunk whose min is base millionths
+inline double ColumnMicrosValue(const int64_t base, const uint32_t micros)
+{
+	if (micros == column_micros_nan) return NAN;
+	if (micros == column_micros_negative_zero) return -0.0;
+	return static_cast<double>(base + micros) / 1e6;
+}
+
+inline double ColumnValue(const uint32_t type, const uint8_t* value)
+{
+	if (type == COLUMN_U8) return *value;
+	if (type == COLUMN_U64)
+	{
+		uint64_t integer;
+		memcpy(&integer, value, sizeof(integer));
+		return static_cast<double>(integer);
+	}
+	double real;
+	memcpy(&real, value, sizeof(real));
+	return real;
+}
+
+// Writes a column file a row at a time, buffering a block
+class ColumnWriter
+{
+private:
+	FILE* file = nullptr;
+	std::vector<ColumnDescriptor> columns;
+	std::vector<std::vector<uint8_t>> values; // Of the block being filled, by column
+	std::vector<ColumnChunk> chunks;
+	std::vector<std::vector<uint32_t>> micros; // Of the block being filled, by column
+	uint32_t block_rows = 0;
+	uint32_t rows = 0; // In the block being filled
+	uint64_t written_rows = 0;
+	bool ok = true;
+
+	void WriteBlock()
+	{
+		if (rows == 0) return;
+		const ColumnBlockHeader header = { rows, 0 };
+		ok &= fwrite(&header, sizeof(header), 1, file) == 1;
+		for (size_t column = 0; column < columns.size(); column++)
+		{
+			const auto size = ColumnValueSize(columns[column].type);
+			const auto* data = values[column].data();
+			auto& chunk = chunks[column];
+			chunk = { NAN, NAN, COLUMN_CONSTANT, 0 };
+			if (columns[column].type == COLUMN_F64)
+			{
+				// Without NaN, which every comparison is false for
+				auto min = INFINITY;
+				auto max = -INFINITY;
+				for (uint32_t row = 0; row < rows; row++)
+				{
+					double value;
+					memcpy(&value, data + row * size, sizeof(value));
+					min = value < min ? value : min;
+					max = value > max ? value : max;
+				}
+				if (min <= max) chunk.min = min, chunk.max = max;
+			}
+			else
+			{
+				for (uint32_t row = 0; row < rows; row++)
+				{
+					const auto value = ColumnValue(columns[column].type, data + row * size);
+					if (value < chunk.min || std::isnan(chunk.min)) chunk.min = value;
+					if (value > chunk.max || std::isnan(chunk.max)) chunk.max = value;
+				}
+			}
+			for (uint32_t row = 1; row < rows && chunk.encoding == COLUMN_CONSTANT; row++)
+			{
+				if (memcmp(data, data + row * size, size) != 0) chunk.encoding = COLUMN_PLAIN;
+			}
+			if (columns[column].type == COLUMN_F64 && chunk.encoding == COLUMN_PLAIN && EncodeMicros(column)) chunk.encoding = COLUMN_MICROS;
+		}
+		ok &= fwrite(chunks.data(), sizeof(ColumnChunk), chunks.size(), file) == chunks.size();
+		static const uint8_t padding[8] = {};
+		for (size_t column = 0; column < columns.size(); column++)
+		{
+			const auto encoding = chunks[column].encoding;
+			const auto bytes = encoding == COLUMN_MICROS ? rows * sizeof(uint32_t) : (encoding == COLUMN_CONSTANT ? 1 : rows) * ColumnValueSize(columns[column].type);
+			const void* data = encoding == COLUMN_MICROS ? static_cast<const void*>(micros[column].data()) : values[column].data();
+			ok &= fwrite(data, 1, bytes, file) == bytes;
+			ok &= fwrite(padding, 1, ColumnPadding(bytes), file) == ColumnPadding(bytes);
+		}
+		written_rows += rows;
+		rows = 0;
+	}
+	// Encodes the values of column as millionths above the min of its chunk; returns false if any cannot be
+	bool EncodeMicros(const size_t column)
+	{
+		const auto& chunk = chunks[column];
+		if (!(std::fabs(chunk.min) < 1e12 && std::fabs(chunk.max) < 1e12)) return false;
+		const auto base = ColumnMicros(chunk.min);
+		auto& encoded = micros[column];
+		for (uint32_t row = 0; row < rows; row++)
+		{
+			double value;
+			memcpy(&value, &values[column][row * sizeof(double)], sizeof(double));
+			if (std::isnan(value)) encoded[row] = column_micros_nan;
+			else if (value == 0 && std::signbit(value)) encoded[row] = column_micros_negative_zero;
+			else
+			{
+				const auto offset = ColumnMicros(value) - base;
+				if (offset < 0 || offset >= column_micros_negative_zero) return false;
+				encoded[row] = static_cast<uint32_t>(offset);
+				if (ColumnMicrosValue(base, encoded[row]) != value) return false;
+			}
+		}
+		return true;
+	}
+public:
+	ColumnWriter() = default;
+	ColumnWriter(const ColumnWriter&) = delete;
+	ColumnWriter& operator=(const ColumnWriter&) = delete;
+	~ColumnWriter() { Close(); }
+
+	// Creates the file at path with the given columns; returns false if it cannot be created
+	bool Open(const char* path, const ColumnDescriptor* descriptors, const uint32_t column_count, const uint32_t rows_per_block = 4096)
+	{
+		Close();
+		file = fopen(path, "wb");
+		if (!file) return false;
+		columns.assign(descriptors, descriptors + column_count);
+		values.assign(column_count, std::vector<uint8_t>());
+		chunks.assign(column_count, ColumnChunk());
+		micros.assign(column_count, std::vector<uint32_t>(rows_per_block));
+		for (uint32_t column = 0; column < column_count; column++) values[column].resize(rows_per_block * ColumnValueSize(columns[column].type));
+		block_rows = rows_per_block;
+		rows = 0;
+		written_rows = 0;
+		const ColumnFileHeader header = { { 'F', 'B', 'W', 'C' }, column_file_version, column_count, block_rows };
+		ok = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(descriptors, sizeof(ColumnDescriptor), column_count, file) == column_count;
+		return ok;
+	}
+
+	// The values of the row being filled; a row is complete once every column was set
+	void SetF64(const uint32_t column, const double value) { memcpy(&values[column][rows * sizeof(double)], &value, sizeof(double)); }
+	void SetU8(const uint32_t column, const uint8_t value) { values[column][rows] = value; }
+	void SetU64(const uint32_t column, const uint64_t value) { memcpy(&values[column][rows * sizeof(uint64_t)], &value, sizeof(uint64_t)); }
+	void EndRow()
+	{
+		if (++rows == block_rows) WriteBlock();
+	}
+
+	uint64_t Rows() const { return written_rows + rows; }
+
+	// Writes the last block; returns false if any write failed
+	bool Close()
+	{
+		if (!file) return ok;
+		WriteBlock();
+		ok &= fclose(file) == 0;
+		file = nullptr;
+		return ok;
+	}
+};
+
+// Reads a column file in place
+class ColumnReader
+{
+private:
+	MappedFile file;
+	const ColumnFileHeader* header = nullptr;
+	const ColumnDescriptor* columns = nullptr;
+	std::vector<const char*> blocks; // Their headers
+	std::vector<uint64_t> block_first_rows;
+	std::vector<const uint8_t*> block_values; // Of every column of every block, by block then column
+	uint64_t rows = 0;
+public:
+	// Maps the file at path and finds its blocks; returns false, with the reason in error, if it is not a column file
+	bool Open(const char* path, std::string& error)
+	{
+		blocks.clear();
+		block_first_rows.clear();
+		block_values.clear();
+		rows = 0;
+		if (!file.Open(path))
+		{
+			error = std::string("cannot read ") + path;
+			return false;
+		}
+		const auto* data = file.Data();
+		const auto size = file.Size();
+		header = reinterpret_cast<const ColumnFileHeader*>(data);
+		if (size < sizeof(ColumnFileHeader) || memcmp(header->magic, "FBWC", 4) != 0 || header->version != column_file_version
+			|| size < sizeof(ColumnFileHeader) + header->column_count * sizeof(ColumnDescriptor))
+		{
+			error = std::string(path) + " is not a column file of version " + std::to_string(column_file_version);
+			return false;
+		}
+		columns = reinterpret_cast<const ColumnDescriptor*>(data + sizeof(ColumnFileHeader));
+
+		const auto column_count = header->column_count;
+		auto offset = sizeof(ColumnFileHeader) + column_count * sizeof(ColumnDescriptor);
+		while (offset + sizeof(ColumnBlockHeader) + column_count * sizeof(ColumnChunk) <= size)
+		{
+			const auto* block = reinterpret_cast<const ColumnBlockHeader*>(data + offset);
+			const auto* chunks = reinterpret_cast<const ColumnChunk*>(data + offset + sizeof(ColumnBlockHeader));
+			auto end = offset + sizeof(ColumnBlockHeader) + column_count * sizeof(ColumnChunk);
+			const auto first_value = block_values.size();
+			for (uint32_t column = 0; column < column_count; column++)
+			{
+				block_values.push_back(reinterpret_cast<const uint8_t*>(data + end));
+				end += ColumnChunkBytes(columns[column].type, chunks[column], block->rows);
+			}
+			if (block->rows == 0 || end > size) // Cut short
+			{
+				block_values.resize(first_value);
+				break;
+			}
+			blocks.push_back(data + offset);
+			block_first_rows.push_back(rows);
+			rows += block->rows;
+			offset = end;
+		}
+		return true;
+	}
+
+	uint32_t ColumnCount() const { return header->column_count; }
+	const ColumnDescriptor& Column(const uint32_t column) const { return columns[column]; }
+	// The index of the column called name, or -1
+	int Find(const char* name) const
+	{
+		for (uint32_t column = 0; column < header->column_count; column++)
+		{
+			if (strncmp(columns[column].name, name, sizeof(columns[column].name)) == 0) return static_cast<int>(column);
+		}
+		return -1;
+	}
+
+	uint64_t Rows() const { return rows; }
+	size_t BlockCount() const { return blocks.size(); }
+	uint32_t BlockRows(const size_t block) const { return reinterpret_cast<const ColumnBlockHeader*>(blocks[block])->rows; }
+	uint64_t BlockFirstRow(const size_t block) const { return block_first_rows[block]; }
+	// The block that holds row, which must be below Rows()
+	size_t BlockOf(const uint64_t row) const
+	{
+		return std::upper_bound(block_first_rows.begin(), block_first_rows.end(), row) - block_first_rows.begin() - 1;
+	}
+	const ColumnChunk& Chunk(const size_t block, const uint32_t column) const
+	{
+		return reinterpret_cast<const ColumnChunk*>(blocks[block] + sizeof(ColumnBlockHeader))[column];
+	}
+	// The values of column in block as the encoding of its chunk: BlockRows(block) of its type, a single one if it is
+	// COLUMN_CONSTANT, or BlockRows(block) uint32_t if it is COLUMN_MICROS
+	const void* Values(const size_t block, const uint32_t column) const { return block_values[block * header->column_count + column]; }
+	// The value of column in row of block, as a double
+	double Value(const size_t block, const uint32_t column, const uint32_t row) const
+	{
+		const auto type = columns[column].type;
+		const auto& chunk = Chunk(block, column);
+		const auto* values = static_cast<const uint8_t*>(Values(block, column));
+		if (chunk.encoding == COLUMN_MICROS)
+		{
+			uint32_t micros;
+			memcpy(&micros, values + row * sizeof(uint32_t), sizeof(micros));
+			return ColumnMicrosValue(ColumnMicros(chunk.min), micros);
+		}
+		return ColumnValue(type, values + (chunk.encoding == COLUMN_CONSTANT ? 0 : row) * ColumnValueSize(type));
+	}
+};
\ No newline at end of file
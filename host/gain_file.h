@@ -0,0 +1,177 @@
+#pragma once
+// Gain tables (see gains.h) read from a text file, so that schedules can be tried without rebuilding
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../gain_tables.h"
+
+constexpr const char* gain_axis_names[GAIN_AXIS_COUNT] = { "ias", "mach", "altitude", "flaps" };
+constexpr const char* gain_controller_names[GAIN_CONTROLLER_COUNT] = { "aoa", "gforce", "vertical_fpa", "pitch_rate", "roll" };
+
+class GainFile
+{
+private:
+	std::vector<double> breakpoints[GAIN_AXIS_COUNT];
+	std::vector<PIDGains> points;
+	GainTable table = default_gain_table;
+public:
+	GainFile() = default;
+	// The table refers to the vectors
+	GainFile(const GainFile&) = delete;
+	GainFile& operator=(const GainFile&) = delete;
+
+	// Reads "<axis> breakpoint..." lines, one per axis of gain_axis_names; an axis that is left out has a single
+	// breakpoint. Then one "point kp ki kd ..." line per grid point, the last axis varying fastest, with the gains
+	// of each controller of gain_controller_names in turn. # starts a comment.
+	// Returns false, with the reason in error, if the file cannot be read or does not describe a whole table.
+	bool Load(const char* path, std::string& error)
+	{
+		auto* file = fopen(path, "r");
+		if (!file)
+		{
+			error = std::string("cannot open ") + path;
+			return false;
+		}
+
+		for (auto& axis : breakpoints) axis.clear();
+		points.clear();
+		char line[1024];
+		auto ok = true;
+		while (ok && fgets(line, sizeof(line), file))
+		{
+			line[strcspn(line, "#\r\n")] = '\0';
+			char name[64];
+			auto offset = 0;
+			if (sscanf(line, " %63s%n", name, &offset) != 1) continue;
+
+			std::vector<double> values;
+			double value;
+			auto consumed = 0;
+			for (auto* rest = line + offset; sscanf(rest, " %lf%n", &value, &consumed) == 1; rest += consumed) values.push_back(value);
+
+			auto found = false;
+			if (strcmp(name, "point") == 0)
+			{
+				found = values.size() == 3 * GAIN_CONTROLLER_COUNT;
+				for (size_t i = 0; found && i < values.size(); i += 3) points.push_back({ values[i], values[i + 1], values[i + 2] });
+			}
+			for (auto axis = 0; axis < GAIN_AXIS_COUNT; axis++)
+			{
+				if (strcmp(name, gain_axis_names[axis]) != 0) continue;
+				found = breakpoints[axis].empty() && !values.empty();
+				for (size_t i = 1; i < values.size(); i++) found &= values[i] > values[i - 1];
+				breakpoints[axis] = values;
+			}
+			ok &= found;
+			if (!ok) error = std::string("bad line in ") + path + ": " + line;
+		}
+		fclose(file);
+		if (!ok) return false;
+
+		size_t count = 1;
+		for (auto axis = 0; axis < GAIN_AXIS_COUNT; axis++)
+		{
+			if (breakpoints[axis].empty()) breakpoints[axis].push_back(0);
+			table.breakpoints[axis] = breakpoints[axis].data();
+			table.sizes[axis] = static_cast<int>(breakpoints[axis].size());
+			count *= breakpoints[axis].size();
+		}
+		if (points.size() != count * GAIN_CONTROLLER_COUNT)
+		{
+			error = std::string(path) + " has " + std::to_string(points.size() / GAIN_CONTROLLER_COUNT) + " points, the breakpoints make "
+				+ std::to_string(count);
+			return false;
+		}
+		table.points = points.data();
+		return true;
+	}
+
+	const GainTable& Table() const { return table; }
+};
+
+namespace gain_file
+{
+	template <typename Write>
+	void ForEachPoint(const GainTable& table, Write write)
+	{
+		auto count = 1;
+		for (const auto size : table.sizes) count *= size;
+		for (auto point = 0; point < count; point++) write(table.points + point * GAIN_CONTROLLER_COUNT);
+	}
+}
+
+// Writes table in the format GainFile reads
+inline bool SaveGainFile(const char* path, const GainTable& table, std::string& error)
+{
+	auto* file = fopen(path, "w");
+	if (!file)
+	{
+		error = std::string("cannot create ") + path;
+		return false;
+	}
+	for (auto axis = 0; axis < GAIN_AXIS_COUNT; axis++)
+	{
+		fprintf(file, "%s", gain_axis_names[axis]);
+		for (auto i = 0; i < table.sizes[axis]; i++) fprintf(file, " %.9g", table.breakpoints[axis][i]);
+		fprintf(file, "\n");
+	}
+	gain_file::ForEachPoint(table, [file](const PIDGains* gains)
+	{
+		fprintf(file, "point");
+		for (auto controller = 0; controller < GAIN_CONTROLLER_COUNT; controller++)
+		{
+			fprintf(file, " %.9g %.9g %.9g", gains[controller].kp, gains[controller].ki, gains[controller].kd);
+		}
+		fprintf(file, "\n");
+	});
+	const auto ok = fclose(file) == 0;
+	if (!ok) error = std::string("cannot write ") + path;
+	return ok;
+}
+
+// Writes table as a replacement for gain_tables.h, with comment (one or more lines) describing where it came from
+inline bool SaveGainHeader(const char* path, const GainTable& table, const std::string& comment, std::string& error)
+{
+	auto* file = fopen(path, "w");
+	if (!file)
+	{
+		error = std::string("cannot create ") + path;
+		return false;
+	}
+	fprintf(file, "#pragma once\n#include \"gains.h\"\n\n");
+	size_t start = 0;
+	while (start < comment.size())
+	{
+		auto end = comment.find('\n', start);
+		if (end == std::string::npos) end = comment.size();
+		fprintf(file, "// %s\n", comment.substr(start, end - start).c_str());
+		start = end + 1;
+	}
+	fprintf(file, "namespace default_gains\n{\n");
+	for (auto axis = 0; axis < GAIN_AXIS_COUNT; axis++)
+	{
+		fprintf(file, "\tconstexpr double %s[] = {", gain_axis_names[axis]);
+		for (auto i = 0; i < table.sizes[axis]; i++) fprintf(file, "%s %.9g", i > 0 ? "," : "", table.breakpoints[axis][i]);
+		fprintf(file, " };\n");
+	}
+	fprintf(file, "\tconstexpr PIDGains points[][GAIN_CONTROLLER_COUNT] = {\n");
+	gain_file::ForEachPoint(table, [file](const PIDGains* gains)
+	{
+		fprintf(file, "\t\t{");
+		for (auto controller = 0; controller < GAIN_CONTROLLER_COUNT; controller++)
+		{
+			fprintf(file, "%s { %.9g, %.9g, %.9g }", controller > 0 ? "," : "", gains[controller].kp, gains[controller].ki, gains[controller].kd);
+		}
+		fprintf(file, " },\n");
+	});
+	fprintf(file, "\t};\n}\n\nconstexpr GainTable default_gain_table = {\n");
+	fprintf(file, "\t{ default_gains::ias, default_gains::mach, default_gains::altitude, default_gains::flaps },\n");
+	fprintf(file, "\t{ %d, %d, %d, %d },\n", table.sizes[0], table.sizes[1], table.sizes[2], table.sizes[3]);
+	fprintf(file, "\tdefault_gains::points[0],\n};");
+	const auto ok = fclose(file) == 0;
+	if (!ok) error = std::string("cannot write ") + path;
+	return ok;
+}
\ No newline at end of file
@@ -0,0 +1,318 @@
+#pragma once
+// Live telemetry, for plotting a flight flown on the host while it is flown: after every frame the publisher copies a
+// LiveFrame of the FBW into a ring in POSIX shared memory, which any number of readers tail (see tools/live_tail.cpp).
+// The readers only ever read the ring, so the publisher never waits for them: a reader that falls more than the ring
+// behind loses the oldest frames, and counts them. Each slot is a sequence lock; a reader copies the frame out and keeps
+// it only if the slot held the same frame before and after.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "../fbw_instance.h"
+
+// The PID terms of a controller (see BasicPIDController::Terms)
+struct LivePidTerms
+{
+	double p;
+	double i;
+	double d;
+};
+
+// One frame of the FBW, in its sign conventions (+ is up, right)
+struct LiveFrame
+{
+	double t; // Seconds
+	// Aircraft state
+	double altitude; // Feet
+	double ias; // Knots
+	double mach;
+	double aoa; // Degrees
+	double pitch; // Degrees
+	double pitch_rate; // Degrees/second
+	double roll; // Degrees
+	double gforce;
+	double vfpa; // Degrees
+	// Sidestick, -1 to +1 (+ is back, right)
+	double yoke_x;
+	double yoke_y;
+	// Limits of the protections
+	double alpha_prot; // Degrees
+	double alpha_max; // Degrees
+	double max_pitch; // Degrees
+	double max_load_factor;
+	double min_load_factor;
+	double max_bank; // Degrees
+	// The PID controllers, indexed by GAIN_CONTROLLER
+	LivePidTerms pid[GAIN_CONTROLLER_COUNT];
+	// Surface outputs, -1 to +1
+	double elevator;
+	double ailerons;
+	double rudder;
+	// The active pitch branch: the law, its path and the pitch control mode, then the demand of the pitch law and the
+	// protections it applied (PITCH_TRACE_IDs) in its last control step
+	uint8_t law; // PITCH_LAW
+	uint8_t path; // PITCH_PATH
+	uint8_t mode; // PITCH_CONTROL_MODE
+	uint8_t demand;
+	uint8_t protections[max_trace_protections];
+	uint8_t protection_count;
+};
+
+// The fields of a LiveFrame, in order, for exporting it
+struct LiveColumn
+{
+	const char* name;
+	bool byte; // uint8_t, otherwise double
+	size_t offset;
+};
+#define LIVE_COLUMN(name, byte, field) { name, byte, offsetof(LiveFrame, field) }
+#define LIVE_PID_COLUMNS(name, controller) \
+	LIVE_COLUMN(name "_p", false, pid[controller].p), LIVE_COLUMN(name "_i", false, pid[controller].i), LIVE_COLUMN(name "_d", false, pid[controller].d)
+constexpr LiveColumn live_columns[] = {
+	LIVE_COLUMN("t", false, t), LIVE_COLUMN("altitude", false, altitude), LIVE_COLUMN("ias", false, ias), LIVE_COLUMN("mach", false, mach),
+	LIVE_COLUMN("aoa", false, aoa), LIVE_COLUMN("pitch", false, pitch), LIVE_COLUMN("pitch_rate", false, pitch_rate),
+	LIVE_COLUMN("roll", false, roll), LIVE_COLUMN("gforce", false, gforce), LIVE_COLUMN("vfpa", false, vfpa),
+	LIVE_COLUMN("yoke_x", false, yoke_x), LIVE_COLUMN("yoke_y", false, yoke_y), LIVE_COLUMN("alpha_prot", false, alpha_prot),
+	LIVE_COLUMN("alpha_max", false, alpha_max), LIVE_COLUMN("max_pitch", false, max_pitch),
+	LIVE_COLUMN("max_load_factor", false, max_load_factor), LIVE_COLUMN("min_load_factor", false, min_load_factor),
+	LIVE_COLUMN("max_bank", false, max_bank),
+	LIVE_PID_COLUMNS("aoa", GAIN_AOA), LIVE_PID_COLUMNS("gforce", GAIN_GFORCE), LIVE_PID_COLUMNS("vfpa", GAIN_VERTICAL_FPA),
+	LIVE_PID_COLUMNS("pitch_rate", GAIN_PITCH_RATE), LIVE_PID_COLUMNS("roll", GAIN_ROLL),
+	LIVE_COLUMN("elevator", false, elevator), LIVE_COLUMN("ailerons", false, ailerons), LIVE_COLUMN("rudder", false, rudder),
+	LIVE_COLUMN("law", true, law), LIVE_COLUMN("path", true, path), LIVE_COLUMN("mode", true, mode), LIVE_COLUMN("demand", true, demand),
+	LIVE_COLUMN("protection_1", true, protections[0]), LIVE_COLUMN("protection_2", true, protections[1]),
+	LIVE_COLUMN("protection_3", true, protections[2]), LIVE_COLUMN("protection_count", true, protection_count),
+};
+#undef LIVE_PID_COLUMNS
+#undef LIVE_COLUMN
+
+// Fills frame with the state of fbw after a frame that ended at t with surfaces. The pitch telemetry of fbw has to be
+// enabled for the demand and the protections, and is drained; frame keeps those it had if no control step ran.
+inline void CaptureLiveFrame(FbwInstance& fbw, const CONTROL_SURFACES_DATA& surfaces, const double t, LiveFrame& frame)
+{
+	auto& aircraft = fbw.Aircraft();
+	auto& protections = fbw.Protections();
+	auto& pitch = fbw.Surfaces().Pitch();
+	frame.t = t;
+	frame.altitude = aircraft.Altitude();
+	frame.ias = aircraft.IAS();
+	frame.mach = aircraft.Mach();
+	frame.aoa = aircraft.Alpha();
+	frame.pitch = aircraft.Pitch();
+	frame.pitch_rate = aircraft.PitchRate();
+	frame.roll = aircraft.Roll();
+	frame.gforce = aircraft.GForce();
+	frame.vfpa = aircraft.VFPA();
+	frame.yoke_x = fbw.Input().YokeX();
+	frame.yoke_y = fbw.Input().YokeY();
+	frame.alpha_prot = aircraft.AlphaProt();
+	frame.alpha_max = aircraft.AlphaMax();
+	frame.max_pitch = protections.MaxPitchAngle();
+	frame.max_load_factor = protections.MaxLoadFactor();
+	frame.min_load_factor = protections.MinLoadFactor();
+	frame.max_bank = protections.MaxBankAngle();
+	for (auto controller = 0; controller < GAIN_ROLL; controller++)
+	{
+		auto& terms = frame.pid[controller];
+		pitch.Controller(static_cast<GAIN_CONTROLLER>(controller)).Terms(terms.p, terms.i, terms.d);
+	}
+	fbw.Surfaces().Roll().Controller().Terms(frame.pid[GAIN_ROLL].p, frame.pid[GAIN_ROLL].i, frame.pid[GAIN_ROLL].d);
+	frame.elevator = surfaces.elevator;
+	frame.ailerons = surfaces.ailerons;
+	frame.rudder = surfaces.rudder;
+	frame.law = pitch.Law();
+	frame.path = pitch.Path();
+	frame.mode = fbw.PitchMode().Mode();
+
+	// The last control step of the frame
+	const PitchTraceRecord* last = nullptr;
+	fbw.Telemetry().Drain([&last](const PitchTraceRecord* records, const uint32_t count) { last = &records[count - 1]; });
+	if (!last) return;
+	frame.demand = last->demand.id;
+	frame.protection_count = last->protection_count;
+	for (auto i = 0; i < max_trace_protections; i++) frame.protections[i] = i < frame.protection_count ? last->protections[i].id : TRACE_NONE;
+}
+
+constexpr uint32_t live_telemetry_version = 1;
+constexpr uint32_t live_telemetry_capacity = 4096; // Frames, a power of two; over a minute at 60 fps
+constexpr const char* live_telemetry_name = "/a32nx_fbw_live";
+
+// The shared memory object: this header, then live_telemetry_capacity slots
+struct LiveTelemetryHeader
+{
+	char magic[4]; // "FBWL"
+	uint32_t version;
+	uint32_t frame_size;
+	uint32_t capacity;
+	std::atomic<uint64_t> published; // Frames published so far; frame n is in slot n % capacity
+	std::atomic<uint32_t> publishing; // Cleared when the publisher closes
+	uint32_t reserved;
+};
+
+struct alignas(64) LiveTelemetrySlot
+{
+	std::atomic<uint64_t> sequence; // 2n + 1 while frame n is written into the slot, 2n + 2 once it is
+	LiveFrame frame;
+};
+
+constexpr size_t live_telemetry_size = sizeof(LiveTelemetryHeader) + live_telemetry_capacity * sizeof(LiveTelemetrySlot);
+
+// Creates the shared memory object and publishes frames into it, from a single thread
+class LiveTelemetryPublisher
+{
+private:
+	LiveTelemetryHeader* header = nullptr;
+	LiveTelemetrySlot* slots = nullptr;
+	const char* name = nullptr;
+	uint64_t published = 0;
+public:
+	LiveTelemetryPublisher() = default;
+	LiveTelemetryPublisher(const LiveTelemetryPublisher&) = delete;
+	LiveTelemetryPublisher& operator=(const LiveTelemetryPublisher&) = delete;
+	~LiveTelemetryPublisher() { Close(); }
+
+	// Creates the object called object_name afresh, so that readers attached to an older one see it closed
+	bool Open(const char* object_name)
+	{
+		Close();
+		shm_unlink(object_name);
+		const auto fd = shm_open(object_name, O_CREAT | O_EXCL | O_RDWR, 0644);
+		if (fd < 0) return false;
+		auto* mapping = ftruncate(fd, live_telemetry_size) == 0
+			? mmap(nullptr, live_telemetry_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+		close(fd);
+		if (mapping == MAP_FAILED)
+		{
+			shm_unlink(object_name);
+			return false;
+		}
+		name = object_name;
+		header = static_cast<LiveTelemetryHeader*>(mapping);
+		slots = reinterpret_cast<LiveTelemetrySlot*>(header + 1);
+		memcpy(header->magic, "FBWL", 4);
+		header->version = live_telemetry_version;
+		header->frame_size = sizeof(LiveFrame);
+		header->capacity = live_telemetry_capacity;
+		header->published.store(0, std::memory_order_relaxed);
+		header->publishing.store(1, std::memory_order_release);
+		published = 0;
+		return true;
+	}
+
+	uint64_t Published() const { return published; }
+
+	void Publish(const LiveFrame& frame)
+	{
+		auto& slot = slots[published & (live_telemetry_capacity - 1)];
+		slot.sequence.store(2 * published + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		memcpy(&slot.frame, &frame, sizeof(LiveFrame));
+		slot.sequence.store(2 * published + 2, std::memory_order_release);
+		header->published.store(++published, std::memory_order_release);
+	}
+
+	// Tells the readers there is no more to come, and removes the object; readers keep what they mapped
+	void Close()
+	{
+		if (!header) return;
+		header->publishing.store(0, std::memory_order_release);
+		munmap(header, live_telemetry_size);
+		shm_unlink(name);
+		header = nullptr;
+		slots = nullptr;
+	}
+};
+
+// Tails the frames of a publisher, from any thread or process
+class LiveTelemetryReader
+{
+private:
+	const LiveTelemetryHeader* header = nullptr;
+	const LiveTelemetrySlot* slots = nullptr;
+	uint64_t next = 0; // The next frame to read
+	uint64_t lost = 0;
+public:
+	LiveTelemetryReader() = default;
+	LiveTelemetryReader(const LiveTelemetryReader&) = delete;
+	LiveTelemetryReader& operator=(const LiveTelemetryReader&) = delete;
+	~LiveTelemetryReader() { Close(); }
+
+	// Attaches to the object called object_name, from its oldest frame still in the ring or from the next one published
+	bool Open(const char* object_name, const bool from_oldest)
+	{
+		Close();
+		const auto fd = shm_open(object_name, O_RDONLY, 0);
+		if (fd < 0) return false;
+		auto* mapping = mmap(nullptr, live_telemetry_size, PROT_READ, MAP_SHARED, fd, 0);
+		close(fd);
+		if (mapping == MAP_FAILED) return false;
+		header = static_cast<const LiveTelemetryHeader*>(mapping);
+		if (memcmp(header->magic, "FBWL", 4) != 0 || header->version != live_telemetry_version || header->frame_size != sizeof(LiveFrame)
+			|| header->capacity != live_telemetry_capacity)
+		{
+			Close();
+			return false;
+		}
+		slots = reinterpret_cast<const LiveTelemetrySlot*>(header + 1);
+		const auto published = header->published.load(std::memory_order_acquire);
+		next = from_oldest ? (published > live_telemetry_capacity ? published - live_telemetry_capacity : 0) : published;
+		lost = 0;
+		return true;
+	}
+
+	// Frames that were overwritten before they were read
+	uint64_t Lost() const { return lost; }
+	// False once the publisher has closed and every frame it published was read or lost
+	bool Live() const
+	{
+		return header->publishing.load(std::memory_order_acquire) != 0 || next < header->published.load(std::memory_order_acquire);
+	}
+
+	// Hands every frame published since the last call to consume(const LiveFrame&), up to max_frames; returns the
+	// number handed over
+	template <typename Consume>
+	uint64_t Poll(Consume consume, const uint64_t max_frames = UINT64_MAX)
+	{
+		const auto published = header->published.load(std::memory_order_acquire);
+		if (published - next > live_telemetry_capacity)
+		{
+			lost += published - live_telemetry_capacity - next;
+			next = published - live_telemetry_capacity;
+		}
+		uint64_t read = 0;
+		LiveFrame frame;
+		for (; next < published && read < max_frames; next++)
+		{
+			const auto& slot = slots[next & (live_telemetry_capacity - 1)];
+			const auto written = 2 * next + 2;
+			if (slot.sequence.load(std::memory_order_acquire) != written)
+			{
+				lost++; // Overwritten by a later frame, or being
+				continue;
+			}
+			memcpy(&frame, &slot.frame, sizeof(LiveFrame));
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (slot.sequence.load(std::memory_order_relaxed) != written)
+			{
+				lost++;
+				continue;
+			}
+			consume(frame);
+			read++;
+		}
+		return read;
+	}
+
+	void Close()
+	{
+		if (header) munmap(const_cast<LiveTelemetryHeader*>(header), live_telemetry_size);
+		header = nullptr;
+		slots = nullptr;
+	}
+};
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+// Read-only memory mapping of a whole file, for the host tools that read recordings and traces
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+
+class MappedFile
+{
+private:
+	const char* data = nullptr;
+	size_t size = 0;
+public:
+	MappedFile() = default;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	~MappedFile() { Close(); }
+
+	// Maps the file at path; returns false if it cannot be opened or mapped. An empty file maps to no data.
+	bool Open(const char* path)
+	{
+		Close();
+		const auto fd = open(path, O_RDONLY);
+		if (fd < 0) return false;
+		struct stat status;
+		auto ok = fstat(fd, &status) == 0;
+		if (ok && status.st_size > 0)
+		{
+			auto* mapping = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			ok = mapping != MAP_FAILED;
+			if (ok)
+			{
+				madvise(mapping, status.st_size, MADV_SEQUENTIAL);
+				data = static_cast<const char*>(mapping);
+				size = status.st_size;
+			}
+		}
+		close(fd);
+		return ok;
+	}
+
+	void Close()
+	{
+		if (data) munmap(const_cast<char*>(data), size);
+		data = nullptr;
+		size = 0;
+	}
+
+	const char* Data() const { return data; }
+	size_t Size() const { return size; }
+};
\ No newline at end of file
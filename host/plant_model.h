@@ -0,0 +1,343 @@
+#pragma once
+// Stand-in for the simulator's flight model, so the control laws can be flown closed loop on the host
+
+#include <array>
+#include <cmath>
+
+#include "../aircraft_data.h"
+#include "../controls.h"
+#include "aero_data.h"
+
+// Where the plant starts; the aircraft is trimmed for level flight at this speed and altitude
+struct PlantInitialConditions
+{
+	double ias = 250; // Knots
+	double altitude = 10000; // Feet above the ground
+	int flaps = 0; // Flaps handle index (0 = Clean CONF, 4 = CONF FULL)
+	double pitch = 0; // Pitch attitude offset from the trimmed attitude in degrees (+ is up)
+	double bank = 0; // Degrees (+ is right)
+	double vmo = 350; // Knots
+	double mmo = 0.82; // Mach
+	double weight = 64000; // Kilograms
+};
+
+// Rigid-body (six degrees of freedom) A320 model over a flat earth, integrated with fourth-order Runge-Kutta.
+// The aerodynamic coefficients are interpolated in the tables of aero_data.h. The FBW does not command the thrust or
+// the stabilizer yet, so both are set to trim the initial conditions and held. There is no ground model.
+class PlantModel
+{
+private:
+	static constexpr double g = 32.174; // Feet/second^2
+	static constexpr double kts = 1.68781; // Feet/second per knot
+	static constexpr double wing_area = 1319.7; // Feet^2
+	static constexpr double chord = 13.75; // Mean aerodynamic chord in feet
+	static constexpr double span = 111.9; // Feet
+	// Moments of inertia in slug feet^2
+	static constexpr double ixx = 0.66e6;
+	static constexpr double iyy = 2.0e6;
+	static constexpr double izz = 2.6e6;
+	static constexpr double ixz = 0.03e6;
+
+	enum STATE_INDEX
+	{
+		NORTH, EAST, ALTITUDE, // Feet
+		U, V, W, // Body velocity in feet/second (+ is forward, right, down)
+		Q0, Q1, Q2, Q3, // Attitude quaternion, body to north-east-down axes
+		P, Q, R, // Body rates in radians/second (+ is right wing down, nose up, nose right)
+		STATE_SIZE
+	};
+	using State = std::array<double, STATE_SIZE>;
+
+	// Everything derived from a state that the equations of motion and the sample need
+	struct Flight
+	{
+		double rotation[3][3]; // Body to north-east-down axes
+		double airspeed; // True airspeed in feet/second
+		double alpha; // Radians
+		double beta; // Radians
+		double density_ratio;
+		double mach;
+		double force[3]; // Aerodynamic body force in pounds, without thrust and gravity
+		double moment[3]; // Aerodynamic body moment in foot-pounds
+	};
+
+	State state = {};
+	CONTROL_SURFACES_DATA surfaces; // Held through each step
+	int flaps = 0;
+	double weight = 64000; // Kilograms
+	double mass = 64000 * 2.20462 / g; // Slugs
+	double stabilizer = 0; // Pitching moment coefficient of the trimmed stabilizer
+	double thrust = 0; // Pounds, along the body axis
+	double vmo = 0;
+	double mmo = 0;
+
+	// International Standard Atmosphere up to 65617 feet
+	static double DensityRatio(const double altitude)
+	{
+		const auto h = fmax(altitude, 0);
+		return h < 36089 ? pow(1 - 6.8756e-6 * h, 4.2559) : 0.29708 * exp(-(h - 36089) / 20806.7);
+	}
+	static double SpeedOfSound(const double altitude)
+	{
+		return 661.47 * kts * sqrt(1 - 6.8756e-6 * fmin(fmax(altitude, 0), 36089));
+	}
+
+	// Lift, drag and pitching moment coefficients at alpha (degrees) and mach, by interpolation in the tables
+	void Coefficients(const double alpha, const double mach, double& lift, double& drag, double& pitching_moment) const
+	{
+		const auto cell = [](const double* breakpoints, const int count, const double value, int& index, double& fraction)
+		{
+			index = 0;
+			while (index < count - 2 && value > breakpoints[index + 1]) index++;
+			fraction = clamp((value - breakpoints[index]) / (breakpoints[index + 1] - breakpoints[index]), 0, 1);
+		};
+		int a, m;
+		double fa, fm;
+		cell(aero::alpha_breakpoints, aero::alpha_count, alpha, a, fa);
+		cell(aero::mach_breakpoints, aero::mach_count, mach, m, fm);
+		const auto bilinear = [a, m, fa, fm](const double (&table)[aero::mach_count][aero::alpha_count])
+		{
+			const auto low = table[m][a] + (table[m][a + 1] - table[m][a]) * fa;
+			const auto high = table[m + 1][a] + (table[m + 1][a + 1] - table[m + 1][a]) * fa;
+			return low + (high - low) * fm;
+		};
+		lift = bilinear(aero::lift[flaps]);
+		drag = bilinear(aero::drag[flaps]);
+		pitching_moment = bilinear(aero::pitching_moment[flaps]);
+	}
+
+	Flight Evaluate(const State& s) const
+	{
+		Flight flight;
+		const auto q0 = s[Q0], q1 = s[Q1], q2 = s[Q2], q3 = s[Q3];
+		flight.rotation[0][0] = q0 * q0 + q1 * q1 - q2 * q2 - q3 * q3;
+		flight.rotation[0][1] = 2 * (q1 * q2 - q0 * q3);
+		flight.rotation[0][2] = 2 * (q1 * q3 + q0 * q2);
+		flight.rotation[1][0] = 2 * (q1 * q2 + q0 * q3);
+		flight.rotation[1][1] = q0 * q0 - q1 * q1 + q2 * q2 - q3 * q3;
+		flight.rotation[1][2] = 2 * (q2 * q3 - q0 * q1);
+		flight.rotation[2][0] = 2 * (q1 * q3 - q0 * q2);
+		flight.rotation[2][1] = 2 * (q2 * q3 + q0 * q1);
+		flight.rotation[2][2] = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
+
+		flight.airspeed = fmax(sqrt(s[U] * s[U] + s[V] * s[V] + s[W] * s[W]), 1.0);
+		flight.alpha = atan2(s[W], s[U]);
+		flight.beta = asin(clamp(s[V] / flight.airspeed, -1, 1));
+		flight.density_ratio = DensityRatio(s[ALTITUDE]);
+		flight.mach = flight.airspeed / SpeedOfSound(s[ALTITUDE]);
+
+		// Control deflections in radians
+		const auto elevator = radians(surfaces.elevator * (surfaces.elevator >= 0 ? aero::elevator_up : aero::elevator_down));
+		const auto aileron = radians(surfaces.ailerons * aero::aileron_travel);
+		const auto rudder = radians(surfaces.rudder * aero::rudder_travel);
+		// Nondimensional rates
+		const auto roll_rate = s[P] * span / (2 * flight.airspeed);
+		const auto pitch_rate = s[Q] * chord / (2 * flight.airspeed);
+		const auto yaw_rate = s[R] * span / (2 * flight.airspeed);
+
+		double lift, drag, pitching_moment;
+		Coefficients(degrees(flight.alpha), flight.mach, lift, drag, pitching_moment);
+		lift += aero::lift_pitch_rate * pitch_rate + aero::lift_elevator * elevator;
+		drag += aero::drag_sideslip * flight.beta * flight.beta;
+		pitching_moment += aero::pitch_rate_damping * pitch_rate + aero::pitch_elevator * elevator + stabilizer;
+		const auto side_force = aero::side_force_sideslip * flight.beta + aero::side_force_rudder * rudder;
+		const auto rolling_moment = aero::roll_sideslip * flight.beta + aero::roll_rate_damping * roll_rate
+			+ aero::roll_yaw_rate * yaw_rate + aero::roll_aileron * aileron + aero::roll_rudder * rudder;
+		const auto yawing_moment = aero::yaw_sideslip * flight.beta + aero::yaw_roll_rate * roll_rate
+			+ aero::yaw_rate_damping * yaw_rate + aero::yaw_aileron * aileron + aero::yaw_rudder * rudder;
+
+		const auto pressure = 0.5 * 0.0023769 * flight.density_ratio * flight.airspeed * flight.airspeed * wing_area;
+		const auto cos_alpha = cos(flight.alpha), sin_alpha = sin(flight.alpha);
+		flight.force[0] = pressure * (lift * sin_alpha - drag * cos_alpha);
+		flight.force[1] = pressure * side_force;
+		flight.force[2] = pressure * (-lift * cos_alpha - drag * sin_alpha);
+		flight.moment[0] = pressure * span * rolling_moment;
+		flight.moment[1] = pressure * chord * pitching_moment;
+		flight.moment[2] = pressure * span * yawing_moment;
+		return flight;
+	}
+
+	State Derivative(const State& s) const
+	{
+		const auto flight = Evaluate(s);
+		const auto& rotation = flight.rotation;
+		const auto p = s[P], q = s[Q], r = s[R];
+		State d;
+
+		// Position in north-east-down axes, kept as altitude
+		d[NORTH] = rotation[0][0] * s[U] + rotation[0][1] * s[V] + rotation[0][2] * s[W];
+		d[EAST] = rotation[1][0] * s[U] + rotation[1][1] * s[V] + rotation[1][2] * s[W];
+		d[ALTITUDE] = -(rotation[2][0] * s[U] + rotation[2][1] * s[V] + rotation[2][2] * s[W]);
+
+		// Translation; the last row of the rotation is the down axis in body axes
+		d[U] = r * s[V] - q * s[W] + (flight.force[0] + thrust) / mass + g * rotation[2][0];
+		d[V] = p * s[W] - r * s[U] + flight.force[1] / mass + g * rotation[2][1];
+		d[W] = q * s[U] - p * s[V] + flight.force[2] / mass + g * rotation[2][2];
+
+		// Attitude
+		d[Q0] = -0.5 * (p * s[Q1] + q * s[Q2] + r * s[Q3]);
+		d[Q1] = 0.5 * (p * s[Q0] + r * s[Q2] - q * s[Q3]);
+		d[Q2] = 0.5 * (q * s[Q0] - r * s[Q1] + p * s[Q3]);
+		d[Q3] = 0.5 * (r * s[Q0] + q * s[Q1] - p * s[Q2]);
+
+		// Rotation, with the product of inertia in the plane of symmetry
+		constexpr auto gamma = ixx * izz - ixz * ixz;
+		const auto l = flight.moment[0], m = flight.moment[1], n = flight.moment[2];
+		d[P] = (((iyy - izz) * izz - ixz * ixz) * r * q + (ixx - iyy + izz) * ixz * p * q + izz * l + ixz * n) / gamma;
+		d[Q] = ((izz - ixx) * p * r - ixz * (p * p - r * r) + m) / iyy;
+		d[R] = ((ixx * (ixx - iyy) + ixz * ixz) * p * q - (ixx - iyy + izz) * ixz * r * q + ixz * l + ixx * n) / gamma;
+		return d;
+	}
+
+	static State Advance(const State& s, const State& d, const double h)
+	{
+		State result;
+		for (auto i = 0; i < STATE_SIZE; i++) result[i] = s[i] + d[i] * h;
+		return result;
+	}
+public:
+	void Reset(const PlantInitialConditions& initial)
+	{
+		flaps = static_cast<int>(clamp(initial.flaps, 0, aero::flap_count - 1));
+		weight = initial.weight;
+		mass = weight * 2.20462 / g;
+		vmo = initial.vmo;
+		mmo = initial.mmo;
+		surfaces = CONTROL_SURFACES_DATA();
+		stabilizer = 0;
+		thrust = 0;
+
+		// Trim the angle of attack for a level turn at the requested bank, without going past the lift peak
+		const auto altitude = initial.altitude;
+		const auto airspeed = initial.ias * kts / sqrt(DensityRatio(altitude));
+		const auto mach = airspeed / SpeedOfSound(altitude);
+		const auto bank = radians(clamp(initial.bank, -80, 80));
+		const auto pressure = 0.5 * 0.0023769 * DensityRatio(altitude) * airspeed * airspeed * wing_area;
+		// The thrust is along the body axis, so with the body at alpha the part of the drag it balances pushes down
+		// by drag * tan(alpha), which the lift has to carry as well
+		const auto required_lift = mass * g / cos(bank) / pressure;
+		double lift, drag, pitching_moment;
+		const auto excess_lift = [&](const double alpha)
+		{
+			Coefficients(alpha, mach, lift, drag, pitching_moment);
+			return lift + drag * tan(radians(alpha)) - required_lift;
+		};
+		auto low = aero::alpha_breakpoints[0], high = low;
+		for (auto alpha = low, peak = -1e9; alpha <= aero::alpha_breakpoints[aero::alpha_count - 1]; alpha += 0.25)
+		{
+			const auto excess = excess_lift(alpha);
+			if (excess <= peak) break;
+			peak = excess;
+			high = alpha;
+		}
+		for (auto i = 0; i < 50; i++)
+		{
+			const auto alpha = (low + high) / 2;
+			(excess_lift(alpha) < 0 ? low : high) = alpha;
+		}
+		const auto alpha = radians((low + high) / 2);
+
+		// Attitude and body rates of the steady turn, offset in pitch
+		const auto theta = alpha + radians(initial.pitch);
+		const auto turn_rate = g * tan(bank) / airspeed;
+		const auto cos_phi = cos(bank / 2), sin_phi = sin(bank / 2), cos_theta = cos(theta / 2), sin_theta = sin(theta / 2);
+		state = {};
+		state[ALTITUDE] = altitude;
+		state[U] = airspeed * cos(alpha);
+		state[W] = airspeed * sin(alpha);
+		state[Q0] = cos_phi * cos_theta;
+		state[Q1] = sin_phi * cos_theta;
+		state[Q2] = cos_phi * sin_theta;
+		state[Q3] = -sin_phi * sin_theta;
+		state[P] = -turn_rate * sin(theta);
+		state[Q] = turn_rate * sin(bank) * cos(theta);
+		state[R] = turn_rate * cos(bank) * cos(theta);
+
+		// Trim the stabilizer for no pitching moment, and the thrust to hold the speed in level flight
+		const auto flight = Evaluate(state);
+		stabilizer = -flight.moment[1] / (pressure * chord);
+		thrust = -flight.force[0] + mass * g * sin(alpha);
+	}
+
+	// The lift coefficient at alpha (degrees) and mach with the flaps of the last Reset, with the controls neutral and
+	// without rotation
+	double LiftCoefficient(const double alpha, const double mach) const
+	{
+		double lift, drag, pitching_moment;
+		Coefficients(alpha, mach, lift, drag, pitching_moment);
+		return lift;
+	}
+
+	// Advances the plant by dt with the surfaces held
+	void Step(const CONTROL_SURFACES_DATA& control_surfaces, const double dt)
+	{
+		surfaces.elevator = clamp(control_surfaces.elevator, -1, 1);
+		surfaces.ailerons = clamp(control_surfaces.ailerons, -1, 1);
+		surfaces.rudder = clamp(control_surfaces.rudder, -1, 1);
+
+		const auto k1 = Derivative(state);
+		const auto k2 = Derivative(Advance(state, k1, dt / 2));
+		const auto k3 = Derivative(Advance(state, k2, dt / 2));
+		const auto k4 = Derivative(Advance(state, k3, dt));
+		for (auto i = 0; i < STATE_SIZE; i++) state[i] += (k1[i] + 2 * k2[i] + 2 * k3[i] + k4[i]) * dt / 6;
+
+		const auto norm = sqrt(state[Q0] * state[Q0] + state[Q1] * state[Q1] + state[Q2] * state[Q2] + state[Q3] * state[Q3]);
+		for (auto i = int(Q0); i <= Q3; i++) state[i] /= norm;
+	}
+
+	// The plant state as the simulator would report it
+	AircraftDataSample Sample() const
+	{
+		const auto flight = Evaluate(state);
+		const auto& rotation = flight.rotation;
+		AircraftDataSample sample;
+		sample.altitude = state[ALTITUDE];
+		sample.aoa = degrees(flight.alpha);
+		sample.flaps = flaps;
+		// Normal load factor: the specific force along the body's down axis, to which thrust does not contribute
+		sample.gforce = -flight.force[2] / (mass * g);
+		sample.ias = flight.airspeed * sqrt(flight.density_ratio) / kts;
+		sample.lateral_speed = rotation[0][0] * state[U] + rotation[0][1] * state[V] + rotation[0][2] * state[W];
+		sample.longitudinal_speed = rotation[1][0] * state[U] + rotation[1][1] * state[V] + rotation[1][2] * state[W];
+		sample.mach = flight.mach;
+		sample.mmo = mmo;
+		sample.on_ground = state[ALTITUDE] <= 0;
+		sample.pitch = degrees(asin(clamp(rotation[2][0], -1, 1))); // The simulator reports nose up as negative
+		sample.radio_height = fmax(state[ALTITUDE], 0);
+		sample.roll = -degrees(atan2(rotation[2][1], rotation[2][2])); // The simulator reports right bank as negative
+		sample.vertical_speed = -(rotation[2][0] * state[U] + rotation[2][1] * state[V] + rotation[2][2] * state[W]);
+		sample.vmo = vmo;
+		sample.weight = weight * 2.20462;
+
+		// Rotation in the simulator's body axes (+ is nose down, nose right)
+		sample.pitch_velocity = -degrees(state[Q]);
+		sample.yaw_velocity = degrees(state[R]);
+		// Acceleration relative to the earth: the specific force and gravity, in north-east-down axes
+		const double acceleration[3] = {
+			(flight.force[0] + thrust) / mass + g * rotation[2][0],
+			flight.force[1] / mass + g * rotation[2][1],
+			flight.force[2] / mass + g * rotation[2][2] };
+		sample.lateral_acceleration = rotation[0][0] * acceleration[0] + rotation[0][1] * acceleration[1] + rotation[0][2] * acceleration[2];
+		sample.longitudinal_acceleration = rotation[1][0] * acceleration[0] + rotation[1][1] * acceleration[1] + rotation[1][2] * acceleration[2];
+		sample.vertical_acceleration = -(rotation[2][0] * acceleration[0] + rotation[2][1] * acceleration[1] + rotation[2][2] * acceleration[2]);
+		return sample;
+	}
+
+	// The true rates of the pitch attitude and the vertical flight path angle, in degrees/second (+ is up)
+	double PitchRate() const
+	{
+		const auto flight = Evaluate(state);
+		const auto& rotation = flight.rotation;
+		const auto cos_pitch = sqrt(fmax(1 - rotation[2][0] * rotation[2][0], 1e-12));
+		const auto sin_bank = rotation[2][1] / cos_pitch, cos_bank = rotation[2][2] / cos_pitch;
+		return degrees(state[Q] * cos_bank - state[R] * sin_bank);
+	}
+	double FlightPathRate() const
+	{
+		const auto sample = Sample();
+		const auto horizontal_speed = sqrt(sample.lateral_speed * sample.lateral_speed + sample.longitudinal_speed * sample.longitudinal_speed);
+		const auto horizontal_acceleration = (sample.lateral_speed * sample.lateral_acceleration + sample.longitudinal_speed * sample.longitudinal_acceleration) / horizontal_speed;
+		return degrees((horizontal_speed * sample.vertical_acceleration - sample.vertical_speed * horizontal_acceleration)
+			/ (horizontal_speed * horizontal_speed + sample.vertical_speed * sample.vertical_speed));
+	}
+};
\ No newline at end of file
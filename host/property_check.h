@@ -0,0 +1,72 @@
+#pragma once
+// Property-based checking for host tools: a property is checked over many randomly generated cases on every core, and
+// the first case it fails on is shrunk to a simpler one that still fails
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+#include "thread_pool.h"
+
+// The case a property failed on, and the simplest case found that fails it the same way
+template <typename Case>
+struct Counterexample
+{
+	uint64_t index = 0; // Of the first case that failed
+	Case original;
+	Case shrunk;
+	const char* violation = nullptr; // What the shrunk case violates
+	int shrink_steps = 0; // Simpler failing cases adopted on the way from original to shrunk
+};
+
+// Generates cases count times from seed, each with generate(random, case), and checks them with check(case), which
+// returns nullptr if the case holds and otherwise a description of what it violates.
+// The cases are spread over the pool in chunks. Each case gets its own generator, seeded from seed and its index, so
+// the lowest failing index and its case do not depend on the number of threads. A failing case is then shrunk on the
+// calling thread: shrink(case, offer) offers simpler variants of the case, simplest first, by calling offer(variant),
+// which returns true when the variant fails the same way and was adopted, at which point shrink should return.
+// Shrinking starts over from every adopted variant until none is, or until max_shrink_steps were adopted.
+// Returns true if every case held; otherwise fills counterexample.
+template <typename Case, typename Generate, typename Check, typename Shrink>
+bool CheckProperty(ThreadPool& pool, const uint64_t count, const uint64_t seed, Generate generate, Check check, Shrink shrink,
+	Counterexample<Case>& counterexample, const int max_shrink_steps = 10000)
+{
+	std::atomic<uint64_t> first_failure = { count };
+	pool.ParallelFor(count, 4096, [&](const size_t index)
+	{
+		// Cases after a known failure cannot be the first one
+		if (index > first_failure.load(std::memory_order_relaxed)) return;
+		std::mt19937_64 random(seed * 0x9E3779B97F4A7C15ull + index);
+		Case candidate;
+		generate(random, candidate);
+		if (!check(candidate)) return;
+		auto known = first_failure.load();
+		while (index < known && !first_failure.compare_exchange_weak(known, index)) {}
+	});
+	if (first_failure == count) return true;
+
+	counterexample.index = first_failure;
+	std::mt19937_64 random(seed * 0x9E3779B97F4A7C15ull + counterexample.index);
+	generate(random, counterexample.original);
+	counterexample.shrunk = counterexample.original;
+	counterexample.violation = check(counterexample.original);
+	counterexample.shrink_steps = 0;
+
+	auto adopted = true;
+	while (adopted && counterexample.shrink_steps < max_shrink_steps)
+	{
+		adopted = false;
+		const auto current = counterexample.shrunk;
+		shrink(current, [&](const Case& variant)
+		{
+			const char* violation = check(variant);
+			if (!violation || strcmp(violation, counterexample.violation) != 0) return false;
+			counterexample.shrunk = variant;
+			counterexample.shrink_steps++;
+			adopted = true;
+			return true;
+		});
+	}
+	return false;
+}
\ No newline at end of file
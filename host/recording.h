@@ -0,0 +1,109 @@
+#pragma once
+// Reads the recordings written by FlightRecorder (see recorder.h) straight from a memory mapping
+
+#include <cstring>
+#include <string>
+
+#include "../recorder.h"
+#include "mapped_file.h"
+
+// One recorded frame: the input events to apply to the instance's InputCapture, then the Update() arguments
+struct RecordedFrame
+{
+	double t;
+	double dt;
+	AircraftDataSample sample;
+	const uint32_t* event_ids;
+	const int32_t* event_data;
+	uint32_t event_count;
+};
+
+class RecordingReader
+{
+private:
+	MappedFile file;
+public:
+	bool Open(const char* path) { return file.Open(path); }
+	size_t Size() const { return file.Size(); }
+
+	// Calls on_session(const RecordingHeader&) at the start of every session and on_frame(const RecordedFrame&) for
+	// every frame. Returns false, with the reason in error, if the recording is malformed; a trailing partial block
+	// (from a gauge that did not shut down cleanly) is ignored.
+	template <typename OnSession, typename OnFrame>
+	bool Read(OnSession on_session, OnFrame on_frame, std::string& error) const
+	{
+		const auto* data = file.Data();
+		const auto size = file.Size();
+		size_t offset = 0;
+		auto in_session = false;
+		while (offset + 4 <= size)
+		{
+			const auto* magic = data + offset;
+			if (memcmp(magic, "FBWR", 4) == 0)
+			{
+				if (offset + sizeof(RecordingHeader) > size) return true;
+				RecordingHeader header;
+				memcpy(&header, magic, sizeof(header));
+				if (header.version != recording_version || header.simvar_count != aircraft_simvar_count)
+				{
+					error = "unsupported recording version " + std::to_string(header.version) + " with " + std::to_string(header.simvar_count) + " simvars";
+					return false;
+				}
+				on_session(header);
+				in_session = true;
+				offset += sizeof(header);
+			}
+			else if (memcmp(magic, "FBWB", 4) == 0 && in_session)
+			{
+				if (offset + sizeof(RecordingBlockHeader) > size) return true;
+				RecordingBlockHeader header;
+				memcpy(&header, magic, sizeof(header));
+				if (header.frame_count > recording_block_frames || header.event_count > recording_block_events
+					|| header.size != RecordingBlockSize(header.frame_count, header.event_count))
+				{
+					error = "corrupt block at offset " + std::to_string(offset);
+					return false;
+				}
+				if (offset + header.size > size) return true;
+
+				// Columns start 8-byte aligned, as the mapping and every header size are multiples of 8
+				const auto frames = header.frame_count;
+				const auto* column = reinterpret_cast<const double*>(magic + sizeof(header));
+				const auto* frame_events = reinterpret_cast<const uint32_t*>(column + (2 + aircraft_simvar_count) * frames);
+				const auto* event_ids = reinterpret_cast<const uint32_t*>(reinterpret_cast<const char*>(frame_events)
+					+ frames * sizeof(uint32_t) + RecordingPadding(frames * sizeof(uint32_t)));
+				const auto* event_data = reinterpret_cast<const int32_t*>(reinterpret_cast<const char*>(event_ids)
+					+ header.event_count * sizeof(uint32_t) + RecordingPadding(header.event_count * sizeof(uint32_t)));
+
+				RecordedFrame frame;
+				uint32_t event = 0;
+				for (uint32_t i = 0; i < frames; i++)
+				{
+					frame.t = column[i];
+					frame.dt = column[frames + i];
+					for (size_t simvar = 0; simvar < aircraft_simvar_count; simvar++)
+					{
+						frame.sample.*aircraft_simvars[simvar].field = column[(2 + simvar) * frames + i];
+					}
+					frame.event_count = frame_events[i];
+					if (event + frame.event_count > header.event_count)
+					{
+						error = "corrupt event counts at offset " + std::to_string(offset);
+						return false;
+					}
+					frame.event_ids = event_ids + event;
+					frame.event_data = event_data + event;
+					event += frame.event_count;
+					on_frame(frame);
+				}
+				offset += header.size;
+			}
+			else
+			{
+				error = "unexpected data at offset " + std::to_string(offset);
+				return false;
+			}
+		}
+		return true;
+	}
+};
\ No newline at end of file
@@ -0,0 +1,170 @@
+#pragma once
+// Randomized closed-loop scenarios for the host tools
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+
+#include "plant_model.h"
+
+// What the pilot does with the sidestick during a scenario
+enum SIDESTICK_PROFILE
+{
+	PROFILE_NEUTRAL, // Hands off
+	PROFILE_STEP, // Held deflection after the start time
+	PROFILE_DOUBLET, // Deflection one way, then the other way, then neutral
+	PROFILE_SINE, // Continuous oscillation
+	PROFILE_FULL_BACK, // Full back stick held, with the lateral deflection, to probe the protections
+	PROFILE_COUNT
+};
+
+constexpr const char* sidestick_profile_names[PROFILE_COUNT] = { "neutral", "step", "doublet", "sine", "fullback" };
+
+struct Scenario
+{
+	PlantInitialConditions initial;
+	SIDESTICK_PROFILE profile = PROFILE_NEUTRAL;
+	double pitch_amplitude = 0; // Sidestick deflection (-1 to +1, + is back)
+	double roll_amplitude = 0; // Sidestick deflection (-1 to +1, + is right)
+	double start = 0; // Seconds after the controls are handed over
+	double period = 4; // Seconds
+
+	// Sidestick position (pitch, roll) at time t since the controls were handed over
+	void Sidestick(const double t, double& pitch, double& roll) const
+	{
+		auto shape = 0.0;
+		if (t >= start)
+		{
+			const auto phase = (t - start) / period;
+			switch (profile)
+			{
+			case PROFILE_STEP:
+			case PROFILE_FULL_BACK: shape = 1; break;
+			case PROFILE_DOUBLET: shape = phase < 0.5 ? 1 : phase < 1 ? -1 : 0; break;
+			case PROFILE_SINE: shape = sin(2 * M_PI * phase); break;
+			default: break;
+			}
+		}
+		pitch = profile == PROFILE_FULL_BACK ? (t >= start ? 1.0 : 0.0) : pitch_amplitude * shape;
+		roll = roll_amplitude * shape;
+	}
+};
+
+// Each parameter is drawn uniformly from [min, max]; the flaps index is drawn from the integers in its range
+struct ScenarioRange
+{
+	double min;
+	double max;
+};
+
+struct ScenarioDistribution
+{
+	ScenarioRange ias = { 140, 340 };
+	ScenarioRange altitude = { 3000, 37000 };
+	ScenarioRange flaps = { 0, 4 };
+	ScenarioRange pitch = { -5, 10 };
+	ScenarioRange bank = { -45, 45 };
+	ScenarioRange vmo = { 350, 350 };
+	ScenarioRange mmo = { 0.82, 0.82 };
+	ScenarioRange pitch_amplitude = { -1, 1 };
+	ScenarioRange roll_amplitude = { -1, 1 };
+	ScenarioRange start = { 0, 5 };
+	ScenarioRange period = { 2, 10 };
+	bool profiles[PROFILE_COUNT] = { true, true, true, true, true };
+
+	// Reads "name min max" lines (and "profiles name...") over the defaults; # starts a comment.
+	// Returns false, with the offending line in error, if the file cannot be read or parsed.
+	bool Load(const char* path, std::string& error)
+	{
+		auto* file = fopen(path, "r");
+		if (!file)
+		{
+			error = std::string("cannot open ") + path;
+			return false;
+		}
+
+		const struct { const char* name; ScenarioRange* range; } ranges[] = {
+			{ "ias", &ias }, { "altitude", &altitude }, { "flaps", &flaps }, { "pitch", &pitch }, { "bank", &bank },
+			{ "vmo", &vmo }, { "mmo", &mmo }, { "pitch_amplitude", &pitch_amplitude },
+			{ "roll_amplitude", &roll_amplitude }, { "start", &start }, { "period", &period }
+		};
+
+		char line[256];
+		auto ok = true;
+		while (ok && fgets(line, sizeof(line), file))
+		{
+			line[strcspn(line, "#\r\n")] = '\0';
+			char name[64];
+			auto offset = 0;
+			if (sscanf(line, " %63s%n", name, &offset) != 1) continue;
+
+			if (strcmp(name, "profiles") == 0)
+			{
+				for (auto& enabled : profiles) enabled = false;
+				char profile[64];
+				auto consumed = 0;
+				for (auto* rest = line + offset; sscanf(rest, " %63s%n", profile, &consumed) == 1; rest += consumed)
+				{
+					auto found = false;
+					for (auto i = 0; i < PROFILE_COUNT; i++)
+					{
+						if (strcmp(profile, sidestick_profile_names[i]) == 0) profiles[i] = found = true;
+					}
+					ok &= found;
+				}
+			}
+			else
+			{
+				auto found = false;
+				for (const auto& entry : ranges)
+				{
+					if (strcmp(name, entry.name) != 0) continue;
+					found = sscanf(line + offset, " %lf %lf", &entry.range->min, &entry.range->max) == 2
+						&& entry.range->min <= entry.range->max;
+				}
+				ok &= found;
+			}
+			if (!ok) error = std::string("bad line in ") + path + ": " + line;
+		}
+		fclose(file);
+
+		auto any_profile = false;
+		for (const auto enabled : profiles) any_profile |= enabled;
+		if (ok && !any_profile)
+		{
+			error = std::string("no sidestick profile enabled in ") + path;
+			ok = false;
+		}
+		return ok;
+	}
+
+	// Draws scenario number index; the same seed and index always give the same scenario, whichever thread draws it
+	Scenario Draw(const uint64_t seed, const uint64_t index) const
+	{
+		std::mt19937_64 random(seed * 0x9E3779B97F4A7C15ull + index);
+		const auto uniform = [&random](const ScenarioRange& range)
+		{
+			return range.min + (range.max - range.min) * std::uniform_real_distribution<double>(0, 1)(random);
+		};
+
+		Scenario scenario;
+		scenario.initial.ias = uniform(ias);
+		scenario.initial.altitude = uniform(altitude);
+		scenario.initial.flaps = static_cast<int>(floor(uniform({ flaps.min, flaps.max + 0.999 })));
+		scenario.initial.pitch = uniform(pitch);
+		scenario.initial.bank = uniform(bank);
+		scenario.initial.vmo = uniform(vmo);
+		scenario.initial.mmo = uniform(mmo);
+		do
+		{
+			scenario.profile = static_cast<SIDESTICK_PROFILE>(std::uniform_int_distribution<int>(0, PROFILE_COUNT - 1)(random));
+		} while (!profiles[scenario.profile]);
+		scenario.pitch_amplitude = uniform(pitch_amplitude);
+		scenario.roll_amplitude = uniform(roll_amplitude);
+		scenario.start = uniform(start);
+		scenario.period = uniform(period);
+		return scenario;
+	}
+};
\ No newline at end of file
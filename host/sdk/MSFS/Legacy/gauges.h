@@ -0,0 +1,46 @@
+#pragma once
+// Host stand-in for the MSFS SDK's Legacy/gauges.h
+
+#include "../MSFS.h"
+
+typedef UINT32 ENUM;
+typedef SINT32 ID;
+typedef uint64_t FsContext;
+
+enum PANEL_SERVICE
+{
+	PANEL_SERVICE_PRE_QUERY,
+	PANEL_SERVICE_POST_QUERY,
+	PANEL_SERVICE_PRE_INSTALL,
+	PANEL_SERVICE_POST_INSTALL,
+	PANEL_SERVICE_PRE_INITIALIZE,
+	PANEL_SERVICE_POST_INITIALIZE,
+	PANEL_SERVICE_PRE_UPDATE,
+	PANEL_SERVICE_POST_UPDATE,
+	PANEL_SERVICE_PRE_GENERATE,
+	PANEL_SERVICE_POST_GENERATE,
+	PANEL_SERVICE_PRE_DRAW,
+	PANEL_SERVICE_POST_DRAW,
+	PANEL_SERVICE_PRE_KILL,
+	PANEL_SERVICE_POST_KILL,
+};
+
+struct sGaugeDrawData
+{
+	double mx;
+	double my;
+	double t; // Absolute simulation time
+	double dt; // Time elapsed since the last frame
+	int winWidth;
+	int winHeight;
+	int fbWidth;
+	int fbHeight;
+};
+
+ENUM get_aircraft_var_enum(PCSTRINGZ simvar);
+ENUM get_units_enum(PCSTRINGZ unitname);
+FLOAT64 aircraft_varget(ENUM simvar, ENUM units, SINT32 index);
+
+ID register_named_variable(PCSTRINGZ name);
+FLOAT64 get_named_variable_value(ID id);
+void set_named_variable_value(ID id, FLOAT64 value);
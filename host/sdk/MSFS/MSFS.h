@@ -0,0 +1,37 @@
+#pragma once
+// Host stand-in for the MSFS SDK's MSFS.h
+// Only the declarations the FBW gauge uses are provided; see host/sim_host.cpp for the implementations.
+
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define MSFS_CALLBACK
+
+#ifndef TRUE
+#define TRUE 1
+#endif
+#ifndef FALSE
+#define FALSE 0
+#endif
+
+#ifndef CALLBACK
+#define CALLBACK
+#endif
+
+typedef int BOOL;
+typedef uint32_t DWORD;
+typedef int32_t SINT32;
+typedef uint32_t UINT32;
+typedef double FLOAT64;
+typedef long HRESULT;
+typedef void * HANDLE;
+typedef void * HWND;
+typedef const char * LPCSTR;
+typedef const char * PCSTRINGZ;
+
+#define S_OK ((HRESULT)0L)
+#define E_FAIL ((HRESULT)0x80004005L)
+#define SUCCEEDED(hr) (((HRESULT)(hr)) >= 0)
+#define FAILED(hr) (((HRESULT)(hr)) < 0)
@@ -0,0 +1,5 @@
+#pragma once
+// Host stand-in for the MSFS SDK's MSFS_Render.h
+// The FBW gauge does not render anything, so nothing is declared here.
+
+#include "MSFS.h"
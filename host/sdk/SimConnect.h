@@ -0,0 +1,89 @@
+#pragma once
+// Host stand-in for the MSFS SDK's SimConnect.h
+
+#include "MSFS/MSFS.h"
+
+typedef DWORD SIMCONNECT_OBJECT_ID;
+typedef DWORD SIMCONNECT_CLIENT_EVENT_ID;
+typedef DWORD SIMCONNECT_NOTIFICATION_GROUP_ID;
+typedef DWORD SIMCONNECT_DATA_DEFINITION_ID;
+typedef DWORD SIMCONNECT_DATA_REQUEST_ID;
+typedef DWORD SIMCONNECT_DATA_SET_FLAG;
+typedef DWORD SIMCONNECT_DATA_REQUEST_FLAG;
+
+static const DWORD SIMCONNECT_UNUSED = 0xFFFFFFFF;
+static const DWORD SIMCONNECT_OBJECT_ID_USER = 0;
+static const DWORD SIMCONNECT_GROUP_PRIORITY_HIGHEST = 1;
+static const DWORD SIMCONNECT_GROUP_PRIORITY_HIGHEST_MASKABLE = 10000000;
+
+enum SIMCONNECT_RECV_ID
+{
+	SIMCONNECT_RECV_ID_NULL,
+	SIMCONNECT_RECV_ID_EXCEPTION,
+	SIMCONNECT_RECV_ID_OPEN,
+	SIMCONNECT_RECV_ID_QUIT,
+	SIMCONNECT_RECV_ID_EVENT,
+	SIMCONNECT_RECV_ID_EVENT_OBJECT_ADDREMOVE,
+	SIMCONNECT_RECV_ID_EVENT_FILENAME,
+	SIMCONNECT_RECV_ID_EVENT_FRAME,
+	SIMCONNECT_RECV_ID_SIMOBJECT_DATA,
+	SIMCONNECT_RECV_ID_SIMOBJECT_DATA_BYTYPE,
+};
+
+enum SIMCONNECT_DATATYPE
+{
+	SIMCONNECT_DATATYPE_INVALID,
+	SIMCONNECT_DATATYPE_INT32,
+	SIMCONNECT_DATATYPE_INT64,
+	SIMCONNECT_DATATYPE_FLOAT32,
+	SIMCONNECT_DATATYPE_FLOAT64,
+};
+
+enum SIMCONNECT_PERIOD
+{
+	SIMCONNECT_PERIOD_NEVER,
+	SIMCONNECT_PERIOD_ONCE,
+	SIMCONNECT_PERIOD_VISUAL_FRAME,
+	SIMCONNECT_PERIOD_SIM_FRAME,
+	SIMCONNECT_PERIOD_SECOND,
+};
+
+#pragma pack(push, 1)
+struct SIMCONNECT_RECV
+{
+	DWORD dwSize;
+	DWORD dwVersion;
+	DWORD dwID;
+};
+
+struct SIMCONNECT_RECV_EVENT : public SIMCONNECT_RECV
+{
+	DWORD uGroupID;
+	DWORD uEventID;
+	DWORD dwData;
+};
+
+struct SIMCONNECT_RECV_SIMOBJECT_DATA : public SIMCONNECT_RECV
+{
+	DWORD dwRequestID;
+	DWORD dwObjectID;
+	DWORD dwDefineID;
+	DWORD dwFlags;
+	DWORD dwentrynumber;
+	DWORD dwoutof;
+	DWORD dwDefineCount;
+	DWORD dwData; // First DWORD of the packed data definition payload
+};
+#pragma pack(pop)
+
+typedef void (CALLBACK *DispatchProc)(SIMCONNECT_RECV* pData, DWORD cbData, void* pContext);
+
+HRESULT SimConnect_Open(HANDLE* phSimConnect, LPCSTR szName, HWND hWnd, DWORD UserEventWin32, HANDLE hEventHandle, DWORD ConfigIndex);
+HRESULT SimConnect_Close(HANDLE hSimConnect);
+HRESULT SimConnect_CallDispatch(HANDLE hSimConnect, DispatchProc pfcnDispatch, void* pContext);
+HRESULT SimConnect_AddToDataDefinition(HANDLE hSimConnect, SIMCONNECT_DATA_DEFINITION_ID DefineID, const char* DatumName, const char* UnitsName, SIMCONNECT_DATATYPE DatumType = SIMCONNECT_DATATYPE_FLOAT64, float fEpsilon = 0, DWORD DatumID = SIMCONNECT_UNUSED);
+HRESULT SimConnect_RequestDataOnSimObject(HANDLE hSimConnect, SIMCONNECT_DATA_REQUEST_ID RequestID, SIMCONNECT_DATA_DEFINITION_ID DefineID, SIMCONNECT_OBJECT_ID ObjectID, SIMCONNECT_PERIOD Period, SIMCONNECT_DATA_REQUEST_FLAG Flags = 0, DWORD origin = 0, DWORD interval = 0, DWORD limit = 0);
+HRESULT SimConnect_SetDataOnSimObject(HANDLE hSimConnect, SIMCONNECT_DATA_DEFINITION_ID DefineID, SIMCONNECT_OBJECT_ID ObjectID, SIMCONNECT_DATA_SET_FLAG Flags, DWORD ArrayCount, DWORD cbUnitSize, void* pDataSet);
+HRESULT SimConnect_MapClientEventToSimEvent(HANDLE hSimConnect, SIMCONNECT_CLIENT_EVENT_ID EventID, const char* EventName = "");
+HRESULT SimConnect_AddClientEventToNotificationGroup(HANDLE hSimConnect, SIMCONNECT_NOTIFICATION_GROUP_ID GroupID, SIMCONNECT_CLIENT_EVENT_ID EventID, BOOL bMaskable = FALSE);
+HRESULT SimConnect_SetNotificationGroupPriority(HANDLE hSimConnect, SIMCONNECT_NOTIFICATION_GROUP_ID GroupID, DWORD uPriority);
@@ -0,0 +1,368 @@
+#include <cstring>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <MSFS/MSFS.h>
+#include <MSFS/Legacy/gauges.h>
+#include <SimConnect.h>
+
+#include "sim_host.h"
+
+namespace
+{
+	// Like the simulator, names are resolved to enums by searching a string table
+	struct NameTable
+	{
+		std::vector<std::string> names;
+
+		ENUM Resolve(const char* name)
+		{
+			for (size_t i = 0; i < names.size(); i++)
+			{
+				if (strcmp(names[i].c_str(), name) == 0) return static_cast<ENUM>(i);
+			}
+			names.emplace_back(name);
+			return static_cast<ENUM>(names.size() - 1);
+		}
+	};
+
+	struct Datum
+	{
+		int slot; // Slot in the source
+		SIMCONNECT_DATATYPE type;
+	};
+
+	struct Request
+	{
+		SIMCONNECT_DATA_REQUEST_ID request_id;
+		SIMCONNECT_DATA_DEFINITION_ID define_id;
+		SIMCONNECT_OBJECT_ID object_id;
+		SIMCONNECT_PERIOD period;
+	};
+
+	struct MappedEvent
+	{
+		std::string sim_event;
+		SIMCONNECT_CLIENT_EVENT_ID client_event;
+		SIMCONNECT_NOTIFICATION_GROUP_ID group;
+	};
+
+	struct QueuedEvent
+	{
+		size_t mapped_event;
+		DWORD data;
+	};
+
+	TableSimSource default_source;
+	SimSource* source = &default_source;
+
+	NameTable simvar_names;
+	NameTable unit_names;
+	std::map<std::pair<ENUM, ENUM>, int> varget_slots;
+	std::map<SIMCONNECT_DATA_DEFINITION_ID, std::vector<Datum>> definitions;
+	std::vector<Request> requests;
+	std::vector<MappedEvent> mapped_events;
+	std::vector<QueuedEvent> queued_events;
+	std::vector<char> packet;
+
+	NameTable named_variable_names; // LVars
+	std::vector<double> named_variable_values;
+
+	NameTable table_names;
+	std::vector<double> table_values;
+
+	size_t DatumSize(const SIMCONNECT_DATATYPE type)
+	{
+		switch (type)
+		{
+		case SIMCONNECT_DATATYPE_INT32:
+		case SIMCONNECT_DATATYPE_FLOAT32:
+			return 4;
+		default:
+			return 8;
+		}
+	}
+
+	// Of the SIMCONNECT_RECV_SIMOBJECT_DATA packet delivering a data definition, whose payload starts at dwData
+	size_t PacketSize(const std::vector<Datum>& datums)
+	{
+		const auto header_size = sizeof(SIMCONNECT_RECV_SIMOBJECT_DATA) - sizeof(DWORD);
+		auto payload_size = size_t(0);
+		for (const auto& datum : datums) payload_size += DatumSize(datum.type);
+		return header_size + (payload_size > sizeof(DWORD) ? payload_size : sizeof(DWORD));
+	}
+
+	void WriteDatum(char* destination, const Datum& datum)
+	{
+		const auto value = datum.slot < 0 ? 0.0 : source->Read(datum.slot);
+		switch (datum.type)
+		{
+		case SIMCONNECT_DATATYPE_INT32:
+		{
+			const auto converted = static_cast<int32_t>(value);
+			memcpy(destination, &converted, sizeof(converted));
+		}
+		break;
+		case SIMCONNECT_DATATYPE_FLOAT32:
+		{
+			const auto converted = static_cast<float>(value);
+			memcpy(destination, &converted, sizeof(converted));
+		}
+		break;
+		default:
+			memcpy(destination, &value, sizeof(value));
+			break;
+		}
+	}
+
+	double ReadDatum(const char* origin, const Datum& datum)
+	{
+		switch (datum.type)
+		{
+		case SIMCONNECT_DATATYPE_INT32:
+		{
+			int32_t value;
+			memcpy(&value, origin, sizeof(value));
+			return value;
+		}
+		case SIMCONNECT_DATATYPE_FLOAT32:
+		{
+			float value;
+			memcpy(&value, origin, sizeof(value));
+			return value;
+		}
+		default:
+		{
+			double value;
+			memcpy(&value, origin, sizeof(value));
+			return value;
+		}
+		}
+	}
+}
+
+int TableSimSource::Bind(const char* name, const char* units)
+{
+	const auto slot = table_names.Resolve(name);
+	if (slot >= table_values.size()) table_values.resize(slot + 1, 0);
+	return static_cast<int>(slot);
+}
+
+double TableSimSource::Read(const int slot)
+{
+	return table_values[slot];
+}
+
+void TableSimSource::Write(const int slot, const double value)
+{
+	table_values[slot] = value;
+}
+
+void TableSimSource::Set(const char* name, const double value)
+{
+	Write(Bind(name, ""), value);
+}
+
+double TableSimSource::Get(const char* name)
+{
+	return Read(Bind(name, ""));
+}
+
+void SimHostSetSource(SimSource* new_source)
+{
+	source = new_source ? new_source : &default_source;
+	varget_slots.clear();
+}
+
+void SimHostSetVar(const char* name, const double value)
+{
+	default_source.Set(name, value);
+}
+
+double SimHostGetVar(const char* name)
+{
+	return default_source.Get(name);
+}
+
+void SimHostSendEvent(const char* sim_event, const DWORD data)
+{
+	for (size_t i = 0; i < mapped_events.size(); i++)
+	{
+		if (mapped_events[i].sim_event == sim_event)
+		{
+			queued_events.push_back({ i, data });
+		}
+	}
+}
+
+void SimHostReset()
+{
+	simvar_names.names.clear();
+	unit_names.names.clear();
+	varget_slots.clear();
+	definitions.clear();
+	requests.clear();
+	mapped_events.clear();
+	queued_events.clear();
+	named_variable_names.names.clear();
+	named_variable_values.clear();
+}
+
+ENUM get_aircraft_var_enum(PCSTRINGZ simvar)
+{
+	return simvar_names.Resolve(simvar);
+}
+
+ENUM get_units_enum(PCSTRINGZ unitname)
+{
+	return unit_names.Resolve(unitname);
+}
+
+FLOAT64 aircraft_varget(ENUM simvar, ENUM units, SINT32 index)
+{
+	if (simvar >= simvar_names.names.size() || units >= unit_names.names.size()) return 0;
+
+	const auto key = std::make_pair(simvar, units);
+	auto slot = varget_slots.find(key);
+	if (slot == varget_slots.end())
+	{
+		slot = varget_slots.emplace(key, source->Bind(simvar_names.names[simvar].c_str(), unit_names.names[units].c_str())).first;
+	}
+	return slot->second < 0 ? 0 : source->Read(slot->second);
+}
+
+ID register_named_variable(PCSTRINGZ name)
+{
+	const auto id = named_variable_names.Resolve(name);
+	if (id >= named_variable_values.size()) named_variable_values.resize(id + 1, 0);
+	return static_cast<ID>(id);
+}
+
+FLOAT64 get_named_variable_value(ID id)
+{
+	return id >= 0 && static_cast<size_t>(id) < named_variable_values.size() ? named_variable_values[id] : 0;
+}
+
+void set_named_variable_value(ID id, FLOAT64 value)
+{
+	if (id >= 0 && static_cast<size_t>(id) < named_variable_values.size()) named_variable_values[id] = value;
+}
+
+HRESULT SimConnect_Open(HANDLE* phSimConnect, LPCSTR szName, HWND hWnd, DWORD UserEventWin32, HANDLE hEventHandle, DWORD ConfigIndex)
+{
+	static int handle;
+	*phSimConnect = &handle;
+	return S_OK;
+}
+
+HRESULT SimConnect_Close(HANDLE hSimConnect)
+{
+	return S_OK;
+}
+
+HRESULT SimConnect_CallDispatch(HANDLE hSimConnect, DispatchProc pfcnDispatch, void* pContext)
+{
+	// Input events are delivered in the order they were sent
+	for (const auto& queued : queued_events)
+	{
+		const auto& mapped = mapped_events[queued.mapped_event];
+		SIMCONNECT_RECV_EVENT event = {};
+		event.dwSize = sizeof(event);
+		event.dwID = SIMCONNECT_RECV_ID_EVENT;
+		event.uGroupID = mapped.group;
+		event.uEventID = mapped.client_event;
+		event.dwData = queued.data;
+		pfcnDispatch(&event, sizeof(event), pContext);
+	}
+	queued_events.clear();
+
+	// Then every data request that is due, sampled from the source at this instant
+	const auto header_size = sizeof(SIMCONNECT_RECV_SIMOBJECT_DATA) - sizeof(DWORD); // The payload starts at dwData
+	for (auto& request : requests)
+	{
+		if (request.period == SIMCONNECT_PERIOD_NEVER) continue;
+
+		const auto& datums = definitions[request.define_id];
+		packet.assign(PacketSize(datums), 0); // Within the capacity reserved by the request, so the frame does not allocate
+
+		auto* data = reinterpret_cast<SIMCONNECT_RECV_SIMOBJECT_DATA*>(packet.data());
+		data->dwSize = static_cast<DWORD>(packet.size());
+		data->dwID = SIMCONNECT_RECV_ID_SIMOBJECT_DATA;
+		data->dwRequestID = request.request_id;
+		data->dwObjectID = request.object_id;
+		data->dwDefineID = request.define_id;
+		data->dwentrynumber = 1;
+		data->dwoutof = 1;
+		data->dwDefineCount = static_cast<DWORD>(datums.size());
+
+		auto offset = header_size;
+		for (const auto& datum : datums)
+		{
+			WriteDatum(packet.data() + offset, datum);
+			offset += DatumSize(datum.type);
+		}
+		pfcnDispatch(data, data->dwSize, pContext);
+
+		if (request.period == SIMCONNECT_PERIOD_ONCE) request.period = SIMCONNECT_PERIOD_NEVER;
+	}
+	return S_OK;
+}
+
+HRESULT SimConnect_AddToDataDefinition(HANDLE hSimConnect, SIMCONNECT_DATA_DEFINITION_ID DefineID, const char* DatumName, const char* UnitsName, SIMCONNECT_DATATYPE DatumType, float fEpsilon, DWORD DatumID)
+{
+	definitions[DefineID].push_back({ source->Bind(DatumName, UnitsName), DatumType });
+	return S_OK;
+}
+
+HRESULT SimConnect_RequestDataOnSimObject(HANDLE hSimConnect, SIMCONNECT_DATA_REQUEST_ID RequestID, SIMCONNECT_DATA_DEFINITION_ID DefineID, SIMCONNECT_OBJECT_ID ObjectID, SIMCONNECT_PERIOD Period, SIMCONNECT_DATA_REQUEST_FLAG Flags, DWORD origin, DWORD interval, DWORD limit)
+{
+	packet.reserve(PacketSize(definitions[DefineID]));
+	for (auto& request : requests)
+	{
+		if (request.request_id == RequestID)
+		{
+			request = { RequestID, DefineID, ObjectID, Period };
+			return S_OK;
+		}
+	}
+	requests.push_back({ RequestID, DefineID, ObjectID, Period });
+	return S_OK;
+}
+
+HRESULT SimConnect_SetDataOnSimObject(HANDLE hSimConnect, SIMCONNECT_DATA_DEFINITION_ID DefineID, SIMCONNECT_OBJECT_ID ObjectID, SIMCONNECT_DATA_SET_FLAG Flags, DWORD ArrayCount, DWORD cbUnitSize, void* pDataSet)
+{
+	const auto found = definitions.find(DefineID);
+	if (found == definitions.end()) return E_FAIL;
+
+	const auto* origin = static_cast<const char*>(pDataSet);
+	auto offset = size_t(0);
+	for (const auto& datum : found->second)
+	{
+		if (offset + DatumSize(datum.type) > cbUnitSize) return E_FAIL;
+		if (datum.slot >= 0) source->Write(datum.slot, ReadDatum(origin + offset, datum));
+		offset += DatumSize(datum.type);
+	}
+	return S_OK;
+}
+
+HRESULT SimConnect_MapClientEventToSimEvent(HANDLE hSimConnect, SIMCONNECT_CLIENT_EVENT_ID EventID, const char* EventName)
+{
+	mapped_events.push_back({ EventName, EventID, SIMCONNECT_UNUSED });
+	return S_OK;
+}
+
+HRESULT SimConnect_AddClientEventToNotificationGroup(HANDLE hSimConnect, SIMCONNECT_NOTIFICATION_GROUP_ID GroupID, SIMCONNECT_CLIENT_EVENT_ID EventID, BOOL bMaskable)
+{
+	for (auto& mapped : mapped_events)
+	{
+		if (mapped.client_event == EventID) mapped.group = GroupID;
+	}
+	return S_OK;
+}
+
+HRESULT SimConnect_SetNotificationGroupPriority(HANDLE hSimConnect, SIMCONNECT_NOTIFICATION_GROUP_ID GroupID, DWORD uPriority)
+{
+	return S_OK;
+}
\ No newline at end of file
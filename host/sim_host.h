@@ -0,0 +1,46 @@
+#pragma once
+// Host-side control of the stand-in gauge and SimConnect API (see host/sdk)
+
+#include <MSFS/MSFS.h>
+
+// Supplies the simulator state to the stand-in API and receives what the gauge writes back.
+// SimVars are bound once per (name, units) pair; afterwards only the returned slot is used.
+class SimSource
+{
+public:
+	virtual ~SimSource() = default;
+
+	// Returns a slot identifying the SimVar, or -1 if the source does not know it (it then reads as 0)
+	virtual int Bind(const char* name, const char* units) = 0;
+	virtual double Read(int slot) = 0;
+	virtual void Write(int slot, double value) {}
+};
+
+// A SimSource holding plain values, set by name
+class TableSimSource : public SimSource
+{
+public:
+	int Bind(const char* name, const char* units) override;
+	double Read(int slot) override;
+	void Write(int slot, double value) override;
+
+	void Set(const char* name, double value);
+	double Get(const char* name);
+};
+
+// Replaces the source used by aircraft_varget and the SimConnect data definitions.
+// Passing nullptr restores the default TableSimSource. Must be called before the gauge is installed.
+void SimHostSetSource(SimSource* source);
+
+// Sets the value a SimVar has in the default source (any units, any index)
+void SimHostSetVar(const char* name, double value);
+
+// Returns the value a SimVar has in the default source, including what the gauge wrote to it
+double SimHostGetVar(const char* name);
+
+// Queues a sim event (e.g. "AXIS_ELEVATOR_SET") for delivery on the next SimConnect_CallDispatch,
+// if the gauge mapped a client event to it
+void SimHostSendEvent(const char* sim_event, DWORD data);
+
+// Forgets every name, data definition, request, event mapping and queued event
+void SimHostReset();
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+// Fingerprint of every control surface output of a run, to tell whether two runs agree bit for bit
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+
+#include "../controls.h"
+
+class SurfaceHash
+{
+private:
+	uint64_t value = 14695981039346656037ull; // FNV-1a
+public:
+	void Add(const CONTROL_SURFACES_DATA& surfaces)
+	{
+		for (const auto surface : { surfaces.elevator, surfaces.ailerons, surfaces.rudder })
+		{
+			uint64_t bits;
+			memcpy(&bits, &surface, sizeof(bits));
+			value = (value ^ bits) * 1099511628211ull;
+		}
+	}
+	uint64_t Value() const { return value; }
+};
\ No newline at end of file
@@ -0,0 +1,325 @@
+#pragma once
+// The text form of pitch trace records: one line per frame, the demand and the protections with their values, then the
+// state, optionally after the simulation time, e.g.
+//   12.500000 HOLD_VFPA:DesVFPA=-0.5,LF_LIMIT_MAX:PreDE=0.01,PostDE=0.008,P=2.1,PR=0.3,VFPA=-0.4,VFPAR=0.1,LF=1.2,DE=0.008,E=0.1
+// as trace_decode prints it, and as the gauge used to print it to the console. The parser reads it at the speed of the
+// disk: the delimiters are found 64 bytes at a time with SIMD compares, and the values, which %lf prints with six
+// decimals, are converted without strtod unless they do not fit a double exactly that way.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "../telemetry.h"
+
+inline void PrintPitchTraceEntry(FILE* file, const PitchTraceEntry& entry)
+{
+	if (entry.id >= TRACE_ID_COUNT) return;
+	const auto& format = pitch_trace_formats[entry.id];
+	for (auto i = 0; i < format.value_count; i++)
+	{
+		fprintf(file, "%s%s=%lf", i == 0 ? "" : ",", format.names[i], entry.values[i]);
+	}
+}
+
+// Prints record as a line of text, after its time if time is set
+inline void PrintPitchTraceRecord(FILE* file, const PitchTraceRecord& record, const bool time)
+{
+	if (time) fprintf(file, "%lf ", record.t);
+	if (record.demand.id != TRACE_NONE && record.demand.id < TRACE_ID_COUNT)
+	{
+		fprintf(file, "%s:", pitch_trace_formats[record.demand.id].tag);
+		PrintPitchTraceEntry(file, record.demand);
+	}
+	for (auto i = 0; i < record.protection_count && i < max_trace_protections; i++)
+	{
+		if (record.protections[i].id >= TRACE_ID_COUNT) continue;
+		fprintf(file, ",%s:", pitch_trace_formats[record.protections[i].id].tag);
+		PrintPitchTraceEntry(file, record.protections[i]);
+	}
+	fprintf(file, ",P=%lf,PR=%lf,VFPA=%lf,VFPAR=%lf,LF=%lf,DE=%lf,E=%lf\n",
+		record.pitch, record.pitch_rate,
+		record.vfpa, record.vfpa_rate,
+		record.gforce,
+		record.delta_elevator, record.elevator);
+}
+
+// Bitmask of the bytes of the 64 at data that delimit the fields of a line: ',', ':', '=' and '\n'
+inline uint64_t TextTraceDelimiters(const char* data)
+{
+#if defined(__AVX2__)
+	const auto scan = [](const char* bytes)
+	{
+		const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes));
+		const auto delimiters = _mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(',')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(':'))),
+			_mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('=')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n'))));
+		return static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(delimiters)));
+	};
+	return scan(data) | scan(data + 32) << 32;
+#elif defined(__SSE2__)
+	uint64_t mask = 0;
+	for (auto offset = 0; offset < 64; offset += 16)
+	{
+		const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+		const auto delimiters = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(',')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(':'))),
+			_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('=')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'))));
+		mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(delimiters))) << offset;
+	}
+	return mask;
+#else
+	uint64_t mask = 0;
+	for (auto offset = 0; offset < 64; offset++)
+	{
+		const auto c = data[offset];
+		if (c == ',' || c == ':' || c == '=' || c == '\n') mask |= uint64_t(1) << offset;
+	}
+	return mask;
+#endif
+}
+
+// Parses the number in [begin, end), allowing trailing spaces and a carriage return; returns false if it is not one
+inline bool ParseTraceNumber(const char* begin, const char* end, double& value)
+{
+	static constexpr double powers_of_ten[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+	};
+	while (end > begin && (end[-1] == ' ' || end[-1] == '\r')) end--;
+
+	// Plain decimals with at most 19 digits: an integer and a power of ten that are both exact in a double give the
+	// correctly rounded value with a single division
+	auto* c = begin;
+	const auto negative = c < end && *c == '-';
+	if (c < end && (*c == '-' || *c == '+')) c++;
+	uint64_t mantissa = 0;
+	auto digits = 0;
+	auto decimals = 0;
+	const auto* const first_digit = c;
+	for (; c < end && static_cast<unsigned>(*c - '0') < 10; c++, digits++) mantissa = mantissa * 10 + (*c - '0');
+	if (c < end && *c == '.')
+	{
+		for (c++; c < end && static_cast<unsigned>(*c - '0') < 10; c++, digits++, decimals++) mantissa = mantissa * 10 + (*c - '0');
+	}
+	if (c == end && c != first_digit && digits <= 19 && mantissa <= (uint64_t(1) << 53) && decimals <= 22)
+	{
+		value = static_cast<double>(mantissa) / powers_of_ten[decimals];
+		if (negative) value = -value;
+		return true;
+	}
+
+	// Anything else, e.g. an exponent, nan or inf
+	char text[64];
+	const auto length = static_cast<size_t>(end - begin);
+	if (length == 0 || length >= sizeof(text)) return false;
+	memcpy(text, begin, length);
+	text[length] = 0;
+	char* parsed;
+	value = strtod(text, &parsed);
+	return parsed == text + length;
+}
+
+// Parses text trace lines into PitchTraceRecords. Lines that are not records (e.g. other console output) are counted and
+// skipped. Lines in which the gauge printed PR_LIM_MIN with the tag of PR_LIM_MAX are read as PR_LIM_MIN.
+class TextTraceParser
+{
+private:
+	PitchTraceRecord record;
+	PitchTraceEntry* entry; // Whose values are being read, if any
+	int entry_values; // Read of entry
+	uint8_t state_fields; // Bits of the state fields read
+	bool valid;
+	bool first_field; // Whether the field is the first of its line, which may follow the time
+	const char* line_start;
+	const char* field_start;
+	const char* value_start; // Past the '=' of the field, if it has one
+	uint64_t lines = 0;
+	uint64_t records = 0;
+
+	void StartLine(const char* start)
+	{
+		record = {};
+		record.t = NAN;
+		entry = nullptr;
+		entry_values = 0;
+		state_fields = 0;
+		valid = true;
+		first_field = true;
+		line_start = start;
+		field_start = start;
+		value_start = nullptr;
+	}
+
+	static bool Equals(const char* begin, const char* end, const char* name)
+	{
+		const auto length = static_cast<size_t>(end - begin);
+		return strlen(name) == length && memcmp(begin, name, length) == 0;
+	}
+
+	// Ends the entry being read, which has to have all its values
+	void EndEntry()
+	{
+		if (entry && entry_values != pitch_trace_formats[entry->id].value_count) valid = false;
+		entry = nullptr;
+	}
+
+	// Reads the time before the first field of the line, if there is one, and moves field_start past it
+	void ReadTime(const char* end)
+	{
+		first_field = false;
+		const auto* space = static_cast<const char*>(memchr(field_start, ' ', end - field_start));
+		if (!space) return;
+		valid &= ParseTraceNumber(field_start, space, record.t);
+		field_start = space + 1;
+	}
+
+	void Tag(const char* end)
+	{
+		if (first_field) ReadTime(end);
+		EndEntry();
+		auto id = TRACE_ID_COUNT;
+		for (auto candidate = 1; candidate < TRACE_ID_COUNT && id == TRACE_ID_COUNT; candidate++)
+		{
+			if (Equals(field_start, end, pitch_trace_formats[candidate].tag)) id = static_cast<PITCH_TRACE_ID>(candidate);
+		}
+		const auto demand = id < TRACE_LF_LIMIT_MAX || id == TRACE_MPC;
+		if (id == TRACE_ID_COUNT || state_fields != 0) valid = false;
+		else if (demand && record.demand.id == TRACE_NONE && record.protection_count == 0) entry = &record.demand;
+		else if (!demand && record.protection_count < max_trace_protections) entry = &record.protections[record.protection_count++];
+		else valid = false;
+		if (!valid) return;
+		entry->id = id;
+		entry_values = 0;
+	}
+
+	void Value(const char* end)
+	{
+		const auto* key = field_start;
+		const auto* key_end = value_start - 1;
+		double value;
+		if (!ParseTraceNumber(value_start, end, value))
+		{
+			valid = false;
+			return;
+		}
+		if (entry)
+		{
+			const auto& format = pitch_trace_formats[entry->id];
+			if (entry_values < format.value_count && Equals(key, key_end, format.names[entry_values]))
+			{
+				entry->values[entry_values++] = value;
+				return;
+			}
+			if (entry->id == TRACE_PR_LIM_MAX && entry_values == 1 && Equals(key, key_end, "MinPR"))
+			{
+				entry->id = TRACE_PR_LIM_MIN;
+				entry->values[entry_values++] = value;
+				return;
+			}
+			EndEntry();
+		}
+		const auto length = key_end - key;
+		auto bit = -1;
+		if (length == 1 && key[0] == 'P') { bit = 0; record.pitch = value; }
+		else if (length == 2 && key[0] == 'P' && key[1] == 'R') { bit = 1; record.pitch_rate = value; }
+		else if (length == 4 && memcmp(key, "VFPA", 4) == 0) { bit = 2; record.vfpa = value; }
+		else if (length == 5 && memcmp(key, "VFPAR", 5) == 0) { bit = 3; record.vfpa_rate = value; }
+		else if (length == 2 && key[0] == 'L' && key[1] == 'F') { bit = 4; record.gforce = value; }
+		else if (length == 2 && key[0] == 'D' && key[1] == 'E') { bit = 5; record.delta_elevator = value; }
+		else if (length == 1 && key[0] == 'E') { bit = 6; record.elevator = value; }
+		if (bit < 0 || state_fields & (1 << bit)) valid = false;
+		else state_fields |= 1 << bit;
+	}
+
+	// Ends the field that ends at end: a value, or nothing at all (after a tag without values, or before the state of a
+	// frame without demand, which may follow the time)
+	void EndField(const char* end)
+	{
+		if (value_start) Value(end);
+		else
+		{
+			if (first_field) ReadTime(end);
+			if (field_start != end && !(end - field_start == 1 && *field_start == '\r')) valid = false;
+		}
+		first_field = false;
+		field_start = end + 1;
+		value_start = nullptr;
+	}
+
+	template <typename Consume>
+	void EndLine(const char* end, Consume& consume)
+	{
+		lines++;
+		if (valid && state_fields == 0x7f)
+		{
+			records++;
+			consume(static_cast<const PitchTraceRecord&>(record));
+		}
+		StartLine(end + 1);
+	}
+
+	template <typename Consume>
+	void Delimiter(const char* position, Consume& consume)
+	{
+		switch (*position)
+		{
+		case ':':
+			if (value_start) valid = false;
+			else Tag(position);
+			field_start = position + 1;
+			return;
+		case '=':
+			if (first_field) ReadTime(position);
+			if (value_start) valid = false;
+			value_start = position + 1;
+			return;
+		case ',':
+			EndField(position);
+			return;
+		default: // '\n'
+			EndField(position);
+			EndLine(position, consume);
+		}
+	}
+public:
+	// Parses the lines in data[0..size), calling consume(const PitchTraceRecord&) with the record of every line that is
+	// one; a last line without a line feed counts as one
+	template <typename Consume>
+	void Parse(const char* data, const size_t size, Consume&& consume)
+	{
+		StartLine(data);
+		size_t offset = 0;
+		for (; offset + 64 <= size; offset += 64)
+		{
+			for (auto mask = TextTraceDelimiters(data + offset); mask; mask &= mask - 1) Delimiter(data + offset + __builtin_ctzll(mask), consume);
+		}
+		if (offset < size)
+		{
+			// The scan reads 64 bytes, which may not be mapped past the data
+			char tail[64] = {};
+			memcpy(tail, data + offset, size - offset);
+			for (auto mask = TextTraceDelimiters(tail) & ((uint64_t(1) << (size - offset)) - 1); mask; mask &= mask - 1)
+			{
+				Delimiter(data + offset + __builtin_ctzll(mask), consume);
+			}
+		}
+		if (line_start < data + size)
+		{
+			EndField(data + size);
+			EndLine(data + size, consume);
+		}
+	}
+
+	uint64_t Lines() const { return lines; }
+	uint64_t Records() const { return records; }
+	uint64_t Skipped() const { return lines - records; }
+};
\ No newline at end of file
@@ -0,0 +1,143 @@
+#pragma once
+// Work-stealing thread pool for host tools that run many independent simulations
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Every worker owns a queue: it takes its own work from the back and, once that runs out, steals from the front
+// of the other workers' queues. Tasks are expected to be coarse (a whole simulation), so the queues use a mutex.
+class ThreadPool
+{
+private:
+	struct Worker
+	{
+		std::mutex mutex;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::vector<std::thread> threads;
+	std::mutex idle_mutex;
+	std::condition_variable work_available;
+	std::condition_variable work_done;
+	std::atomic<size_t> pending = { 0 }; // Tasks submitted and not finished yet
+	std::atomic<size_t> queued = { 0 }; // Tasks submitted and not started yet
+	std::atomic<size_t> steals = { 0 };
+	size_t next_worker = 0; // Round-robin submission target
+	bool stopping = false;
+
+	bool TryTake(const size_t index, std::function<void()>& task)
+	{
+		{
+			auto& own = *workers[index];
+			std::lock_guard<std::mutex> lock(own.mutex);
+			if (!own.tasks.empty())
+			{
+				task = std::move(own.tasks.back());
+				own.tasks.pop_back();
+				queued--;
+				return true;
+			}
+		}
+		for (size_t offset = 1; offset < workers.size(); offset++)
+		{
+			auto& victim = *workers[(index + offset) % workers.size()];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if (!victim.tasks.empty())
+			{
+				task = std::move(victim.tasks.front());
+				victim.tasks.pop_front();
+				queued--;
+				steals++;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void Run(const size_t index)
+	{
+		std::function<void()> task;
+		while (true)
+		{
+			if (TryTake(index, task))
+			{
+				task();
+				task = nullptr;
+				if (--pending == 0)
+				{
+					std::lock_guard<std::mutex> lock(idle_mutex);
+					work_done.notify_all();
+				}
+				continue;
+			}
+
+			// Submit() counts a task as queued before it notifies under this lock, so no wake-up can be missed
+			std::unique_lock<std::mutex> lock(idle_mutex);
+			work_available.wait(lock, [this]() { return stopping || queued > 0; });
+			if (stopping) return;
+		}
+	}
+public:
+	explicit ThreadPool(size_t thread_count = 0)
+	{
+		if (thread_count == 0) thread_count = std::thread::hardware_concurrency();
+		if (thread_count == 0) thread_count = 1;
+		for (size_t i = 0; i < thread_count; i++) workers.push_back(std::make_unique<Worker>());
+		for (size_t i = 0; i < thread_count; i++) threads.emplace_back([this, i]() { Run(i); });
+	}
+
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(idle_mutex);
+			stopping = true;
+		}
+		work_available.notify_all();
+		for (auto& thread : threads) thread.join();
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	size_t Size() { return threads.size(); }
+	size_t Steals() { return steals; }
+
+	void Submit(std::function<void()> task)
+	{
+		pending++;
+		queued++;
+		{
+			auto& worker = *workers[next_worker++ % workers.size()];
+			std::lock_guard<std::mutex> lock(worker.mutex);
+			worker.tasks.push_back(std::move(task));
+		}
+		std::lock_guard<std::mutex> lock(idle_mutex);
+		work_available.notify_one();
+	}
+
+	// Blocks until every submitted task has finished
+	void Wait()
+	{
+		std::unique_lock<std::mutex> lock(idle_mutex);
+		work_done.wait(lock, [this]() { return pending == 0; });
+	}
+
+	// Runs body(i) for every i in [0, count), in chunks of chunk_size, and waits for all of them
+	template <typename Body>
+	void ParallelFor(const size_t count, const size_t chunk_size, Body body)
+	{
+		for (size_t start = 0; start < count; start += chunk_size)
+		{
+			const auto end = start + chunk_size < count ? start + chunk_size : count;
+			Submit([start, end, &body]() { for (auto i = start; i < end; i++) body(i); });
+		}
+		Wait();
+	}
+};
\ No newline at end of file
@@ -0,0 +1,178 @@
+#pragma once
+// Pitch trace records as the rows of a column file (see column_file.h), and the index of the branches that goes with it:
+// a column file of its own, with a row for every run of consecutive frames in which a demand branch or a protection was
+// active. The ranges of the times of every block of the frames index them by time.
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "column_file.h"
+#include "../telemetry.h"
+
+// The columns of a frame: the time (NaN if the trace had none), the demand and its values, the protections and their
+// values, and the state. The values of an entry that has fewer are NaN.
+enum TRACE_COLUMN : uint32_t
+{
+	TRACE_COLUMN_T,
+	TRACE_COLUMN_DEMAND,
+	TRACE_COLUMN_DEMAND_VALUES,
+	TRACE_COLUMN_PROTECTION_COUNT = TRACE_COLUMN_DEMAND_VALUES + max_trace_values,
+	TRACE_COLUMN_PROTECTIONS,
+	TRACE_COLUMN_PROTECTION_VALUES = TRACE_COLUMN_PROTECTIONS + max_trace_protections,
+	TRACE_COLUMN_PITCH = TRACE_COLUMN_PROTECTION_VALUES + max_trace_protections * max_trace_values,
+	TRACE_COLUMN_PITCH_RATE,
+	TRACE_COLUMN_VFPA,
+	TRACE_COLUMN_VFPA_RATE,
+	TRACE_COLUMN_GFORCE,
+	TRACE_COLUMN_DELTA_ELEVATOR,
+	TRACE_COLUMN_ELEVATOR,
+	TRACE_COLUMN_COUNT
+};
+
+inline void TraceColumnDescriptors(ColumnDescriptor (&descriptors)[TRACE_COLUMN_COUNT])
+{
+	static constexpr const char* state_names[] = { "pitch", "pitch_rate", "vfpa", "vfpa_rate", "gforce", "delta_elevator", "elevator" };
+	const auto set = [&descriptors](const uint32_t column, const COLUMN_TYPE type, const char* format, const int a, const int b)
+	{
+		descriptors[column] = {};
+		snprintf(descriptors[column].name, sizeof(descriptors[column].name), format, a, b);
+		descriptors[column].type = type;
+	};
+	set(TRACE_COLUMN_T, COLUMN_F64, "t", 0, 0);
+	set(TRACE_COLUMN_DEMAND, COLUMN_U8, "demand", 0, 0);
+	for (auto value = 0; value < max_trace_values; value++) set(TRACE_COLUMN_DEMAND_VALUES + value, COLUMN_F64, "demand_%d", value + 1, 0);
+	set(TRACE_COLUMN_PROTECTION_COUNT, COLUMN_U8, "protection_count", 0, 0);
+	for (auto protection = 0; protection < max_trace_protections; protection++)
+	{
+		set(TRACE_COLUMN_PROTECTIONS + protection, COLUMN_U8, "protection_%d", protection + 1, 0);
+		for (auto value = 0; value < max_trace_values; value++)
+		{
+			set(TRACE_COLUMN_PROTECTION_VALUES + protection * max_trace_values + value, COLUMN_F64, "protection_%d_%d", protection + 1, value + 1);
+		}
+	}
+	for (auto state = 0; state < 7; state++) set(TRACE_COLUMN_PITCH + state, COLUMN_F64, state_names[state], 0, 0);
+}
+
+inline void WriteTraceRecord(ColumnWriter& writer, const PitchTraceRecord& record)
+{
+	const auto write_entry = [&writer](const uint32_t id_column, const uint32_t values_column, const PitchTraceEntry* entry)
+	{
+		writer.SetU8(id_column, entry ? entry->id : static_cast<uint8_t>(TRACE_NONE));
+		const auto count = entry && entry->id < TRACE_ID_COUNT ? pitch_trace_formats[entry->id].value_count : 0;
+		for (auto value = 0; value < max_trace_values; value++) writer.SetF64(values_column + value, value < count ? entry->values[value] : NAN);
+	};
+	writer.SetF64(TRACE_COLUMN_T, record.t);
+	write_entry(TRACE_COLUMN_DEMAND, TRACE_COLUMN_DEMAND_VALUES, &record.demand);
+	writer.SetU8(TRACE_COLUMN_PROTECTION_COUNT, record.protection_count);
+	for (auto protection = 0; protection < max_trace_protections; protection++)
+	{
+		write_entry(TRACE_COLUMN_PROTECTIONS + protection, TRACE_COLUMN_PROTECTION_VALUES + protection * max_trace_values,
+			protection < record.protection_count ? &record.protections[protection] : nullptr);
+	}
+	const double state[] = { record.pitch, record.pitch_rate, record.vfpa, record.vfpa_rate, record.gforce, record.delta_elevator, record.elevator };
+	for (auto column = 0; column < 7; column++) writer.SetF64(TRACE_COLUMN_PITCH + column, state[column]);
+	writer.EndRow();
+}
+
+inline void ReadTraceRecord(const ColumnReader& reader, const size_t block, const uint32_t row, PitchTraceRecord& record)
+{
+	const auto read_entry = [&](const uint32_t id_column, const uint32_t values_column, PitchTraceEntry& entry)
+	{
+		entry = {};
+		entry.id = static_cast<uint8_t>(reader.Value(block, id_column, row));
+		for (auto value = 0; value < max_trace_values; value++) entry.values[value] = reader.Value(block, values_column + value, row);
+	};
+	record = {};
+	record.t = reader.Value(block, TRACE_COLUMN_T, row);
+	read_entry(TRACE_COLUMN_DEMAND, TRACE_COLUMN_DEMAND_VALUES, record.demand);
+	record.protection_count = static_cast<uint8_t>(reader.Value(block, TRACE_COLUMN_PROTECTION_COUNT, row));
+	for (auto protection = 0; protection < max_trace_protections; protection++)
+	{
+		read_entry(TRACE_COLUMN_PROTECTIONS + protection, TRACE_COLUMN_PROTECTION_VALUES + protection * max_trace_values, record.protections[protection]);
+	}
+	double* state[] = { &record.pitch, &record.pitch_rate, &record.vfpa, &record.vfpa_rate, &record.gforce, &record.delta_elevator, &record.elevator };
+	for (auto column = 0; column < 7; column++) *state[column] = reader.Value(block, TRACE_COLUMN_PITCH + column, row);
+}
+
+// The columns of the branch index
+enum TRACE_RUN_COLUMN : uint32_t
+{
+	TRACE_RUN_BRANCH, // PITCH_TRACE_ID; TRACE_NONE for frames without demand
+	TRACE_RUN_FIRST_ROW,
+	TRACE_RUN_ROWS,
+	TRACE_RUN_T_MIN, // Of the frames of the run
+	TRACE_RUN_T_MAX,
+	TRACE_RUN_COLUMN_COUNT
+};
+
+constexpr ColumnDescriptor trace_run_columns[TRACE_RUN_COLUMN_COUNT] = {
+	{ "branch", COLUMN_U8, 0 },
+	{ "first_row", COLUMN_U64, 0 },
+	{ "rows", COLUMN_U64, 0 },
+	{ "t_min", COLUMN_F64, 0 },
+	{ "t_max", COLUMN_F64, 0 },
+};
+
+// Writes the branch index of the frames it is given, a row for every run once it ends
+class TraceRunWriter
+{
+private:
+	struct Run
+	{
+		uint64_t first_row;
+		double t_min, t_max;
+	};
+
+	ColumnWriter writer;
+	Run runs[TRACE_ID_COUNT]; // Of the branches active in the last frame
+	uint32_t active = 0; // Bits of the branches active in the last frame
+	uint64_t rows = 0;
+
+	void End(const int branch)
+	{
+		const auto& run = runs[branch];
+		writer.SetU8(TRACE_RUN_BRANCH, static_cast<uint8_t>(branch));
+		writer.SetU64(TRACE_RUN_FIRST_ROW, run.first_row);
+		writer.SetU64(TRACE_RUN_ROWS, rows - run.first_row);
+		writer.SetF64(TRACE_RUN_T_MIN, run.t_min);
+		writer.SetF64(TRACE_RUN_T_MAX, run.t_max);
+		writer.EndRow();
+	}
+public:
+	bool Open(const char* path) { return writer.Open(path, trace_run_columns, TRACE_RUN_COLUMN_COUNT); }
+
+	void Add(const PitchTraceRecord& record)
+	{
+		uint32_t branches = 1 << (record.demand.id < TRACE_ID_COUNT ? record.demand.id : TRACE_NONE);
+		for (auto protection = 0; protection < record.protection_count && protection < max_trace_protections; protection++)
+		{
+			if (record.protections[protection].id < TRACE_ID_COUNT) branches |= 1 << record.protections[protection].id;
+		}
+		for (auto ended = active & ~branches; ended; ended &= ended - 1) End(__builtin_ctz(ended));
+		for (auto remaining = branches; remaining; remaining &= remaining - 1)
+		{
+			const auto branch = __builtin_ctz(remaining);
+			auto& run = runs[branch];
+			if (!(active & (1 << branch))) run = { rows, NAN, NAN };
+			if (record.t < run.t_min || std::isnan(run.t_min)) run.t_min = record.t;
+			if (record.t > run.t_max || std::isnan(run.t_max)) run.t_max = record.t;
+		}
+		active = branches;
+		rows++;
+	}
+
+	// Ends the runs still active; returns false if any write failed
+	bool Close()
+	{
+		for (auto branch = 0; branch < TRACE_ID_COUNT; branch++)
+		{
+			if (active & (1 << branch)) End(branch);
+		}
+		active = 0;
+		return writer.Close();
+	}
+};
+
+// The tag a branch is queried by, "NONE" for frames without demand
+inline const char* TraceBranchName(const int branch) { return branch == TRACE_NONE ? "NONE" : pitch_trace_formats[branch].tag; }
\ No newline at end of file
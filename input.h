@@ -1,4 +1,7 @@
 #pragma once
+#include <chrono>
+#include <cstdint>
+
 #include "common.h"
 
 
@@ -14,14 +17,114 @@ enum EVENT_ID
 	RUDDER_CENTER_EVENT, // RUDDER_CENTER
 };
 
-void CALLBACK OnInputCaptureEvent(SIMCONNECT_RECV* pData, DWORD cbData, void* pContext);
+enum INPUT_AXIS
+{
+	AXIS_YOKE_Y,
+	AXIS_YOKE_X,
+	AXIS_RUDDER,
+	AXIS_COUNT
+};
+
+// A position an axis event set, and when it arrived
+struct InputEvent
+{
+	INPUT_AXIS axis;
+	double position; // With the null zone applied, as the laws read it
+	double time; // In simulation time, which decides the control step that reads it; NAN until stamped (see StampEvents)
+	uint32_t frame; // The frame it arrived in, once stamped
+	int64_t arrival; // Steady clock nanoseconds at which it was dispatched to the gauge
+};
+
+// Fixed capacity FIFO of input events, oldest first
+template <size_t Capacity>
+class InputEventQueue
+{
+private:
+	InputEvent events[Capacity];
+	size_t head = 0;
+	size_t count = 0;
+public:
+	bool Empty() const { return count == 0; }
+	bool Full() const { return count == Capacity; }
+	size_t Size() const { return count; }
+
+	InputEvent& Front() { return events[head]; }
+	// The index-th event from the oldest
+	InputEvent& operator[](const size_t index) { return events[(head + index) % Capacity]; }
+
+	void Push(const InputEvent& event)
+	{
+		events[(head + count) % Capacity] = event;
+		count++;
+	}
+	void Pop()
+	{
+		head = (head + 1) % Capacity;
+		count--;
+	}
+	void Clear()
+	{
+		head = 0;
+		count = 0;
+	}
+};
+
+// How long the axis events took to reach the control surfaces: from their dispatch to the gauge to the end of the
+// frame whose surfaces first included the control step that read them, on the steady clock
+struct InputLatency
+{
+	static constexpr int frame_buckets = 4; // 0, 1, 2 and 3 or more frames
+
+	uint64_t events = 0;
+	double total_ms = 0;
+	double max_ms = 0;
+	uint64_t frames[frame_buckets] = {};
+
+	void Add(const double milliseconds, const uint32_t frame_count)
+	{
+		events++;
+		total_ms += milliseconds;
+		max_ms = fmax(max_ms, milliseconds);
+		frames[frame_count < frame_buckets ? frame_count : frame_buckets - 1]++;
+	}
+	void Merge(const InputLatency& other)
+	{
+		events += other.events;
+		total_ms += other.total_ms;
+		max_ms = fmax(max_ms, other.max_ms);
+		for (auto i = 0; i < frame_buckets; i++) frames[i] += other.frames[i];
+	}
+	double MeanMs() const { return events > 0 ? total_ms / events : 0; }
+};
 
 class InputCapture
 {
 private:
-	double yoke_y; // -1 is full down, and +1 is full up
-	double yoke_x; // -1 is full left, and +1 is full right
-	double rudder; // -1 is full left, and +1 is full right
+	double yoke_y = 0; // -1 is full down, and +1 is full up
+	double yoke_x = 0; // -1 is full left, and +1 is full right
+	double rudder = 0; // -1 is full left, and +1 is full right
+
+	// The positions with the null zone applied, worked out whenever a position is set as the laws read them many times
+	double yoke_y_null_zone = PositionWithNullZone(0, 0.10);
+	double yoke_x_null_zone = PositionWithNullZone(0, 0.10);
+
+	// Axis events are queued with their arrival time, so that each control step can read the mean of the positions set
+	// during it instead of whichever event came last
+	static constexpr size_t queue_capacity = 64;
+	InputEventQueue<queue_capacity> queue;
+	size_t unstamped = 0; // Events at the back of the queue that arrived in the frame not stamped yet
+	double step_start_position[AXIS_COUNT] = {}; // Each axis at the start of the next control step
+	double mean_position[AXIS_COUNT] = {}; // Of the events the last control step read
+	uint32_t frame = 0;
+	InputLatency latency;
+	// The events consumed by the control steps of the frame in progress, until its surfaces are computed
+	struct Consumed
+	{
+		int64_t arrival;
+		uint32_t frames; // Since the frame it arrived in
+	};
+	Consumed consumed[queue_capacity];
+	size_t consumed_count = 0;
 
 	enum GROUP_ID
 	{
@@ -34,20 +137,107 @@ private:
 	{
 		return sign(position) * linear_decay_coefficient(position, sign(position), sign(position) * null_zone_percent / 2.0);
 	}
+
+	static int64_t Now() { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+
+	void Enqueue(const INPUT_AXIS axis, const double position)
+	{
+		if (queue.Full())
+		{
+			// Fold the oldest event into the position it left its axis in
+			step_start_position[queue.Front().axis] = queue.Front().position;
+			if (unstamped == queue.Size()) unstamped--;
+			queue.Pop();
+		}
+		queue.Push({ axis, position, NAN, 0, Now() });
+		unstamped++;
+	}
 public:	
 	double RawYokeY() { return yoke_y; }
 	double RawYokeX() { return yoke_x; }
 	double RawRudder() { return rudder; }
 	
-	double YokeY() { return PositionWithNullZone(yoke_y, 0.10); }
-	double YokeX() { return PositionWithNullZone(yoke_x, 0.10); }
+	// The latest positions
+	double YokeY() { return yoke_y_null_zone; }
+	double YokeX() { return yoke_x_null_zone; }
 	double Rudder() { return rudder; }
 
-	void SetYokeY(const double value) { yoke_y = value; }
-	void SetYokeX(const double value) { yoke_x = value; }
-	void SetRudder(const double value) { rudder = value; }
+	// The mean of the positions the events read by the last control step set, each counted once however long it was
+	// held (as SimConnect gives no time within the frame to weight them by), or the held position if none came
+	double MeanYokeY() { return mean_position[AXIS_YOKE_Y]; }
+	double MeanYokeX() { return mean_position[AXIS_YOKE_X]; }
+	double MeanRudder() { return mean_position[AXIS_RUDDER]; }
+
+	const InputLatency& Latency() { return latency; }
+	void ResetLatency() { latency = InputLatency(); }
+
+	// Sets a position directly, from now on, rather than through an event
+	void SetYokeY(const double value)
+	{
+		yoke_y = value;
+		yoke_y_null_zone = PositionWithNullZone(yoke_y, 0.10);
+		step_start_position[AXIS_YOKE_Y] = mean_position[AXIS_YOKE_Y] = yoke_y_null_zone;
+	}
+	void SetYokeX(const double value)
+	{
+		yoke_x = value;
+		yoke_x_null_zone = PositionWithNullZone(yoke_x, 0.10);
+		step_start_position[AXIS_YOKE_X] = mean_position[AXIS_YOKE_X] = yoke_x_null_zone;
+	}
+	void SetRudder(const double value)
+	{
+		rudder = value;
+		step_start_position[AXIS_RUDDER] = mean_position[AXIS_RUDDER] = rudder;
+	}
+
+	// Gives the events that arrived since the last frame their times in the simulation, which decide the control step
+	// of the frame that reads each one. SimConnect delivers them together at the start of the frame lasting dt and
+	// ending at t, without the simulation time they were made at (and their arrival only records that dispatch), so
+	// they are spread evenly over the frame in the order they came. The latency is measured from their arrival.
+	void StampEvents(const double t, const double dt)
+	{
+		frame++;
+		for (size_t i = 0; i < unstamped; i++)
+		{
+			auto& event = queue[queue.Size() - unstamped + i];
+			event.time = t - dt + dt * i / unstamped;
+			event.frame = frame;
+		}
+		unstamped = 0;
+	}
+
+	// Works out the mean positions of the control step ending at t, consuming the events up to t
+	void Update(const double t)
+	{
+		double position[AXIS_COUNT], sum[AXIS_COUNT] = {};
+		int samples[AXIS_COUNT] = {};
+		for (auto axis = 0; axis < AXIS_COUNT; axis++) position[axis] = step_start_position[axis];
+		while (!queue.Empty() && queue.Front().time <= t)
+		{
+			const auto& event = queue.Front();
+			position[event.axis] = event.position;
+			sum[event.axis] += event.position;
+			samples[event.axis]++;
+			if (consumed_count < queue_capacity) consumed[consumed_count++] = { event.arrival, frame - event.frame };
+			queue.Pop();
+		}
+		for (auto axis = 0; axis < AXIS_COUNT; axis++)
+		{
+			mean_position[axis] = samples[axis] > 0 ? sum[axis] / samples[axis] : position[axis];
+			step_start_position[axis] = position[axis];
+		}
+	}
+
+	// Adds the events the frame's control steps consumed to the latency, once the surfaces of the frame are computed
+	void MeasureLatency()
+	{
+		if (consumed_count == 0) return;
+		const auto now = Now();
+		for (size_t i = 0; i < consumed_count; i++) latency.Add((now - consumed[i].arrival) / 1e6, consumed[i].frames);
+		consumed_count = 0;
+	}
 	
-	void Init()
+	void Init(HANDLE hSimConnect)
 	{
 		// Register input capture
 		// Client events reference: http://www.prepar3d.com/SDKv3/LearningCenter/utilities/variables/event_ids.html
@@ -72,43 +262,54 @@ public:
 		SimConnect_SetNotificationGroupPriority(hSimConnect, AILERON_GROUP, SIMCONNECT_GROUP_PRIORITY_HIGHEST_MASKABLE);
 		SimConnect_SetNotificationGroupPriority(hSimConnect, RUDDER_GROUP, SIMCONNECT_GROUP_PRIORITY_HIGHEST_MASKABLE);
 	}
-	void Update(const double t, const double dt)
-	{
-		SimConnect_CallDispatch(hSimConnect, OnInputCaptureEvent, nullptr);
-	}
 	void Destroy()
 	{
 		// TODO: Unregister all the input capture?
 	}
-};
-
-InputCapture input_capture;
 
-void CALLBACK OnInputCaptureEvent(SIMCONNECT_RECV* pData, DWORD cbData, void* pContext)
-{
-	if (pData->dwID == SIMCONNECT_RECV_ID_EVENT)
+	// Applies an input event, with its data as the simulator sends it
+	void OnEvent(const EVENT_ID event, const int32_t data)
 	{
-		auto* evt = static_cast<SIMCONNECT_RECV_EVENT*>(pData);
-		switch (evt->uEventID)
+		switch (event)
 		{
 		case ELEVATOR_SET_EVENT:
-			input_capture.SetYokeY(0 - (static_cast<long>(evt->dwData) / 16384.0)); // scale from [-16384,16384] to [-1,1] and reverse the sign
+			yoke_y = 0 - (data / 16384.0); // scale from [-16384,16384] to [-1,1] and reverse the sign
+			yoke_y_null_zone = PositionWithNullZone(yoke_y, 0.10);
+			Enqueue(AXIS_YOKE_Y, yoke_y_null_zone);
 			break;
 		case AILERONS_SET_EVENT:
-			input_capture.SetYokeX(0 - (static_cast<long>(evt->dwData) / 16384.0)); // scale from [-16384,16384] to [-1,1] and reverse the sign
+			yoke_x = 0 - (data / 16384.0); // scale from [-16384,16384] to [-1,1] and reverse the sign
+			yoke_x_null_zone = PositionWithNullZone(yoke_x, 0.10);
+			Enqueue(AXIS_YOKE_X, yoke_x_null_zone);
 			break;
 		case CENTER_AILERONS_RUDDER_EVENT:
-			input_capture.SetYokeX(0);
-			input_capture.SetRudder(0);
+			yoke_x = 0;
+			yoke_x_null_zone = PositionWithNullZone(yoke_x, 0.10);
+			rudder = 0;
+			Enqueue(AXIS_YOKE_X, yoke_x_null_zone);
+			Enqueue(AXIS_RUDDER, rudder);
 			break;
 		case RUDDER_SET_EVENT:
-			input_capture.SetRudder(0 - (static_cast<long>(evt->dwData) / 16384.0)); // scale from [-16384,16384] to [-1,1] and reverse the sign
+			rudder = 0 - (data / 16384.0); // scale from [-16384,16384] to [-1,1] and reverse the sign
+			Enqueue(AXIS_RUDDER, rudder);
 			break;
 		case RUDDER_CENTER_EVENT:
-			input_capture.SetRudder(0);
+			rudder = 0;
+			Enqueue(AXIS_RUDDER, rudder);
 			break;
 		default: break;
 		}
 	}
-}
+};
+
+
 
+// Decodes an input event delivered through SimConnect_CallDispatch into the InputCapture passed as pContext
+inline void CALLBACK OnInputCaptureEvent(SIMCONNECT_RECV* pData, DWORD cbData, void* pContext)
+{
+	if (pData->dwID == SIMCONNECT_RECV_ID_EVENT)
+	{
+		const auto* evt = static_cast<SIMCONNECT_RECV_EVENT*>(pData);
+		static_cast<InputCapture*>(pContext)->OnEvent(static_cast<EVENT_ID>(evt->uEventID), static_cast<int32_t>(evt->dwData));
+	}
+}
\ No newline at end of file
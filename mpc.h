@@ -0,0 +1,681 @@
+#pragma once
+#include <array>
+#include <cmath>
+
+#include "common.h"
+
+// Minimizes 1/2 x'Px + q'x subject to l <= Ax <= u, for N variables and M constraints, with the dual active set
+// method of Goldfarb and Idnani: starting from the unconstrained minimum, the most violated bound is added to the
+// active set, dropping active bounds whose multipliers would turn negative on the way, until no bound is violated. The
+// factors of the active set are kept up to date by Givens rotations, so an iteration costs O(N^2). Setup() factors P
+// (Cholesky) once for every Solve() until the next Setup(); every Solve() adds the bounds active in the previous
+// solution first, which is the warm start. A is kept as the span of every row from its first to its last nonzero, so
+// the banded and triangular constraints of a prediction horizon cost only their nonzeros. Everything is held in fixed
+// size arrays and a solve runs at most max_iterations iterations, each adding or dropping a bound, so its worst-case
+// time is bounded.
+template <int N, int M>
+class ActiveSetQpSolver
+{
+private:
+	static constexpr int bounds = 2 * M; // Bound 2i is l[i] <= (Ax)[i], and bound 2i + 1 is (Ax)[i] <= u[i]
+
+	std::array<double, M * N> A = {}; // The spans of the rows, packed one after the other
+	std::array<int, M> row_start = {}; // Of the span of each row in A
+	std::array<int, M> row_first = {}; // Column of the first value of the span
+	std::array<int, M> row_length = {};
+	std::array<double, N * N> inverse_factor = {}; // L^-T, where P = LL'
+
+	std::array<double, N> x = {};
+	std::array<double, N * N> J = {}; // L^-T rotated by the active set, row major
+	std::array<double, N * N> R = {}; // Upper triangular factor of the normals of the active set
+	double R_norm = 1;
+	std::array<int, N + 1> active_set = {}; // And the bound being added
+	std::array<double, N + 1> multipliers = {};
+	int active = 0;
+	std::array<bool, bounds> is_active = {};
+	std::array<bool, bounds> was_active = {}; // In the previous solution, the warm start
+	bool solved = false;
+
+	// Row i of A times v
+	double Row(const int i, const std::array<double, N>& v) const
+	{
+		const auto* span = &A[row_start[i]];
+		const auto* values = &v[row_first[i]];
+		auto sum = 0.0;
+		for (auto j = 0; j < row_length[i]; j++) sum += span[j] * values[j];
+		return sum;
+	}
+
+	// How far x is inside a bound, negative if it violates it
+	double Slack(const int bound, const double* l, const double* u) const
+	{
+		const auto row = bound / 2;
+		return bound % 2 == 0 ? Row(row, x) - l[row] : u[row] - Row(row, x);
+	}
+
+	// d = J' n, for the normal n of a bound (the row of A, negated for an upper bound)
+	void Project(const int bound, std::array<double, N>& d) const
+	{
+		const auto row = bound / 2;
+		const auto sign = bound % 2 == 0 ? 1.0 : -1.0;
+		const auto* span = &A[row_start[row]];
+		d.fill(0);
+		for (auto k = 0; k < row_length[row]; k++)
+		{
+			const auto value = sign * span[k];
+			const auto* J_row = &J[(row_first[row] + k) * N];
+			for (auto j = 0; j < N; j++) d[j] += J_row[j] * value;
+		}
+	}
+
+	// Rotates columns a and b of J by a Givens rotation, in the form of Goldfarb and Idnani
+	void RotateColumns(const int a, const int b, const double cc, const double ss, const double xny)
+	{
+		for (auto k = 0; k < N; k++)
+		{
+			const auto t1 = J[k * N + a];
+			const auto t2 = J[k * N + b];
+			J[k * N + a] = t1 * cc + t2 * ss;
+			J[k * N + b] = xny * (t1 + J[k * N + a]) - t2;
+		}
+	}
+
+	// Adds the bound being added, given d = J' n for it; returns false if its normal depends on the active ones
+	bool Add(std::array<double, N>& d)
+	{
+		for (auto j = N - 1; j > active; j--)
+		{
+			auto cc = d[j - 1];
+			auto ss = d[j];
+			const auto h = hypot(cc, ss);
+			if (h == 0) continue;
+			d[j] = 0;
+			cc /= h;
+			ss /= h;
+			if (cc < 0)
+			{
+				cc = -cc;
+				ss = -ss;
+				d[j - 1] = -h;
+			}
+			else d[j - 1] = h;
+			RotateColumns(j - 1, j, cc, ss, ss / (1 + cc));
+		}
+		for (auto i = 0; i <= active; i++) R[i * N + active] = d[i];
+		if (fabs(d[active]) <= 1e-14 * R_norm) return false;
+		R_norm = fmax(R_norm, fabs(d[active]));
+		is_active[active_set[active]] = true;
+		active++;
+		return true;
+	}
+
+	// Drops the active bound at position, moving the bound being added down with the others
+	void Drop(const int position)
+	{
+		is_active[active_set[position]] = false;
+		for (auto i = position; i < active; i++)
+		{
+			active_set[i] = active_set[i + 1];
+			multipliers[i] = multipliers[i + 1];
+			if (i < active - 1)
+			{
+				for (auto k = 0; k < N; k++) R[k * N + i] = R[k * N + i + 1];
+			}
+		}
+		for (auto k = 0; k < N; k++) R[k * N + active - 1] = 0;
+		active--;
+
+		// R is upper Hessenberg from position on; rotate it back to triangular
+		for (auto j = position; j < active; j++)
+		{
+			auto cc = R[j * N + j];
+			auto ss = R[(j + 1) * N + j];
+			const auto h = hypot(cc, ss);
+			if (h == 0) continue;
+			cc /= h;
+			ss /= h;
+			R[(j + 1) * N + j] = 0;
+			if (cc < 0)
+			{
+				R[j * N + j] = -h;
+				cc = -cc;
+				ss = -ss;
+			}
+			else R[j * N + j] = h;
+			const auto xny = ss / (1 + cc);
+			for (auto k = j + 1; k < active; k++)
+			{
+				const auto t1 = R[j * N + k];
+				const auto t2 = R[(j + 1) * N + k];
+				R[j * N + k] = t1 * cc + t2 * ss;
+				R[(j + 1) * N + k] = xny * (t1 + R[j * N + k]) - t2;
+			}
+			RotateColumns(j, j + 1, cc, ss, xny);
+		}
+	}
+public:
+	// Sets P (N x N, symmetric) and A (M x N), both row major, and factors P. Returns false if P is not positive
+	// definite, keeping the previous setup.
+	bool Setup(const double* p, const double* a)
+	{
+		// Cholesky factor, lower triangular
+		std::array<double, N * N> factor = {};
+		for (auto i = 0; i < N; i++)
+		{
+			for (auto j = 0; j <= i; j++)
+			{
+				auto sum = p[i * N + j];
+				for (auto k = 0; k < j; k++) sum -= factor[i * N + k] * factor[j * N + k];
+				if (i == j)
+				{
+					if (!(sum > 0)) return false;
+					factor[i * N + i] = sqrt(sum);
+				}
+				else factor[i * N + j] = sum / factor[j * N + j];
+			}
+		}
+
+		// L^-T: row c is column c of L^-1, by forward substitution
+		for (auto column = 0; column < N; column++)
+		{
+			auto* v = &inverse_factor[column * N];
+			for (auto i = 0; i < N; i++)
+			{
+				auto sum = i == column ? 1.0 : 0.0;
+				for (auto k = 0; k < i; k++) sum -= factor[i * N + k] * v[k];
+				v[i] = sum / factor[i * N + i];
+			}
+		}
+
+		auto start = 0;
+		for (auto i = 0; i < M; i++)
+		{
+			auto first = 0, end = 0;
+			while (first < N && a[i * N + first] == 0) first++;
+			for (auto j = first; j < N; j++)
+			{
+				if (a[i * N + j] != 0) end = j + 1;
+			}
+			row_start[i] = start;
+			row_first[i] = first;
+			row_length[i] = end > first ? end - first : 0;
+			for (auto j = 0; j < row_length[i]; j++) A[start + j] = a[i * N + first + j];
+			start += row_length[i];
+		}
+		return true;
+	}
+
+	// Forgets the warm start
+	void Reset() { was_active.fill(false); }
+
+	// Adds and drops bounds until none is violated by more than tolerance, or max_iterations iterations have run.
+	// Returns the number of iterations run.
+	int Solve(const double* q, const double* l, const double* u, const int max_iterations, const double tolerance)
+	{
+		// The unconstrained minimum, -P^-1 q = -J J' q
+		J = inverse_factor;
+		std::array<double, N> d, z, r;
+		for (auto j = 0; j < N; j++)
+		{
+			d[j] = 0;
+			for (auto k = 0; k < N; k++) d[j] += J[k * N + j] * q[k];
+		}
+		for (auto k = 0; k < N; k++)
+		{
+			x[k] = 0;
+			for (auto j = k; j < N; j++) x[k] -= J[k * N + j] * d[j];
+		}
+		active = 0;
+		R_norm = 1;
+		is_active.fill(false);
+		solved = false;
+
+		auto iteration = 0;
+		while (iteration < max_iterations)
+		{
+			// The bound to add: the most violated, preferring those active in the previous solution
+			auto adding = -1;
+			auto slack = -tolerance;
+			auto warm = false;
+			for (auto row = 0; row < M; row++)
+			{
+				const auto value = Row(row, x);
+				// A row violates at most one of its bounds
+				const auto bound = value < l[row] ? 2 * row : 2 * row + 1;
+				const auto violation = bound % 2 == 0 ? value - l[row] : u[row] - value;
+				if (violation >= -tolerance || is_active[bound] || (warm && !was_active[bound])) continue;
+				if (violation < slack || (was_active[bound] && !warm))
+				{
+					adding = bound;
+					slack = violation;
+					warm = was_active[bound];
+				}
+			}
+			if (adding < 0)
+			{
+				solved = true;
+				break;
+			}
+			active_set[active] = adding;
+			multipliers[active] = 0;
+
+			// Step towards it until it is reached, dropping the active bounds that would have negative multipliers
+			auto added = false;
+			while (!added && iteration < max_iterations)
+			{
+				iteration++;
+				Project(adding, d);
+				// The step in x, z = J2 d2, and in the multipliers, r = R^-1 d1
+				auto z_length = 0.0, z_normal = 0.0;
+				for (auto k = 0; k < N; k++)
+				{
+					z[k] = 0;
+					for (auto j = active; j < N; j++) z[k] += J[k * N + j] * d[j];
+					z_length += z[k] * z[k];
+				}
+				for (auto i = active - 1; i >= 0; i--)
+				{
+					auto sum = d[i];
+					for (auto j = i + 1; j < active; j++) sum -= R[i * N + j] * r[j];
+					r[i] = sum / R[i * N + i];
+				}
+				const auto row = adding / 2;
+				for (auto k = 0; k < row_length[row]; k++) z_normal += z[row_first[row] + k] * A[row_start[row] + k];
+				if (adding % 2 == 1) z_normal = -z_normal;
+
+				// The partial step, until an active bound's multiplier reaches 0, and the full step, until the bound
+				// being added is reached
+				auto partial = INFINITY;
+				auto dropping = -1;
+				for (auto i = 0; i < active; i++)
+				{
+					if (r[i] > 0 && multipliers[i] / r[i] < partial)
+					{
+						partial = multipliers[i] / r[i];
+						dropping = i;
+					}
+				}
+				const auto full = z_length > 1e-16 ? -slack / z_normal : INFINITY;
+				const auto step = fmin(partial, full);
+				if (step == INFINITY) return iteration; // Infeasible
+
+				if (full < INFINITY)
+				{
+					for (auto k = 0; k < N; k++) x[k] += step * z[k];
+				}
+				for (auto i = 0; i < active; i++) multipliers[i] -= step * r[i];
+				multipliers[active] += step;
+				if (step == full)
+				{
+					if (!Add(d)) return iteration; // Dependent on the active bounds
+					added = true;
+				}
+				else
+				{
+					Drop(dropping);
+					slack = Slack(adding, l, u);
+				}
+			}
+		}
+		if (solved) was_active = is_active;
+		return iteration;
+	}
+
+	// Whether the last solve found the minimum
+	bool Solved() const { return solved; }
+	const std::array<double, N>& Solution() const { return x; }
+};
+
+// The state of the aircraft and the limits for one step of ModelPredictivePitchController
+struct PitchPrediction
+{
+	double alpha = 0; // Degrees
+	double pitch = 0; // Degrees (+ is up)
+	double pitch_rate = 0; // Degrees/second (+ is up)
+	double pitch_acceleration = 0; // Degrees/second^2 (+ is up)
+	double gforce = 0; // Load factor
+	double elevator = 0; // -1 is full down, and +1 is full up
+	double ias = 0; // Knots
+	double mach = 0;
+	double speed = 0; // True airspeed in feet/second
+	double roll = 0; // Degrees
+	double vfpa = 0; // Degrees
+	double target_load_factor = 1; // What the pilot asks for
+	// Hard limits over the horizon
+	double min_load_factor = -1;
+	double max_load_factor = 2.5;
+	double min_pitch = -15;
+	double max_pitch = 30;
+	double alpha_max = 25;
+};
+
+// Chooses the elevator movement that best follows a load factor target over the next horizon_steps * step_time
+// seconds without leaving the load factor, pitch attitude or angle of attack limits, by solving a quadratic program
+// every control step. The aircraft is predicted with a short period model linearized around the current state, with
+// nominal A320 derivatives scaled by the dynamic pressure; what it gets wrong is corrected on the next step, as the
+// model always starts from the measured state. The model (and the factorization of the quadratic program) is only
+// rebuilt when the speed or bank has moved enough to change it, or the elevator crosses neutral. When the limits
+// cannot all be kept from where the aircraft is, the same program plans the recovery towards them instead.
+class ModelPredictivePitchController
+{
+public:
+	static constexpr int horizon_steps = 10;
+	static constexpr double step_time = 0.15; // Seconds the elevator rate is held for, each step of the horizon
+	static constexpr int variables = horizon_steps; // The elevator rate (per second) of each step
+	static constexpr int constraints = 5 * horizon_steps; // Load factor, pitch, alpha, elevator and elevator rate
+private:
+	// Nominal A320 in feet, slugs and pounds
+	static constexpr double g = 32.174;
+	static constexpr double kts = 1.68781;
+	static constexpr double mass = 64000 * 2.20462 / g;
+	static constexpr double wing_area = 1319.7;
+	static constexpr double chord = 13.75;
+	static constexpr double pitch_inertia = 2.0e6;
+	// Stability and control derivatives, per radian
+	static constexpr double lift_slope = 5.0; // At low Mach; grows with Prandtl-Glauert up to Mach 0.78
+	static constexpr double lift_elevator = 0.35;
+	static constexpr double pitch_stiffness = -1.2;
+	static constexpr double pitch_damping = -22;
+	static constexpr double pitch_elevator = 1.2;
+	static constexpr double elevator_up = 30; // Degrees of travel
+	static constexpr double elevator_down = 17;
+
+	// Cost: squared load factor error against squared elevator rate
+	static constexpr double load_factor_weight = 1;
+	static constexpr double elevator_rate_weight = 0.02;
+	static constexpr double max_elevator_rate = 1.5; // Per second
+	static constexpr double recovery_weight[3] = { 0, 1, 1 }; // Of the load factor, pitch and alpha past their limits
+
+	static constexpr int state_size = 4; // Alpha and pitch rate offsets, pitch offset, elevator offset
+	enum PREDICTION_ROW { ROW_LOAD_FACTOR, ROW_PITCH, ROW_ALPHA, ROW_ELEVATOR, ROW_COUNT };
+
+	using Matrix = std::array<double, state_size * state_size>;
+	using Vector = std::array<double, state_size>;
+
+	ActiveSetQpSolver<variables, constraints> solver;
+	int max_iterations = 2 * variables;
+	int recovery_iterations = 6 * variables; // Of a recovery, which starts further from its solution
+	double tolerance = 1e-6;
+	int iterations = 0;
+	int setups = 0;
+	bool solved = false;
+	bool recovering = false;
+
+	// What the model was built for
+	bool built = false;
+	double model_ias = 0;
+	double model_mach = 0;
+	double model_speed = 0;
+	double model_bank_cos = 0;
+	bool model_elevator_up = true;
+
+	double alpha_load_factor = 0; // Load factor per degree of alpha
+	double elevator_load_factor = 0; // Load factor per unit of elevator
+	double flight_path_rate = 0; // Degrees/second of flight path per unit of load factor
+	Matrix free_response[horizon_steps]; // State at the end of each step per unit of the affine term
+	Vector forced_response[horizon_steps]; // State after each step per unit of elevator rate held in the first step
+	std::array<double, constraints * variables> constraint_matrix;
+	std::array<double, constraints> row_scale;
+	double cost_scale = 1;
+	std::array<double, horizon_steps * variables> load_factor_matrix; // Predicted load factor per elevator rate
+
+	static void Multiply(const double* a, const double* b, double* result, const int n)
+	{
+		for (auto i = 0; i < n; i++)
+		{
+			for (auto j = 0; j < n; j++)
+			{
+				auto sum = 0.0;
+				for (auto k = 0; k < n; k++) sum += a[i * n + k] * b[k * n + j];
+				result[i * n + j] = sum;
+			}
+		}
+	}
+
+	// The output of a prediction row for a state offset
+	double Row(const int row, const Vector& state) const
+	{
+		switch (row)
+		{
+		case ROW_LOAD_FACTOR: return alpha_load_factor * state[0] + elevator_load_factor * state[3];
+		case ROW_PITCH: return state[2];
+		case ROW_ALPHA: return state[0];
+		default: return state[3];
+		}
+	}
+
+	// Linearizes the short period around the prediction's flight condition, discretizes it over step_time and builds
+	// the constraint matrix and the cost of the quadratic program. Returns false if the cost cannot be factored (a
+	// flight condition out of range, or NaN), leaving the model to be built again on the next update.
+	bool Build(const PitchPrediction& prediction)
+	{
+		const auto pressure = 0.5 * 0.0023769 * pow(prediction.ias * kts, 2) * wing_area;
+		const auto speed = fmax(prediction.speed, 50.0);
+		const auto mach = fmin(prediction.mach, 0.78);
+		const auto slope = lift_slope * sqrt(1 - 0.2 * 0.2) / sqrt(1 - mach * mach);
+		const auto bank_cos = cos(radians(prediction.roll));
+		const auto elevator_travel = radians(prediction.elevator >= 0 ? elevator_up : elevator_down);
+
+		alpha_load_factor = pressure * slope / (mass * g) / degrees(1);
+		elevator_load_factor = pressure * lift_elevator * elevator_travel / (mass * g);
+		flight_path_rate = degrees(g / speed) * bank_cos;
+		const auto stiffness = pressure * chord * pitch_stiffness / pitch_inertia;
+		const auto damping = pressure * chord * pitch_damping * (chord / (2 * speed)) / pitch_inertia;
+		const auto control = degrees(pressure * chord * pitch_elevator * elevator_travel / pitch_inertia);
+
+		// Continuous model; the affine term enters every state through an identity
+		Matrix continuous = {};
+		continuous[0 * state_size + 0] = -flight_path_rate * alpha_load_factor;
+		continuous[0 * state_size + 1] = 1;
+		continuous[0 * state_size + 3] = -flight_path_rate * elevator_load_factor;
+		continuous[1 * state_size + 0] = stiffness;
+		continuous[1 * state_size + 1] = damping;
+		continuous[1 * state_size + 3] = control;
+		continuous[2 * state_size + 1] = 1;
+
+		// transition = exp(Ac h) and integral = its integral over [0, h], by scaling and squaring their Taylor series:
+		// over twice the time, the transition squares and the integral becomes integral + transition integral
+		constexpr auto squarings = 4;
+		const auto h = step_time / (1 << squarings);
+		for (auto& value : continuous) value *= h;
+		Matrix transition = {}, integral = {}, term = {}, product;
+		for (auto i = 0; i < state_size; i++) transition[i * state_size + i] = integral[i * state_size + i] = term[i * state_size + i] = 1;
+		for (auto order = 1; order <= 8; order++)
+		{
+			Multiply(term.data(), continuous.data(), product.data(), state_size);
+			for (auto i = 0; i < state_size * state_size; i++)
+			{
+				term[i] = product[i] / order;
+				transition[i] += term[i];
+				if (order < 8) integral[i] += term[i] / (order + 1);
+			}
+		}
+		for (auto& value : integral) value *= h;
+		for (auto i = 0; i < squarings; i++)
+		{
+			Multiply(transition.data(), integral.data(), product.data(), state_size);
+			for (auto j = 0; j < state_size * state_size; j++) integral[j] += product[j];
+			Multiply(transition.data(), transition.data(), product.data(), state_size);
+			transition = product;
+		}
+
+		// free_response[k] = sum of transition^i integral for i <= k, and forced_response[k] = transition^k integral[:, 3]
+		free_response[0] = integral;
+		for (auto i = 0; i < state_size; i++) forced_response[0][i] = integral[i * state_size + 3];
+		for (auto k = 1; k < horizon_steps; k++)
+		{
+			Multiply(transition.data(), free_response[k - 1].data(), free_response[k].data(), state_size);
+			for (auto i = 0; i < state_size * state_size; i++) free_response[k][i] += integral[i];
+			for (auto i = 0; i < state_size; i++)
+			{
+				forced_response[k][i] = 0;
+				for (auto j = 0; j < state_size; j++) forced_response[k][i] += transition[i * state_size + j] * forced_response[k - 1][j];
+			}
+		}
+
+		// Constraint rows: for each step, the four predicted outputs, then the elevator rates; every row is scaled to
+		// a largest coefficient of 1, so that a single tolerance suits them all
+		constraint_matrix.fill(0);
+		for (auto k = 0; k < horizon_steps; k++)
+		{
+			for (auto row = 0; row < ROW_COUNT; row++)
+			{
+				const auto index = k * ROW_COUNT + row;
+				auto largest = 0.0;
+				for (auto j = 0; j <= k; j++)
+				{
+					const auto value = Row(row, forced_response[k - j]);
+					constraint_matrix[index * variables + j] = value;
+					largest = fmax(largest, fabs(value));
+					if (row == ROW_LOAD_FACTOR) load_factor_matrix[k * variables + j] = value;
+				}
+				row_scale[index] = largest > 0 ? 1 / largest : 1;
+				for (auto j = 0; j <= k; j++) constraint_matrix[index * variables + j] *= row_scale[index];
+			}
+			for (auto j = k + 1; j < variables; j++) load_factor_matrix[k * variables + j] = 0;
+			const auto rate_row = ROW_COUNT * horizon_steps + k;
+			constraint_matrix[rate_row * variables + k] = 1;
+			row_scale[rate_row] = 1;
+		}
+
+		// Cost: load_factor_weight |load factor - target|^2 + elevator_rate_weight |rates|^2, scaled to a largest
+		// diagonal of 1
+		std::array<double, variables * variables> cost;
+		for (auto i = 0; i < variables; i++)
+		{
+			for (auto j = 0; j < variables; j++)
+			{
+				auto sum = 0.0;
+				for (auto k = i > j ? i : j; k < horizon_steps; k++) sum += load_factor_matrix[k * variables + i] * load_factor_matrix[k * variables + j];
+				cost[i * variables + j] = 2 * (load_factor_weight * sum + (i == j ? elevator_rate_weight : 0));
+			}
+		}
+		auto largest = 0.0;
+		for (auto i = 0; i < variables; i++) largest = fmax(largest, cost[i * variables + i]);
+		cost_scale = 1 / largest;
+		for (auto& value : cost) value *= cost_scale;
+
+		setups++;
+		built = solver.Setup(cost.data(), constraint_matrix.data());
+		if (!built) return false;
+
+		model_ias = prediction.ias;
+		model_mach = prediction.mach;
+		model_speed = prediction.speed;
+		model_bank_cos = bank_cos;
+		model_elevator_up = prediction.elevator >= 0;
+		return true;
+	}
+
+	bool ModelValid(const PitchPrediction& prediction) const
+	{
+		return built
+			&& fabs(prediction.ias - model_ias) <= 2
+			&& fabs(prediction.mach - model_mach) <= 0.01
+			&& fabs(prediction.speed - model_speed) <= 0.01 * model_speed
+			&& fabs(cos(radians(prediction.roll)) - model_bank_cos) <= 0.02
+			&& (prediction.elevator >= 0) == model_elevator_up;
+	}
+public:
+	// Returns the elevator rate (per second) to hold until the next control step, or 0 if the step could not be solved
+	// (see Solved())
+	double Update(const PitchPrediction& prediction)
+	{
+		solved = false;
+		recovering = false;
+		iterations = 0;
+		if (!ModelValid(prediction) && !Build(prediction)) return 0;
+
+		// Affine term of the model: the rates the aircraft already has, the alpha rate being what the pitch rate gains
+		// on the flight path
+		const auto equilibrium_load_factor = cos(radians(prediction.vfpa)) / fmax(cos(radians(prediction.roll)), 0.1);
+		const auto flight_path = flight_path_rate * (prediction.gforce - equilibrium_load_factor);
+		const Vector affine = { prediction.pitch_rate - flight_path, prediction.pitch_acceleration, prediction.pitch_rate, 0 };
+
+		// Predicted outputs with the elevator held, and the bounds of every row around them
+		const double lower[ROW_COUNT] = { prediction.min_load_factor - prediction.gforce, prediction.min_pitch - prediction.pitch, -1e9, -1 - prediction.elevator };
+		const double upper[ROW_COUNT] = { prediction.max_load_factor - prediction.gforce, prediction.max_pitch - prediction.pitch, prediction.alpha_max - prediction.alpha, 1 - prediction.elevator };
+		std::array<double, constraints> l, u;
+		std::array<double, variables> q;
+		double free_load_factor[horizon_steps];
+		for (auto k = 0; k < horizon_steps; k++)
+		{
+			Vector state;
+			for (auto i = 0; i < state_size; i++)
+			{
+				state[i] = 0;
+				for (auto j = 0; j < state_size; j++) state[i] += free_response[k][i * state_size + j] * affine[j];
+			}
+			for (auto row = 0; row < ROW_COUNT; row++)
+			{
+				const auto index = k * ROW_COUNT + row;
+				const auto free = Row(row, state);
+				l[index] = (lower[row] - free) * row_scale[index];
+				u[index] = (upper[row] - free) * row_scale[index];
+			}
+			free_load_factor[k] = Row(ROW_LOAD_FACTOR, state) + prediction.gforce - prediction.target_load_factor;
+			l[ROW_COUNT * horizon_steps + k] = -max_elevator_rate;
+			u[ROW_COUNT * horizon_steps + k] = max_elevator_rate;
+		}
+		for (auto j = 0; j < variables; j++)
+		{
+			auto sum = 0.0;
+			for (auto k = j; k < horizon_steps; k++) sum += load_factor_matrix[k * variables + j] * free_load_factor[k];
+			q[j] = 2 * load_factor_weight * sum * cost_scale;
+		}
+
+		// Keep every limit while none is exceeded yet
+		auto exceeded = false;
+		for (auto row = 0; row < ROW_ELEVATOR; row++) exceeded = exceeded || lower[row] > 0 || upper[row] < 0;
+		if (!exceeded) iterations = solver.Solve(q.data(), l.data(), u.data(), max_iterations, tolerance);
+		if (exceeded || !solver.Solved())
+		{
+			// A limit is exceeded, or cannot be kept from where the aircraft is, so the plan recovers instead, from the
+			// same model: each predicted output that would be past its limit with the elevator held may go no further
+			// than that. The load factor recovers through its cost, towards a target within its limits; the pitch and
+			// alpha cost recovery_weight per degree past theirs, so that the elevator moves back towards them at once.
+			for (auto k = 0; k < horizon_steps; k++)
+			{
+				for (auto row = 0; row < ROW_ELEVATOR; row++)
+				{
+					const auto index = k * ROW_COUNT + row;
+					if (l[index] <= 0 && u[index] >= 0) continue;
+					const auto weight = (u[index] < 0 ? 1 : -1) * recovery_weight[row] * cost_scale / row_scale[index];
+					l[index] = fmin(l[index], 0);
+					u[index] = fmax(u[index], 0);
+					for (auto j = 0; j <= k; j++) q[j] += weight * constraint_matrix[index * variables + j];
+				}
+			}
+			recovering = true;
+			iterations += solver.Solve(q.data(), l.data(), u.data(), recovery_iterations, tolerance);
+		}
+		const auto elevator_rate = solver.Solution()[0];
+		solved = solver.Solved() && std::isfinite(elevator_rate);
+		return solved ? clamp(elevator_rate, -max_elevator_rate, max_elevator_rate) : 0;
+	}
+
+	// Whether the last update found a plan; it did not if the model could not be built, or the solves ran out of
+	// iterations
+	bool Solved() const { return solved; }
+	// Whether the last update could not keep every limit, and planned to recover instead
+	bool Recovering() const { return recovering; }
+	// Iterations of the last update, over both solves if it recovered
+	int Iterations() const { return iterations; }
+	// Times the model has been built
+	int Setups() const { return setups; }
+
+	// Rebuilds the model on the next update, and forgets the warm start
+	void Reset()
+	{
+		built = false;
+		solver.Reset();
+	}
+	int IterationLimit() const { return max_iterations; }
+	int RecoveryIterationLimit() const { return recovery_iterations; }
+	void SetLimits(const int iteration_limit, const int recovery_iteration_limit, const double iteration_tolerance)
+	{
+		max_iterations = iteration_limit;
+		recovery_iterations = recovery_iteration_limit;
+		tolerance = iteration_tolerance;
+	}
+};
\ No newline at end of file
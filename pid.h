@@ -1,65 +1,106 @@
 #pragma once
+#include <cstddef>
+
 #include "common.h"
 
-class PIDController
+// What a PID controller carries from one update to the next
+template <typename T>
+struct PIDState
+{
+	T integral = 0;
+	T last_error = 0;
+	T last_output = 0;
+};
+
+// T is the scalar type of the controller (float or double)
+template <typename T>
+class BasicPIDController
 {
 public:
-	PIDController(const double output_min, const double output_max, const double Kp, const double Ki, const double Kd)
+	BasicPIDController(const T output_min, const T output_max, const T Kp, const T Ki, const T Kd)
 		: output_min(output_min), output_max(output_max),
-		Kp(Kp), Kd(Kd), Ki(Ki),
-		integral(0),
-		last_error(0), last_output(0) {};
-	double Update(const double error, const double dt)
+		Kp(Kp), Kd(Kd), Ki(Ki) {};
+
+	// The output for error from the given state, and the state that follows, without touching the controller
+	T Evaluate(const PIDState<T>& state, const T error, const T dt, PIDState<T>& next) const
 	{
+		auto integral = state.integral;
+
+		// Guard against integrator windup
+		if (anti_windup && ((state.last_output >= output_min && state.last_output <= output_max) || sign(error) != sign(state.last_output)))
+		{
+			integral -= error * dt;
+		}
+
 		// Proportional term
-		auto P = Kp * error;
+		T P = Kp * error;
 
 		// Integral term
 		integral += error * dt;
-		auto I = Ki * integral;
+		T I = Ki * integral;
 
 		// Derivative term
-		auto D = Kd * ((error - last_error) / dt);
+		T D = Kd * ((error - state.last_error) / dt);
 
-		auto output = P + I + D;
+		T output = P + I + D;
 		output = clamp(output, output_min, output_max);
 
-		// Save terms
-		last_output = output;
-		last_error = error;
-
+		next.integral = integral;
+		next.last_error = error;
+		next.last_output = output;
 		return output;
 	}
-	double Query(const double error, const double dt)
+	T Evaluate(const PIDState<T>& state, const T error, const T dt) const
+	{
+		PIDState<T> next;
+		return Evaluate(state, error, dt, next);
+	}
+	// What Update(error, dt) would return next, without updating
+	T Evaluate(const T error, const T dt) const { return Evaluate(state, error, dt); }
+	// What-if: the output for each of count candidate errors from the same state, e.g. to find which commands would
+	// keep a protection limit next frame
+	void Evaluate(const PIDState<T>& from, const T* errors, const size_t count, const T dt, T* outputs) const
 	{
-		const auto saved_last_error = last_error;
-		const auto saved_last_output = last_output;
-		const auto saved_integral = integral;
-		const auto update = Update(error, dt);
-		last_error = saved_last_error;
-		last_output = saved_last_output;
-		integral = saved_integral;
-		return update;
+		PIDState<T> next;
+		for (size_t i = 0; i < count; i++) outputs[i] = Evaluate(from, errors[i], dt, next);
+	}
+
+	T Update(const T error, const T dt) { return Evaluate(state, error, dt, state); }
+
+	// Keeps the state, so that gains can change from one update to the next (see GainScheduler in gains.h)
+	void SetGains(const T value_Kp, const T value_Ki, const T value_Kd)
+	{
+		Kp = value_Kp;
+		Ki = value_Ki;
+		Kd = value_Kd;
+	}
+
+	const PIDState<T>& State() const { return state; }
+	// The proportional and integral terms of the last output, and the rest of it, which is the derivative term unless
+	// the output was clamped
+	void Terms(T& p, T& i, T& d) const
+	{
+		p = Kp * state.last_error;
+		i = Ki * state.integral;
+		d = state.last_output - p - i;
 	}
 protected:
-	double output_min, output_max;
-	double Kp, Kd, Ki;
-	double integral;
-	double last_error, last_output;
+	T output_min, output_max;
+	T Kp, Kd, Ki;
+	bool anti_windup = false;
+	PIDState<T> state;
 };
 
-class AntiWindupPIDController : public PIDController
+template <typename T>
+class BasicAntiWindupPIDController : public BasicPIDController<T>
 {
 public:
-	AntiWindupPIDController(const double output_min, const double output_max, const double Kp, const double Ki, const double Kd)
-		: PIDController(output_min, output_max, Kp, Ki, Kd) {};
-	double Update(const double error, const double dt)
+	BasicAntiWindupPIDController(const T output_min, const T output_max, const T Kp, const T Ki, const T Kd)
+		: BasicPIDController<T>(output_min, output_max, Kp, Ki, Kd)
 	{
-		// Guard against integrator windup
-		if ((last_output >= output_min && last_output <= output_max) || sign(error) != sign(last_output))
-		{
-			integral -= error * dt;
-		}
-		return PIDController::Update(error, dt);
-	}
-};
\ No newline at end of file
+		this->anti_windup = true;
+	};
+};
+
+using PIDController = BasicPIDController<double>;
+using AntiWindupPIDController = BasicAntiWindupPIDController<double>;
\ No newline at end of file
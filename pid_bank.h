@@ -0,0 +1,284 @@
+#pragma once
+#include <cstddef>
+
+#include "pid.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
+// One controller at a time, with the same operations as BasicPIDController and BasicAntiWindupPIDController
+template <typename T>
+struct ScalarLanes
+{
+	using Vector = T;
+	using Mask = bool;
+	static constexpr size_t width = 1;
+	static constexpr const char* name = "scalar";
+
+	static Vector Load(const T* values) { return *values; }
+	static void Store(T* values, const Vector vector) { *values = vector; }
+	static Vector Broadcast(const T value) { return value; }
+	static Vector Add(const Vector a, const Vector b) { return a + b; }
+	static Vector Sub(const Vector a, const Vector b) { return a - b; }
+	static Vector Mul(const Vector a, const Vector b) { return a * b; }
+	static Vector Div(const Vector a, const Vector b) { return a / b; }
+	static Mask Less(const Vector a, const Vector b) { return a < b; }
+	static Mask Greater(const Vector a, const Vector b) { return a > b; }
+	static Mask LessEqual(const Vector a, const Vector b) { return a <= b; }
+	static Mask GreaterEqual(const Vector a, const Vector b) { return a >= b; }
+	static Mask And(const Mask a, const Mask b) { return a && b; }
+	static Mask Or(const Mask a, const Mask b) { return a || b; }
+	static Mask Xor(const Mask a, const Mask b) { return a != b; }
+	static Vector Select(const Mask mask, const Vector a, const Vector b) { return mask ? a : b; }
+};
+
+// The widest lanes the target has; without SIMD, one controller at a time
+template <typename T>
+struct VectorLanes : ScalarLanes<T> {};
+
+#if defined(__AVX__)
+
+template <>
+struct VectorLanes<double>
+{
+	using Vector = __m256d;
+	using Mask = __m256d;
+	static constexpr size_t width = 4;
+	static constexpr const char* name = "avx";
+
+	static Vector Load(const double* values) { return _mm256_load_pd(values); }
+	static void Store(double* values, const Vector vector) { _mm256_store_pd(values, vector); }
+	static Vector Broadcast(const double value) { return _mm256_set1_pd(value); }
+	static Vector Add(const Vector a, const Vector b) { return _mm256_add_pd(a, b); }
+	static Vector Sub(const Vector a, const Vector b) { return _mm256_sub_pd(a, b); }
+	static Vector Mul(const Vector a, const Vector b) { return _mm256_mul_pd(a, b); }
+	static Vector Div(const Vector a, const Vector b) { return _mm256_div_pd(a, b); }
+	static Mask Less(const Vector a, const Vector b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+	static Mask Greater(const Vector a, const Vector b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+	static Mask LessEqual(const Vector a, const Vector b) { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+	static Mask GreaterEqual(const Vector a, const Vector b) { return _mm256_cmp_pd(a, b, _CMP_GE_OQ); }
+	static Mask And(const Mask a, const Mask b) { return _mm256_and_pd(a, b); }
+	static Mask Or(const Mask a, const Mask b) { return _mm256_or_pd(a, b); }
+	static Mask Xor(const Mask a, const Mask b) { return _mm256_xor_pd(a, b); }
+	static Vector Select(const Mask mask, const Vector a, const Vector b) { return _mm256_blendv_pd(b, a, mask); }
+};
+
+template <>
+struct VectorLanes<float>
+{
+	using Vector = __m256;
+	using Mask = __m256;
+	static constexpr size_t width = 8;
+	static constexpr const char* name = "avx";
+
+	static Vector Load(const float* values) { return _mm256_load_ps(values); }
+	static void Store(float* values, const Vector vector) { _mm256_store_ps(values, vector); }
+	static Vector Broadcast(const float value) { return _mm256_set1_ps(value); }
+	static Vector Add(const Vector a, const Vector b) { return _mm256_add_ps(a, b); }
+	static Vector Sub(const Vector a, const Vector b) { return _mm256_sub_ps(a, b); }
+	static Vector Mul(const Vector a, const Vector b) { return _mm256_mul_ps(a, b); }
+	static Vector Div(const Vector a, const Vector b) { return _mm256_div_ps(a, b); }
+	static Mask Less(const Vector a, const Vector b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+	static Mask Greater(const Vector a, const Vector b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+	static Mask LessEqual(const Vector a, const Vector b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+	static Mask GreaterEqual(const Vector a, const Vector b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+	static Mask And(const Mask a, const Mask b) { return _mm256_and_ps(a, b); }
+	static Mask Or(const Mask a, const Mask b) { return _mm256_or_ps(a, b); }
+	static Mask Xor(const Mask a, const Mask b) { return _mm256_xor_ps(a, b); }
+	static Vector Select(const Mask mask, const Vector a, const Vector b) { return _mm256_blendv_ps(b, a, mask); }
+};
+
+#elif defined(__SSE2__)
+
+template <>
+struct VectorLanes<double>
+{
+	using Vector = __m128d;
+	using Mask = __m128d;
+	static constexpr size_t width = 2;
+	static constexpr const char* name = "sse2";
+
+	static Vector Load(const double* values) { return _mm_load_pd(values); }
+	static void Store(double* values, const Vector vector) { _mm_store_pd(values, vector); }
+	static Vector Broadcast(const double value) { return _mm_set1_pd(value); }
+	static Vector Add(const Vector a, const Vector b) { return _mm_add_pd(a, b); }
+	static Vector Sub(const Vector a, const Vector b) { return _mm_sub_pd(a, b); }
+	static Vector Mul(const Vector a, const Vector b) { return _mm_mul_pd(a, b); }
+	static Vector Div(const Vector a, const Vector b) { return _mm_div_pd(a, b); }
+	static Mask Less(const Vector a, const Vector b) { return _mm_cmplt_pd(a, b); }
+	static Mask Greater(const Vector a, const Vector b) { return _mm_cmpgt_pd(a, b); }
+	static Mask LessEqual(const Vector a, const Vector b) { return _mm_cmple_pd(a, b); }
+	static Mask GreaterEqual(const Vector a, const Vector b) { return _mm_cmpge_pd(a, b); }
+	static Mask And(const Mask a, const Mask b) { return _mm_and_pd(a, b); }
+	static Mask Or(const Mask a, const Mask b) { return _mm_or_pd(a, b); }
+	static Mask Xor(const Mask a, const Mask b) { return _mm_xor_pd(a, b); }
+	static Vector Select(const Mask mask, const Vector a, const Vector b) { return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b)); }
+};
+
+template <>
+struct VectorLanes<float>
+{
+	using Vector = __m128;
+	using Mask = __m128;
+	static constexpr size_t width = 4;
+	static constexpr const char* name = "sse2";
+
+	static Vector Load(const float* values) { return _mm_load_ps(values); }
+	static void Store(float* values, const Vector vector) { _mm_store_ps(values, vector); }
+	static Vector Broadcast(const float value) { return _mm_set1_ps(value); }
+	static Vector Add(const Vector a, const Vector b) { return _mm_add_ps(a, b); }
+	static Vector Sub(const Vector a, const Vector b) { return _mm_sub_ps(a, b); }
+	static Vector Mul(const Vector a, const Vector b) { return _mm_mul_ps(a, b); }
+	static Vector Div(const Vector a, const Vector b) { return _mm_div_ps(a, b); }
+	static Mask Less(const Vector a, const Vector b) { return _mm_cmplt_ps(a, b); }
+	static Mask Greater(const Vector a, const Vector b) { return _mm_cmpgt_ps(a, b); }
+	static Mask LessEqual(const Vector a, const Vector b) { return _mm_cmple_ps(a, b); }
+	static Mask GreaterEqual(const Vector a, const Vector b) { return _mm_cmpge_ps(a, b); }
+	static Mask And(const Mask a, const Mask b) { return _mm_and_ps(a, b); }
+	static Mask Or(const Mask a, const Mask b) { return _mm_or_ps(a, b); }
+	static Mask Xor(const Mask a, const Mask b) { return _mm_xor_ps(a, b); }
+	static Vector Select(const Mask mask, const Vector a, const Vector b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+};
+
+#elif defined(__wasm_simd128__)
+
+template <>
+struct VectorLanes<double>
+{
+	using Vector = v128_t;
+	using Mask = v128_t;
+	static constexpr size_t width = 2;
+	static constexpr const char* name = "simd128";
+
+	static Vector Load(const double* values) { return wasm_v128_load(values); }
+	static void Store(double* values, const Vector vector) { wasm_v128_store(values, vector); }
+	static Vector Broadcast(const double value) { return wasm_f64x2_splat(value); }
+	static Vector Add(const Vector a, const Vector b) { return wasm_f64x2_add(a, b); }
+	static Vector Sub(const Vector a, const Vector b) { return wasm_f64x2_sub(a, b); }
+	static Vector Mul(const Vector a, const Vector b) { return wasm_f64x2_mul(a, b); }
+	static Vector Div(const Vector a, const Vector b) { return wasm_f64x2_div(a, b); }
+	static Mask Less(const Vector a, const Vector b) { return wasm_f64x2_lt(a, b); }
+	static Mask Greater(const Vector a, const Vector b) { return wasm_f64x2_gt(a, b); }
+	static Mask LessEqual(const Vector a, const Vector b) { return wasm_f64x2_le(a, b); }
+	static Mask GreaterEqual(const Vector a, const Vector b) { return wasm_f64x2_ge(a, b); }
+	static Mask And(const Mask a, const Mask b) { return wasm_v128_and(a, b); }
+	static Mask Or(const Mask a, const Mask b) { return wasm_v128_or(a, b); }
+	static Mask Xor(const Mask a, const Mask b) { return wasm_v128_xor(a, b); }
+	static Vector Select(const Mask mask, const Vector a, const Vector b) { return wasm_v128_bitselect(a, b, mask); }
+};
+
+template <>
+struct VectorLanes<float>
+{
+	using Vector = v128_t;
+	using Mask = v128_t;
+	static constexpr size_t width = 4;
+	static constexpr const char* name = "simd128";
+
+	static Vector Load(const float* values) { return wasm_v128_load(values); }
+	static void Store(float* values, const Vector vector) { wasm_v128_store(values, vector); }
+	static Vector Broadcast(const float value) { return wasm_f32x4_splat(value); }
+	static Vector Add(const Vector a, const Vector b) { return wasm_f32x4_add(a, b); }
+	static Vector Sub(const Vector a, const Vector b) { return wasm_f32x4_sub(a, b); }
+	static Vector Mul(const Vector a, const Vector b) { return wasm_f32x4_mul(a, b); }
+	static Vector Div(const Vector a, const Vector b) { return wasm_f32x4_div(a, b); }
+	static Mask Less(const Vector a, const Vector b) { return wasm_f32x4_lt(a, b); }
+	static Mask Greater(const Vector a, const Vector b) { return wasm_f32x4_gt(a, b); }
+	static Mask LessEqual(const Vector a, const Vector b) { return wasm_f32x4_le(a, b); }
+	static Mask GreaterEqual(const Vector a, const Vector b) { return wasm_f32x4_ge(a, b); }
+	static Mask And(const Mask a, const Mask b) { return wasm_v128_and(a, b); }
+	static Mask Or(const Mask a, const Mask b) { return wasm_v128_or(a, b); }
+	static Mask Xor(const Mask a, const Mask b) { return wasm_v128_xor(a, b); }
+	static Vector Select(const Mask mask, const Vector a, const Vector b) { return wasm_v128_bitselect(a, b, mask); }
+};
+
+#endif
+
+// Capacity PID controllers stored as a structure of arrays and updated together, a vector of lanes at a time. Every
+// lane produces bit for bit what a BasicPIDController<T> (or BasicAntiWindupPIDController<T>) with the same gains fed
+// the same errors would: the operations and their order are the same, only the branches become masks.
+template <typename T, size_t Capacity>
+class PIDBank
+{
+	static_assert(Capacity % 8 == 0, "the capacity must be a whole number of the widest vectors");
+private:
+	alignas(32) T output_min[Capacity] = {};
+	alignas(32) T output_max[Capacity] = {};
+	alignas(32) T Kp[Capacity] = {};
+	alignas(32) T Ki[Capacity] = {};
+	alignas(32) T Kd[Capacity] = {};
+	alignas(32) T anti_windup[Capacity] = {}; // 1 for an anti-windup controller, 0 otherwise
+	alignas(32) T integral[Capacity] = {};
+	alignas(32) T last_error[Capacity] = {};
+	alignas(32) T last_output[Capacity] = {};
+	alignas(32) T error[Capacity] = {};
+	size_t size = 0;
+
+	template <typename Lanes>
+	void Step(const T dt)
+	{
+		using Vector = typename Lanes::Vector;
+		const auto zero = Lanes::Broadcast(0);
+		const auto step = Lanes::Broadcast(dt);
+		for (size_t lane = 0; lane < size; lane += Lanes::width)
+		{
+			const auto e = Lanes::Load(error + lane);
+			const auto minimum = Lanes::Load(output_min + lane);
+			const auto maximum = Lanes::Load(output_max + lane);
+			const auto previous = Lanes::Load(last_output + lane);
+			const auto e_dt = Lanes::Mul(e, step);
+			Vector i = Lanes::Load(integral + lane);
+
+			// Guard against integrator windup
+			const auto within = Lanes::And(Lanes::GreaterEqual(previous, minimum), Lanes::LessEqual(previous, maximum));
+			const auto reversed = Lanes::Xor(Lanes::Greater(e, zero), Lanes::Greater(previous, zero));
+			const auto guard = Lanes::And(Lanes::Greater(Lanes::Load(anti_windup + lane), zero), Lanes::Or(within, reversed));
+			i = Lanes::Select(guard, Lanes::Sub(i, e_dt), i);
+
+			const auto P = Lanes::Mul(Lanes::Load(Kp + lane), e);
+			i = Lanes::Add(i, e_dt);
+			const auto I = Lanes::Mul(Lanes::Load(Ki + lane), i);
+			const auto D = Lanes::Mul(Lanes::Load(Kd + lane), Lanes::Div(Lanes::Sub(e, Lanes::Load(last_error + lane)), step));
+
+			auto output = Lanes::Add(Lanes::Add(P, I), D);
+			output = Lanes::Select(Lanes::Less(output, minimum), minimum, Lanes::Select(Lanes::Greater(output, maximum), maximum, output));
+
+			Lanes::Store(integral + lane, i);
+			Lanes::Store(last_output + lane, output);
+			Lanes::Store(last_error + lane, e);
+		}
+	}
+public:
+	static constexpr const char* VectorName() { return VectorLanes<T>::name; }
+
+	// Adds a controller and returns its lane, or -1 when the bank is full
+	int Add(const T min, const T max, const T p, const T i, const T d, const bool windup_guard)
+	{
+		if (size == Capacity) return -1;
+		output_min[size] = min;
+		output_max[size] = max;
+		Kp[size] = p;
+		Ki[size] = i;
+		Kd[size] = d;
+		anti_windup[size] = windup_guard ? 1 : 0;
+		return static_cast<int>(size++);
+	}
+
+	size_t Size() const { return size; }
+
+	// The error to feed a lane on the next update
+	T& Error(const size_t lane) { return error[lane]; }
+	// A lane's output from the last update
+	T Output(const size_t lane) const { return last_output[lane]; }
+
+	// Updates every lane with its error, a vector at a time. Lanes past Size() in the last vector are updated too, with
+	// zero gains and limits, and stay at zero.
+	void Update(const T dt) { Step<VectorLanes<T>>(dt); }
+	// The same, one lane at a time
+	void UpdateScalar(const T dt) { Step<ScalarLanes<T>>(dt); }
+};
\ No newline at end of file
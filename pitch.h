@@ -1,118 +1,189 @@
 #pragma once
 #include "aircraft_data.h"
+#include "gains.h"
+#include "input.h"
+#include "mpc.h"
 #include "protections.h"
 #include "pid.h"
 #include "pitch_control_mode.h"
+#include "pitch_law.h"
 #include "common.h"
+#include "telemetry.h"
 
 class PitchController
 {
 private:
-	// Controllers
-	AntiWindupPIDController aoa_controller = AntiWindupPIDController(-2, 2, 0.002, 0, 0.0002); // AoA error -> elevator handle movement rate
-	AntiWindupPIDController gforce_controller = AntiWindupPIDController(-2, 2, 0.008, 0.008, 0.001); // GForce error -> elevator handle movement rate
-	AntiWindupPIDController vertical_fpa_controller = AntiWindupPIDController(-2, 2, 0.0015, 0.0020, 0.002); // Vertical FPA error -> elevator handle movement rate
-	AntiWindupPIDController pitch_rate_controller = AntiWindupPIDController(-2, 2, 0.01, 0.015, 0.0025); // Pitch rate error -> elevator handle movement rate
+	AircraftData& aircraft_data;
+	InputCapture& input_capture;
+	PitchControlMode& pitch_control_mode;
+	NormalLawProtections& normal_law_protections;
+	PitchTelemetry& pitch_telemetry;
+
+	// Controllers; their gains come from ControlSurfaces, from construction on (see gain_tables.h)
+	AntiWindupPIDController aoa_controller = AntiWindupPIDController(-2, 2, 0, 0, 0); // AoA error -> elevator handle movement rate
+	AntiWindupPIDController gforce_controller = AntiWindupPIDController(-2, 2, 0, 0, 0); // GForce error -> elevator handle movement rate
+	AntiWindupPIDController vertical_fpa_controller = AntiWindupPIDController(-2, 2, 0, 0, 0); // Vertical FPA error -> elevator handle movement rate
+	AntiWindupPIDController pitch_rate_controller = AntiWindupPIDController(-2, 2, 0, 0, 0); // Pitch rate error -> elevator handle movement rate
+
+	// A protection's own state of a controller of the law, whose gains it shares: the demand it overrides updates the
+	// controller in the same step, and must not share an integral and a last error with it. The state starts afresh
+	// when the protection engages, as whatever it left off with is stale by then. A protection has no derivative term,
+	// which would move the elevator back towards the limit as soon as the aircraft recovers quickly: its output keeps
+	// the sign of its error, so it never moves the elevator towards a limit already exceeded.
+	struct ProtectionState
+	{
+		PIDState<double> state;
+		bool engaged = false; // Whether the last step used it
+		bool ran = false; // Whether this step used it so far
+
+		double Update(const AntiWindupPIDController& controller, const double error, const double dt)
+		{
+			if (!engaged && !ran) state = {};
+			ran = true;
+			state.last_error = error;
+			return controller.Evaluate(state, error, dt, state);
+		}
+		void EndStep()
+		{
+			engaged = ran;
+			ran = false;
+		}
+	};
+	ProtectionState load_factor_limitation; // Of gforce_controller
+	ProtectionState high_speed_protection; // Of pitch_rate_controller
+	ProtectionState pitch_attitude_protection; // Of pitch_rate_controller
 
 	double held_pitch_time = 0;
 	double held_vertical_fpa = 0;
 
+	PITCH_LAW law = NORMAL_LAW;
+	PITCH_PATH path = PATH_GROUND; // Of the last step
+
+	// Flight mode law optimizing the elevator over a horizon instead of the PIDs and protections of LoadFactorDemand
+	bool model_predictive = false;
+	bool model_predictive_engaged = false; // Whether the last step used it, to start afresh when it did not
+	bool model_predictive_ran = false; // Whether this step used it so far
+	ModelPredictivePitchController model_predictive_controller;
+	PitchPrediction prediction; // The last input of the model predictive controller
+	double model_predictive_rate = 0; // Of the elevator, per second, that it planned for this step
+	double last_pitch_rate = 0;
+	uint64_t model_predictive_plans = 0; // Steps it planned
+	uint64_t model_predictive_fallbacks = 0; // Steps it could not solve, which flew LoadFactorDemandPath
+
 	// Applies load factor limitation protection to a proposed elevator movement
-	double LoadFactorLimitation(const double delta_elevator, const double dt)
+	double LoadFactorLimitation(const double delta_elevator, const PitchStep& step)
 	{
-		if (aircraft_data.GForce() > normal_law_protections.MaxLoadFactor())
+		if (step.limits.above_max_load_factor)
 		{
-			const auto new_delta_elevator = gforce_controller.Update(normal_law_protections.MaxLoadFactor() - aircraft_data.GForce(), dt);
-			printf(",LF_LIMIT_MAX:PreDE=%lf,PostDE=%lf", delta_elevator, new_delta_elevator);
+			const auto new_delta_elevator = load_factor_limitation.Update(gforce_controller, normal_law_protections.MaxLoadFactor() - aircraft_data.GForce(), step.dt);
+			pitch_telemetry.Protection(TRACE_LF_LIMIT_MAX, delta_elevator, new_delta_elevator);
 			return new_delta_elevator;
 		}
 
-		if (aircraft_data.GForce() < normal_law_protections.MinLoadFactor())
+		if (step.limits.below_min_load_factor)
 		{
-			const auto new_delta_elevator = gforce_controller.Update(normal_law_protections.MinLoadFactor() - aircraft_data.GForce(), dt);
-			printf(",LF_LIMIT_MIN:PreDE=%lf,PostDE=%lf", delta_elevator, new_delta_elevator);
+			const auto new_delta_elevator = load_factor_limitation.Update(gforce_controller, normal_law_protections.MinLoadFactor() - aircraft_data.GForce(), step.dt);
+			pitch_telemetry.Protection(TRACE_LF_LIMIT_MIN, delta_elevator, new_delta_elevator);
 			return new_delta_elevator;
 		}
 		
 		return delta_elevator;
 	}
 
+	// The share of the nose-down authority high speed protection leaves the user
+	double HighSpeedUserAuthority()
+	{
+		// The FCOM says "As the speed increases above VMO/MMO, the sidestick nose-down authority is progressively reduced"
+		// Let's make the user have no authority above Vmo + 8, Mmo + 0.012 (arbitrarily chosen)
+		// We'll pick whichever path leaves the user with the least control
+		const auto knots = linear_decay_coefficient(aircraft_data.IAS(), aircraft_data.Vmo(), aircraft_data.Vmo() + 8);
+		const auto mach = linear_decay_coefficient(aircraft_data.Mach(), aircraft_data.Mmo(), aircraft_data.Mmo() + 0.012);
+		return fmin(knots, mach);
+	}
+
+	// The nose-up pitch rate high speed protection recovers with, in degrees/second
+	double HighSpeedRecoveryPitchRate()
+	{
+		// While accelerating, we'll act on the speed the trend reaches within the lead time, which is past Vmo/Mmo
+		// whenever the protection is anticipated, so the recovery starts before the limit rather than at it
+		const auto& predictor = normal_law_protections.Predictor();
+		const auto lead_time = normal_law_protections.HighSpeedProtLeadTime();
+		const auto ias = aircraft_data.IAS() + fmax(0, predictor.Trend(SIGNAL_IAS).Rate()) * lead_time;
+		const auto mach = aircraft_data.Mach() + fmax(0, predictor.Trend(SIGNAL_MACH).Rate()) * lead_time;
+
+		// We'll aim the speed for Vmo - 1, Mmo - 0.0015 (arbitrarily chosen)
+		// We'll cap at a maximum of 5 degrees/second pitch-up as the speed goes past Vmo + 16 degree, Mmo + 0.024 (arbitrarily chosen)
+		const auto knots_rate = 5 * linear_decay_coefficient(ias, aircraft_data.Vmo() + 16, aircraft_data.Vmo() - 1);
+		const auto mach_rate = 5 * linear_decay_coefficient(mach, aircraft_data.Mmo() + 0.024, aircraft_data.Mmo() - 0.0015);
+		return fmax(knots_rate, mach_rate);
+	}
+
 	// Applies high speed protection to a proposed elevator movement
-	double HighSpeedProtection(const double delta_elevator, const double dt)
+	double HighSpeedProtection(const double delta_elevator, const PitchStep& step)
 	{
-		if (!normal_law_protections.HighSpeedProtActive()) return delta_elevator;
+		if (!step.limits.high_speed_protection) return delta_elevator;
 
-		held_pitch_time = 0;
+		// Only once past Vmo/Mmo does the protection keep the flight path from being held
+		if (normal_law_protections.HighSpeedProtActive()) held_pitch_time = 0;
 		
-		double user = 0;
-		if (user < 0)
-		{
-			// The FCOM says "As the speed increases above VMO/MMO, the sidestick nose-down authority is progressively reduced"
-			// Let's make the user have no authority above Vmo + 8, Mmo + 0.012 (arbitrarily chosen)
-			// We'll pick whichever path leaves the user with the least control
-			const auto user_knots = user * linear_decay_coefficient(aircraft_data.IAS(), aircraft_data.Vmo(), aircraft_data.Vmo() + 8);
-			const auto user_mach = user * linear_decay_coefficient(aircraft_data.Mach(),aircraft_data.Mmo(), aircraft_data.Mmo() + 0.012);
-			user = fmax(user_knots, user_mach);
-		}
+		// The nose-down part of what the law asked for is the user's, and loses its authority with the speed
+		const auto user = delta_elevator < 0 ? delta_elevator * HighSpeedUserAuthority() : delta_elevator;
 
 		// Now let's get the nose-up input necessary
-		// We'll aim the speed for Vmo - 1, Mmo - 0.0015 (arbitrarily chosen)
-		// We'll cap at a maximum of 5 degrees/second pitch-up as the speed goes past Vmo + 16 degree, Mmo + 0.024 (arbitrarily chosen)
-		const auto recovery_pitch_rate_knots = 5 * linear_decay_coefficient(aircraft_data.IAS(), aircraft_data.Vmo() + 16, aircraft_data.Vmo() - 1);
-		const auto recovery_pitch_rate_mach = 5 * linear_decay_coefficient(aircraft_data.Mach(), aircraft_data.Mmo() + 0.024, aircraft_data.Mmo() - 0.0015);
-		const auto recovery_pitch_rate = fmax(recovery_pitch_rate_knots, recovery_pitch_rate_mach);
-		const auto recovery = pitch_rate_controller.Update(recovery_pitch_rate - aircraft_data.PitchRate(), dt);
+		const auto recovery_pitch_rate = HighSpeedRecoveryPitchRate();
+		const auto recovery = high_speed_protection.Update(pitch_rate_controller, recovery_pitch_rate - aircraft_data.PitchRate(), step.dt);
 
 		// Let's blend the two together
 		const auto new_delta_elevator = user + recovery;
-		printf(",OVSPD:PreDE=%lf,UserDE=%lf,RecDE=%lf,PostDE=%lf", delta_elevator, user, recovery, new_delta_elevator);
+		pitch_telemetry.Protection(TRACE_OVSPD, delta_elevator, user, recovery, new_delta_elevator);
 		return new_delta_elevator;
 	}
 
 	// Applies pitch attitude protection to a proposed elevator movement
-	double PitchAttitudeProtection(const double delta_elevator, const double dt)
+	double PitchAttitudeProtection(const double delta_elevator, const PitchStep& step)
 	{	
-		if (aircraft_data.Pitch() > normal_law_protections.MaxPitchAngle())
+		if (step.limits.above_max_pitch)
 		{
 			// Correct using up to -5 degrees/second pitch rate when we are up to 1 degree above our limit
 			// Thereafter, correct using -5 degrees/second pitch rate
 			const auto corrective_pitch_rate = -5 * linear_decay_coefficient(aircraft_data.Pitch(), normal_law_protections.MaxPitchAngle() + 1, normal_law_protections.MaxPitchAngle());
-			const auto new_delta_elevator = pitch_rate_controller.Update(corrective_pitch_rate - aircraft_data.PitchRate(), dt);
-			printf(",MAX_P_VIOL:PreDE=%lf,DesPR=%lf,PostDE=%lf", delta_elevator, corrective_pitch_rate, new_delta_elevator);
+			const auto new_delta_elevator = pitch_attitude_protection.Update(pitch_rate_controller, corrective_pitch_rate - aircraft_data.PitchRate(), step.dt);
+			pitch_telemetry.Protection(TRACE_MAX_P_VIOL, delta_elevator, corrective_pitch_rate, new_delta_elevator);
 			return new_delta_elevator;
 			
 		}
-		if (aircraft_data.Pitch() < normal_law_protections.MinPitchAngle())
+		if (step.limits.below_min_pitch)
 		{
 			// Correct using up to +5 degrees/second pitch rate when we are up to 1 degree above our limit
 			// Thereafter, correct using +5 degrees/second pitch rate
 			const auto corrective_pitch_rate = 5 * linear_decay_coefficient(aircraft_data.Pitch(), normal_law_protections.MinPitchAngle() - 1, normal_law_protections.MinPitchAngle());
-			const auto new_delta_elevator = pitch_rate_controller.Update(corrective_pitch_rate - aircraft_data.PitchRate(), dt);
-			printf(",MIN_P_VIOL:PreDE=%lf,DesPR=%lf,PostDE=%lf", delta_elevator, corrective_pitch_rate, new_delta_elevator);
+			const auto new_delta_elevator = pitch_attitude_protection.Update(pitch_rate_controller, corrective_pitch_rate - aircraft_data.PitchRate(), step.dt);
+			pitch_telemetry.Protection(TRACE_MIN_P_VIOL, delta_elevator, corrective_pitch_rate, new_delta_elevator);
 			return new_delta_elevator;
 		}
 		
-		// Naturally limit the pitch up/down rate from +/-30 degree/sec to 0 as we approach our limits
+		// Naturally limit the pitch up/down rate from +/-30 degree/sec to 0 as we approach our limits, unless load factor
+		// limitation is recovering from an exceeded limit, which comes first
 		const auto max_pitch_rate = 30 * linear_decay_coefficient(aircraft_data.Pitch(), 0, normal_law_protections.MaxPitchAngle());
-		if (aircraft_data.PitchRate() > max_pitch_rate && delta_elevator >= 0)
+		if (!load_factor_limitation.ran && aircraft_data.PitchRate() > max_pitch_rate && delta_elevator >= 0)
 		{
-			const auto new_delta_elevator = pitch_rate_controller.Update(max_pitch_rate - aircraft_data.PitchRate(), dt);
-			printf(",PR_LIM_MAX:PreDE=%lf,MaxPR=%lf,PostDE=%lf", delta_elevator, max_pitch_rate, new_delta_elevator);
+			const auto new_delta_elevator = pitch_attitude_protection.Update(pitch_rate_controller, max_pitch_rate - aircraft_data.PitchRate(), step.dt);
+			pitch_telemetry.Protection(TRACE_PR_LIM_MAX, delta_elevator, max_pitch_rate, new_delta_elevator);
 			return new_delta_elevator;
 		}
 		
 		const auto min_pitch_rate = -30 * linear_decay_coefficient(aircraft_data.Pitch(), 0, normal_law_protections.MinPitchAngle());
-		if (aircraft_data.PitchRate() < min_pitch_rate && delta_elevator <= 0)
+		if (!load_factor_limitation.ran && aircraft_data.PitchRate() < min_pitch_rate && delta_elevator <= 0)
 		{
-			const auto new_delta_elevator = pitch_rate_controller.Update(min_pitch_rate - aircraft_data.PitchRate(), dt);
-			printf(",PR_LIM_MAX:PreDE=%lf,MinPR=%lf,PostDE=%lf", delta_elevator, min_pitch_rate, new_delta_elevator);
+			const auto new_delta_elevator = pitch_attitude_protection.Update(pitch_rate_controller, min_pitch_rate - aircraft_data.PitchRate(), step.dt);
+			pitch_telemetry.Protection(TRACE_PR_LIM_MIN, delta_elevator, min_pitch_rate, new_delta_elevator);
 			return new_delta_elevator;
 		}
 
 		return delta_elevator;
 	}
 
-	// Applies rules assuming sidestick demands angle of attack
+	// Applies rules assuming sidestick demands angle of attack (see AoaDemandPath for the protections that follow)
 	double AngleOfAttackDemand(const double dt)
 	{
 		held_pitch_time = 0;
@@ -123,17 +194,12 @@ private:
 			  // Neutral -> Full Down = AoA proportional range from alpha_prot -> 0 AoA
 			: linear_range(input_capture.YokeY(), aircraft_data.AlphaProt(), 0);
 
-		auto delta_elevator = aoa_controller.Update(commanded_aoa - aircraft_data.Alpha(), dt);
-		printf("AOA:AOA=%lf,DesAOA=%lf,ErrAOA=%lf", aircraft_data.Alpha(), commanded_aoa,  commanded_aoa - aircraft_data.Alpha());
-
-		// Apply protections
-		delta_elevator = LoadFactorLimitation(delta_elevator, dt);
-		delta_elevator = PitchAttitudeProtection(delta_elevator, dt); // This isn't specified in the FCOM, but the flight model is not true enough to real life
-		
+		const auto delta_elevator = aoa_controller.Update(commanded_aoa - aircraft_data.Alpha(), dt);
+		pitch_telemetry.Demand(TRACE_AOA, aircraft_data.Alpha(), commanded_aoa, commanded_aoa - aircraft_data.Alpha());
 		return delta_elevator;
 	}
 
-	// Applies rules assuming sidestick demands load factor
+	// Applies rules assuming sidestick demands load factor (see LoadFactorDemandPath for the protections that follow)
 	double LoadFactorDemand(const double dt)
 	{
 		double delta_elevator;
@@ -146,22 +212,22 @@ private:
 				delta_elevator = pitch_rate_controller.Update(0 - aircraft_data.PitchRate(), dt);
 				held_vertical_fpa = aircraft_data.VFPA();
 				held_pitch_time += dt;
-				printf("HOLD_PITCH:");
+				pitch_telemetry.Demand(TRACE_HOLD_PITCH);
 			}
 			else
 			{
 				// Hold the VFPA				
 				delta_elevator = vertical_fpa_controller.Update(held_vertical_fpa - aircraft_data.VFPA(), dt);
-				printf("HOLD_VFPA:DesVFPA=%lf", held_vertical_fpa);
+				pitch_telemetry.Demand(TRACE_HOLD_VFPA, held_vertical_fpa);
 			}
 		}
-		else if (input_capture.YokeY() == 0 && fabs(aircraft_data.Roll() > normal_law_protections.NominalBankAngle()))
+		else if (input_capture.YokeY() == 0 && fabs(aircraft_data.Roll()) > normal_law_protections.NominalBankAngle())
 		{
 			held_pitch_time = 0;
 			
 			// Neutral y, but we're rolling and bank angle is greater than our nominal bank angle = Drop pitch to 1G LF
 			delta_elevator = gforce_controller.Update(1 - aircraft_data.GForce(), dt);
-			printf("ROLL_1G:");
+			pitch_telemetry.Demand(TRACE_ROLL_1G);
 		}
 		else if (input_capture.YokeY() == 0)
 		{
@@ -169,7 +235,7 @@ private:
 			
 			// Neutral y, but we're rolling and bank angle is less than our nominal bank angle = Hold pitch
 			delta_elevator = pitch_rate_controller.Update(0 - aircraft_data.PitchRate(), dt);
-			printf("HOLD_PITCH:");
+			pitch_telemetry.Demand(TRACE_HOLD_PITCH);
 		}
 		else
 		{
@@ -177,7 +243,7 @@ private:
 			held_pitch_time = 0;
 
 			// Determine the normal load factor for our bank angle
-			const auto normal_load_factor = 1 / cos(radians(aircraft_data.Roll()));
+			const auto normal_load_factor = aircraft_data.NormalLoadFactor();
 
 			// Determine the user's requested load factor
 			const auto requested_load_factor = input_capture.YokeY() >= 0 ?
@@ -185,17 +251,101 @@ private:
 				: linear_range(-input_capture.YokeY(), normal_load_factor, normal_law_protections.MinLoadFactor());
 
 			delta_elevator = gforce_controller.Update(requested_load_factor - aircraft_data.GForce(), dt);
-			printf("CMD_LF:NLF=%lf,RLF=%lf,LFErr=%lf", normal_load_factor, requested_load_factor, requested_load_factor - aircraft_data.GForce());
+			pitch_telemetry.Demand(TRACE_CMD_LF, normal_load_factor, requested_load_factor, requested_load_factor - aircraft_data.GForce());
 		}
-
-		// Apply protections
-		delta_elevator = HighSpeedProtection(delta_elevator, dt);
-		delta_elevator = LoadFactorLimitation(delta_elevator, dt);
-		delta_elevator = PitchAttitudeProtection(delta_elevator, dt);
-		
 		return delta_elevator;
 	}
 
+	// Plans the elevator with the model predictive controller, by the rules of LoadFactorDemand as load factors, with
+	// the load factor and pitch attitude protections as its constraints and high speed protection in its target. The
+	// plan recovers towards the limits it cannot keep. Returns false, leaving the held pitch and flight path as they
+	// were, if it could not be solved at all (see ModelPredictivePitchController::Solved()): the step then flies
+	// LoadFactorDemandPath and its protections instead.
+	bool PlanModelPredictive(const double current_elevator, const double dt)
+	{
+		const auto saved_held_pitch_time = held_pitch_time;
+		const auto saved_held_vertical_fpa = held_vertical_fpa;
+		const auto normal_load_factor = aircraft_data.NormalLoadFactor();
+		double target_load_factor;
+		if (input_capture.YokeX() == 0 && input_capture.YokeY() == 0)
+		{
+			if (held_pitch_time < 5)
+			{
+				// Let the flight path settle for 5 seconds before holding it
+				target_load_factor = normal_load_factor;
+				held_vertical_fpa = aircraft_data.VFPA();
+				held_pitch_time += dt;
+			}
+			else
+			{
+				// Hold the VFPA, asking for up to 0.2 G more or less to get back to it
+				target_load_factor = normal_load_factor + clamp(0.05 * (held_vertical_fpa - aircraft_data.VFPA()), -0.2, 0.2);
+			}
+		}
+		else if (input_capture.YokeY() == 0 && fabs(aircraft_data.Roll()) > normal_law_protections.NominalBankAngle())
+		{
+			held_pitch_time = 0;
+			target_load_factor = 1;
+		}
+		else if (input_capture.YokeY() == 0)
+		{
+			held_pitch_time = 0;
+			target_load_factor = normal_load_factor;
+		}
+		else
+		{
+			held_pitch_time = 0;
+			target_load_factor = input_capture.YokeY() >= 0 ?
+				  linear_range(input_capture.YokeY(), normal_load_factor, normal_law_protections.MaxLoadFactor())
+				: linear_range(-input_capture.YokeY(), normal_load_factor, normal_law_protections.MinLoadFactor());
+		}
+
+		// High speed protection is part of the plan: the nose-down part of the target loses its authority with the speed,
+		// and the recovery pitch rate is asked for as the load factor that turns the flight path at that rate
+		if (normal_law_protections.HighSpeedProtActive() || normal_law_protections.HighSpeedProtAnticipated())
+		{
+			if (normal_law_protections.HighSpeedProtActive()) held_pitch_time = 0;
+			if (target_load_factor < normal_load_factor) target_load_factor = normal_load_factor + (target_load_factor - normal_load_factor) * HighSpeedUserAuthority();
+			target_load_factor += radians(HighSpeedRecoveryPitchRate()) * aircraft_data.Speed() / 32.174;
+		}
+
+		if (!model_predictive_engaged) model_predictive_controller.Reset();
+
+		prediction.alpha = aircraft_data.Alpha();
+		prediction.pitch = aircraft_data.Pitch();
+		prediction.pitch_rate = aircraft_data.PitchRate();
+		prediction.pitch_acceleration = model_predictive_engaged ? (aircraft_data.PitchRate() - last_pitch_rate) / dt : 0;
+		last_pitch_rate = aircraft_data.PitchRate();
+		prediction.gforce = aircraft_data.GForce();
+		prediction.elevator = current_elevator;
+		prediction.ias = aircraft_data.IAS();
+		prediction.mach = aircraft_data.Mach();
+		prediction.speed = aircraft_data.Speed();
+		prediction.roll = aircraft_data.Roll();
+		prediction.vfpa = aircraft_data.VFPA();
+		prediction.target_load_factor = target_load_factor;
+		prediction.min_load_factor = normal_law_protections.MinLoadFactor();
+		prediction.max_load_factor = normal_law_protections.MaxLoadFactor();
+		prediction.min_pitch = normal_law_protections.MinPitchAngle();
+		prediction.max_pitch = normal_law_protections.MaxPitchAngle();
+		prediction.alpha_max = aircraft_data.AlphaMax();
+		model_predictive_plans++;
+		model_predictive_rate = model_predictive_controller.Update(prediction);
+		if (model_predictive_controller.Solved()) return true;
+
+		held_pitch_time = saved_held_pitch_time;
+		held_vertical_fpa = saved_held_vertical_fpa;
+		model_predictive_fallbacks++;
+		return false;
+	}
+
+	// Flies the plan of PlanModelPredictive
+	double ModelPredictiveDemand(const double dt)
+	{
+		pitch_telemetry.Demand(TRACE_MPC, prediction.target_load_factor, prediction.target_load_factor - aircraft_data.GForce(), model_predictive_controller.Iterations());
+		model_predictive_ran = true;
+		return model_predictive_rate * dt;
+	}
 	
 	double FlareModeDemand(const double dt)
 	{
@@ -220,34 +370,136 @@ private:
 		}
 
 		const auto delta_elevator = pitch_rate_controller.Update(pitch_rate - aircraft_data.PitchRate(), dt);
-		printf("FLARE:DesPR=%lf,RH=%lf", pitch_rate, aircraft_data.RadioHeight());
+		pitch_telemetry.Demand(TRACE_FLARE, pitch_rate, aircraft_data.RadioHeight());
 		return delta_elevator;
 	}
+
+	// Stages of the pitch laws (see pitch_law.h)
+	struct LimitsStage
+	{
+		static double Apply(PitchController& pitch, PitchStep& step, double)
+		{
+			auto& aircraft_data = pitch.aircraft_data;
+			auto& protections = pitch.normal_law_protections;
+			step.limits.above_max_pitch = aircraft_data.Pitch() > protections.MaxPitchAngle();
+			step.limits.below_min_pitch = aircraft_data.Pitch() < protections.MinPitchAngle();
+			step.limits.above_max_load_factor = aircraft_data.GForce() > protections.MaxLoadFactor();
+			step.limits.below_min_load_factor = aircraft_data.GForce() < protections.MinLoadFactor();
+			step.limits.high_speed_protection = protections.HighSpeedProtActive() || protections.HighSpeedProtAnticipated();
+			return 0;
+		}
+	};
+	struct DirectStage { static double Apply(PitchController& pitch, const PitchStep&, double) { return pitch.input_capture.RawYokeY(); } };
+	struct AoaDemandStage { static double Apply(PitchController& pitch, const PitchStep& step, double) { return pitch.AngleOfAttackDemand(step.dt); } };
+	struct FlareDemandStage { static double Apply(PitchController& pitch, const PitchStep& step, double) { return pitch.FlareModeDemand(step.dt); } };
+	struct ModelPredictiveStage { static double Apply(PitchController& pitch, const PitchStep& step, double) { return pitch.ModelPredictiveDemand(step.dt); } };
+	struct LoadFactorDemandStage { static double Apply(PitchController& pitch, const PitchStep& step, double) { return pitch.LoadFactorDemand(step.dt); } };
+	struct HighSpeedStage { static double Apply(PitchController& pitch, const PitchStep& step, double delta) { return pitch.HighSpeedProtection(delta, step); } };
+	struct LoadFactorLimitationStage { static double Apply(PitchController& pitch, const PitchStep& step, double delta) { return pitch.LoadFactorLimitation(delta, step); } };
+	// This isn't specified in the FCOM, but the flight model is not true enough to real life
+	struct PitchAttitudeStage { static double Apply(PitchController& pitch, const PitchStep& step, double delta) { return pitch.PitchAttitudeProtection(delta, step); } };
+	struct IntegrateStage { static double Apply(PitchController&, const PitchStep& step, double delta) { return step.current_elevator + delta; } };
+
+	// The elevator follows the sidestick: on the ground, and in direct law
+	using DirectPath = PitchPipeline<DirectStage>;
+	using AoaDemandPath = PitchPipeline<LimitsStage, AoaDemandStage, LoadFactorLimitationStage, PitchAttitudeStage, IntegrateStage>;
+	// Flare mode has a special effect and does not have all the protections of flight mode
+	using FlarePath = PitchPipeline<FlareDemandStage, IntegrateStage>;
+	using ModelPredictivePath = PitchPipeline<ModelPredictiveStage, IntegrateStage>;
+	using LoadFactorDemandPath = PitchPipeline<LimitsStage, LoadFactorDemandStage, HighSpeedStage, LoadFactorLimitationStage, PitchAttitudeStage, IntegrateStage>;
+	// Alternate law loses every protection but load factor limitation
+	using AlternatePath = PitchPipeline<LimitsStage, LoadFactorDemandStage, LoadFactorLimitationStage, IntegrateStage>;
 public:
-	
-	double Calculate(const double current_elevator, const double t, const double dt)
+	PitchController(AircraftData& aircraft_data, InputCapture& input_capture, PitchControlMode& pitch_control_mode, NormalLawProtections& normal_law_protections, PitchTelemetry& pitch_telemetry)
+		: aircraft_data(aircraft_data), input_capture(input_capture),
+		pitch_control_mode(pitch_control_mode), normal_law_protections(normal_law_protections),
+		pitch_telemetry(pitch_telemetry) {};
+
+	bool ModelPredictive() { return model_predictive; }
+	void SetModelPredictive(const bool value) { model_predictive = value; }
+	PITCH_LAW Law() { return law; }
+	void SetLaw(const PITCH_LAW value) { law = value; }
+	// The path the last step took through its law
+	PITCH_PATH Path() { return path; }
+	// Takes the gains of the PID controllers from the scheduler, once per control step
+	void SetGains(const GainScheduler& scheduler)
 	{
-		// On the ground, pitch is direct
-		// TODO: Add ground mode calculations (e.g. when aircraft reaches 70 knots during the T/O roll, maximum deflection of elevators is affected)
+		const auto set = [&scheduler](AntiWindupPIDController& controller, const GAIN_CONTROLLER gains)
+		{
+			const auto& value = scheduler.Gains(gains);
+			controller.SetGains(value.kp, value.ki, value.kd);
+		};
+		set(aoa_controller, GAIN_AOA);
+		set(gforce_controller, GAIN_GFORCE);
+		set(vertical_fpa_controller, GAIN_VERTICAL_FPA);
+		set(pitch_rate_controller, GAIN_PITCH_RATE);
+	}
+	// The PID controller of the flight law that gains schedules, from GAIN_AOA to GAIN_PITCH_RATE
+	const AntiWindupPIDController& Controller(const GAIN_CONTROLLER gains) const
+	{
+		switch (gains)
+		{
+		case GAIN_AOA: return aoa_controller;
+		case GAIN_GFORCE: return gforce_controller;
+		case GAIN_VERTICAL_FPA: return vertical_fpa_controller;
+		default: return pitch_rate_controller;
+		}
+	}
+	// Whether the last step used the model predictive controller, and what it was given
+	bool ModelPredictiveEngaged() { return model_predictive_engaged; }
+	const PitchPrediction& LastPrediction() { return prediction; }
+	ModelPredictivePitchController& ModelPredictiveController() { return model_predictive_controller; }
+	// Steps the model predictive controller planned, and those in which it could not solve its plan, and the load
+	// factor demand law flew
+	uint64_t ModelPredictivePlans() { return model_predictive_plans; }
+	uint64_t ModelPredictiveFallbacks() { return model_predictive_fallbacks; }
 
-		double new_elevator;
-		if (pitch_control_mode.Mode() == GROUND_MODE) new_elevator = input_capture.RawYokeY();
+	// Flattened, so that the pipeline of every route through the switch below is inlined into its case
+	__attribute__((flatten)) double Calculate(const double current_elevator, const double t, const double dt)
+	{
+		// TODO: Add ground mode calculations (e.g. when aircraft reaches 70 knots during the T/O roll, maximum deflection of elevators is affected)
 
-		// AoA protections are available in both flight/flare modes
-		else if (normal_law_protections.AoaDemandActive()) new_elevator = current_elevator + AngleOfAttackDemand(dt);
+		// AoA protections are available in both flight and flare modes
+		path = pitch_control_mode.Mode() == GROUND_MODE ? PATH_GROUND
+			: normal_law_protections.AoaDemandActive() ? PATH_AOA_DEMAND
+			: pitch_control_mode.FlareEffect() > 0 ? PATH_FLARE
+			: model_predictive ? PATH_MODEL_PREDICTIVE : PATH_LOAD_FACTOR_DEMAND;
 
-		// Flare mode has a special effect and does not have all the protections of flight mode
-		else if (pitch_control_mode.FlareEffect() > 0) new_elevator = current_elevator + FlareModeDemand(dt);
+		PitchStep step;
+		step.current_elevator = current_elevator;
+		step.dt = dt;
+		model_predictive_ran = false;
+		// The model predictive law is planned ahead of its route, which it leaves to the load factor demand law if unsolved
+		if (PitchRoute(law, path) == PitchRoute(NORMAL_LAW, PATH_MODEL_PREDICTIVE) && !PlanModelPredictive(current_elevator, dt)) path = PATH_LOAD_FACTOR_DEMAND;
 
-		// Flight mode
-		else new_elevator = current_elevator + LoadFactorDemand(dt);
+		// A single jump on the route, whatever the number of laws
+		double new_elevator;
+		switch (PitchRoute(law, path))
+		{
+		case PitchRoute(NORMAL_LAW, PATH_AOA_DEMAND): new_elevator = AoaDemandPath::Run(*this, step); break;
+		case PitchRoute(NORMAL_LAW, PATH_FLARE): new_elevator = FlarePath::Run(*this, step); break;
+		case PitchRoute(NORMAL_LAW, PATH_MODEL_PREDICTIVE): new_elevator = ModelPredictivePath::Run(*this, step); break;
+		case PitchRoute(NORMAL_LAW, PATH_LOAD_FACTOR_DEMAND): new_elevator = LoadFactorDemandPath::Run(*this, step); break;
+		case PitchRoute(ALTERNATE_LAW, PATH_AOA_DEMAND):
+		case PitchRoute(ALTERNATE_LAW, PATH_MODEL_PREDICTIVE):
+		case PitchRoute(ALTERNATE_LAW, PATH_LOAD_FACTOR_DEMAND): new_elevator = AlternatePath::Run(*this, step); break;
+		// On the ground in every law, in flare out of normal law, and in direct law
+		default: new_elevator = DirectPath::Run(*this, step); break;
+		}
+		model_predictive_engaged = model_predictive_ran;
+		load_factor_limitation.EndStep();
+		high_speed_protection.EndStep();
+		pitch_attitude_protection.EndStep();
 
 		new_elevator = clamp(new_elevator, -1, 1);
-		printf(",P=%lf,PR=%lf,VFPA=%lf,VFPAR=%lf,LF=%lf,DE=%lf,E=%lf\n",
-			aircraft_data.Pitch(), aircraft_data.PitchRate(),
-			aircraft_data.VFPA(), aircraft_data.VFPARate(),
-			aircraft_data.GForce(),
-			new_elevator - current_elevator, new_elevator);
+		if (pitch_telemetry.Enabled())
+		{
+			pitch_telemetry.Commit(t,
+				aircraft_data.Pitch(), aircraft_data.PitchRate(),
+				aircraft_data.VFPA(), aircraft_data.VFPARate(),
+				aircraft_data.GForce(),
+				new_elevator - current_elevator, new_elevator);
+		}
 		return new_elevator;
 	}
 };
\ No newline at end of file
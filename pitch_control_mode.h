@@ -13,6 +13,8 @@ enum PITCH_CONTROL_MODE
 class PitchControlMode
 {
 private:
+	AircraftData& aircraft_data;
+
 	PITCH_CONTROL_MODE mode = GROUND_MODE;
 
 	double ground_effect = 1;
@@ -120,6 +122,9 @@ private:
 		
 	}
 public:
+	PitchControlMode(AircraftData& aircraft_data)
+		: aircraft_data(aircraft_data) {};
+
 	PITCH_CONTROL_MODE Mode() { return mode; }
 	double GroundEffect() { return ground_effect; }
 	double FlightEffect() { return flight_effect; }
@@ -141,5 +146,4 @@ public:
 			break;
 		}
 	}
-};
-PitchControlMode pitch_control_mode;
\ No newline at end of file
+};
\ No newline at end of file
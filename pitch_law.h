@@ -0,0 +1,64 @@
+#pragma once
+// Pitch laws composed at compile time (see PitchController). Each path a law can take through a control step is a
+// fixed list of stages, so that a step costs a single jump, through a table, to the pipeline of its route (its law and
+// path), in which the stages are inlined one after the other. A new law adds routes to the table, not branches.
+
+// The flight control laws, from normal towards the most degraded
+enum PITCH_LAW
+{
+	NORMAL_LAW,
+	ALTERNATE_LAW,
+	DIRECT_LAW,
+	PITCH_LAW_COUNT
+};
+
+// What a control step has to do, from the pitch control mode and the protections, in order of precedence
+enum PITCH_PATH
+{
+	PATH_GROUND,
+	PATH_AOA_DEMAND,
+	PATH_FLARE,
+	PATH_MODEL_PREDICTIVE,
+	PATH_LOAD_FACTOR_DEMAND,
+	PITCH_PATH_COUNT
+};
+
+// The law and path of a control step as a single index, to switch on
+constexpr int PitchRoute(const PITCH_LAW law, const PITCH_PATH path)
+{
+	return law * PITCH_PATH_COUNT + path;
+}
+
+// The limits the protections compare the aircraft against, compared once per control step by the first stage of the
+// paths that have protections
+struct PitchLimits
+{
+	bool above_max_pitch;
+	bool below_min_pitch;
+	bool above_max_load_factor;
+	bool below_min_load_factor;
+	bool high_speed_protection; // Active or anticipated
+};
+
+// What every stage of a control step is given
+struct PitchStep
+{
+	double current_elevator;
+	double dt;
+	PitchLimits limits;
+};
+
+// Runs Stages in order, each given what the one before returned through its static Apply(controller, step, value).
+// Demands ignore the value they are given and return an elevator movement, protections adjust the movement, and the
+// last stage turns it into the elevator position the step returns. Stages may fill in step for the ones after them.
+template <typename... Stages>
+struct PitchPipeline
+{
+	template <typename Controller>
+	static double Run(Controller& controller, PitchStep& step)
+	{
+		auto value = 0.0;
+		((value = Stages::Apply(controller, step, value)), ...);
+		return value;
+	}
+};
\ No newline at end of file
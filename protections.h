@@ -1,10 +1,14 @@
 #pragma once
 #include "aircraft_data.h"
+#include "envelope.h"
 #include "input.h"
 
 class NormalLawProtections
 {
 private:
+	AircraftData& aircraft_data;
+	InputCapture& input_capture;
+
 	double max_bank_angle = 67; // Maximum bank angle in degrees
 									// - Normally: 67 degrees
 									// - High Angle of Attack Protection: 45 degrees
@@ -18,18 +22,28 @@ private:
 	double max_pitch_angle = 30; // Maximum pitch attitude in degrees
 									 // 30 degrees nose up in conf 0-3 (progressively reduced to 25 degrees at low speed)
 									 // 25 degrees nose up in conf FULL (progressively reduced to 20 degrees at low speed)
-									 // TODO: To implement the 'progressively reduced' limitation, we need to find a way to
-									 //       calculate speeds like V_alpha_prot or V_alpha_max, for which I think we will
-									 //       have to work out via experimentation.
+									 // From V_alpha_prot down to V_alpha_max (see flight_envelope.h)
 	double min_pitch_angle = -15; // Minimum pitch attitude in degrees
 
 	bool aoa_demand_active = false;
 	double aoa_demand_deactivation_timer = 0;
 	bool high_speed_protection_active = false;
+	bool high_speed_protection_anticipated = false;
+
+	// High speed protection engages this many seconds before the speed trend reaches Vmo/Mmo
+	double high_speed_prot_lead_time = 2;
+	EnvelopePredictor envelope_predictor;
 
 public:
+	NormalLawProtections(AircraftData& aircraft_data, InputCapture& input_capture)
+		: aircraft_data(aircraft_data), input_capture(input_capture) {};
+
 	bool AoaDemandActive() { return aoa_demand_active; }
 	bool HighSpeedProtActive() { return high_speed_protection_active; }
+	// The speed is below Vmo/Mmo, but will be above within the lead time
+	bool HighSpeedProtAnticipated() { return high_speed_protection_anticipated; }
+	double HighSpeedProtLeadTime() { return high_speed_prot_lead_time; }
+	const EnvelopePredictor& Predictor() { return envelope_predictor; }
 	double MaxBankAngle() { return max_bank_angle; }
 	double MaxLoadFactor() { return max_load_factor; }
 	double MaxPitchAngle() { return max_pitch_angle; }
@@ -39,6 +53,31 @@ public:
 	
 	void Update(const double t, const double dt)
 	{
+		// Update load and pitch factors, first as the envelope predictor measures the time to them
+		switch (aircraft_data.Flaps())
+		{
+		case 0: // Clean CONF
+			min_load_factor = -1;
+			max_load_factor = 2.5;
+			break;
+		case 1: // CONF 1
+		case 2: // CONF 2
+		case 3: // CONF 3
+			min_load_factor = 0;
+			max_load_factor = 2;
+			break;
+		case 4: // CONF FULL
+			min_load_factor = 0;
+			max_load_factor = 2;
+			break;
+		default: break;
+		}
+		max_pitch_angle = MaxPitchAttitude(aircraft_data.Envelope(), aircraft_data.IAS());
+
+		envelope_predictor.Update(aircraft_data, {
+			aircraft_data.AlphaProt(), aircraft_data.Vmo(), aircraft_data.Mmo(),
+			max_pitch_angle, min_pitch_angle, max_load_factor, min_load_factor }, dt);
+
 		// Check if we are in AoA demand mode (as dictated by the High Angle of Attack Protection)
 		if (aoa_demand_active)
 		{
@@ -80,6 +119,8 @@ public:
 		// Check if high speed protection is active
 		high_speed_protection_active = aircraft_data.IAS() > aircraft_data.Vmo()
 		  	                        || aircraft_data.Mach() > aircraft_data.Mmo();
+		high_speed_protection_anticipated = !high_speed_protection_active
+			&& (envelope_predictor.TimeToLimit(LIMIT_VMO) < high_speed_prot_lead_time || envelope_predictor.TimeToLimit(LIMIT_MMO) < high_speed_prot_lead_time);
 
 		// Update bank angle limits
 		if (aoa_demand_active || high_speed_protection_active)
@@ -92,29 +133,5 @@ public:
 			max_bank_angle = 67;
 			nominal_bank_angle = 33;
 		}
-
-		// Update load and pitch factors
-		switch (aircraft_data.Flaps())
-		{
-		case 0: // Clean CONF
-			min_load_factor = -1;
-			max_load_factor = 2.5;
-			max_pitch_angle = 30;
-			break;
-		case 1: // CONF 1
-		case 2: // CONF 2
-		case 3: // CONF 3
-			min_load_factor = 0;
-			max_load_factor = 2;
-			max_pitch_angle = 30;
-			break;
-		case 4: // CONF FULL
-			min_load_factor = 0;
-			max_load_factor = 2;
-			max_pitch_angle = 25;
-			break;
-		default: break;
-		}
 	}
-};
-NormalLawProtections normal_law_protections;
\ No newline at end of file
+};
\ No newline at end of file
@@ -0,0 +1,173 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "common.h"
+#include "aircraft_data.h"
+#include "input.h"
+#include "sim_data.h"
+
+// A recording is a sequence of sessions, each a RecordingHeader followed by blocks of up to recording_block_frames
+// frames. A block is a RecordingBlockHeader followed by its columns, each padded to 8 bytes:
+//   double t[frames], double dt[frames]
+//   double <simvar>[frames] for every entry of aircraft_simvars, in order
+//   uint32_t events[frames] (the number of input events applied before each frame)
+//   uint32_t event_id[event_count], int32_t event_data[event_count]
+// Blocks are only ever appended, so a recording cut short (e.g. by a crash) is valid up to its last whole block.
+constexpr uint32_t recording_version = 1;
+constexpr uint32_t recording_block_frames = 1024;
+constexpr uint32_t recording_block_events = 4096;
+
+// How the recorded instance was configured, which a replay has to configure the same way
+enum RECORDING_FLAG
+{
+	RECORDING_PITCH_MPC = 1, // The model predictive pitch law (see mpc.h) was enabled
+	RECORDING_FINITE_DIFFERENCE = 2, // The rates were derived by ESTIMATOR_FINITE_DIFFERENCE (see estimator.h)
+	RECORDING_ACTUATORS = 4, // The surface actuators were modelled (see actuators.h)
+};
+
+struct RecordingHeader
+{
+	char magic[4]; // "FBWR"
+	uint32_t version;
+	uint32_t simvar_count; // aircraft_simvar_count of the gauge that recorded
+	uint32_t flags; // RECORDING_FLAG bits
+	double control_rate; // The FixedRateScheduler configuration, which a replay must use to be exact
+	int32_t max_control_steps;
+	uint32_t reserved2;
+};
+static_assert(sizeof(RecordingHeader) == 32, "RecordingHeader layout is part of the file format");
+
+struct RecordingBlockHeader
+{
+	char magic[4]; // "FBWB"
+	uint32_t frame_count;
+	uint32_t event_count;
+	uint32_t size; // Bytes in the block, including this header
+};
+static_assert(sizeof(RecordingBlockHeader) == 16, "RecordingBlockHeader layout is part of the file format");
+
+constexpr size_t RecordingPadding(const size_t bytes)
+{
+	return (8 - bytes % 8) % 8;
+}
+
+constexpr size_t RecordingBlockSize(const size_t frames, const size_t events)
+{
+	return sizeof(RecordingBlockHeader)
+		+ (2 + aircraft_simvar_count) * frames * sizeof(double)
+		+ frames * sizeof(uint32_t) + RecordingPadding(frames * sizeof(uint32_t))
+		+ 2 * (events * sizeof(uint32_t) + RecordingPadding(events * sizeof(uint32_t)));
+}
+
+#ifndef FBW_RECORD_FILE
+#define FBW_RECORD_FILE "\\work\\fbw_recording.bin"
+#endif
+
+// Records everything an FbwInstance is given (samples, input events, t and dt) to FBW_RECORD_FILE, so that the flight
+// can be replayed exactly by tools/fbw_replay. A replay starts from a fresh instance, so a recording has to cover the
+// whole life of the instance: it is enabled by setting the A32NX_FBW_RECORD LVar before the gauge is installed.
+// The configuration of the instance is recorded as RECORDING_FLAG bits.
+class FlightRecorder
+{
+private:
+	double control_rate;
+	int max_control_steps;
+	bool recording = false;
+	FILE * file = nullptr;
+
+	// The block being filled; frames are stored column by column
+	double columns[2 + aircraft_simvar_count][recording_block_frames];
+	uint32_t frame_events[recording_block_frames];
+	uint32_t event_ids[recording_block_events];
+	int32_t event_data[recording_block_events];
+	uint32_t frames = 0;
+	uint32_t events = 0; // Including the events of the frame not recorded yet
+	uint32_t block_events = 0; // Events of the recorded frames
+	uint32_t dropped_events = 0;
+
+	void WriteColumn(const void* data, const size_t size)
+	{
+		static const char padding[8] = {};
+		fwrite(data, size, 1, file);
+		fwrite(padding, RecordingPadding(size), 1, file);
+	}
+
+	// Writes the recorded frames as one block; the events of the frame in progress are kept for the next block
+	void Flush()
+	{
+		if (frames == 0) return;
+		const RecordingBlockHeader header = { { 'F', 'B', 'W', 'B' }, frames, block_events, static_cast<uint32_t>(RecordingBlockSize(frames, block_events)) };
+		fwrite(&header, sizeof(header), 1, file);
+		for (const auto& column : columns) WriteColumn(column, frames * sizeof(double));
+		WriteColumn(frame_events, frames * sizeof(uint32_t));
+		WriteColumn(event_ids, block_events * sizeof(uint32_t));
+		WriteColumn(event_data, block_events * sizeof(int32_t));
+		fflush(file);
+
+		const auto pending = events - block_events;
+		memmove(event_ids, event_ids + block_events, pending * sizeof(uint32_t));
+		memmove(event_data, event_data + block_events, pending * sizeof(int32_t));
+		frames = 0;
+		events = pending;
+		block_events = 0;
+	}
+public:
+	FlightRecorder(const double control_rate, const int max_control_steps)
+		: control_rate(control_rate), max_control_steps(max_control_steps) {};
+
+	bool Recording() { return recording; }
+	uint32_t DroppedEvents() { return dropped_events; }
+
+	void Init(const uint32_t flags)
+	{
+		const auto lvar = register_named_variable("A32NX_FBW_RECORD");
+		if (get_named_variable_value(lvar) == 0) return;
+
+		file = fopen(FBW_RECORD_FILE, "ab");
+		if (!file) return;
+		setvbuf(file, nullptr, _IONBF, 0); // Whole columns are written at once, so stdio buffering would only copy them
+		const RecordingHeader header = { { 'F', 'B', 'W', 'R' }, recording_version, aircraft_simvar_count, flags, control_rate, max_control_steps, 0 };
+		fwrite(&header, sizeof(header), 1, file);
+		recording = true;
+	}
+
+	// Records an input event as it is applied to the instance's InputCapture
+	void OnEvent(const EVENT_ID event, const int32_t data)
+	{
+		if (!recording) return;
+		if (events == recording_block_events) Flush();
+		if (events == recording_block_events)
+		{
+			dropped_events++; // A single frame had more events than a block holds
+			return;
+		}
+		event_ids[events] = event;
+		event_data[events] = data;
+		events++;
+	}
+
+	// Records the sample, t and dt a frame passes to FbwInstance::Update, after the frame's events
+	void OnFrame(const AircraftDataSample& sample, const double t, const double dt)
+	{
+		if (!recording) return;
+		columns[0][frames] = t;
+		columns[1][frames] = dt;
+		for (size_t i = 0; i < aircraft_simvar_count; i++) columns[2 + i][frames] = sample.*aircraft_simvars[i].field;
+		frame_events[frames] = events - block_events;
+		block_events = events;
+		if (++frames == recording_block_frames) Flush();
+	}
+
+	void Destroy()
+	{
+		if (file)
+		{
+			Flush();
+			fclose(file);
+		}
+		file = nullptr;
+		recording = false;
+	}
+};
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include "gains.h"
 #include "pid.h"
 #include "pitch_control_mode.h"
 #include "input.h"
@@ -7,16 +8,38 @@
 class RollController
 {
 private:
+	AircraftData& aircraft_data;
+	InputCapture& input_capture;
+	PitchControlMode& pitch_control_mode;
+	NormalLawProtections& normal_law_protections;
+
 	double roll = 0; // The desired bank angle
-	PIDController controller = PIDController(-1, 1, 0.10, 0, 0.02);
+	PIDController controller = PIDController(-1, 1, 0, 0, 0); // Gains from ControlSurfaces, from construction on (see gain_tables.h)
 public:
+	RollController(AircraftData& aircraft_data, InputCapture& input_capture, PitchControlMode& pitch_control_mode, NormalLawProtections& normal_law_protections)
+		: aircraft_data(aircraft_data), input_capture(input_capture),
+		pitch_control_mode(pitch_control_mode), normal_law_protections(normal_law_protections) {};
+
+	// The bank angle the law is steering towards
+	double TargetBank() const { return roll; }
+	const PIDController& Controller() const { return controller; }
+
+	// Takes the gains of the PID controller from the scheduler, once per control step
+	void SetGains(const GainScheduler& scheduler)
+	{
+		const auto& gains = scheduler.Gains(GAIN_ROLL);
+		controller.SetGains(gains.kp, gains.ki, gains.kd);
+	}
+
 	double Calculate(const double current_ailerons, const double t, const double dt)
 	{
 		// TODO: Handle other control laws besides normal law
 
 		if (pitch_control_mode.Mode() == FLIGHT_MODE || pitch_control_mode.Mode() == FLARE_MODE)
 		{
-			if (input_capture.YokeX() == 0)
+			// The mean of the step's events, so that every stick movement of the frame is integrated
+			const auto yoke_x = input_capture.MeanYokeX();
+			if (yoke_x == 0)
 			{
 				// If we are banked beyond the nominal bank angle, roll back to the nominal bank angle
 				if (fabs(roll) > normal_law_protections.NominalBankAngle())
@@ -33,9 +56,10 @@ public:
 			else
 			{
 				// We should be responsive to the user's roll request
-				roll += 15 * input_capture.YokeX() * dt; // 15 degrees/sec at maximum deflection
-				roll = clamp(roll, -normal_law_protections.MaxBankAngle(), normal_law_protections.MaxBankAngle());
+				roll += 15 * yoke_x * dt; // 15 degrees/sec at maximum deflection
 			}
+			// Also with the stick released, as the maximum can shrink below the bank angle we hold (high speed protection)
+			roll = clamp(roll, -normal_law_protections.MaxBankAngle(), normal_law_protections.MaxBankAngle());
 			return controller.Update(roll - aircraft_data.Roll(), dt);
 		}
 		else
@@ -0,0 +1,68 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+
+// Runs the control logic in fixed-size steps, independent of the frame rate.
+// The time of every frame is accumulated and consumed in steps of 1/rate seconds. After a frame hitch, at most
+// max_steps steps are run and the rest of the backlog is dropped, so the cost of a frame stays bounded.
+class FixedRateScheduler
+{
+private:
+	double step; // Length of a step in seconds
+	int max_steps; // Maximum number of steps run in one frame
+	double accumulator = 0; // Frame time not yet consumed by a step
+	uint64_t steps = 0;
+	uint64_t dropped_steps = 0;
+public:
+	FixedRateScheduler(const double rate, const int max_steps)
+		: step(1 / rate), max_steps(max_steps) {};
+
+	double Rate() { return 1 / step; }
+	double StepLength() { return step; }
+	uint64_t Steps() { return steps; }
+	uint64_t DroppedSteps() { return dropped_steps; }
+
+	void SetRate(const double rate)
+	{
+		step = 1 / rate;
+		accumulator = fmin(accumulator, step);
+	}
+	void SetMaxSteps(const int value) { max_steps = value; }
+
+	// Runs the steps that are due at the end of a frame lasting dt and ending at time t.
+	// Each step is run as step_function(step_t, step_dt, frame_fraction), where frame_fraction says where the step
+	// falls within the frame (0 = at its start, 1 = at its end), for interpolating inputs sampled once per frame.
+	template <typename StepFunction>
+	int Advance(const double t, const double dt, StepFunction step_function)
+	{
+		if (!(dt > 0)) return 0; // Paused, or time went backwards
+
+		accumulator += dt;
+		auto count = 0;
+		while (accumulator >= step && count < max_steps)
+		{
+			accumulator -= step;
+			const auto frame_fraction = fmax(0.0, 1 - accumulator / dt);
+			step_function(t - accumulator, step, frame_fraction);
+			count++;
+		}
+		steps += count;
+
+		// Drop the backlog we could not catch up on, but keep the phase of the steps
+		if (accumulator >= step)
+		{
+			const auto backlog = floor(accumulator / step);
+			dropped_steps += static_cast<uint64_t>(backlog);
+			accumulator -= backlog * step;
+		}
+		return count;
+	}
+
+	// Where the outputs should be presented between the previous step (0) and the latest step (1).
+	// This presents them as they were one step before the end of the frame, which keeps them smooth when steps
+	// and frames do not line up.
+	double Blend()
+	{
+		return accumulator / step;
+	}
+};
\ No newline at end of file
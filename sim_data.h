@@ -0,0 +1,101 @@
+#pragma once
+#include <cstring>
+
+#include "common.h"
+#include "aircraft_data.h"
+
+struct SimVarDefinition
+{
+	const char * name;
+	const char * units;
+	double fallback; // Used when the simulator reports NaN
+	double AircraftDataSample::* field;
+};
+
+// Every SimVar that makes up an AircraftDataSample
+// The order of this table is the order of the AIRCRAFT_DATA_DEFINITION data definition
+constexpr SimVarDefinition aircraft_simvars[] = {
+	{ "PLANE ALTITUDE", "Feet", 0, &AircraftDataSample::altitude },
+	{ "INCIDENCE ALPHA", "Degrees", 0, &AircraftDataSample::aoa },
+	{ "AUTOPILOT MASTER", "Bool", FALSE, &AircraftDataSample::autopilot },
+	{ "FLAPS HANDLE INDEX", "Number", 0, &AircraftDataSample::flaps },
+	{ "G FORCE", "GForce", 0, &AircraftDataSample::gforce },
+	{ "AIRSPEED INDICATED", "Knots", 0, &AircraftDataSample::ias },
+	{ "ACCELERATION WORLD Z", "Feet per second squared", 0, &AircraftDataSample::lateral_acceleration },
+	{ "VELOCITY WORLD Z", "Feet per second", 0, &AircraftDataSample::lateral_speed },
+	{ "ACCELERATION WORLD X", "Feet per second squared", 0, &AircraftDataSample::longitudinal_acceleration },
+	{ "VELOCITY WORLD X", "Feet per second", 0, &AircraftDataSample::longitudinal_speed },
+	{ "AIRSPEED MACH", "Mach", 0, &AircraftDataSample::mach },
+	{ "BARBER POLE MACH", "Mach", DBL_MAX, &AircraftDataSample::mmo },
+	{ "SIM ON GROUND", "Bool", FALSE, &AircraftDataSample::on_ground },
+	{ "PLANE PITCH DEGREES", "Degrees", 0, &AircraftDataSample::pitch },
+	{ "ROTATION VELOCITY BODY X", "Degrees per second", 0, &AircraftDataSample::pitch_velocity },
+	{ "RADIO HEIGHT", "Feet", 0, &AircraftDataSample::radio_height },
+	{ "PLANE BANK DEGREES", "Degrees", 0, &AircraftDataSample::roll },
+	{ "ACCELERATION WORLD Y", "Feet per second squared", 0, &AircraftDataSample::vertical_acceleration },
+	{ "VELOCITY WORLD Y", "Feet per second", 0, &AircraftDataSample::vertical_speed },
+	{ "AIRSPEED BARBER POLE", "Knots", DBL_MAX, &AircraftDataSample::vmo },
+	{ "TOTAL WEIGHT", "Pounds", 141096, &AircraftDataSample::weight },
+	{ "ROTATION VELOCITY BODY Y", "Degrees per second", 0, &AircraftDataSample::yaw_velocity },
+};
+constexpr size_t aircraft_simvar_count = sizeof(aircraft_simvars) / sizeof(aircraft_simvars[0]);
+
+// Acquires the whole aircraft state as one consistent sample per frame.
+// The SimVars are registered once as a SimConnect data definition which the simulator sends every sim frame,
+// so the per-frame cost is a single copy instead of a string lookup and an aircraft_varget per SimVar.
+class SimData
+{
+private:
+	ENUM var_enums[aircraft_simvar_count] = {}; // Resolved once in Init() for the aircraft_varget fallback
+	ENUM unit_enums[aircraft_simvar_count] = {};
+	AircraftDataSample sample;
+	bool received = false; // True once the first data definition packet arrived
+
+	static double Sanitize(const double value, const double fallback)
+	{
+		return isnan(value) ? fallback : value;
+	}
+public:
+	const AircraftDataSample& Sample() { return sample; }
+
+	void Init(HANDLE hSimConnect)
+	{
+		for (size_t i = 0; i < aircraft_simvar_count; i++)
+		{
+			var_enums[i] = get_aircraft_var_enum(aircraft_simvars[i].name);
+			unit_enums[i] = get_units_enum(aircraft_simvars[i].units);
+			SimConnect_AddToDataDefinition(hSimConnect, AIRCRAFT_DATA_DEFINITION, aircraft_simvars[i].name, aircraft_simvars[i].units);
+		}
+		SimConnect_RequestDataOnSimObject(hSimConnect, AIRCRAFT_DATA_REQUEST, AIRCRAFT_DATA_DEFINITION, SIMCONNECT_OBJECT_ID_USER, SIMCONNECT_PERIOD_SIM_FRAME);
+	}
+
+	// Handles the AIRCRAFT_DATA_REQUEST packet delivered through SimConnect_CallDispatch
+	void OnSimObjectData(const SIMCONNECT_RECV_SIMOBJECT_DATA* data, const DWORD cbData)
+	{
+		double values[aircraft_simvar_count];
+		const auto header_size = reinterpret_cast<const char*>(&data->dwData) - reinterpret_cast<const char*>(data);
+		if (cbData < header_size + sizeof(values)) return; // Malformed packet, keep the previous sample
+		memcpy(values, &data->dwData, sizeof(values)); // The payload is not guaranteed to be 8-byte aligned
+
+		for (size_t i = 0; i < aircraft_simvar_count; i++)
+		{
+			sample.*aircraft_simvars[i].field = Sanitize(values[i], aircraft_simvars[i].fallback);
+		}
+		received = true;
+	}
+
+	// Makes sure the sample is populated before the first data definition packet arrives
+	void Update(const double t, const double dt)
+	{
+		if (!received) FetchSample();
+	}
+
+	// Reads every SimVar directly using the enums resolved in Init()
+	void FetchSample()
+	{
+		for (size_t i = 0; i < aircraft_simvar_count; i++)
+		{
+			sample.*aircraft_simvars[i].field = Sanitize(aircraft_varget(var_enums[i], unit_enums[i], 0), aircraft_simvars[i].fallback);
+		}
+	}
+};
\ No newline at end of file
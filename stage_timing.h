@@ -0,0 +1,177 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+#include "common.h"
+#include "input.h"
+
+// Where a frame's time goes. The control stages run once per control step, so several times in a frame that catches up.
+enum TIMING_STAGE
+{
+	STAGE_DISPATCH, // SimConnect_CallDispatch: input events and the aircraft data packet
+	STAGE_SIM_DATA, // SimData::Update
+	STAGE_AIRCRAFT_DATA, // AircraftData::Update
+	STAGE_PITCH_MODE, // PitchControlMode::Update
+	STAGE_PROTECTIONS, // NormalLawProtections::Update
+	STAGE_CONTROL_SURFACES, // ControlSurfaces::Update, i.e. the roll and pitch laws
+	STAGE_OUTPUT, // SimConnect_SetDataOnSimObject
+	STAGE_FRAME, // The whole PANEL_SERVICE_PRE_DRAW
+	STAGE_COUNT
+};
+
+constexpr const char* timing_stage_names[STAGE_COUNT] = {
+	"DISPATCH", "SIM_DATA", "AIRCRAFT_DATA", "PITCH_MODE", "PROTECTIONS", "CONTROL_SURFACES", "OUTPUT", "FRAME"
+};
+
+// Durations in nanoseconds, counted in power of two buckets: bucket b holds [2^b, 2^(b+1)), bucket 0 also holds 0
+class LatencyHistogram
+{
+private:
+	static constexpr int bucket_count = 40; // Up to about 18 minutes
+	uint32_t buckets[bucket_count] = {};
+	uint32_t count = 0;
+	uint64_t max = 0;
+public:
+	void Record(const uint64_t nanoseconds)
+	{
+		auto bucket = 63 - __builtin_clzll(nanoseconds | 1);
+		if (bucket >= bucket_count) bucket = bucket_count - 1;
+		buckets[bucket]++;
+		count++;
+		if (nanoseconds > max) max = nanoseconds;
+	}
+
+	uint32_t Count() const { return count; }
+	uint64_t Max() const { return max; }
+
+	// Upper bound of the bucket holding the given fraction (0 to 1) of the samples, no more than the maximum
+	uint64_t Percentile(const double fraction) const
+	{
+		if (count == 0) return 0;
+		const auto rank = static_cast<uint32_t>(fraction * (count - 1)) + 1;
+		uint32_t seen = 0;
+		for (auto bucket = 0; bucket < bucket_count; bucket++)
+		{
+			seen += buckets[bucket];
+			if (seen >= rank)
+			{
+				const auto bound = (uint64_t(2) << bucket) - 1;
+				return bound < max ? bound : max;
+			}
+		}
+		return max;
+	}
+
+	void Reset() { *this = LatencyHistogram(); }
+};
+
+#ifdef FBW_STAGE_TIMING
+
+// One histogram per stage
+class StageTimings
+{
+private:
+	LatencyHistogram histograms[STAGE_COUNT];
+public:
+	void Record(const TIMING_STAGE stage, const uint64_t nanoseconds) { histograms[stage].Record(nanoseconds); }
+	const LatencyHistogram& Histogram(const TIMING_STAGE stage) const { return histograms[stage]; }
+	void Reset() { for (auto& histogram : histograms) histogram.Reset(); }
+};
+
+// Records the time from its construction to the end of its scope
+class ScopedStageTimer
+{
+private:
+	StageTimings& timings;
+	TIMING_STAGE stage;
+	std::chrono::steady_clock::time_point start;
+public:
+	ScopedStageTimer(StageTimings& timings, const TIMING_STAGE stage)
+		: timings(timings), stage(stage), start(std::chrono::steady_clock::now()) {};
+	~ScopedStageTimer()
+	{
+		timings.Record(stage, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+	}
+};
+
+#define FBW_STAGE_TIMER_NAME(line) stage_timer_##line
+#define FBW_STAGE_TIMER_AT(timings, stage, line) ScopedStageTimer FBW_STAGE_TIMER_NAME(line)(timings, stage)
+// Times the rest of the enclosing scope as the given stage
+#define FBW_STAGE_TIMER(timings, stage) FBW_STAGE_TIMER_AT(timings, stage, __LINE__)
+
+#ifndef FBW_STAGE_TIMING_PERIOD
+#define FBW_STAGE_TIMING_PERIOD 10
+#endif
+
+// Every FBW_STAGE_TIMING_PERIOD seconds, publishes the p50, p99 and maximum of every stage over the period, in
+// microseconds, to the A32NX_FBW_TIME_<STAGE>_P50/_P99/_MAX LVars and the console, and the mean and maximum input
+// latency (see InputLatency in input.h), in milliseconds, to A32NX_FBW_INPUT_LATENCY_MEAN/_MAX, then starts a new period
+class StageTimingPublisher
+{
+private:
+	StageTimings& timings;
+	InputCapture& input_capture;
+	ID lvars[STAGE_COUNT][3] = {};
+	ID latency_lvars[2] = {};
+	double elapsed = 0;
+	char line[64 * (STAGE_COUNT + 2)]; // Room for every stage's timings up to 1000 s, and the latency
+public:
+	StageTimingPublisher(StageTimings& timings, InputCapture& input_capture)
+		: timings(timings), input_capture(input_capture) {};
+
+	void Init()
+	{
+		const char* suffixes[3] = { "P50", "P99", "MAX" };
+		for (auto stage = 0; stage < STAGE_COUNT; stage++)
+		{
+			for (auto i = 0; i < 3; i++)
+			{
+				char name[64];
+				snprintf(name, sizeof(name), "A32NX_FBW_TIME_%s_%s", timing_stage_names[stage], suffixes[i]);
+				lvars[stage][i] = register_named_variable(name);
+			}
+		}
+		latency_lvars[0] = register_named_variable("A32NX_FBW_INPUT_LATENCY_MEAN");
+		latency_lvars[1] = register_named_variable("A32NX_FBW_INPUT_LATENCY_MAX");
+	}
+
+	void Update(const double t, const double dt)
+	{
+		elapsed += dt;
+		if (elapsed < FBW_STAGE_TIMING_PERIOD) return;
+		elapsed = 0;
+
+		// Formatted in place and written to the unbuffered stderr, as stdout would allocate its buffer on first use
+		auto length = snprintf(line, sizeof(line), "FBW stage timings over %d s (us):", FBW_STAGE_TIMING_PERIOD);
+		for (auto stage = 0; stage < STAGE_COUNT; stage++)
+		{
+			const auto& histogram = timings.Histogram(static_cast<TIMING_STAGE>(stage));
+			const double values[3] = { histogram.Percentile(0.5) / 1000.0, histogram.Percentile(0.99) / 1000.0, histogram.Max() / 1000.0 };
+			for (auto i = 0; i < 3; i++) set_named_variable_value(lvars[stage][i], values[i]);
+			length += snprintf(line + length, sizeof(line) - length, " %s=%.2f/%.2f/%.2f", timing_stage_names[stage], values[0], values[1], values[2]);
+		}
+		const auto& latency = input_capture.Latency();
+		set_named_variable_value(latency_lvars[0], latency.MeanMs());
+		set_named_variable_value(latency_lvars[1], latency.max_ms);
+		snprintf(line + length, sizeof(line) - length, " INPUT_LATENCY(ms)=%.3f/%.3f over %llu events", latency.MeanMs(), latency.max_ms,
+			static_cast<unsigned long long>(latency.events));
+		fputs(line, stderr);
+		fputs("\n", stderr);
+		timings.Reset();
+		input_capture.ResetLatency();
+	}
+};
+
+#else
+
+// Stage timing is compiled out: the timings hold nothing and the timers disappear
+class StageTimings
+{
+public:
+	void Reset() {}
+};
+
+#define FBW_STAGE_TIMER(timings, stage) ((void)0)
+
+#endif
\ No newline at end of file
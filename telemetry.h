@@ -0,0 +1,264 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+
+#include "common.h"
+
+// Identifies the pitch law branch or protection that produced a trace entry
+enum PITCH_TRACE_ID : uint8_t
+{
+	TRACE_NONE,
+	// Sidestick demand branches
+	TRACE_AOA,
+	TRACE_HOLD_PITCH,
+	TRACE_HOLD_VFPA,
+	TRACE_ROLL_1G,
+	TRACE_CMD_LF,
+	TRACE_FLARE,
+	// Protections applied to the demand
+	TRACE_LF_LIMIT_MAX,
+	TRACE_LF_LIMIT_MIN,
+	TRACE_OVSPD,
+	TRACE_MAX_P_VIOL,
+	TRACE_MIN_P_VIOL,
+	TRACE_PR_LIM_MAX,
+	TRACE_PR_LIM_MIN,
+	// Model predictive demand (see mpc.h), which applies the load factor and attitude limits itself
+	TRACE_MPC,
+	TRACE_ID_COUNT
+};
+
+constexpr int max_trace_values = 4;
+constexpr int max_trace_protections = 3; // The load factor demand path applies at most three protections
+
+struct PitchTraceFormat
+{
+	const char * tag;
+	int value_count;
+	const char * names[max_trace_values];
+};
+
+// The text form of every trace entry, indexed by PITCH_TRACE_ID (see tools/trace_decode.cpp)
+constexpr PitchTraceFormat pitch_trace_formats[TRACE_ID_COUNT] = {
+	{ "", 0, {} },
+	{ "AOA", 3, { "AOA", "DesAOA", "ErrAOA" } },
+	{ "HOLD_PITCH", 0, {} },
+	{ "HOLD_VFPA", 1, { "DesVFPA" } },
+	{ "ROLL_1G", 0, {} },
+	{ "CMD_LF", 3, { "NLF", "RLF", "LFErr" } },
+	{ "FLARE", 2, { "DesPR", "RH" } },
+	{ "LF_LIMIT_MAX", 2, { "PreDE", "PostDE" } },
+	{ "LF_LIMIT_MIN", 2, { "PreDE", "PostDE" } },
+	{ "OVSPD", 4, { "PreDE", "UserDE", "RecDE", "PostDE" } },
+	{ "MAX_P_VIOL", 3, { "PreDE", "DesPR", "PostDE" } },
+	{ "MIN_P_VIOL", 3, { "PreDE", "DesPR", "PostDE" } },
+	{ "PR_LIM_MAX", 3, { "PreDE", "MaxPR", "PostDE" } },
+	{ "PR_LIM_MIN", 3, { "PreDE", "MinPR", "PostDE" } },
+	{ "MPC", 3, { "RLF", "LFErr", "Iter" } },
+};
+
+struct PitchTraceEntry
+{
+	double values[max_trace_values];
+	uint8_t id;
+	uint8_t padding[7];
+};
+
+// One frame of the pitch law, in a fixed binary layout
+struct PitchTraceRecord
+{
+	double t;
+	PitchTraceEntry demand;
+	PitchTraceEntry protections[max_trace_protections];
+	// State snapshot
+	double pitch;
+	double pitch_rate;
+	double vfpa;
+	double vfpa_rate;
+	double gforce;
+	double delta_elevator;
+	double elevator;
+	uint8_t protection_count;
+	uint8_t padding[7];
+};
+static_assert(sizeof(PitchTraceRecord) == 8 + 4 * 40 + 7 * 8 + 8, "PitchTraceRecord must keep its binary layout");
+
+// Written at the start of every trace session, followed by blocks of PitchTraceRecords
+struct PitchTraceHeader
+{
+	char magic[4]; // "FBWT"
+	uint32_t version;
+	uint32_t record_size;
+	uint32_t reserved;
+};
+constexpr uint32_t pitch_trace_version = 2;
+
+// Precedes every run of records, so that a reader never has to tell a header from a record by its bytes
+struct PitchTraceBlockHeader
+{
+	char magic[4]; // "FBWB"
+	uint32_t record_count;
+};
+static_assert(sizeof(PitchTraceBlockHeader) == 8, "PitchTraceBlockHeader layout is part of the file format");
+
+// Single-producer/single-consumer ring of fixed-size records. The producer never blocks: when the ring is full
+// the record is dropped and counted.
+template <typename Record, uint32_t Capacity>
+class TelemetryRing
+{
+private:
+	static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+	Record records[Capacity];
+	std::atomic<uint32_t> head = { 0 }; // Next slot the producer writes
+	std::atomic<uint32_t> tail = { 0 }; // Next slot the consumer reads
+	uint32_t dropped = 0;
+public:
+	uint32_t Dropped() { return dropped; }
+
+	bool Push(const Record& record)
+	{
+		const auto current_head = head.load(std::memory_order_relaxed);
+		if (current_head - tail.load(std::memory_order_acquire) == Capacity)
+		{
+			dropped++;
+			return false;
+		}
+		records[current_head & (Capacity - 1)] = record;
+		head.store(current_head + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Hands every available record to consume(const Record*, count) in at most two contiguous runs
+	template <typename Consume>
+	uint32_t Drain(Consume consume)
+	{
+		const auto current_tail = tail.load(std::memory_order_relaxed);
+		const auto available = head.load(std::memory_order_acquire) - current_tail;
+		if (available == 0) return 0;
+
+		const auto start = current_tail & (Capacity - 1);
+		const auto first_run = available < Capacity - start ? available : Capacity - start;
+		consume(&records[start], first_run);
+		if (available > first_run) consume(&records[0], available - first_run);
+		tail.store(current_tail + available, std::memory_order_release);
+		return available;
+	}
+};
+
+// Records what the pitch law did each frame, without any formatting on the frame path.
+// Every call is a no-op while tracing is disabled.
+class PitchTelemetry
+{
+private:
+	bool enabled = false;
+	PitchTraceRecord record = {};
+	TelemetryRing<PitchTraceRecord, 256> ring;
+public:
+	bool Enabled() { return enabled; }
+	void SetEnabled(const bool value) { enabled = value; }
+	uint32_t Dropped() { return ring.Dropped(); }
+
+	void Demand(const PITCH_TRACE_ID id, const double a = 0, const double b = 0, const double c = 0, const double d = 0)
+	{
+		if (!enabled) return;
+		record.demand = { { a, b, c, d }, id };
+	}
+
+	void Protection(const PITCH_TRACE_ID id, const double a = 0, const double b = 0, const double c = 0, const double d = 0)
+	{
+		if (!enabled || record.protection_count == max_trace_protections) return;
+		record.protections[record.protection_count++] = { { a, b, c, d }, id };
+	}
+
+	void Commit(const double t, const double pitch, const double pitch_rate, const double vfpa, const double vfpa_rate, const double gforce, const double delta_elevator, const double elevator)
+	{
+		if (!enabled) return;
+		record.t = t;
+		record.pitch = pitch;
+		record.pitch_rate = pitch_rate;
+		record.vfpa = vfpa;
+		record.vfpa_rate = vfpa_rate;
+		record.gforce = gforce;
+		record.delta_elevator = delta_elevator;
+		record.elevator = elevator;
+		ring.Push(record);
+		record = {};
+	}
+
+	template <typename Consume>
+	uint32_t Drain(Consume consume)
+	{
+		return ring.Drain(consume);
+	}
+};
+
+#ifndef FBW_TRACE_FILE
+#define FBW_TRACE_FILE "\\work\\fbw_trace.bin"
+#endif
+
+// Follows the A32NX_FBW_TRACE LVar: while it is set, the pitch telemetry is enabled and streamed to FBW_TRACE_FILE.
+// Decode the file with tools/trace_decode.
+// The file is opened when the gauge is installed and only closed when it is killed, so that toggling the trace in
+// flight never reaches the heap: each time the trace is enabled a new header is appended, and disabling it flushes.
+class PitchTraceWriter
+{
+private:
+	PitchTelemetry& pitch_telemetry;
+	ID trace_lvar = -1;
+	FILE * file = nullptr;
+	char buffer[16 * 1024]; // Owned by us so that stdio does not allocate one for the file
+
+	void Start()
+	{
+		if (!file) return;
+		const PitchTraceHeader header = { { 'F', 'B', 'W', 'T' }, pitch_trace_version, sizeof(PitchTraceRecord), 0 };
+		fwrite(&header, sizeof(header), 1, file);
+	}
+
+	void Write()
+	{
+		pitch_telemetry.Drain([this](const PitchTraceRecord* records, const uint32_t count)
+		{
+			if (!file) return;
+			const PitchTraceBlockHeader header = { { 'F', 'B', 'W', 'B' }, count };
+			fwrite(&header, sizeof(header), 1, file);
+			fwrite(records, sizeof(PitchTraceRecord), count, file);
+		});
+	}
+
+	void Stop()
+	{
+		Write();
+		if (file) fflush(file);
+	}
+public:
+	PitchTraceWriter(PitchTelemetry& pitch_telemetry)
+		: pitch_telemetry(pitch_telemetry) {};
+
+	void Init()
+	{
+		trace_lvar = register_named_variable("A32NX_FBW_TRACE");
+		file = fopen(FBW_TRACE_FILE, "ab");
+		if (file) setvbuf(file, buffer, _IOFBF, sizeof(buffer));
+	}
+	void Update(const double t, const double dt)
+	{
+		const auto enabled = get_named_variable_value(trace_lvar) != 0;
+		if (enabled != pitch_telemetry.Enabled())
+		{
+			pitch_telemetry.SetEnabled(enabled);
+			if (enabled) Start();
+			else Stop();
+		}
+		Write();
+	}
+	void Destroy()
+	{
+		pitch_telemetry.SetEnabled(false);
+		Write();
+		if (file) fclose(file);
+		file = nullptr;
+	}
+};
\ No newline at end of file
@@ -0,0 +1,278 @@
+// Checks that FBW_gauge_callback never reaches the heap once the gauge is installed, and measures how deep the stack
+// of a PANEL_SERVICE_PRE_DRAW frame goes. The gauge is flown closed loop, through the stand-in SDK, against the host
+// plant model over a sequence of randomized scenarios (see host/scenario.h), with the flight recorder running and the
+// pitch trace toggled on and off every scenario. malloc and its relatives are interposed for the whole process, and
+// every allocation made while a frame runs is counted; the first few are reported with their call stack.
+// Exits with 1 if any frame allocated.
+//
+// Usage: alloc_check [scenarios] [seconds] [--seed n] [--fps n] [--mpc] [--actuators] [--complementary]
+//   scenarios          number of scenarios flown one after the other by the same gauge (default 50)
+//   seconds            flight time of each scenario (default 60)
+//   seed               selects the set of scenarios (default 1)
+//   fps                frame rate the gauge runs at (default 60)
+//   mpc                set A32NX_FBW_PITCH_MPC so the gauge flies the model predictive pitch law (see mpc.h)
+//   actuators          set A32NX_FBW_ACTUATORS so the surfaces move through their actuators (see actuators.h)
+//   complementary      set A32NX_FBW_COMPLEMENTARY_ESTIMATOR so the rates are estimated by the complementary filter
+// fbw_trace.bin and fbw_recording.bin are appended to in the working directory.
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <execinfo.h>
+#include <unistd.h>
+
+#include <MSFS/Legacy/gauges.h>
+
+#include "../sim_data.h"
+#include "plant_model.h"
+#include "scenario.h"
+#include "sim_host.h"
+
+extern "C" bool FBW_gauge_callback(FsContext ctx, int service_id, void* pData);
+
+// glibc's allocator, under the names it exports for allocators that wrap it
+extern "C"
+{
+	void* __libc_malloc(size_t size);
+	void* __libc_calloc(size_t count, size_t size);
+	void* __libc_realloc(void* pointer, size_t size);
+	void* __libc_memalign(size_t alignment, size_t size);
+	void __libc_free(void* pointer);
+}
+
+namespace
+{
+	constexpr int reported_allocations = 4;
+	constexpr int reported_depth = 24;
+
+	// Only touched from the thread that runs the gauge; the interposed functions must not allocate themselves
+	struct AllocationLog
+	{
+		bool counting = false;
+		uint64_t allocations = 0;
+		uint64_t bytes = 0;
+		uint64_t frees = 0;
+		size_t sizes[reported_allocations];
+		void* stacks[reported_allocations][reported_depth];
+		int depths[reported_allocations];
+	};
+	AllocationLog allocation_log;
+
+	void OnAllocation(const size_t size)
+	{
+		if (!allocation_log.counting) return;
+		allocation_log.counting = false; // backtrace() below must not count itself
+		if (allocation_log.allocations < reported_allocations)
+		{
+			allocation_log.sizes[allocation_log.allocations] = size;
+			allocation_log.depths[allocation_log.allocations] = backtrace(allocation_log.stacks[allocation_log.allocations], reported_depth);
+		}
+		allocation_log.allocations++;
+		allocation_log.bytes += size;
+		allocation_log.counting = true;
+	}
+}
+
+extern "C"
+{
+	void* malloc(size_t size)
+	{
+		OnAllocation(size);
+		return __libc_malloc(size);
+	}
+	void* calloc(size_t count, size_t size)
+	{
+		OnAllocation(count * size);
+		return __libc_calloc(count, size);
+	}
+	void* realloc(void* pointer, size_t size)
+	{
+		OnAllocation(size);
+		return __libc_realloc(pointer, size);
+	}
+	void* memalign(size_t alignment, size_t size)
+	{
+		OnAllocation(size);
+		return __libc_memalign(alignment, size);
+	}
+	void* aligned_alloc(size_t alignment, size_t size)
+	{
+		OnAllocation(size);
+		return __libc_memalign(alignment, size);
+	}
+	int posix_memalign(void** pointer, size_t alignment, size_t size)
+	{
+		OnAllocation(size);
+		*pointer = __libc_memalign(alignment, size);
+		return *pointer ? 0 : ENOMEM;
+	}
+	void free(void* pointer)
+	{
+		if (allocation_log.counting && pointer) allocation_log.frees++;
+		__libc_free(pointer);
+	}
+}
+
+namespace
+{
+	// The stack below the caller of a frame is painted before the frame runs; afterwards the lowest word that no
+	// longer holds the paint is as deep as the frame went
+	constexpr size_t stack_window = 128 * 1024;
+	constexpr uint64_t stack_paint = 0xa5a5a5a5a5a5a5a5;
+
+	__attribute__((noinline)) void PaintStack(unsigned char* top)
+	{
+		// Leaves this function's own frame, and memset's, alone
+		auto* end = static_cast<unsigned char*>(__builtin_frame_address(0)) - 256;
+		memset(top - stack_window, 0xa5, end - (top - stack_window));
+	}
+
+	__attribute__((noinline)) size_t StackDepth(unsigned char* top)
+	{
+		auto* word = reinterpret_cast<volatile uint64_t*>(top - stack_window);
+		while (reinterpret_cast<unsigned char*>(const_cast<uint64_t*>(word)) < top && *word == stack_paint) word++;
+		return top - reinterpret_cast<unsigned char*>(const_cast<uint64_t*>(word));
+	}
+
+	// Hands the plant state to the gauge under the SimVar names of aircraft_simvars, and moves the plant's surfaces
+	// to whatever the gauge writes
+	class PlantSimSource : public SimSource
+	{
+	private:
+		static constexpr const char* surface_names[3] = { "ELEVATOR POSITION", "AILERON POSITION", "RUDDER POSITION" };
+		PlantModel plant;
+		AircraftDataSample sample;
+		CONTROL_SURFACES_DATA surfaces;
+	public:
+		int Bind(const char* name, const char* units) override
+		{
+			for (size_t i = 0; i < aircraft_simvar_count; i++)
+			{
+				if (strcmp(name, aircraft_simvars[i].name) == 0) return static_cast<int>(i);
+			}
+			for (auto i = 0; i < 3; i++)
+			{
+				if (strcmp(name, surface_names[i]) == 0) return static_cast<int>(aircraft_simvar_count) + i;
+			}
+			return -1;
+		}
+		double Read(const int slot) override
+		{
+			if (slot < static_cast<int>(aircraft_simvar_count)) return sample.*aircraft_simvars[slot].field;
+			const double values[3] = { surfaces.elevator, surfaces.ailerons, surfaces.rudder };
+			return values[slot - aircraft_simvar_count];
+		}
+		void Write(const int slot, const double value) override
+		{
+			if (slot == static_cast<int>(aircraft_simvar_count)) surfaces.elevator = value;
+			else if (slot == static_cast<int>(aircraft_simvar_count) + 1) surfaces.ailerons = value;
+			else if (slot == static_cast<int>(aircraft_simvar_count) + 2) surfaces.rudder = value;
+		}
+
+		void Reset(const PlantInitialConditions& initial)
+		{
+			plant.Reset(initial);
+			surfaces = CONTROL_SURFACES_DATA();
+			sample = plant.Sample();
+		}
+		void Step(const double dt)
+		{
+			plant.Step(surfaces, dt);
+			sample = plant.Sample();
+		}
+	};
+}
+
+int main(int argc, char* argv[])
+{
+	auto scenarios = 50L;
+	auto seconds = 60.0;
+	auto seed = uint64_t(1);
+	auto fps = 60.0;
+	auto model_predictive = false;
+	auto actuators = false;
+	auto complementary = false;
+	auto positional = 0;
+	auto usage = false;
+	for (auto i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoull(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) fps = atof(argv[++i]);
+		else if (strcmp(argv[i], "--mpc") == 0) model_predictive = true;
+		else if (strcmp(argv[i], "--actuators") == 0) actuators = true;
+		else if (strcmp(argv[i], "--complementary") == 0) complementary = true;
+		else if (argv[i][0] == '-') usage = true;
+		else if (positional++ == 0) scenarios = atol(argv[i]);
+		else seconds = atof(argv[i]);
+	}
+	if (usage || scenarios <= 0 || seconds <= 0 || fps <= 0)
+	{
+		fprintf(stderr, "usage: %s [scenarios] [seconds] [--seed n] [--fps n] [--mpc] [--actuators] [--complementary]\n", argv[0]);
+		return 1;
+	}
+
+	// backtrace() loads its unwinder the first time, which allocates
+	void* warm_up[1];
+	backtrace(warm_up, 1);
+
+	static PlantSimSource source;
+	SimHostSetSource(&source);
+	const ScenarioDistribution distribution;
+	source.Reset(distribution.Draw(seed, 0).initial);
+
+	set_named_variable_value(register_named_variable("A32NX_FBW_RECORD"), 1);
+	set_named_variable_value(register_named_variable("A32NX_FBW_PITCH_MPC"), model_predictive ? 1 : 0);
+	set_named_variable_value(register_named_variable("A32NX_FBW_ACTUATORS"), actuators ? 1 : 0);
+	set_named_variable_value(register_named_variable("A32NX_FBW_COMPLEMENTARY_ESTIMATOR"), complementary ? 1 : 0);
+	const auto trace_lvar = register_named_variable("A32NX_FBW_TRACE");
+
+	const FsContext ctx = 0;
+	if (!FBW_gauge_callback(ctx, PANEL_SERVICE_PRE_INSTALL, nullptr) || !FBW_gauge_callback(ctx, PANEL_SERVICE_POST_INSTALL, nullptr))
+	{
+		fprintf(stderr, "gauge installation failed\n");
+		return 1;
+	}
+
+	auto* stack_top = static_cast<unsigned char*>(__builtin_frame_address(0));
+	size_t peak_stack = 0;
+	auto frames = 0L;
+	sGaugeDrawData draw_data = {};
+	draw_data.dt = 1 / fps;
+	for (auto index = 0L; index < scenarios; index++)
+	{
+		const auto scenario = distribution.Draw(seed, index);
+		source.Reset(scenario.initial);
+		set_named_variable_value(trace_lvar, index % 2);
+		for (auto since_start = 0.0; since_start < seconds; since_start += draw_data.dt, frames++)
+		{
+			double pitch_input, roll_input;
+			scenario.Sidestick(since_start, pitch_input, roll_input);
+			SimHostSendEvent("AXIS_ELEVATOR_SET", static_cast<DWORD>(static_cast<long>(-pitch_input * 16384)));
+			SimHostSendEvent("AXIS_AILERONS_SET", static_cast<DWORD>(static_cast<long>(-roll_input * 16384)));
+
+			draw_data.t += draw_data.dt;
+			PaintStack(stack_top);
+			allocation_log.counting = true;
+			FBW_gauge_callback(ctx, PANEL_SERVICE_PRE_DRAW, &draw_data);
+			allocation_log.counting = false;
+			const auto depth = StackDepth(stack_top);
+			if (depth > peak_stack) peak_stack = depth;
+
+			source.Step(draw_data.dt);
+		}
+	}
+	FBW_gauge_callback(ctx, PANEL_SERVICE_PRE_KILL, nullptr);
+
+	printf("%ld frames over %ld scenarios: %llu allocations (%llu bytes), %llu frees in frames\n", frames, scenarios,
+		static_cast<unsigned long long>(allocation_log.allocations), static_cast<unsigned long long>(allocation_log.bytes),
+		static_cast<unsigned long long>(allocation_log.frees));
+	printf("peak stack depth of a frame: %zu bytes%s\n", peak_stack, peak_stack >= stack_window ? " or more" : "");
+	for (uint64_t i = 0; i < allocation_log.allocations && i < reported_allocations; i++)
+	{
+		printf("allocation %llu of %zu bytes:\n", static_cast<unsigned long long>(i + 1), allocation_log.sizes[i]);
+		fflush(stdout);
+		backtrace_symbols_fd(allocation_log.stacks[i], allocation_log.depths[i], STDOUT_FILENO);
+	}
+	return allocation_log.allocations == 0 ? 0 : 1;
+}
\ No newline at end of file
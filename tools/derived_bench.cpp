@@ -0,0 +1,123 @@
+// Measures what caching the derived aircraft data (VFPA, the alpha thresholds and the normal load factor) saves, by
+// running the queries a pitch law step makes against AircraftData and against the same formulas evaluated on every
+// query, then the cost of a whole FbwInstance frame.
+//
+// Usage: derived_bench [steps]
+//   steps  number of control steps to time (default 2000000)
+#include <chrono>
+#include <cstdlib>
+
+#include "../fbw_instance.h"
+
+namespace
+{
+	// The derived values as they were worked out before caching, on every query
+	struct Recomputed
+	{
+		AircraftDataSample sample;
+
+		double VFPA()
+		{
+			const auto horizontal_speed = sqrt(sample.lateral_speed * sample.lateral_speed + sample.longitudinal_speed * sample.longitudinal_speed);
+			if (horizontal_speed == 0 && sample.vertical_speed == 0) return 0;
+			if (horizontal_speed == 0 && sample.vertical_speed < 0) return -90;
+			if (horizontal_speed == 0 && sample.vertical_speed > 0) return 90;
+			return degrees(atan(sample.vertical_speed / horizontal_speed));
+		}
+		double AlphaFloor()
+		{
+			switch (static_cast<int>(sample.flaps))
+			{
+			case 0: return 9.5;
+			case 1:
+			case 2: return 15;
+			case 3: return 14;
+			case 4: return 13;
+			default: return 9.5;
+			}
+		}
+		double AlphaProt() { return 19.0 / 21.0 * AlphaFloor(); }
+		double AlphaMax() { return 7.0 / 6.0 * AlphaFloor(); }
+		double NormalLoadFactor() { return 1 / cos(radians(-sample.roll)); }
+	};
+
+	AircraftDataSample Sample(const long step)
+	{
+		AircraftDataSample sample;
+		sample.flaps = step / 1000 % 5;
+		sample.lateral_speed = 300 + step % 7;
+		sample.longitudinal_speed = 200 + step % 11;
+		sample.vertical_speed = -20 + step % 40;
+		sample.roll = -30 + step % 60;
+		return sample;
+	}
+
+	// The queries of one step: VFPA in Update (twice), LoadFactorDemand (twice) and the trace; the alpha thresholds in
+	// NormalLawProtections::Update and AngleOfAttackDemand; the normal load factor in a turn
+	template <typename Derived>
+	double Queries(Derived& derived)
+	{
+		return derived.VFPA() + derived.VFPA() + derived.VFPA() + derived.VFPA() + derived.VFPA()
+			+ derived.AlphaProt() + derived.AlphaMax() + derived.AlphaMax() + derived.AlphaProt() + derived.AlphaMax()
+			+ derived.NormalLoadFactor();
+	}
+
+	template <typename Step>
+	double NanosecondsPerStep(const long steps, Step step)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		for (auto i = 0L; i < steps; i++) step(i);
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / steps;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const auto steps = argc > 1 ? atol(argv[1]) : 2000000L;
+	if (steps <= 0)
+	{
+		fprintf(stderr, "usage: %s [steps]\n", argv[0]);
+		return 1;
+	}
+
+	volatile double sink = 0;
+	Recomputed recomputed;
+	const auto recomputed_ns = NanosecondsPerStep(steps, [&](const long i)
+	{
+		recomputed.sample = Sample(i);
+		sink = sink + Queries(recomputed);
+	});
+	const auto recomputed_sum = sink;
+
+	sink = 0;
+	AircraftData aircraft_data;
+	const auto cached_ns = NanosecondsPerStep(steps, [&](const long i)
+	{
+		aircraft_data.Update(Sample(i), i / 60.0, 1 / 60.0);
+		sink = sink + Queries(aircraft_data);
+	});
+	if (sink != recomputed_sum)
+	{
+		fprintf(stderr, "the cached values differ from the recomputed ones\n");
+		return 1;
+	}
+
+	FbwInstance fbw;
+	const auto frame_ns = NanosecondsPerStep(steps, [&](const long i)
+	{
+		auto sample = Sample(i);
+		sample.ias = 250;
+		sample.radio_height = 5000;
+		sample.gforce = 1;
+		sample.vmo = 350;
+		sample.mmo = 0.82;
+		fbw.Input().SetYokeY(sin(i * 0.001));
+		fbw.Input().SetYokeX(0.3 * sin(i * 0.0003));
+		sink = sink + fbw.Update(sample, (i + 1) / 60.0, 1 / 60.0).elevator;
+	});
+
+	printf("derived queries of a step, recomputed: %.1f ns\n", recomputed_ns);
+	printf("derived queries of a step, cached:     %.1f ns (including AircraftData::Update)\n", cached_ns);
+	printf("FbwInstance frame:                     %.1f ns\n", frame_ns);
+	return 0;
+}
\ No newline at end of file
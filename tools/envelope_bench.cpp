@@ -0,0 +1,144 @@
+// Measures what the envelope predictor (see envelope.h) costs per control step, against fitting the trend of every
+// signal over a window of past samples each step, and checks the time to limit it predicts on a steady climb in speed.
+//
+// Usage: envelope_bench [steps] [window]
+//   steps   number of control steps to time (default 2000000)
+//   window  samples the rescanning fit uses (default 60, a second at the control rate)
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
+#include "../fbw_instance.h"
+
+namespace
+{
+	constexpr double dt = 1 / 60.0;
+
+	// The trend of the signals by least squares over the last window samples, rescanning them every step
+	class WindowTrends
+	{
+	private:
+		size_t window;
+		std::vector<double> history[SIGNAL_COUNT];
+		size_t count = 0;
+	public:
+		WindowTrends(const size_t window) : window(window)
+		{
+			for (auto& samples : history) samples.resize(window);
+		}
+
+		// Returns the sum of the time to each upper limit, so that nothing is optimized away
+		double Update(AircraftData& aircraft_data, const EnvelopeLimits& limits)
+		{
+			const double values[SIGNAL_COUNT] = { aircraft_data.Alpha(), aircraft_data.IAS(), aircraft_data.Mach(), aircraft_data.Pitch(), aircraft_data.GForce() };
+			const double upper[SIGNAL_COUNT] = { limits.alpha_prot, limits.vmo, limits.mmo, limits.max_pitch, limits.max_load_factor };
+			const auto slot = count++ % window;
+			const auto samples = count < window ? count : window;
+			auto total = 0.0;
+			for (auto signal = 0; signal < SIGNAL_COUNT; signal++)
+			{
+				history[signal][slot] = values[signal];
+				double sum_t = 0, sum_x = 0, sum_tt = 0, sum_tx = 0;
+				for (size_t i = 0; i < samples; i++)
+				{
+					const auto t = -static_cast<double>(i) * dt; // Age of the sample
+					const auto x = history[signal][(slot + window - i) % window];
+					sum_t += t;
+					sum_x += x;
+					sum_tt += t * t;
+					sum_tx += t * x;
+				}
+				const auto denominator = samples * sum_tt - sum_t * sum_t;
+				const auto rate = denominator > 0 ? (samples * sum_tx - sum_t * sum_x) / denominator : 0;
+				const auto level = (sum_x - rate * sum_t) / samples;
+				total += level >= upper[signal] ? 0 : rate > 0 ? (upper[signal] - level) / rate : 1e9;
+			}
+			return total;
+		}
+	};
+
+	// A descent picking up speed, with the attitude and load factor wandering as in a hand flown descent
+	AircraftDataSample Sample(const long step)
+	{
+		const auto t = step * dt;
+		const auto cycle = fmod(t, 60.0);
+		AircraftDataSample sample;
+		sample.aoa = 3 + sin(t * 0.7);
+		sample.gforce = 1 + 0.2 * sin(t * 1.3);
+		sample.ias = 300 + cycle;
+		sample.mach = 0.6 + cycle * 0.002;
+		sample.pitch = 2 + 3 * sin(t * 0.4);
+		sample.longitudinal_speed = 500;
+		sample.vmo = 350;
+		sample.mmo = 0.82;
+		return sample;
+	}
+
+	EnvelopeLimits Limits(AircraftData& aircraft_data)
+	{
+		return { aircraft_data.AlphaProt(), aircraft_data.Vmo(), aircraft_data.Mmo(), 30, -15, 2.5, -1 };
+	}
+
+	template <typename Step>
+	double NanosecondsPerStep(const long steps, Step step)
+	{
+		AircraftData aircraft_data;
+		const auto start = std::chrono::steady_clock::now();
+		for (auto i = 0L; i < steps; i++)
+		{
+			aircraft_data.Update(Sample(i), i * dt, dt);
+			step(aircraft_data);
+		}
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / steps;
+	}
+
+	// On a steady climb in speed of 2 kts per second from 320 kts, the predicted time to Vmo once the trend has settled
+	bool CheckRamp()
+	{
+		AircraftData aircraft_data;
+		EnvelopePredictor predictor;
+		auto worst_error = 0.0;
+		for (auto step = 0L; step < 840; step++)
+		{
+			auto sample = Sample(0);
+			sample.ias = 320 + 2 * step * dt;
+			aircraft_data.Update(sample, step * dt, dt);
+			predictor.Update(aircraft_data, Limits(aircraft_data), dt);
+			if (step * dt < 10) continue;
+			const auto expected = (350 - sample.ias) / 2;
+			worst_error = fmax(worst_error, fabs(predictor.TimeToLimit(LIMIT_VMO) - expected));
+		}
+		printf("time to Vmo on a 2 kts/s climb: worst error %.2g s after settling\n", worst_error);
+		return worst_error < 0.01;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const auto steps = argc > 1 ? atol(argv[1]) : 2000000L;
+	const auto window = argc > 2 ? atol(argv[2]) : 60L;
+	if (steps <= 0 || window <= 1)
+	{
+		fprintf(stderr, "usage: %s [steps] [window]\n", argv[0]);
+		return 1;
+	}
+
+	volatile double sink = 0;
+	const auto baseline_ns = NanosecondsPerStep(steps, [&](AircraftData& aircraft_data) { sink = sink + aircraft_data.IAS(); });
+	EnvelopePredictor predictor;
+	const auto predictor_ns = NanosecondsPerStep(steps, [&](AircraftData& aircraft_data)
+	{
+		predictor.Update(aircraft_data, Limits(aircraft_data), dt);
+		sink = sink + predictor.TimeToLimit(LIMIT_VMO);
+	});
+	WindowTrends window_trends(window);
+	const auto window_ns = NanosecondsPerStep(steps, [&](AircraftData& aircraft_data)
+	{
+		sink = sink + window_trends.Update(aircraft_data, Limits(aircraft_data));
+	});
+
+	printf("%ld steps, %d signals, %d limits\n", steps, SIGNAL_COUNT, LIMIT_COUNT);
+	printf("predictor             %7.2f ns per step\n", predictor_ns - baseline_ns);
+	printf("fit over %3ld samples  %7.2f ns per step\n", window, window_ns - baseline_ns);
+	return CheckRamp() ? 0 : 1;
+}
\ No newline at end of file
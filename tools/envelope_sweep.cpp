@@ -0,0 +1,224 @@
+// Generates flight_envelope_tables.h: the envelope of the high angle of attack protection and the pitch attitude limits
+// (see flight_envelope.h) over flaps, weight and Mach, swept on every core over the host plant model. At every point of
+// the grid:
+//   - the lift curve of the flaps at the Mach number is scanned for its peak, where the wing stalls
+//   - alpha_max, alpha_floor and alpha_prot are the angles of attack below the peak at which the lift reaches
+//     fixed fractions of it (alpha_prot_lift, alpha_floor_lift and alpha_max_lift)
+//   - V_alpha_max and V_alpha_prot are the indicated airspeeds at which the plant, trimmed for level flight at the
+//     weight, at the altitude that makes the speed the Mach number, flies at alpha_max and alpha_prot
+// Speeds that are faster than the Mach number at sea level are trimmed at sea level. Every cell of the table is then
+// checked at its centre against the plant, and the worst interpolation errors are printed.
+//
+// Usage: envelope_sweep [--threads n] [--header path]
+//   threads  worker threads (default: one per core)
+//   header   where to write the table (default flight_envelope_tables.h)
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "plant_model.h"
+#include "thread_pool.h"
+
+namespace
+{
+	// The grid of the table
+	constexpr int flaps_count = aero::flap_count;
+	constexpr double weight_start = 40000; // Kilograms, about the empty weight
+	constexpr double weight_step = 5000;
+	constexpr int weight_count = 9; // Up to 80000 kilograms, beyond the maximum takeoff weight
+	constexpr double mach_start = 0.2; // The lowest Mach number of the aerodynamic tables
+	constexpr double mach_step = 0.05;
+	constexpr int mach_count = 14;
+
+	// The lift at alpha_prot, alpha_floor and alpha_max, as fractions of the peak lift; with them the speeds are
+	// about 1.15, 1.12 and 1.07 times the 1g stall speed
+	constexpr double alpha_prot_lift = 0.75;
+	constexpr double alpha_floor_lift = 0.80;
+	constexpr double alpha_max_lift = 0.87;
+
+	// The FCOM's pitch attitude limits, in degrees, at V_alpha_prot and at V_alpha_max
+	constexpr double max_pitch[flaps_count] = { 30, 30, 30, 30, 25 };
+	constexpr double low_speed_max_pitch[flaps_count] = { 25, 25, 25, 25, 20 };
+
+	constexpr const char* flaps_names[flaps_count] = { "CONF 0", "CONF 1", "CONF 2", "CONF 3", "CONF FULL" };
+
+	PlantInitialConditions Trim(const int flaps, const double weight, const double ias, const double altitude)
+	{
+		PlantInitialConditions initial;
+		initial.ias = ias;
+		initial.altitude = altitude;
+		initial.flaps = flaps;
+		initial.weight = weight;
+		return initial;
+	}
+
+	// The angle of attack the plant is trimmed at for level flight at ias and mach
+	double TrimmedAlpha(PlantModel& plant, const int flaps, const double weight, const double ias, const double mach)
+	{
+		// The Mach number of a given indicated airspeed rises with the altitude
+		auto low = 0.0, high = 60000.0;
+		plant.Reset(Trim(flaps, weight, ias, low));
+		if (plant.Sample().mach < mach)
+		{
+			for (auto i = 0; i < 32; i++)
+			{
+				const auto altitude = (low + high) / 2;
+				plant.Reset(Trim(flaps, weight, ias, altitude));
+				(plant.Sample().mach < mach ? low : high) = altitude;
+			}
+		}
+		plant.Reset(Trim(flaps, weight, ias, low));
+		return plant.Sample().aoa;
+	}
+
+	// The indicated airspeed at which the plant is trimmed at alpha, which falls as the speed rises
+	double TrimmedSpeed(PlantModel& plant, const int flaps, const double weight, const double mach, const double alpha)
+	{
+		auto low = 30.0, high = 600.0;
+		for (auto i = 0; i < 32; i++)
+		{
+			const auto ias = (low + high) / 2;
+			(TrimmedAlpha(plant, flaps, weight, ias, mach) > alpha ? low : high) = ias;
+		}
+		return (low + high) / 2;
+	}
+
+	EnvelopePoint Sweep(const int flaps, const double weight, const double mach)
+	{
+		PlantModel plant;
+		plant.Reset(Trim(flaps, weight, 250, 10000));
+
+		// The lift peak, and the angles below it where the lift reaches a fraction of the peak
+		auto peak_alpha = aero::alpha_breakpoints[0], peak_lift = plant.LiftCoefficient(peak_alpha, mach);
+		for (auto alpha = peak_alpha + 0.001; alpha <= aero::alpha_breakpoints[aero::alpha_count - 1]; alpha += 0.001)
+		{
+			const auto lift = plant.LiftCoefficient(alpha, mach);
+			if (lift <= peak_lift) break;
+			peak_lift = lift;
+			peak_alpha = alpha;
+		}
+		const auto alpha_at = [&plant, mach, peak_alpha, peak_lift](const double fraction)
+		{
+			auto low = aero::alpha_breakpoints[0], high = peak_alpha;
+			for (auto i = 0; i < 50; i++)
+			{
+				const auto alpha = (low + high) / 2;
+				(plant.LiftCoefficient(alpha, mach) < fraction * peak_lift ? low : high) = alpha;
+			}
+			return (low + high) / 2;
+		};
+
+		EnvelopePoint point;
+		point.alpha_prot = alpha_at(alpha_prot_lift);
+		point.alpha_floor = alpha_at(alpha_floor_lift);
+		point.alpha_max = alpha_at(alpha_max_lift);
+		point.v_alpha_prot = TrimmedSpeed(plant, flaps, weight, mach, point.alpha_prot);
+		point.v_alpha_max = TrimmedSpeed(plant, flaps, weight, mach, point.alpha_max);
+		point.max_pitch = max_pitch[flaps];
+		point.low_speed_max_pitch = low_speed_max_pitch[flaps];
+		return point;
+	}
+
+	bool SaveHeader(const char* path, const std::vector<EnvelopePoint>& points)
+	{
+		auto* file = fopen(path, "w");
+		if (!file) return false;
+		fprintf(file, "#pragma once\n#include \"flight_envelope.h\"\n\n");
+		fprintf(file, "// Generated by envelope_sweep (see tools/envelope_sweep.cpp) from the host plant model, which stands in for\n");
+		fprintf(file, "// the simulator's flight model; regenerate it when the aerodynamic tables of host/aero_data.h change.\n");
+		fprintf(file, "namespace default_envelope\n{\n");
+		fprintf(file, "\t// alpha_prot, alpha_floor, alpha_max, v_alpha_prot, v_alpha_max, max_pitch, low_speed_max_pitch\n");
+		fprintf(file, "\tconstexpr EnvelopePoint points[] = {\n");
+		for (auto flaps = 0; flaps < flaps_count; flaps++)
+		{
+			for (auto w = 0; w < weight_count; w++)
+			{
+				fprintf(file, "\t\t// %s, %.0f kg, Mach %.2f to %.2f\n", flaps_names[flaps], weight_start + w * weight_step, mach_start,
+					mach_start + (mach_count - 1) * mach_step);
+				for (auto m = 0; m < mach_count; m++)
+				{
+					const auto& point = points[(flaps * weight_count + w) * mach_count + m];
+					fprintf(file, "\t\t{ %.4f, %.4f, %.4f, %.2f, %.2f, %.0f, %.0f },\n", point.alpha_prot, point.alpha_floor,
+						point.alpha_max, point.v_alpha_prot, point.v_alpha_max, point.max_pitch, point.low_speed_max_pitch);
+				}
+			}
+		}
+		fprintf(file, "\t};\n}\n\nconstexpr EnvelopeTable default_envelope_table = {\n");
+		fprintf(file, "\t%d, %.9g, %.9g, %d, %.9g, %.9g, %d, default_envelope::points,\n};", flaps_count, weight_start, weight_step,
+			weight_count, mach_start, mach_step, mach_count);
+		return fclose(file) == 0;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	auto threads = 0;
+	const char* header_path = "flight_envelope_tables.h";
+	auto usage = false;
+	for (auto i = 1; i < argc; i++)
+	{
+		const auto has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--threads") == 0 && has_value) threads = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--header") == 0 && has_value) header_path = argv[++i];
+		else usage = true;
+	}
+	if (usage || threads < 0)
+	{
+		fprintf(stderr, "usage: %s [--threads n] [--header path]\n", argv[0]);
+		return 1;
+	}
+
+	ThreadPool pool(threads);
+	const auto start = std::chrono::steady_clock::now();
+	const auto point_count = static_cast<size_t>(flaps_count * weight_count * mach_count);
+	std::vector<EnvelopePoint> points(point_count);
+	pool.ParallelFor(point_count, 1, [&points](const size_t index)
+	{
+		const auto flaps = static_cast<int>(index / (weight_count * mach_count));
+		const auto w = static_cast<int>(index / mach_count % weight_count);
+		const auto m = static_cast<int>(index % mach_count);
+		points[index] = Sweep(flaps, weight_start + w * weight_step, mach_start + m * mach_step);
+	});
+	const EnvelopeTable table = { flaps_count, weight_start, weight_step, weight_count, mach_start, mach_step, mach_count, points.data() };
+
+	// The centre of every cell, where the interpolation is furthest from the breakpoints
+	const auto cell_count = static_cast<size_t>(flaps_count * (weight_count - 1) * (mach_count - 1));
+	std::vector<EnvelopePoint> errors(cell_count);
+	pool.ParallelFor(cell_count, 1, [&errors, &table](const size_t index)
+	{
+		const auto flaps = static_cast<int>(index / ((weight_count - 1) * (mach_count - 1)));
+		const auto weight = weight_start + (index / (mach_count - 1) % (weight_count - 1) + 0.5) * weight_step;
+		const auto mach = mach_start + (index % (mach_count - 1) + 0.5) * mach_step;
+		const auto swept = Sweep(flaps, weight, mach);
+		const auto interpolated = LookUpEnvelope(table, flaps, weight, mach);
+		for (const auto field : envelope_fields) errors[index].*field = fabs(interpolated.*field - swept.*field);
+	});
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	EnvelopePoint worst = {};
+	for (const auto& error : errors)
+	{
+		for (const auto field : envelope_fields) worst.*field = fmax(worst.*field, error.*field);
+	}
+	printf("swept %zu points and checked %zu cells in %.2f s on %zu threads\n", point_count, cell_count, elapsed, pool.Size());
+	printf("worst interpolation error: alpha_prot %.3f deg, alpha_max %.3f deg, V_alpha_prot %.2f kt, V_alpha_max %.2f kt\n",
+		worst.alpha_prot, worst.alpha_max, worst.v_alpha_prot, worst.v_alpha_max);
+	for (auto flaps = 0; flaps < flaps_count; flaps++)
+	{
+		const auto at = [&table, flaps](const double weight, const double mach) { return LookUpEnvelope(table, flaps, weight, mach); };
+		const auto light = at(50000, 0.2), heavy = at(75000, 0.2), fast = at(64000, 0.8);
+		printf("  %-9s alpha_prot/alpha_max %.1f/%.1f deg (M0.80 %.1f/%.1f), V_alpha_prot/V_alpha_max %.0f/%.0f kt at 50 t, %.0f/%.0f kt at 75 t\n",
+			flaps_names[flaps], light.alpha_prot, light.alpha_max, fast.alpha_prot, fast.alpha_max, light.v_alpha_prot,
+			light.v_alpha_max, heavy.v_alpha_prot, heavy.v_alpha_max);
+	}
+
+	if (!SaveHeader(header_path, points))
+	{
+		fprintf(stderr, "cannot write %s\n", header_path);
+		return 1;
+	}
+	printf("wrote %s\n", header_path);
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,193 @@
+// Compares the ways AircraftData derives the pitch rate and the vertical flight path angle rate (see estimator.h).
+// Randomized scenarios are flown closed loop against the plant model, recording the samples the FBW was given and
+// the true rates of the plant; the samples are then replayed through AircraftData with each estimator, clean and with
+// noise added to them as a real simulator's would have. For each rate it reports:
+//   lag    the delay of the estimate behind the true rate that fits it best
+//   noise  the RMS error of the estimate once delayed by the lag
+//   error  the RMS error of the estimate, as the control laws see it
+// and what an update of AircraftData costs with each estimator.
+//
+// Usage: estimator_bench [scenarios] [seconds] [--seed n]
+//   scenarios  number of scenarios to fly (default 20)
+//   seconds    flight time of each scenario (default 30)
+//   seed       selects the set of scenarios, as in monte_carlo (default 1)
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "closed_loop.h"
+
+namespace
+{
+	constexpr double dt = 1 / 60.0;
+
+	struct RecordedFrame
+	{
+		AircraftDataSample sample;
+		double pitch_rate; // True, in degrees/second
+		double vfpa_rate;
+		bool first; // First frame of a scenario
+	};
+
+	// Adds white noise to what the simulator reports
+	std::vector<RecordedFrame> AddNoise(std::vector<RecordedFrame> frames)
+	{
+		std::mt19937_64 generator(1);
+		std::normal_distribution<double> normal;
+		for (auto& frame : frames)
+		{
+			auto& sample = frame.sample;
+			sample.pitch += 0.02 * normal(generator);
+			sample.roll += 0.02 * normal(generator);
+			sample.pitch_velocity += 0.05 * normal(generator);
+			sample.yaw_velocity += 0.05 * normal(generator);
+			sample.lateral_speed += 0.05 * normal(generator);
+			sample.longitudinal_speed += 0.05 * normal(generator);
+			sample.vertical_speed += 0.05 * normal(generator);
+			sample.lateral_acceleration += 0.1 * normal(generator);
+			sample.longitudinal_acceleration += 0.1 * normal(generator);
+			sample.vertical_acceleration += 0.1 * normal(generator);
+		}
+		return frames;
+	}
+
+	struct Fit
+	{
+		double lag = 0; // Milliseconds
+		double noise = 0;
+		double error = 0;
+	};
+
+	// Fits estimate to truth delayed by 0 to 3 frames, in twentieths of a frame; scenarios are not mixed
+	Fit FitLag(const std::vector<RecordedFrame>& frames, const std::vector<double>& estimate, double RecordedFrame::* truth)
+	{
+		const auto rms = [&](const double delay)
+		{
+			const auto whole = static_cast<size_t>(delay);
+			const auto fraction = delay - whole;
+			double sum = 0;
+			size_t count = 0;
+			size_t start = 0;
+			for (size_t i = 0; i < frames.size(); i++)
+			{
+				if (frames[i].first) start = i;
+				if (i < start + whole + 1 + 30) continue; // Let the estimators settle after the start
+				const auto delayed = frames[i - whole].*truth * (1 - fraction) + frames[i - whole - 1].*truth * fraction;
+				const auto error = estimate[i] - delayed;
+				sum += error * error;
+				count++;
+			}
+			return sqrt(sum / count);
+		};
+		Fit fit;
+		fit.noise = 1e300;
+		for (auto step = 0; step <= 60; step++)
+		{
+			const auto value = rms(step / 20.0);
+			if (value < fit.noise)
+			{
+				fit.noise = value;
+				fit.lag = step / 20.0 * dt * 1000;
+			}
+		}
+		fit.error = rms(0);
+		return fit;
+	}
+
+	void Compare(const char* name, const std::vector<RecordedFrame>& frames)
+	{
+		static const char* const mode_names[] = { "finite difference", "complementary" };
+		printf("%s\n", name);
+		for (const auto mode : { ESTIMATOR_FINITE_DIFFERENCE, ESTIMATOR_COMPLEMENTARY })
+		{
+			std::vector<double> pitch_rate(frames.size()), vfpa_rate(frames.size());
+			AircraftData aircraft_data;
+			for (size_t i = 0; i < frames.size(); i++)
+			{
+				if (frames[i].first)
+				{
+					aircraft_data = AircraftData();
+					aircraft_data.SetEstimatorMode(mode);
+				}
+				aircraft_data.Update(frames[i].sample, i * dt, dt);
+				pitch_rate[i] = aircraft_data.PitchRate();
+				vfpa_rate[i] = aircraft_data.VFPARate();
+			}
+			const auto pitch = FitLag(frames, pitch_rate, &RecordedFrame::pitch_rate);
+			const auto vfpa = FitLag(frames, vfpa_rate, &RecordedFrame::vfpa_rate);
+			printf("  %-18s pitch rate: lag %5.1f ms, noise %.4f, error %.4f deg/s; VFPA rate: lag %5.1f ms, noise %.4f, error %.4f deg/s\n",
+				mode_names[mode], pitch.lag, pitch.noise, pitch.error, vfpa.lag, vfpa.noise, vfpa.error);
+		}
+	}
+
+	double NanosecondsPerUpdate(const std::vector<RecordedFrame>& frames, const ESTIMATOR_MODE mode)
+	{
+		AircraftData aircraft_data;
+		aircraft_data.SetEstimatorMode(mode);
+		volatile double sink = 0;
+		const auto start = std::chrono::steady_clock::now();
+		for (auto repeat = 0; repeat < 10; repeat++)
+		{
+			for (size_t i = 0; i < frames.size(); i++)
+			{
+				aircraft_data.Update(frames[i].sample, i * dt, dt);
+				sink = sink + aircraft_data.PitchRate() + aircraft_data.VFPARate();
+			}
+		}
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (10.0 * frames.size());
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	auto scenarios = 20L;
+	auto seconds = 30.0;
+	auto seed = 1ull;
+	auto positional = 0;
+	for (auto i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoull(argv[++i], nullptr, 10);
+		else if (positional == 0 && argv[i][0] != '-') { scenarios = atol(argv[i]); positional++; }
+		else if (positional == 1 && argv[i][0] != '-') { seconds = atof(argv[i]); positional++; }
+		else
+		{
+			fprintf(stderr, "usage: %s [scenarios] [seconds] [--seed n]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (scenarios <= 0 || seconds <= 0)
+	{
+		fprintf(stderr, "scenarios and seconds must be positive\n");
+		return 1;
+	}
+
+	ScenarioDistribution distribution;
+	std::vector<RecordedFrame> frames;
+	for (auto index = 0L; index < scenarios; index++)
+	{
+		const auto scenario = distribution.Draw(seed, index);
+		ClosedLoop loop;
+		if (!loop.Start(scenario, dt)) continue;
+		const auto count = static_cast<long>(seconds / dt);
+		for (auto frame = 0L; frame < count; frame++)
+		{
+			loop.Step(scenario, frame * dt, dt);
+			const auto& plant = loop.Plant();
+			frames.push_back({ plant.Sample(), plant.PitchRate(), plant.FlightPathRate(), frame == 0 });
+		}
+	}
+	if (frames.empty())
+	{
+		fprintf(stderr, "no scenario reached flight mode\n");
+		return 1;
+	}
+
+	printf("%zu frames of %ld scenarios at %.0f fps\n", frames.size(), scenarios, 1 / dt);
+	Compare("clean samples", frames);
+	Compare("noisy samples", AddNoise(frames));
+	printf("update: finite difference %.1f ns, complementary %.1f ns\n",
+		NanosecondsPerUpdate(frames, ESTIMATOR_FINITE_DIFFERENCE), NanosecondsPerUpdate(frames, ESTIMATOR_COMPLEMENTARY));
+	return 0;
+}
\ No newline at end of file
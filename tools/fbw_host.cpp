@@ -0,0 +1,109 @@
+// Runs FBW_gauge_callback in a tight loop against the host stand-in SDK, so the per-frame cost can be profiled
+// (e.g. with perf) outside the simulator.
+//
+// Usage: fbw_host [frames] [fps] [--trace] [--record] [--mpc] [--actuators] [--complementary]
+//   frames           number of PANEL_SERVICE_PRE_DRAW frames to run (default 100000)
+//   fps              simulated frame rate, which sets dt (default 60)
+//   --trace          set A32NX_FBW_TRACE so the pitch telemetry is written to fbw_trace.bin (see trace_decode)
+//   --record         set A32NX_FBW_RECORD so the flight is recorded to fbw_recording.bin (see fbw_replay), and print the
+//                    hash of the surfaces the gauge wrote, which a replay of the recording must reproduce
+//   --mpc            set A32NX_FBW_PITCH_MPC so the gauge flies the model predictive pitch law (see mpc.h)
+//   --actuators      set A32NX_FBW_ACTUATORS so the surfaces move through their actuators (see actuators.h)
+//   --complementary  set A32NX_FBW_COMPLEMENTARY_ESTIMATOR so the rates are estimated by the complementary filter
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include <MSFS/Legacy/gauges.h>
+
+#include "sim_host.h"
+#include "surface_hash.h"
+
+extern "C" bool FBW_gauge_callback(FsContext ctx, int service_id, void* pData);
+
+int main(int argc, char* argv[])
+{
+	auto frames = 100000L;
+	auto fps = 60.0;
+	auto trace = false;
+	auto record = false;
+	auto model_predictive = false;
+	auto actuators = false;
+	auto complementary = false;
+	auto positional = 0;
+	for (auto i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--trace") == 0) trace = true;
+		else if (strcmp(argv[i], "--record") == 0) record = true;
+		else if (strcmp(argv[i], "--mpc") == 0) model_predictive = true;
+		else if (strcmp(argv[i], "--actuators") == 0) actuators = true;
+		else if (strcmp(argv[i], "--complementary") == 0) complementary = true;
+		else if (positional++ == 0) frames = atol(argv[i]);
+		else fps = atof(argv[i]);
+	}
+	if (frames <= 0 || fps <= 0)
+	{
+		fprintf(stderr, "usage: %s [frames] [fps] [--trace] [--record] [--mpc] [--actuators] [--complementary]\n", argv[0]);
+		return 1;
+	}
+
+	// A clean configuration cruise, in the simulator's units and sign conventions
+	SimHostSetVar("PLANE ALTITUDE", 10000);
+	SimHostSetVar("INCIDENCE ALPHA", 2.5);
+	SimHostSetVar("FLAPS HANDLE INDEX", 0);
+	SimHostSetVar("G FORCE", 1);
+	SimHostSetVar("AIRSPEED INDICATED", 250);
+	SimHostSetVar("VELOCITY WORLD X", 420);
+	SimHostSetVar("AIRSPEED MACH", 0.45);
+	SimHostSetVar("BARBER POLE MACH", 0.82);
+	SimHostSetVar("SIM ON GROUND", 0);
+	SimHostSetVar("PLANE PITCH DEGREES", -2.5);
+	SimHostSetVar("RADIO HEIGHT", 10000);
+	SimHostSetVar("AIRSPEED BARBER POLE", 350);
+	SimHostSetVar("TOTAL WEIGHT", 141096);
+
+	// Recording, the choice of pitch law, the estimator and the actuators have to start with the gauge
+	set_named_variable_value(register_named_variable("A32NX_FBW_RECORD"), record ? 1 : 0);
+	set_named_variable_value(register_named_variable("A32NX_FBW_PITCH_MPC"), model_predictive ? 1 : 0);
+	set_named_variable_value(register_named_variable("A32NX_FBW_ACTUATORS"), actuators ? 1 : 0);
+	set_named_variable_value(register_named_variable("A32NX_FBW_COMPLEMENTARY_ESTIMATOR"), complementary ? 1 : 0);
+
+	const FsContext ctx = 0;
+	if (!FBW_gauge_callback(ctx, PANEL_SERVICE_PRE_INSTALL, nullptr) || !FBW_gauge_callback(ctx, PANEL_SERVICE_POST_INSTALL, nullptr))
+	{
+		fprintf(stderr, "gauge installation failed\n");
+		return 1;
+	}
+
+	set_named_variable_value(register_named_variable("A32NX_FBW_TRACE"), trace ? 1 : 0);
+
+	SurfaceHash hash;
+	sGaugeDrawData draw_data = {};
+	draw_data.dt = 1 / fps;
+	const auto start = std::chrono::steady_clock::now();
+	for (auto frame = 0L; frame < frames; frame++)
+	{
+		// Sweep the sidestick slowly back and forth so every pitch law branch gets exercised
+		const auto yoke = sin(draw_data.t * 0.5);
+		SimHostSendEvent("AXIS_ELEVATOR_SET", static_cast<DWORD>(static_cast<long>(-yoke * 16384)));
+		SimHostSendEvent("AXIS_AILERONS_SET", static_cast<DWORD>(static_cast<long>(-yoke * 0.2 * 16384)));
+
+		draw_data.t += draw_data.dt;
+		FBW_gauge_callback(ctx, PANEL_SERVICE_PRE_DRAW, &draw_data);
+		if (record)
+		{
+			CONTROL_SURFACES_DATA surfaces;
+			surfaces.elevator = SimHostGetVar("ELEVATOR POSITION");
+			surfaces.ailerons = SimHostGetVar("AILERON POSITION");
+			surfaces.rudder = SimHostGetVar("RUDDER POSITION");
+			hash.Add(surfaces);
+		}
+	}
+	const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+	FBW_gauge_callback(ctx, PANEL_SERVICE_PRE_KILL, nullptr);
+	fprintf(stderr, "%ld frames at %.0f fps: %.1f ns/frame\n", frames, fps, elapsed / frames);
+	if (record) fprintf(stderr, "surfaces %016llx\n", static_cast<unsigned long long>(hash.Value()));
+	return 0;
+}
\ No newline at end of file
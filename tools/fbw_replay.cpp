@@ -0,0 +1,150 @@
+// Replays a recording made by FlightRecorder (see recorder.h) through a fresh FbwInstance per session, as fast as
+// the CPU allows, and prints a hash of every surface position it produced. A replay reproduces the recorded flight
+// bit for bit, so two builds of the control laws can be compared (or bisected) on real pilot sessions.
+// It also reports how long the sidestick events took to reach the surfaces (see InputLatency in input.h), and how many
+// surface writes the output stage skipped (see actuators.h). The frames an event waited are those of the recorded
+// flight, but as the replay does not wait between frames, its milliseconds are only the time the laws took.
+//
+// Usage: fbw_replay <recording> [--csv file] [--repeat n]
+//   --csv     write the surfaces of every frame to file (session,t,elevator,ailerons,rudder)
+//   --repeat  replay n times, checking every replay against the first (default 1)
+#include <chrono>
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "../fbw_instance.h"
+#include "recording.h"
+#include "surface_hash.h"
+
+namespace
+{
+	struct ReplayResult
+	{
+		bool ok = false;
+		int sessions = 0;
+		long frames = 0;
+		double seconds = 0; // Simulated
+		uint64_t hash = 0;
+		InputLatency latency; // Of the axis events of every session
+		uint64_t writes = 0; // Of the surfaces to the simulator
+		uint64_t skipped_writes = 0;
+	};
+
+	ReplayResult Replay(const RecordingReader& reader, FILE* csv, std::string& error)
+	{
+		ReplayResult result;
+		std::unique_ptr<FbwInstance> fbw;
+		SurfaceHash hash;
+		result.ok = reader.Read([&](const RecordingHeader& header)
+		{
+			if (fbw)
+			{
+				result.latency.Merge(fbw->Input().Latency());
+				result.writes += fbw->Output().Writes();
+				result.skipped_writes += fbw->Output().SkippedWrites();
+			}
+			fbw.reset(new FbwInstance(header.control_rate, header.max_control_steps));
+			fbw->Surfaces().Pitch().SetModelPredictive((header.flags & RECORDING_PITCH_MPC) != 0);
+			fbw->Aircraft().SetEstimatorMode((header.flags & RECORDING_FINITE_DIFFERENCE) != 0 ? ESTIMATOR_FINITE_DIFFERENCE : ESTIMATOR_COMPLEMENTARY);
+			fbw->Output().SetEnabled((header.flags & RECORDING_ACTUATORS) != 0);
+			result.sessions++;
+		},
+		[&](const RecordedFrame& frame)
+		{
+			for (uint32_t i = 0; i < frame.event_count; i++)
+			{
+				fbw->Input().OnEvent(static_cast<EVENT_ID>(frame.event_ids[i]), frame.event_data[i]);
+			}
+			const auto surfaces = fbw->Update(frame.sample, frame.t, frame.dt);
+			hash.Add(surfaces);
+			if (csv) fprintf(csv, "%d,%.17g,%.17g,%.17g,%.17g\n", result.sessions, frame.t, surfaces.elevator, surfaces.ailerons, surfaces.rudder);
+			result.frames++;
+			result.seconds += frame.dt;
+		}, error);
+		if (fbw)
+		{
+			result.latency.Merge(fbw->Input().Latency());
+			result.writes += fbw->Output().Writes();
+			result.skipped_writes += fbw->Output().SkippedWrites();
+		}
+		result.hash = hash.Value();
+		return result;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const char* path = nullptr;
+	const char* csv_path = nullptr;
+	auto repeat = 1;
+	for (auto i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) csv_path = argv[++i];
+		else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) repeat = atoi(argv[++i]);
+		else if (!path && argv[i][0] != '-') path = argv[i];
+		else
+		{
+			path = nullptr;
+			break;
+		}
+	}
+	if (!path || repeat <= 0)
+	{
+		fprintf(stderr, "usage: %s <recording> [--csv file] [--repeat n]\n", argv[0]);
+		return 1;
+	}
+
+	RecordingReader reader;
+	if (!reader.Open(path))
+	{
+		fprintf(stderr, "could not open %s\n", path);
+		return 1;
+	}
+
+	FILE* csv = nullptr;
+	if (csv_path)
+	{
+		csv = fopen(csv_path, "w");
+		if (!csv)
+		{
+			fprintf(stderr, "could not open %s\n", csv_path);
+			return 1;
+		}
+		fprintf(csv, "session,t,elevator,ailerons,rudder\n");
+	}
+
+	ReplayResult first;
+	auto best = 1e300;
+	for (auto run = 0; run < repeat; run++)
+	{
+		std::string error;
+		const auto start = std::chrono::steady_clock::now();
+		const auto result = Replay(reader, run == 0 ? csv : nullptr, error);
+		const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if (!result.ok)
+		{
+			fprintf(stderr, "%s: %s\n", path, error.c_str());
+			return 1;
+		}
+		if (run == 0) first = result;
+		else if (result.hash != first.hash)
+		{
+			fprintf(stderr, "replay %d produced %016" PRIx64 " instead of %016" PRIx64 "\n", run + 1, result.hash, first.hash);
+			return 1;
+		}
+		if (elapsed < best) best = elapsed;
+	}
+	if (csv) fclose(csv);
+
+	printf("%d sessions, %ld frames, %.1f s of flight replayed in %.3f s (%.0fx real time)\n",
+		first.sessions, first.frames, first.seconds, best, first.seconds / best);
+	const auto& latency = first.latency;
+	printf("input latency: %" PRIu64 " axis events, mean %.3f ms, max %.3f ms; reached the surfaces in the same frame %" PRIu64 ", 1 frame later %" PRIu64 ", 2 %" PRIu64 ", 3 or more %" PRIu64 "\n",
+		latency.events, latency.MeanMs(), latency.max_ms, latency.frames[0], latency.frames[1], latency.frames[2], latency.frames[3]);
+	printf("surface writes: %" PRIu64 ", %" PRIu64 " skipped as no surface moved\n", first.writes, first.skipped_writes);
+	printf("surfaces %016" PRIx64 "\n", first.hash);
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,201 @@
+// Measures what scheduling the PID gains (see gains.h) costs per control step on a full table, against searching every
+// axis from scratch each step, and checks that both interpolate the same gains.
+//
+// Usage: gain_bench [steps] [--gains file]
+//   steps  number of control steps to time (default 2000000)
+//   gains  file of the gain table to use (see host/gain_file.h); by default a table of 8 x 6 x 6 x 5 points is made up
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gain_file.h"
+
+namespace
+{
+	constexpr double dt = 1 / 60.0;
+
+	struct Conditions
+	{
+		double ias;
+		double mach;
+		double altitude;
+		int flaps;
+	};
+
+	// A climb and a descent over 20 minutes, with the speed wandering and the flaps out near the ground
+	Conditions Flight(const long step)
+	{
+		const auto t = fmod(step * dt, 1200.0);
+		const auto climb = t < 600 ? t / 600 : (1200 - t) / 600;
+		const auto altitude = 37000 * climb;
+		const auto ias = 150 + 150 * sqrt(climb) + 10 * sin(t * 0.05);
+		const auto mach = ias / 661.47 / pow(1 - 6.8756e-6 * fmin(altitude, 36089), 2.628);
+		return { ias, mach, altitude, climb < 0.05 ? 3 : climb < 0.1 ? 1 : 0 };
+	}
+
+	// The gains of gain_tables.h, scaled smoothly over a whole grid
+	class MadeUpTable
+	{
+	private:
+		std::vector<double> breakpoints[GAIN_AXIS_COUNT] = {
+			{ 120, 160, 200, 240, 280, 320, 360, 400 },
+			{ 0.2, 0.35, 0.5, 0.65, 0.75, 0.85 },
+			{ 0, 5000, 10000, 20000, 30000, 40000 },
+			{ 0, 1, 2, 3, 4 },
+		};
+		std::vector<PIDGains> points;
+		GainTable table;
+	public:
+		MadeUpTable()
+		{
+			for (auto axis = 0; axis < GAIN_AXIS_COUNT; axis++)
+			{
+				table.breakpoints[axis] = breakpoints[axis].data();
+				table.sizes[axis] = static_cast<int>(breakpoints[axis].size());
+			}
+			for (const auto ias : breakpoints[GAIN_AXIS_IAS])
+			for (const auto mach : breakpoints[GAIN_AXIS_MACH])
+			for (const auto altitude : breakpoints[GAIN_AXIS_ALTITUDE])
+			for (const auto flaps : breakpoints[GAIN_AXIS_FLAPS])
+			{
+				const auto scale = (250 / ias) * (250 / ias) * (1 + 0.3 * mach) * (1 + altitude / 80000) * (1 + 0.05 * flaps);
+				for (const auto& gains : default_gains::points[0])
+				{
+					points.push_back({ gains.kp * scale, gains.ki * scale, gains.kd * scale });
+				}
+			}
+			table.points = points.data();
+		}
+		MadeUpTable(const MadeUpTable&) = delete;
+		MadeUpTable& operator=(const MadeUpTable&) = delete;
+
+		const GainTable& Table() const { return table; }
+	};
+
+	// The scheduler's interpolation, with each axis searched by bisection every time
+	void SearchedGains(const GainTable& table, const Conditions& conditions, PIDGains* gains)
+	{
+		const double x[GAIN_AXIS_COUNT] = { conditions.ias, conditions.mach, conditions.altitude, static_cast<double>(conditions.flaps) };
+		double weights[GAIN_AXIS_COUNT][2];
+		int offsets[GAIN_AXIS_COUNT][2];
+		auto stride = 1;
+		for (auto axis = GAIN_AXIS_COUNT - 1; axis >= 0; axis--)
+		{
+			const auto* breakpoints = table.breakpoints[axis];
+			const auto size = table.sizes[axis];
+			const auto last_cell = size > 1 ? size - 2 : 0;
+			const auto found = static_cast<int>(std::upper_bound(breakpoints, breakpoints + size, x[axis]) - breakpoints) - 1;
+			const auto cell = std::min(std::max(found, 0), last_cell);
+			const auto upper = size > 1 ? cell + 1 : cell;
+			const auto span = breakpoints[upper] - breakpoints[cell];
+			const auto fraction = span > 0 ? clamp((x[axis] - breakpoints[cell]) / span, 0, 1) : 0;
+			weights[axis][0] = 1 - fraction;
+			weights[axis][1] = fraction;
+			offsets[axis][0] = cell * stride;
+			offsets[axis][1] = upper * stride;
+			stride *= size;
+		}
+
+		constexpr auto values = 3 * GAIN_CONTROLLER_COUNT;
+		double sum[values] = {};
+		for (auto corner = 0; corner < 1 << GAIN_AXIS_COUNT; corner++)
+		{
+			auto weight = 1.0;
+			auto point = 0;
+			for (auto axis = 0; axis < GAIN_AXIS_COUNT; axis++)
+			{
+				const auto side = (corner >> axis) & 1;
+				weight *= weights[axis][side];
+				point += offsets[axis][side];
+			}
+			const auto* corner_values = &table.points[point * GAIN_CONTROLLER_COUNT].kp;
+			for (auto i = 0; i < values; i++) sum[i] += weight * corner_values[i];
+		}
+		for (auto controller = 0; controller < GAIN_CONTROLLER_COUNT; controller++)
+		{
+			gains[controller] = { sum[3 * controller], sum[3 * controller + 1], sum[3 * controller + 2] };
+		}
+	}
+
+	template <typename Step>
+	double NanosecondsPerStep(const long steps, Step step)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		for (auto i = 0L; i < steps; i++) step(Flight(i));
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / steps;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	auto steps = 2000000L;
+	const char* path = nullptr;
+	for (auto i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--gains") == 0 && i + 1 < argc) path = argv[++i];
+		else if (argv[i][0] != '-') steps = atol(argv[i]);
+		else steps = 0;
+	}
+	if (steps <= 0)
+	{
+		fprintf(stderr, "usage: %s [steps] [--gains file]\n", argv[0]);
+		return 1;
+	}
+
+	MadeUpTable made_up;
+	GainFile file;
+	if (path)
+	{
+		std::string error;
+		if (!file.Load(path, error))
+		{
+			fprintf(stderr, "%s\n", error.c_str());
+			return 1;
+		}
+	}
+	const auto& table = path ? file.Table() : made_up.Table();
+
+	volatile double sink = 0;
+	const auto baseline_ns = NanosecondsPerStep(steps, [&](const Conditions& conditions) { sink = sink + conditions.mach; });
+	GainScheduler scheduler(table);
+	const auto scheduler_ns = NanosecondsPerStep(steps, [&](const Conditions& conditions)
+	{
+		scheduler.Update(conditions.ias, conditions.mach, conditions.altitude, conditions.flaps);
+		sink = sink + scheduler.Gains(GAIN_PITCH_RATE).kp;
+	});
+	PIDGains searched[GAIN_CONTROLLER_COUNT];
+	const auto searched_ns = NanosecondsPerStep(steps, [&](const Conditions& conditions)
+	{
+		SearchedGains(table, conditions, searched);
+		sink = sink + searched[GAIN_PITCH_RATE].kp;
+	});
+
+	// Both must agree on every step
+	GainScheduler checked(table);
+	auto worst_difference = 0.0;
+	for (auto i = 0L; i < steps; i++)
+	{
+		const auto conditions = Flight(i);
+		checked.Update(conditions.ias, conditions.mach, conditions.altitude, conditions.flaps);
+		SearchedGains(table, conditions, searched);
+		for (auto controller = 0; controller < GAIN_CONTROLLER_COUNT; controller++)
+		{
+			const auto& gains = checked.Gains(static_cast<GAIN_CONTROLLER>(controller));
+			worst_difference = fmax(worst_difference, fabs(gains.kp - searched[controller].kp));
+			worst_difference = fmax(worst_difference, fabs(gains.ki - searched[controller].ki));
+			worst_difference = fmax(worst_difference, fabs(gains.kd - searched[controller].kd));
+		}
+	}
+
+	printf("%ld steps, table of %d x %d x %d x %d points, %d controllers\n", steps, table.sizes[GAIN_AXIS_IAS],
+		table.sizes[GAIN_AXIS_MACH], table.sizes[GAIN_AXIS_ALTITUDE], table.sizes[GAIN_AXIS_FLAPS], GAIN_CONTROLLER_COUNT);
+	printf("scheduler (cached cells)  %7.2f ns per step, %.4f breakpoints walked per step\n", scheduler_ns - baseline_ns,
+		static_cast<double>(checked.CellMoves()) / steps);
+	printf("searched every step       %7.2f ns per step\n", searched_ns - baseline_ns);
+	printf("largest difference between them: %g\n", worst_difference);
+	return worst_difference == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,320 @@
+// Tunes the PID gains of the pitch and roll laws (see gains.h) by flying randomized scenarios closed loop against the
+// host plant model, with CMA-ES (see host/cma_es.h) searching the gains and every candidate flown on every core.
+// Each gain is searched as a factor of the current one (see gain_tables.h), so a gain that is 0 stays 0. The cost of
+// a candidate is the weighted sum of, each relative to what the current gains score on the same scenarios:
+//   pitch tracking   mean square of the load factor the sidestick asks for minus the load factor flown
+//   roll tracking    mean square of the bank angle the roll law steers towards minus the bank angle flown
+//   g overshoot      largest load factor beyond the one asked for, in the direction asked
+//   bank overshoot   largest bank angle beyond the one steered towards
+//   elevator         mean square of the elevator rate
+//   envelope         time outside the envelope the protections hold, weighted by the relative excursion
+// The tuned gains are checked on a second set of scenarios, and written as a replacement for gain_tables.h.
+//
+// Usage: gain_tune [generations] [--scenarios n] [--seconds s] [--population n] [--seed n] [--threads n]
+//                  [--distribution file] [--per-flaps] [--header path] [--file path]
+//   generations   CMA-ES generations per tuning (default 40)
+//   scenarios     scenarios every candidate flies (default 48)
+//   seconds       flight time of each scenario after the controls are handed over (default 20)
+//   population    candidates per generation (default: CMA-ES's own, 4 + 3 ln(gains))
+//   seed          selects the scenarios, as in monte_carlo; the check flies those of seed + 1 (default 1)
+//   threads       worker threads (default: one per core)
+//   distribution  file overriding the ranges the scenarios are drawn from (see host/scenario.h)
+//   per-flaps     tune each flaps handle position on its own, into a table with a breakpoint per position
+//   header        where to write the gain header (default tuned_gain_tables.h)
+//   file          also write the gains as a gain file, for monte_carlo --gains (see host/gain_file.h)
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "closed_loop.h"
+#include "cma_es.h"
+#include "gain_file.h"
+#include "thread_pool.h"
+
+namespace
+{
+	enum COST_TERM
+	{
+		TERM_PITCH_TRACKING,
+		TERM_ROLL_TRACKING,
+		TERM_LOAD_FACTOR_OVERSHOOT,
+		TERM_BANK_OVERSHOOT,
+		TERM_ELEVATOR_ACTIVITY,
+		TERM_ENVELOPE,
+		TERM_COUNT
+	};
+
+	constexpr const char* term_names[TERM_COUNT] = { "pitch tracking", "roll tracking", "g overshoot", "bank overshoot", "elevator", "envelope" };
+	constexpr double term_weights[TERM_COUNT] = { 1, 1, 0.5, 0.5, 0.5, 2 };
+	constexpr double max_log_factor = 3; // Gains are searched within e^3 of the current ones either way
+
+	struct Terms
+	{
+		double values[TERM_COUNT] = {};
+		long scenarios = 0; // That reached flight mode
+
+		void Add(const Terms& other)
+		{
+			for (auto term = 0; term < TERM_COUNT; term++) values[term] += other.values[term];
+			scenarios += other.scenarios;
+		}
+		double Mean(const int term) const { return scenarios > 0 ? values[term] / scenarios : 0; }
+	};
+
+	// A gain table of a single point
+	struct Candidate
+	{
+		PIDGains gains[GAIN_CONTROLLER_COUNT];
+		GainTable table;
+
+		Candidate(const PIDGains* point)
+		{
+			static constexpr double zero[1] = { 0 };
+			for (auto controller = 0; controller < GAIN_CONTROLLER_COUNT; controller++) gains[controller] = point[controller];
+			table = { { zero, zero, zero, zero }, { 1, 1, 1, 1 }, gains };
+		}
+		Candidate(const Candidate& other) : Candidate(other.gains) {}
+		Candidate& operator=(const Candidate&) = delete;
+	};
+
+	Terms Fly(const Scenario& scenario, const double seconds, const GainTable& table)
+	{
+		constexpr double dt = 1 / 60.0;
+		Terms terms;
+		ClosedLoop loop;
+		loop.Fbw().Surfaces().Gains().SetTable(table);
+		if (!loop.Start(scenario, dt)) return terms;
+		terms.scenarios = 1;
+
+		auto& fbw = loop.Fbw();
+		auto& aircraft = fbw.Aircraft();
+		auto& protections = fbw.Protections();
+		auto last_elevator = fbw.Output().Written().elevator;
+		const auto frames = static_cast<long>(seconds / dt);
+		for (auto frame = 0L; frame < frames; frame++)
+		{
+			const auto since_start = frame * dt;
+			const auto excursion = loop.Step(scenario, since_start, dt);
+			double pitch_input, roll_input;
+			scenario.Sidestick(since_start, pitch_input, roll_input);
+
+			// The load factor demand of the flight mode law; the protections ask for something else
+			if (fbw.PitchMode().Mode() == FLIGHT_MODE && !protections.AoaDemandActive() && !protections.HighSpeedProtActive())
+			{
+				const auto normal_load_factor = aircraft.NormalLoadFactor();
+				const auto requested = pitch_input >= 0
+					? linear_range(pitch_input, normal_load_factor, protections.MaxLoadFactor())
+					: linear_range(-pitch_input, normal_load_factor, protections.MinLoadFactor());
+				const auto error = requested - aircraft.GForce();
+				terms.values[TERM_PITCH_TRACKING] += error * error * dt;
+				if (pitch_input != 0)
+				{
+					const auto overshoot = -error * sign(requested - normal_load_factor);
+					terms.values[TERM_LOAD_FACTOR_OVERSHOOT] = fmax(terms.values[TERM_LOAD_FACTOR_OVERSHOOT], overshoot);
+				}
+			}
+
+			const auto target_bank = fbw.Surfaces().Roll().TargetBank();
+			const auto bank_error = target_bank - aircraft.Roll();
+			terms.values[TERM_ROLL_TRACKING] += bank_error * bank_error * dt;
+			if (fabs(target_bank) > 1)
+			{
+				terms.values[TERM_BANK_OVERSHOOT] = fmax(terms.values[TERM_BANK_OVERSHOOT], -bank_error * sign(target_bank));
+			}
+
+			const auto elevator = fbw.Output().Written().elevator;
+			const auto elevator_rate = (elevator - last_elevator) / dt;
+			last_elevator = elevator;
+			terms.values[TERM_ELEVATOR_ACTIVITY] += elevator_rate * elevator_rate * dt;
+			terms.values[TERM_ENVELOPE] += excursion.Severity() * dt;
+		}
+		terms.values[TERM_PITCH_TRACKING] /= seconds;
+		terms.values[TERM_ROLL_TRACKING] /= seconds;
+		terms.values[TERM_ELEVATOR_ACTIVITY] /= seconds;
+		return terms;
+	}
+
+	// Flies every candidate through every scenario
+	std::vector<Terms> Evaluate(ThreadPool& pool, const std::vector<Candidate>& candidates, const std::vector<Scenario>& scenarios,
+		const double seconds)
+	{
+		std::vector<Terms> results(candidates.size() * scenarios.size());
+		pool.ParallelFor(results.size(), 1, [&](const size_t index)
+		{
+			results[index] = Fly(scenarios[index % scenarios.size()], seconds, candidates[index / scenarios.size()].table);
+		});
+		std::vector<Terms> totals(candidates.size());
+		for (size_t i = 0; i < results.size(); i++) totals[i / scenarios.size()].Add(results[i]);
+		return totals;
+	}
+
+	// Relative to the scale of each term, which is what the current gains score
+	double Cost(const Terms& terms, const Terms& scale)
+	{
+		auto cost = 0.0;
+		for (auto term = 0; term < TERM_COUNT; term++)
+		{
+			const auto reference = scale.Mean(term) > 0 ? scale.Mean(term) : 1;
+			cost += term_weights[term] * terms.Mean(term) / reference;
+		}
+		return cost;
+	}
+
+	void PrintTerms(const char* name, const Terms& initial, const Terms& tuned)
+	{
+		printf("  %s: cost %.3f -> %.3f\n", name, Cost(initial, initial), Cost(tuned, initial));
+		for (auto term = 0; term < TERM_COUNT; term++)
+		{
+			printf("    %-15s %10.4g -> %10.4g\n", term_names[term], initial.Mean(term), tuned.Mean(term));
+		}
+	}
+
+	struct Options
+	{
+		int generations = 40;
+		long scenarios = 48;
+		double seconds = 20;
+		size_t population = 0;
+		uint64_t seed = 1;
+	};
+
+	// Tunes the gains at point over scenarios drawn from distribution, and returns the best
+	Candidate Tune(ThreadPool& pool, const PIDGains* point, const ScenarioDistribution& distribution, const Options& options)
+	{
+		std::vector<Scenario> training, check;
+		for (auto i = 0L; i < options.scenarios; i++)
+		{
+			training.push_back(distribution.Draw(options.seed, i));
+			check.push_back(distribution.Draw(options.seed + 1, i));
+		}
+
+		// The search space: the logarithm of the factor of each gain that is not 0, with the gains of a point taken as
+		// an array of doubles as the scheduler does
+		const Candidate initial(point);
+		std::vector<int> searched;
+		for (auto i = 0; i < 3 * GAIN_CONTROLLER_COUNT; i++)
+		{
+			if ((&initial.gains[0].kp)[i] != 0) searched.push_back(i);
+		}
+		const auto candidate = [&](const std::vector<double>& x)
+		{
+			Candidate result(initial.gains);
+			for (size_t i = 0; i < searched.size(); i++)
+			{
+				(&result.gains[0].kp)[searched[i]] *= exp(clamp(x[i], -max_log_factor, max_log_factor));
+			}
+			return result;
+		};
+
+		const auto initial_terms = Evaluate(pool, { initial }, training, options.seconds)[0];
+		CmaEs optimizer(std::vector<double>(searched.size(), 0), 0.5, options.population, options.seed);
+		for (auto generation = 0; generation < options.generations; generation++)
+		{
+			const auto& xs = optimizer.Ask();
+			std::vector<Candidate> candidates;
+			for (const auto& x : xs) candidates.push_back(candidate(x));
+			const auto terms = Evaluate(pool, candidates, training, options.seconds);
+			std::vector<double> costs;
+			for (const auto& candidate_terms : terms) costs.push_back(Cost(candidate_terms, initial_terms));
+			optimizer.Tell(costs);
+			printf("  generation %3d: best %.4f, sigma %.3f\n", generation + 1, optimizer.BestCost(), optimizer.Sigma());
+			fflush(stdout);
+		}
+
+		const auto tuned = candidate(optimizer.Best());
+		const auto tuned_terms = Evaluate(pool, { tuned }, training, options.seconds)[0];
+		const auto checked = Evaluate(pool, { initial, tuned }, check, options.seconds);
+		PrintTerms("training scenarios", initial_terms, tuned_terms);
+		PrintTerms("check scenarios", checked[0], checked[1]);
+		return tuned;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	auto threads = 0;
+	auto per_flaps = false;
+	const char* header_path = "tuned_gain_tables.h";
+	const char* file_path = nullptr;
+	ScenarioDistribution distribution;
+
+	auto positional = 0;
+	for (auto i = 1; i < argc; i++)
+	{
+		const auto has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--distribution") == 0 && has_value)
+		{
+			std::string error;
+			if (!distribution.Load(argv[++i], error))
+			{
+				fprintf(stderr, "%s\n", error.c_str());
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], "--scenarios") == 0 && has_value) options.scenarios = atol(argv[++i]);
+		else if (strcmp(argv[i], "--seconds") == 0 && has_value) options.seconds = atof(argv[++i]);
+		else if (strcmp(argv[i], "--population") == 0 && has_value) options.population = strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--seed") == 0 && has_value) options.seed = strtoull(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--threads") == 0 && has_value) threads = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--header") == 0 && has_value) header_path = argv[++i];
+		else if (strcmp(argv[i], "--file") == 0 && has_value) file_path = argv[++i];
+		else if (strcmp(argv[i], "--per-flaps") == 0) per_flaps = true;
+		else if (positional == 0 && argv[i][0] != '-') { options.generations = atoi(argv[i]); positional++; }
+		else
+		{
+			fprintf(stderr, "usage: %s [generations] [--scenarios n] [--seconds s] [--population n] [--seed n] [--threads n] "
+				"[--distribution file] [--per-flaps] [--header path] [--file path]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (options.generations <= 0 || options.scenarios <= 0 || options.seconds <= 0 || threads < 0 || options.population == 1)
+	{
+		fprintf(stderr, "generations, scenarios and seconds must be positive, and the population more than 1\n");
+		return 1;
+	}
+
+	ThreadPool pool(threads);
+	const auto start = std::chrono::steady_clock::now();
+
+	// Start from the gains the gauge flies, where the scenarios fly
+	GainScheduler current(default_gain_table);
+	std::vector<double> flaps_breakpoints;
+	std::vector<PIDGains> points;
+	const auto tunings = per_flaps ? 5 : 1;
+	for (auto tuning = 0; tuning < tunings; tuning++)
+	{
+		auto tuning_distribution = distribution;
+		if (per_flaps)
+		{
+			tuning_distribution.flaps = { static_cast<double>(tuning), static_cast<double>(tuning) };
+			flaps_breakpoints.push_back(tuning);
+			printf("flaps %d\n", tuning);
+		}
+		else flaps_breakpoints.push_back(0);
+		current.Update((distribution.ias.min + distribution.ias.max) / 2, 0.45, (distribution.altitude.min + distribution.altitude.max) / 2, tuning);
+		PIDGains point[GAIN_CONTROLLER_COUNT];
+		for (auto controller = 0; controller < GAIN_CONTROLLER_COUNT; controller++) point[controller] = current.Gains(static_cast<GAIN_CONTROLLER>(controller));
+
+		const auto tuned = Tune(pool, point, tuning_distribution, options);
+		points.insert(points.end(), tuned.gains, tuned.gains + GAIN_CONTROLLER_COUNT);
+	}
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	printf("%.1f s wall on %zu threads\n", elapsed, pool.Size());
+
+	static constexpr double single[1] = { 0 };
+	const GainTable table = { { single, single, single, flaps_breakpoints.data() }, { 1, 1, 1, static_cast<int>(flaps_breakpoints.size()) }, points.data() };
+	const auto comment = std::string("The gains the gauge flies with, tuned by gain_tune over ") + std::to_string(options.scenarios) + " scenarios of "
+		+ std::to_string(static_cast<int>(options.seconds)) + " s (seed " + std::to_string(options.seed) + "), "
+		+ std::to_string(options.generations) + " generations" + (per_flaps ? ", for each flaps handle position." : ".");
+	std::string error;
+	if (!SaveGainHeader(header_path, table, comment, error) || (file_path && !SaveGainFile(file_path, table, error)))
+	{
+		fprintf(stderr, "%s\n", error.c_str());
+		return 1;
+	}
+	printf("wrote %s%s%s\n", header_path, file_path ? " and " : "", file_path ? file_path : "");
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+// Flies randomized scenarios closed loop against the host plant model, one after the other, and publishes every frame
+// as live telemetry (see host/live_telemetry.h) for live_tail or any other reader to plot. The flights are paced to the
+// wall clock unless --fast is given. Prints what capturing and publishing cost per frame at the end.
+//
+// Usage: live_publish [scenarios] [seconds] [--seed n] [--fps n] [--name object] [--fast] [--mpc]
+//   scenarios  number of scenarios to fly (default 10)
+//   seconds    flight time of each scenario after the controls are handed over (default 30)
+//   seed       selects the set of scenarios, as in monte_carlo (default 1)
+//   fps        frame rate (default 60)
+//   name       shared memory object to publish to (default /a32nx_fbw_live)
+//   fast       fly as fast as possible instead of in real time
+//   mpc        fly the model predictive pitch law (see mpc.h)
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "closed_loop.h"
+#include "live_telemetry.h"
+
+int main(int argc, char* argv[])
+{
+	auto scenarios = 10L;
+	auto seconds = 30.0;
+	auto seed = 1ull;
+	auto fps = 60.0;
+	const char* name = live_telemetry_name;
+	auto fast = false;
+	auto model_predictive = false;
+	auto positional = 0;
+	auto usage = false;
+	for (auto i = 1; i < argc; i++)
+	{
+		const auto has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--seed") == 0 && has_value) seed = strtoull(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--fps") == 0 && has_value) fps = atof(argv[++i]);
+		else if (strcmp(argv[i], "--name") == 0 && has_value) name = argv[++i];
+		else if (strcmp(argv[i], "--fast") == 0) fast = true;
+		else if (strcmp(argv[i], "--mpc") == 0) model_predictive = true;
+		else if (argv[i][0] == '-') usage = true;
+		else if (positional++ == 0) scenarios = atol(argv[i]);
+		else seconds = atof(argv[i]);
+	}
+	if (usage || scenarios <= 0 || seconds <= 0 || fps <= 0)
+	{
+		fprintf(stderr, "usage: %s [scenarios] [seconds] [--seed n] [--fps n] [--name object] [--fast] [--mpc]\n", argv[0]);
+		return 1;
+	}
+
+	LiveTelemetryPublisher publisher;
+	if (!publisher.Open(name))
+	{
+		fprintf(stderr, "cannot create the shared memory object %s\n", name);
+		return 1;
+	}
+	printf("publishing to %s\n", name);
+	fflush(stdout);
+
+	const auto dt = 1 / fps;
+	const ScenarioDistribution distribution;
+	std::vector<double> nanoseconds;
+	LiveFrame frame = {};
+	const auto start = std::chrono::steady_clock::now();
+	auto flown = 0.0; // Seconds of every scenario so far, which the wall clock is paced to
+	for (auto index = 0L; index < scenarios; index++)
+	{
+		const auto scenario = distribution.Draw(seed, index);
+		auto loop = std::make_unique<ClosedLoop>();
+		loop->Fbw().Surfaces().Pitch().SetModelPredictive(model_predictive);
+		loop->Fbw().Telemetry().SetEnabled(true);
+		if (!loop->Start(scenario, dt)) continue;
+		for (auto since_start = 0.0; since_start < seconds; since_start += dt)
+		{
+			loop->Step(scenario, since_start, dt);
+
+			const auto before = std::chrono::steady_clock::now();
+			CaptureLiveFrame(loop->Fbw(), loop->Surfaces(), flown + since_start, frame);
+			publisher.Publish(frame);
+			nanoseconds.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - before).count());
+
+			if (!fast) std::this_thread::sleep_until(start + std::chrono::duration<double>(flown + since_start + dt));
+		}
+		flown += seconds;
+	}
+	publisher.Close();
+
+	if (nanoseconds.empty()) return 0;
+	auto sum = 0.0;
+	for (const auto value : nanoseconds) sum += value;
+	const auto mean = sum / nanoseconds.size();
+	std::sort(nanoseconds.begin(), nanoseconds.end());
+	printf("published %zu frames; capturing and publishing a frame took mean %.0f ns, p50 %.0f ns, p99 %.0f ns, max %.0f ns\n",
+		nanoseconds.size(), mean, nanoseconds[nanoseconds.size() / 2], nanoseconds[nanoseconds.size() * 99 / 100], nanoseconds.back());
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,154 @@
+// Tails the live telemetry of a publisher (see host/live_telemetry.h, tools/live_publish.cpp), waiting for it to start,
+// until it closes or the tool is interrupted. Prints a line every few frames, and exports every frame read as CSV
+// and/or as a column file (see host/column_file.h), one column per field of LiveFrame. Reports the frames that were
+// overwritten before they could be read, which is all a slow reader costs.
+//
+// Usage: live_tail [--name object] [--oldest] [--every n] [--quiet] [--csv path] [--columns path]
+//   name     shared memory object to read (default /a32nx_fbw_live)
+//   oldest   start from the oldest frame still in the ring instead of the next one published
+//   every    print every nth frame (default 60)
+//   quiet    print nothing but the summary
+//   csv      write every frame to path as CSV, with a header line of the column names
+//   columns  write every frame to path as a column file
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include "column_file.h"
+#include "live_telemetry.h"
+
+namespace
+{
+	constexpr const char* law_names[PITCH_LAW_COUNT] = { "NORMAL", "ALTERNATE", "DIRECT" };
+	constexpr const char* path_names[PITCH_PATH_COUNT] = { "GROUND", "AOA_DEMAND", "FLARE", "MODEL_PREDICTIVE", "LOAD_FACTOR_DEMAND" };
+	constexpr const char* mode_names[3] = { "GROUND_MODE", "FLIGHT_MODE", "FLARE_MODE" };
+
+	std::atomic<bool> interrupted = { false };
+
+	const char* Name(const char* const* names, const int count, const int value) { return value < count ? names[value] : "?"; }
+	const char* Tag(const uint8_t id) { return id < TRACE_ID_COUNT ? pitch_trace_formats[id].tag : "?"; }
+
+	double Field(const LiveFrame& frame, const LiveColumn& column)
+	{
+		const auto* field = reinterpret_cast<const char*>(&frame) + column.offset;
+		if (column.byte) return *reinterpret_cast<const uint8_t*>(field);
+		double value;
+		memcpy(&value, field, sizeof(value));
+		return value;
+	}
+
+	void PrintFrame(const LiveFrame& frame)
+	{
+		printf("t=%.2f %s/%s/%s %s", frame.t, Name(law_names, PITCH_LAW_COUNT, frame.law), Name(path_names, PITCH_PATH_COUNT, frame.path),
+			Name(mode_names, 3, frame.mode), frame.demand != TRACE_NONE ? Tag(frame.demand) : "-");
+		for (auto i = 0; i < frame.protection_count && i < max_trace_protections; i++) printf("+%s", Tag(frame.protections[i]));
+		printf(" IAS=%.1f AOA=%.2f P=%.2f PR=%.2f R=%.2f LF=%.3f E=%.4f A=%.4f\n", frame.ias, frame.aoa, frame.pitch, frame.pitch_rate,
+			frame.roll, frame.gforce, frame.elevator, frame.ailerons);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const char* name = live_telemetry_name;
+	auto oldest = false;
+	auto every = 60L;
+	auto quiet = false;
+	const char* csv_path = nullptr;
+	const char* columns_path = nullptr;
+	auto usage = false;
+	for (auto i = 1; i < argc; i++)
+	{
+		const auto has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--name") == 0 && has_value) name = argv[++i];
+		else if (strcmp(argv[i], "--oldest") == 0) oldest = true;
+		else if (strcmp(argv[i], "--every") == 0 && has_value) every = atol(argv[++i]);
+		else if (strcmp(argv[i], "--quiet") == 0) quiet = true;
+		else if (strcmp(argv[i], "--csv") == 0 && has_value) csv_path = argv[++i];
+		else if (strcmp(argv[i], "--columns") == 0 && has_value) columns_path = argv[++i];
+		else usage = true;
+	}
+	if (usage || every <= 0)
+	{
+		fprintf(stderr, "usage: %s [--name object] [--oldest] [--every n] [--quiet] [--csv path] [--columns path]\n", argv[0]);
+		return 1;
+	}
+
+	constexpr auto column_count = sizeof(live_columns) / sizeof(live_columns[0]);
+	FILE* csv = nullptr;
+	if (csv_path)
+	{
+		csv = fopen(csv_path, "w");
+		if (!csv)
+		{
+			fprintf(stderr, "cannot create %s\n", csv_path);
+			return 1;
+		}
+		for (size_t column = 0; column < column_count; column++) fprintf(csv, "%s%s", column > 0 ? "," : "", live_columns[column].name);
+		fprintf(csv, "\n");
+	}
+	ColumnWriter columns;
+	if (columns_path)
+	{
+		ColumnDescriptor descriptors[column_count] = {};
+		for (size_t column = 0; column < column_count; column++)
+		{
+			strncpy(descriptors[column].name, live_columns[column].name, sizeof(descriptors[column].name) - 1);
+			descriptors[column].type = live_columns[column].byte ? COLUMN_U8 : COLUMN_F64;
+		}
+		if (!columns.Open(columns_path, descriptors, column_count))
+		{
+			fprintf(stderr, "cannot create %s\n", columns_path);
+			return 1;
+		}
+	}
+
+	signal(SIGINT, [](int) { interrupted = true; });
+	signal(SIGTERM, [](int) { interrupted = true; });
+
+	LiveTelemetryReader reader;
+	if (!quiet) fprintf(stderr, "waiting for %s\n", name);
+	while (!reader.Open(name, oldest))
+	{
+		if (interrupted) return 1;
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+
+	uint64_t frames = 0;
+	const auto consume = [&](const LiveFrame& frame)
+	{
+		if (!quiet && frames % every == 0) PrintFrame(frame);
+		if (csv)
+		{
+			for (size_t column = 0; column < column_count; column++)
+			{
+				fprintf(csv, live_columns[column].byte ? "%s%.0f" : "%s%.17g", column > 0 ? "," : "", Field(frame, live_columns[column]));
+			}
+			fprintf(csv, "\n");
+		}
+		if (columns_path)
+		{
+			for (uint32_t column = 0; column < column_count; column++)
+			{
+				const auto value = Field(frame, live_columns[column]);
+				if (live_columns[column].byte) columns.SetU8(column, static_cast<uint8_t>(value));
+				else columns.SetF64(column, value);
+			}
+			columns.EndRow();
+		}
+		frames++;
+	};
+	while (!interrupted && reader.Live())
+	{
+		if (reader.Poll(consume) == 0) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+
+	auto ok = true;
+	if (csv) ok &= fclose(csv) == 0;
+	if (columns_path) ok &= columns.Close();
+	fprintf(stderr, "read %llu frames, lost %llu\n", static_cast<unsigned long long>(frames), static_cast<unsigned long long>(reader.Lost()));
+	if (!ok) fprintf(stderr, "writing the export failed\n");
+	return ok ? 0 : 1;
+}
\ No newline at end of file
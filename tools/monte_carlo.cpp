@@ -0,0 +1,216 @@
+// Flies randomized scenarios closed loop against the host plant model on every core, and reports where the aircraft
+// went outside the envelope the normal law protections are meant to hold.
+//
+// Usage: monte_carlo [scenarios] [seconds] [--distribution file] [--seed n] [--threads n] [--fps n] [--tolerance x] [--mpc] [--actuators] [--complementary] [--swept-alpha] [--gains file]
+//   scenarios     number of scenarios to fly (default 10000)
+//   seconds       flight time of each scenario after the controls are handed over (default 30)
+//   distribution  file of "name min max" lines overriding the default ranges (see host/scenario.h), e.g.
+//                   ias 200 300
+//                   flaps 0 0
+//                   profiles step doublet
+//   seed          selects the set of scenarios; the same seed always flies the same scenarios (default 1)
+//   threads       worker threads (default: one per core)
+//   fps           frame rate the gauge runs at (default 60)
+//   tolerance     excursions up to this fraction of each limit are not counted as violations (default 0)
+//   mpc           fly the model predictive pitch law (see mpc.h) instead of the PID one
+//   actuators     move the surfaces through their actuators (see actuators.h) instead of straight to their command
+//   complementary estimate the rates by the complementary filter (see estimator.h) instead of finite differences
+//   swept-alpha   take alpha prot, alpha floor and alpha max from the swept envelope tables instead of the FCOM
+//                 (see flight_envelope.h)
+//   gains         file of the gain table to schedule the PID gains with (see host/gain_file.h), instead of gain_tables.h
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "closed_loop.h"
+#include "gain_file.h"
+#include "thread_pool.h"
+
+namespace
+{
+	struct ScenarioResult
+	{
+		bool started = false; // False if the FBW never reached flight mode
+		EnvelopeExcursion worst;
+		double first_violation = -1; // Seconds after the hand-over, or -1
+		uint64_t plans = 0; // Steps the model predictive law planned
+		uint64_t fallbacks = 0; // Of those, steps it could not solve, which flew the load factor demand law
+	};
+
+	ScenarioResult Fly(const Scenario& scenario, const double seconds, const double fps, const double tolerance, const bool model_predictive,
+		const bool actuators, const bool complementary, const bool swept_alpha, const GainTable& gains)
+	{
+		ScenarioResult result;
+		ClosedLoop loop;
+		loop.Fbw().Surfaces().Gains().SetTable(gains);
+		loop.Fbw().Surfaces().Pitch().SetModelPredictive(model_predictive);
+		loop.Fbw().Output().SetEnabled(actuators);
+		loop.Fbw().Aircraft().SetEstimatorMode(complementary ? ESTIMATOR_COMPLEMENTARY : ESTIMATOR_FINITE_DIFFERENCE);
+		loop.Fbw().Aircraft().SetSweptAlpha(swept_alpha);
+		const auto dt = 1 / fps;
+		result.started = loop.Start(scenario, dt);
+		if (!result.started) return result;
+
+		const auto frames = static_cast<long>(seconds * fps);
+		for (auto frame = 0L; frame < frames; frame++)
+		{
+			const auto since_start = frame * dt;
+			auto excursion = loop.Step(scenario, since_start, dt);
+			auto& protections = loop.Fbw().Protections();
+			// Ignore excursions within the tolerance
+			const auto beyond = [tolerance](double& value, const double limit) { if (value <= fabs(limit) * tolerance) value = 0; };
+			beyond(excursion.pitch_up, protections.MaxPitchAngle());
+			beyond(excursion.pitch_down, protections.MinPitchAngle());
+			beyond(excursion.bank, protections.MaxBankAngle());
+			beyond(excursion.load_factor_high, protections.MaxLoadFactor());
+			beyond(excursion.load_factor_low, fmax(fabs(protections.MinLoadFactor()), 1.0));
+			beyond(excursion.overspeed, loop.Fbw().Aircraft().Vmo());
+			beyond(excursion.overspeed_mach, loop.Fbw().Aircraft().Mmo());
+			if (excursion.Any() && result.first_violation < 0) result.first_violation = since_start;
+			result.worst.Merge(excursion);
+		}
+		result.plans = loop.Fbw().Surfaces().Pitch().ModelPredictivePlans();
+		result.fallbacks = loop.Fbw().Surfaces().Pitch().ModelPredictiveFallbacks();
+		return result;
+	}
+
+	void PrintScenario(const uint64_t index, const Scenario& scenario)
+	{
+		const auto& initial = scenario.initial;
+		printf("  #%llu: %.0f kts at %.0f ft, CONF %d, pitch %+.1f, bank %+.1f, Vmo %.0f, Mmo %.2f, %s (%+.2f, %+.2f) from %.1f s every %.1f s\n",
+			static_cast<unsigned long long>(index), initial.ias, initial.altitude, initial.flaps, initial.pitch, initial.bank,
+			initial.vmo, initial.mmo, sidestick_profile_names[scenario.profile], scenario.pitch_amplitude,
+			scenario.roll_amplitude, scenario.start, scenario.period);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	auto scenarios = 10000L;
+	auto seconds = 30.0;
+	auto seed = 1ull;
+	auto threads = 0;
+	auto fps = 60.0;
+	auto tolerance = 0.0;
+	auto model_predictive = false;
+	auto actuators = false;
+	auto complementary = false;
+	auto swept_alpha = false;
+	ScenarioDistribution distribution;
+	GainFile gains;
+
+	auto positional = 0;
+	for (auto i = 1; i < argc; i++)
+	{
+		const auto has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--distribution") == 0 && has_value)
+		{
+			std::string error;
+			if (!distribution.Load(argv[++i], error))
+			{
+				fprintf(stderr, "%s\n", error.c_str());
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], "--gains") == 0 && has_value)
+		{
+			std::string error;
+			if (!gains.Load(argv[++i], error))
+			{
+				fprintf(stderr, "%s\n", error.c_str());
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], "--seed") == 0 && has_value) seed = strtoull(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--threads") == 0 && has_value) threads = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--fps") == 0 && has_value) fps = atof(argv[++i]);
+		else if (strcmp(argv[i], "--tolerance") == 0 && has_value) tolerance = atof(argv[++i]);
+		else if (strcmp(argv[i], "--mpc") == 0) model_predictive = true;
+		else if (strcmp(argv[i], "--actuators") == 0) actuators = true;
+		else if (strcmp(argv[i], "--complementary") == 0) complementary = true;
+		else if (strcmp(argv[i], "--swept-alpha") == 0) swept_alpha = true;
+		else if (positional == 0 && argv[i][0] != '-') { scenarios = atol(argv[i]); positional++; }
+		else if (positional == 1 && argv[i][0] != '-') { seconds = atof(argv[i]); positional++; }
+		else
+		{
+			fprintf(stderr, "usage: %s [scenarios] [seconds] [--distribution file] [--seed n] [--threads n] [--fps n] [--tolerance x] [--mpc] [--actuators] [--complementary] [--swept-alpha] [--gains file]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (scenarios <= 0 || seconds <= 0 || fps <= 0 || threads < 0 || tolerance < 0)
+	{
+		fprintf(stderr, "scenarios, seconds and fps must be positive\n");
+		return 1;
+	}
+
+	std::vector<ScenarioResult> results(scenarios);
+	ThreadPool pool(threads);
+	const auto start = std::chrono::steady_clock::now();
+	pool.ParallelFor(scenarios, 16, [&](const size_t index)
+	{
+		results[index] = Fly(distribution.Draw(seed, index), seconds, fps, tolerance, model_predictive, actuators, complementary, swept_alpha, gains.Table());
+	});
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	// Tally the violations of each limit, and rank the scenarios by their largest relative excursion
+	EnvelopeExcursion worst;
+	long not_started = 0, violating = 0;
+	long pitch_up = 0, pitch_down = 0, bank = 0, load_factor_high = 0, load_factor_low = 0, overspeed = 0, overspeed_mach = 0;
+	uint64_t plans = 0, fallbacks = 0;
+	std::vector<std::pair<double, uint64_t>> ranking;
+	for (auto i = 0L; i < scenarios; i++)
+	{
+		const auto& result = results[i];
+		if (!result.started) { not_started++; continue; }
+		plans += result.plans;
+		fallbacks += result.fallbacks;
+		const auto& excursion = result.worst;
+		if (!excursion.Any()) continue;
+		violating++;
+		pitch_up += excursion.pitch_up > 0;
+		pitch_down += excursion.pitch_down > 0;
+		bank += excursion.bank > 0;
+		load_factor_high += excursion.load_factor_high > 0;
+		load_factor_low += excursion.load_factor_low > 0;
+		overspeed += excursion.overspeed > 0;
+		overspeed_mach += excursion.overspeed_mach > 0;
+		worst.Merge(excursion);
+		ranking.emplace_back(excursion.Severity(), i);
+	}
+
+	printf("%ld scenarios of %.0f s at %.0f fps on %zu threads (seed %llu)\n", scenarios, seconds, fps, pool.Size(), seed);
+	printf("%.3f s wall, %.0f scenario-seconds per wall-second, %zu steals\n", elapsed, scenarios * seconds / elapsed, pool.Steals());
+	if (not_started > 0) printf("%ld scenarios never reached flight mode\n", not_started);
+	printf("%ld scenarios left the envelope\n", violating);
+	printf("  pitch above MaxPitchAngle:    %6ld (worst %.2f deg)\n", pitch_up, worst.pitch_up);
+	printf("  pitch below MinPitchAngle:    %6ld (worst %.2f deg)\n", pitch_down, worst.pitch_down);
+	printf("  bank beyond MaxBankAngle:     %6ld (worst %.2f deg)\n", bank, worst.bank);
+	printf("  load factor above the limit:  %6ld (worst %.2f g)\n", load_factor_high, worst.load_factor_high);
+	printf("  load factor below the limit:  %6ld (worst %.2f g)\n", load_factor_low, worst.load_factor_low);
+	printf("  speed above Vmo:              %6ld (worst %.2f kts)\n", overspeed, worst.overspeed);
+	printf("  speed above Mmo:              %6ld (worst %.4f)\n", overspeed_mach, worst.overspeed_mach);
+	if (model_predictive)
+	{
+		printf("model predictive plans unsolved on %llu of %llu steps (%.2f%%), which flew the load factor demand law\n",
+			static_cast<unsigned long long>(fallbacks), static_cast<unsigned long long>(plans), plans > 0 ? 100.0 * fallbacks / plans : 0.0);
+	}
+
+	if (!ranking.empty())
+	{
+		std::sort(ranking.begin(), ranking.end(), std::greater<std::pair<double, uint64_t>>());
+		printf("worst scenarios:\n");
+		for (size_t i = 0; i < ranking.size() && i < 10; i++)
+		{
+			const auto index = ranking[i].second;
+			PrintScenario(index, distribution.Draw(seed, index));
+			const auto& excursion = results[index].worst;
+			printf("      first at %.2f s; pitch +%.2f/-%.2f deg, bank %.2f deg, load factor +%.2f/-%.2f g, overspeed %.2f kts/%.4f\n",
+				results[index].first_violation, excursion.pitch_up, excursion.pitch_down, excursion.bank, excursion.load_factor_high,
+				excursion.load_factor_low, excursion.overspeed, excursion.overspeed_mach);
+		}
+	}
+	return 0;
+}
\ No newline at end of file
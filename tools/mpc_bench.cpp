@@ -0,0 +1,156 @@
+// Measures how long the model predictive pitch law (see mpc.h) takes per control step, and the bound on it.
+// Randomized scenarios are flown closed loop with the law, recording what the controller was given at every step;
+// the recorded steps are then solved again and timed one by one. Every step is solved five times from the same state,
+// with the caches evicted before each solve as the simulator's own frame would between two control steps, and the
+// middle time is kept: a cold cache counts towards every solve, an interrupt during one or two of them does not.
+//   as flown   warm started and with the model cached, as in flight
+//   worst case with the model rebuilt and no warm start, which is the longest path through Update(); its maximum is
+//              the bound
+//
+// Usage: mpc_bench [scenarios] [seconds] [--seed n]
+//   scenarios  number of scenarios to fly (default 50)
+//   seconds    flight time of each scenario (default 30)
+//   seed       selects the set of scenarios, as in monte_carlo (default 1)
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "closed_loop.h"
+
+namespace
+{
+	struct RecordedStep
+	{
+		PitchPrediction prediction;
+		bool fresh; // The controller was reset before this step
+	};
+
+	struct Timings
+	{
+		std::vector<double> microseconds;
+		long iterations = 0;
+		int max_iterations = 0;
+		long unsolved = 0; // Steps the law flew with the load factor demand law instead
+		long recovering = 0; // Steps that could not keep every limit, and solved again to recover
+
+		double Percentile(const double fraction)
+		{
+			const auto rank = static_cast<size_t>(fraction * (microseconds.size() - 1));
+			std::nth_element(microseconds.begin(), microseconds.begin() + rank, microseconds.end());
+			return microseconds[rank];
+		}
+		double Max() { return *std::max_element(microseconds.begin(), microseconds.end()); }
+	};
+
+	constexpr int solves = 5; // Of every step, the middle one timed
+
+	// Written over before every solve, to evict the controller from the caches the way a frame of the simulator would
+	std::vector<char> eviction(4 << 20);
+
+	template <typename Prepare>
+	Timings Time(const std::vector<RecordedStep>& steps, ModelPredictivePitchController& controller, Prepare prepare)
+	{
+		Timings timings;
+		timings.microseconds.reserve(steps.size());
+		volatile double sink = 0;
+		for (const auto& step : steps)
+		{
+			prepare(step);
+			const auto before = controller;
+			double microseconds[solves];
+			for (auto solve = 0; solve < solves; solve++)
+			{
+				controller = before;
+				for (size_t i = 0; i < eviction.size(); i += 64) eviction[i]++;
+				const auto start = std::chrono::steady_clock::now();
+				sink = sink + controller.Update(step.prediction);
+				microseconds[solve] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+			}
+			std::sort(microseconds, microseconds + solves);
+			timings.microseconds.push_back(microseconds[solves / 2]);
+			timings.iterations += controller.Iterations();
+			timings.max_iterations = std::max(timings.max_iterations, controller.Iterations());
+			if (!controller.Solved()) timings.unsolved++;
+			if (controller.Recovering()) timings.recovering++;
+		}
+		return timings;
+	}
+
+	void Print(const char* name, Timings& timings, const size_t steps)
+	{
+		printf("%-11s p50 %6.2f us, p99 %6.2f us, p99.9 %6.2f us, max %6.2f us, %.1f iterations per step, at most %d\n", name,
+			timings.Percentile(0.5), timings.Percentile(0.99), timings.Percentile(0.999), timings.Max(), double(timings.iterations) / steps,
+			timings.max_iterations);
+		printf("            recovering on %.2f%% of the steps, unsolved on %.2f%%\n", 100.0 * timings.recovering / steps, 100.0 * timings.unsolved / steps);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	auto scenarios = 50L;
+	auto seconds = 30.0;
+	auto seed = 1ull;
+	auto positional = 0;
+	for (auto i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoull(argv[++i], nullptr, 10);
+		else if (positional == 0 && argv[i][0] != '-') { scenarios = atol(argv[i]); positional++; }
+		else if (positional == 1 && argv[i][0] != '-') { seconds = atof(argv[i]); positional++; }
+		else
+		{
+			fprintf(stderr, "usage: %s [scenarios] [seconds] [--seed n]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (scenarios <= 0 || seconds <= 0)
+	{
+		fprintf(stderr, "scenarios and seconds must be positive\n");
+		return 1;
+	}
+
+	// Fly the scenarios, recording every step the model predictive controller ran, solved or not
+	constexpr auto dt = 1 / 60.0;
+	ScenarioDistribution distribution;
+	std::vector<RecordedStep> steps;
+	for (auto index = 0L; index < scenarios; index++)
+	{
+		const auto scenario = distribution.Draw(seed, index);
+		ClosedLoop loop;
+		auto& pitch = loop.Fbw().Surfaces().Pitch();
+		pitch.SetModelPredictive(true);
+		if (!loop.Start(scenario, dt)) continue;
+		auto engaged = false;
+		auto fallbacks = pitch.ModelPredictiveFallbacks();
+		const auto frames = static_cast<long>(seconds / dt);
+		for (auto frame = 0L; frame < frames; frame++)
+		{
+			loop.Step(scenario, frame * dt, dt);
+			if (pitch.ModelPredictiveEngaged() || pitch.ModelPredictiveFallbacks() != fallbacks) steps.push_back({ pitch.LastPrediction(), !engaged });
+			engaged = pitch.ModelPredictiveEngaged();
+			fallbacks = pitch.ModelPredictiveFallbacks();
+		}
+	}
+	if (steps.empty())
+	{
+		fprintf(stderr, "the model predictive controller never ran\n");
+		return 1;
+	}
+
+	ModelPredictivePitchController controller;
+	auto flown = Time(steps, controller, [&](const RecordedStep& step) { if (step.fresh) controller.Reset(); });
+	const auto setups = controller.Setups();
+
+	ModelPredictivePitchController worst_case_controller;
+	auto worst_case = Time(steps, worst_case_controller, [&](const RecordedStep&) { worst_case_controller.Reset(); });
+
+	printf("%zu steps of %ld scenarios, %d variables, %d constraints, at most %d iterations and %d more to recover\n", steps.size(),
+		scenarios, ModelPredictivePitchController::variables, ModelPredictivePitchController::constraints, controller.IterationLimit(),
+		controller.RecoveryIterationLimit());
+	Print("as flown", flown, steps.size());
+	printf("            model rebuilt on %.2f%% of the steps\n", 100.0 * setups / steps.size());
+	Print("worst case", worst_case, steps.size());
+	printf("bound: %.2f us per control step\n", worst_case.Max());
+	return 0;
+}
\ No newline at end of file
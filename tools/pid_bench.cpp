@@ -0,0 +1,175 @@
+// Compares updating many PID controllers as separate objects, as the control laws hold them, with updating them
+// together in a PIDBank, a lane at a time and a vector at a time, in double and float. Every way must produce the
+// same outputs bit for bit. Then times scoring candidate errors with the batched Evaluate.
+//
+// Usage: pid_bench [controllers] [steps]
+//   controllers  number of controllers, at most 4096 (default 4096)
+//   steps        number of updates of all of them to time (default 2000)
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "../pid_bank.h"
+
+namespace
+{
+	constexpr size_t capacity = 4096;
+
+	// The gains of the pitch law's controllers; every fifth controller is a plain one like the roll law's
+	struct Gains
+	{
+		double min, max, p, i, d;
+		bool anti_windup;
+	};
+
+	Gains ControllerGains(const size_t index)
+	{
+		static const Gains gains[5] = {
+			{ -2, 2, 0.002, 0, 0.0002, true },
+			{ -2, 2, 0.008, 0.008, 0.001, true },
+			{ -2, 2, 0.0015, 0.0020, 0.002, true },
+			{ -2, 2, 0.01, 0.015, 0.0025, true },
+			{ -1, 1, 0.10, 0, 0.02, false },
+		};
+		return gains[index % 5];
+	}
+
+	// Errors large enough to saturate some controllers, and changing sign, repeating every error_period steps
+	constexpr int error_period = 16;
+
+	template <typename T>
+	std::vector<T> Errors(const size_t controllers)
+	{
+		std::vector<T> errors(error_period * controllers);
+		for (auto step = 0; step < error_period; step++)
+		{
+			for (size_t i = 0; i < controllers; i++)
+			{
+				errors[step * controllers + i] = static_cast<T>(((i * 37 + step * 11) % 400 - 200) * 0.75);
+			}
+		}
+		return errors;
+	}
+
+	template <typename Step>
+	double NanosecondsPerUpdate(const size_t controllers, const int steps, Step step)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		for (auto i = 0; i < steps; i++) step(i);
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (double(steps) * controllers);
+	}
+
+	template <typename T>
+	bool Run(const char* type, const size_t controllers, const int steps)
+	{
+		const T dt = static_cast<T>(1 / 60.0);
+
+		std::vector<BasicPIDController<T>> objects;
+		auto bank = std::make_unique<PIDBank<T, capacity>>();
+		auto scalar_bank = std::make_unique<PIDBank<T, capacity>>();
+		for (size_t i = 0; i < controllers; i++)
+		{
+			const auto gains = ControllerGains(i);
+			if (gains.anti_windup) objects.push_back(BasicAntiWindupPIDController<T>(T(gains.min), T(gains.max), T(gains.p), T(gains.i), T(gains.d)));
+			else objects.push_back(BasicPIDController<T>(T(gains.min), T(gains.max), T(gains.p), T(gains.i), T(gains.d)));
+			bank->Add(T(gains.min), T(gains.max), T(gains.p), T(gains.i), T(gains.d), gains.anti_windup);
+			scalar_bank->Add(T(gains.min), T(gains.max), T(gains.p), T(gains.i), T(gains.d), gains.anti_windup);
+		}
+		std::vector<T> outputs(controllers);
+		const auto errors = Errors<T>(controllers);
+
+		const auto objects_ns = NanosecondsPerUpdate(controllers, steps, [&](const int step)
+		{
+			const auto* error = &errors[step % error_period * controllers];
+			for (size_t i = 0; i < controllers; i++) outputs[i] = objects[i].Update(error[i], dt);
+		});
+		const auto scalar_ns = NanosecondsPerUpdate(controllers, steps, [&](const int step)
+		{
+			const auto* error = &errors[step % error_period * controllers];
+			for (size_t i = 0; i < controllers; i++) scalar_bank->Error(i) = error[i];
+			scalar_bank->UpdateScalar(dt);
+		});
+		const auto vector_ns = NanosecondsPerUpdate(controllers, steps, [&](const int step)
+		{
+			const auto* error = &errors[step % error_period * controllers];
+			for (size_t i = 0; i < controllers; i++) bank->Error(i) = error[i];
+			bank->Update(dt);
+		});
+
+		for (size_t i = 0; i < controllers; i++)
+		{
+			const auto scalar = scalar_bank->Output(i);
+			const auto vector = bank->Output(i);
+			if (memcmp(&outputs[i], &scalar, sizeof(T)) != 0 || memcmp(&outputs[i], &vector, sizeof(T)) != 0)
+			{
+				fprintf(stderr, "%s controller %zu: object %.9g, bank %.9g, vector bank %.9g\n", type, i,
+					double(outputs[i]), double(scalar), double(vector));
+				return false;
+			}
+		}
+
+		printf("%-6s objects %6.2f ns, bank scalar %6.2f ns, bank %s %6.2f ns per update (%.1fx the objects)\n",
+			type, objects_ns, scalar_ns, PIDBank<T, capacity>::VectorName(), vector_ns, objects_ns / vector_ns);
+		return true;
+	}
+
+	// Scores candidate errors for one controller from its current state: by copying the controller and updating the
+	// copy, and with the batched Evaluate
+	bool WhatIf(const int steps)
+	{
+		constexpr size_t candidates = 64;
+		const auto gains = ControllerGains(1);
+		AntiWindupPIDController controller(gains.min, gains.max, gains.p, gains.i, gains.d);
+		for (auto step = 0; step < 100; step++) controller.Update(((step * 11) % 400 - 200) * 0.01, 1 / 60.0);
+
+		double errors[candidates];
+		for (size_t i = 0; i < candidates; i++) errors[i] = (i - candidates / 2.0) * 0.25;
+		double copied[candidates];
+		double evaluated[candidates];
+
+		const auto copy_ns = NanosecondsPerUpdate(candidates, steps * 100, [&](const int)
+		{
+			for (size_t i = 0; i < candidates; i++)
+			{
+				auto copy = controller;
+				copied[i] = copy.Update(errors[i], 1 / 60.0);
+			}
+		});
+		const auto evaluate_ns = NanosecondsPerUpdate(candidates, steps * 100, [&](const int)
+		{
+			controller.Evaluate(controller.State(), errors, candidates, 1 / 60.0, evaluated);
+		});
+		if (memcmp(copied, evaluated, sizeof(copied)) != 0)
+		{
+			fprintf(stderr, "Evaluate differs from updating a copy\n");
+			return false;
+		}
+
+		printf("what-if over %zu candidates: copy and update %.2f ns, Evaluate %.2f ns per candidate\n", candidates, copy_ns, evaluate_ns);
+		return true;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const auto controllers = argc > 1 ? static_cast<size_t>(atol(argv[1])) : capacity;
+	const auto steps = argc > 2 ? atoi(argv[2]) : 2000;
+	if (controllers == 0 || controllers > capacity || steps <= 0)
+	{
+		fprintf(stderr, "usage: %s [controllers] [steps]\n", argv[0]);
+		return 1;
+	}
+#if defined(__AVX__)
+	if (!__builtin_cpu_supports("avx"))
+	{
+		fprintf(stderr, "this build needs a CPU with AVX\n");
+		return 1;
+	}
+#endif
+
+	printf("%zu controllers, %d updates\n", controllers, steps);
+	if (!Run<double>("double", controllers, steps) || !Run<float>("float", controllers, steps) || !WhatIf(steps)) return 1;
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,234 @@
+// Measures how long PitchController::Calculate takes per control step, for each path of the law it takes (see
+// pitch_law.h). Randomized scenarios are flown closed loop against the plant model, recording what the FBW was given
+// at every step; the recorded steps are then replayed through fresh FBW instances a few times, timing every call of
+// Calculate and keeping the fastest of each step over the replays, less what reading the clock costs.
+// The elevator positions of every replay are hashed and must be those of the flight. The hash and the timings only
+// need the public interface of PitchController, so that the same benchmark built against an older pitch.h shows
+// whether a change of the law costs time or changes what it does.
+//
+// Usage: pitch_bench [scenarios] [seconds] [--seed n] [--replays n] [--mpc]
+//   scenarios  number of scenarios to fly (default 200)
+//   seconds    flight time of each scenario (default 30)
+//   seed       selects the set of scenarios, as in monte_carlo (default 1)
+//   replays    times every step is replayed (default 5)
+//   mpc        fly the model predictive pitch law (see mpc.h)
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "closed_loop.h"
+
+namespace
+{
+	constexpr double dt = 1 / 60.0;
+
+	struct RecordedStep
+	{
+		AircraftDataSample sample;
+		double t;
+		double yoke_x;
+		double yoke_y;
+	};
+
+	struct RecordedFlight
+	{
+		std::vector<RecordedStep> steps;
+		double elevator = 0; // The last elevator position of the flight
+	};
+
+	// The paths of the law, told apart from the state Calculate chooses between them with
+	enum PATH
+	{
+		GROUND,
+		AOA_DEMAND,
+		FLARE,
+		MODEL_PREDICTIVE,
+		LOAD_FACTOR_DEMAND,
+		PATH_COUNT
+	};
+	constexpr const char* path_names[PATH_COUNT] = { "ground", "AoA demand", "flare", "model predictive", "load factor demand" };
+
+	PATH Path(FbwInstance& fbw)
+	{
+		if (fbw.PitchMode().Mode() == GROUND_MODE) return GROUND;
+		if (fbw.Protections().AoaDemandActive()) return AOA_DEMAND;
+		if (fbw.PitchMode().FlareEffect() > 0) return FLARE;
+		return fbw.Surfaces().Pitch().ModelPredictive() ? MODEL_PREDICTIVE : LOAD_FACTOR_DEMAND;
+	}
+
+	// Everything a control step runs before the pitch law, with the sidestick of step
+	void Prepare(FbwInstance& fbw, const RecordedStep& step)
+	{
+		fbw.Input().SetYokeX(step.yoke_x);
+		fbw.Input().SetYokeY(step.yoke_y);
+		fbw.Input().Update(step.t);
+		fbw.Aircraft().Update(step.sample, step.t, dt);
+		fbw.PitchMode().Update(step.t, dt);
+		fbw.Protections().Update(step.t, dt);
+	}
+
+	// Flies scenario closed loop with the sidestick neutral until the FBW is in flight mode, then for seconds
+	RecordedFlight Record(const Scenario& scenario, const double seconds, const bool model_predictive)
+	{
+		RecordedFlight flight;
+		auto fbw = std::make_unique<FbwInstance>();
+		fbw->Surfaces().Pitch().SetModelPredictive(model_predictive);
+		PlantModel plant;
+		plant.Reset(scenario.initial);
+		CONTROL_SURFACES_DATA surfaces = {};
+		auto t = 0.0;
+		auto flying = false;
+		for (auto since_start = 0.0; since_start < seconds; t += dt)
+		{
+			RecordedStep step = { plant.Sample(), t, 0, 0 };
+			if (flying) scenario.Sidestick(since_start, step.yoke_y, step.yoke_x);
+			Prepare(*fbw, step);
+			surfaces.ailerons = fbw->Surfaces().Roll().Calculate(surfaces.ailerons, t, dt);
+			surfaces.elevator = fbw->Surfaces().Pitch().Calculate(surfaces.elevator, t, dt);
+			flight.steps.push_back(step);
+
+			// The plant is held at its initial conditions until then, as in ClosedLoop::Start
+			if (flying)
+			{
+				plant.Step(surfaces, dt);
+				since_start += dt;
+			}
+			else if (fbw->PitchMode().Mode() == FLIGHT_MODE) flying = true;
+			else if (t > ClosedLoop::max_warm_up) break;
+		}
+		flight.elevator = surfaces.elevator;
+		return flight;
+	}
+
+	struct PathTimings
+	{
+		std::vector<double> nanoseconds;
+
+		double Mean() const
+		{
+			auto sum = 0.0;
+			for (const auto value : nanoseconds) sum += value;
+			return sum / nanoseconds.size();
+		}
+		double Percentile(const double fraction)
+		{
+			const auto rank = static_cast<size_t>(fraction * (nanoseconds.size() - 1));
+			std::nth_element(nanoseconds.begin(), nanoseconds.begin() + rank, nanoseconds.end());
+			return nanoseconds[rank];
+		}
+	};
+
+	// The least time between two consecutive readings of the clock
+	double ClockOverhead()
+	{
+		auto fastest = 1e9;
+		for (auto i = 0; i < 100000; i++)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			fastest = std::min(fastest, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+		}
+		return fastest;
+	}
+
+	uint64_t HashElevator(uint64_t hash, const double elevator)
+	{
+		uint64_t bits;
+		memcpy(&bits, &elevator, sizeof(bits));
+		for (auto byte = 0; byte < 8; byte++) hash = (hash ^ ((bits >> (8 * byte)) & 0xff)) * 0x100000001b3ull;
+		return hash;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	auto scenarios = 200L;
+	auto seconds = 30.0;
+	auto seed = 1ull;
+	auto replays = 5;
+	auto model_predictive = false;
+	auto positional = 0;
+	auto usage = false;
+	for (auto i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoull(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--replays") == 0 && i + 1 < argc) replays = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--mpc") == 0) model_predictive = true;
+		else if (argv[i][0] == '-') usage = true;
+		else if (positional++ == 0) scenarios = atol(argv[i]);
+		else seconds = atof(argv[i]);
+	}
+	if (usage || scenarios <= 0 || seconds <= 0 || replays <= 0)
+	{
+		fprintf(stderr, "usage: %s [scenarios] [seconds] [--seed n] [--replays n] [--mpc]\n", argv[0]);
+		return 1;
+	}
+
+	ScenarioDistribution distribution;
+	std::vector<RecordedFlight> flights;
+	size_t step_count = 0;
+	for (auto index = 0L; index < scenarios; index++)
+	{
+		flights.push_back(Record(distribution.Draw(seed, index), seconds, model_predictive));
+		step_count += flights.back().steps.size();
+	}
+
+	// The fastest time of every step over the replays, and the path it took
+	std::vector<double> fastest(step_count, 1e9);
+	std::vector<uint8_t> paths(step_count);
+	uint64_t hash = 0;
+	for (auto replay = 0; replay < replays; replay++)
+	{
+		size_t index = 0;
+		hash = 0xcbf29ce484222325ull;
+		for (const auto& flight : flights)
+		{
+			auto fbw = std::make_unique<FbwInstance>();
+			auto& pitch = fbw->Surfaces().Pitch();
+			pitch.SetModelPredictive(model_predictive);
+			auto elevator = 0.0;
+			for (const auto& step : flight.steps)
+			{
+				Prepare(*fbw, step);
+				paths[index] = Path(*fbw);
+				const auto start = std::chrono::steady_clock::now();
+				elevator = pitch.Calculate(elevator, step.t, dt);
+				fastest[index] = std::min(fastest[index], std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+				hash = HashElevator(hash, elevator);
+				index++;
+			}
+			if (elevator != flight.elevator)
+			{
+				fprintf(stderr, "a replay did not fly the elevator of its flight\n");
+				return 1;
+			}
+		}
+	}
+
+	const auto overhead = ClockOverhead();
+	PathTimings timings[PATH_COUNT];
+	PathTimings all;
+	for (size_t index = 0; index < step_count; index++)
+	{
+		const auto nanoseconds = std::max(fastest[index] - overhead, 0.0);
+		timings[paths[index]].nanoseconds.push_back(nanoseconds);
+		all.nanoseconds.push_back(nanoseconds);
+	}
+
+	printf("%zu control steps of %ld scenarios, fastest of %d replays, less %.1f ns of reading the clock\n", step_count, scenarios,
+		replays, overhead);
+	for (auto path = 0; path < PATH_COUNT; path++)
+	{
+		auto& path_timings = timings[path];
+		if (path_timings.nanoseconds.empty()) continue;
+		printf("  %-19s %8zu steps: mean %6.1f ns, p50 %6.1f ns, p99 %6.1f ns\n", path_names[path], path_timings.nanoseconds.size(),
+			path_timings.Mean(), path_timings.Percentile(0.5), path_timings.Percentile(0.99));
+	}
+	printf("  %-19s %8zu steps: mean %6.1f ns, p50 %6.1f ns, p99 %6.1f ns\n", "all", all.nanoseconds.size(), all.Mean(),
+		all.Percentile(0.5), all.Percentile(0.99));
+	printf("elevator %016llx\n", static_cast<unsigned long long>(hash));
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,151 @@
+// Checks that the host plant model holds its trim and stays within the envelope flown closed loop by an FbwInstance
+// with light sidestick inputs, and measures how much faster than real time it runs on one core, on its own and closed
+// loop. Exits non-zero if any closed loop run leaves the envelope.
+//
+// Usage: plant_bench [seconds] [fps]
+//   seconds  simulated time of each timed run (default 600)
+//   fps      frame rate (default 60)
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+
+#include "closed_loop.h"
+
+namespace
+{
+	double Seconds(const std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	void PrintExcursion(const EnvelopeExcursion& excursion)
+	{
+		printf("pitch %+.1f/%+.1f deg, bank %+.1f deg, load factor %+.2f/%+.2f g, %+.1f kts, %+.3f Mach",
+			excursion.pitch_up, excursion.pitch_down, excursion.bank, excursion.load_factor_high, excursion.load_factor_low,
+			excursion.overspeed, excursion.overspeed_mach);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const auto seconds = argc > 1 ? atof(argv[1]) : 600.0;
+	const auto fps = argc > 2 ? atof(argv[2]) : 60.0;
+	if (seconds <= 0 || fps <= 0)
+	{
+		fprintf(stderr, "usage: %s [seconds] [fps]\n", argv[0]);
+		return 1;
+	}
+	const auto dt = 1 / fps;
+	const auto frames = static_cast<long>(seconds * fps);
+
+	// Trim: with the surfaces neutral the plant should hold its initial conditions for a while
+	printf("trim over 60 s with the surfaces neutral:\n");
+	for (const auto flaps : { 0, 2, 4 })
+	{
+		for (const auto ias : { 150.0, 250.0, 320.0 })
+		{
+			PlantInitialConditions initial;
+			initial.ias = ias;
+			initial.altitude = flaps == 0 ? 20000 : 5000;
+			initial.flaps = flaps;
+			PlantModel plant;
+			plant.Reset(initial);
+			const auto start = plant.Sample();
+			for (auto frame = 0L; frame < static_cast<long>(60 * fps); frame++) plant.Step(CONTROL_SURFACES_DATA(), dt);
+			const auto end = plant.Sample();
+			printf("  CONF %d %3.0f kts: alpha %5.2f deg, %+7.2f kts, %+6.2f deg pitch, %+7.1f ft, %.3f g\n", flaps, ias,
+				start.aoa, end.ias - start.ias, start.pitch - end.pitch, end.radio_height - start.radio_height, end.gforce);
+		}
+	}
+
+	// Light inputs: from each trim, doublets and sines of a third of the sidestick travel on both axes should keep the
+	// aircraft within the envelope. Held inputs are left out, as they can fly it to a limit whatever the plant.
+	auto light_runs = 0, light_left = 0;
+	for (const auto flaps : { 0, 2, 4 })
+	{
+		for (const auto ias : { 150.0, 250.0, 320.0 })
+		{
+			for (const auto profile : { PROFILE_DOUBLET, PROFILE_SINE })
+			{
+				for (const auto amplitude : { -0.3, 0.3 })
+				{
+					for (const auto period : { 4.0, 10.0 })
+					{
+						Scenario scenario;
+						scenario.initial.ias = ias;
+						scenario.initial.altitude = flaps == 0 ? 20000 : 5000;
+						scenario.initial.flaps = flaps;
+						scenario.profile = profile;
+						scenario.pitch_amplitude = amplitude;
+						scenario.roll_amplitude = amplitude;
+						scenario.period = period;
+						auto loop = std::make_unique<ClosedLoop>();
+						EnvelopeExcursion worst;
+						if (loop->Start(scenario, dt))
+						{
+							for (auto frame = 0L; frame < static_cast<long>(30 * fps); frame++) worst.Merge(loop->Step(scenario, frame * dt, dt));
+						}
+						else worst.pitch_up = INFINITY;
+						light_runs++;
+						if (!worst.Any()) continue;
+						light_left++;
+						printf("  CONF %d %3.0f kts, %s (%+.1f) every %.0f s left the envelope: ", flaps, ias,
+							sidestick_profile_names[profile], amplitude, period);
+						PrintExcursion(worst);
+						printf("\n");
+					}
+				}
+			}
+		}
+	}
+	printf("light inputs: %d of %d runs of 30 s left the envelope\n", light_left, light_runs);
+
+	// Speed of the plant alone, with the surfaces moving
+	{
+		PlantModel plant;
+		plant.Reset(PlantInitialConditions());
+		CONTROL_SURFACES_DATA surfaces;
+		auto checksum = 0.0;
+		const auto start = std::chrono::steady_clock::now();
+		for (auto frame = 0L; frame < frames; frame++)
+		{
+			surfaces.elevator = 0.05 * sin(frame * dt);
+			surfaces.ailerons = 0.05 * sin(frame * dt * 0.3);
+			plant.Step(surfaces, dt);
+			checksum += plant.Sample().pitch;
+		}
+		const auto elapsed = Seconds(start);
+		printf("plant alone: %.0f s simulated in %.3f s, %.0fx real time (checksum %g)\n", seconds, elapsed, seconds / elapsed, checksum);
+	}
+
+	// Speed closed loop, with the sidestick slowly rolling the aircraft one way and back. It does not oscillate in
+	// pitch: the law gives the sidestick less load factor nose up than nose down, so a pitch sine left alone for
+	// minutes dives into Vmo however the plant flies.
+	auto reference_left = false;
+	{
+		Scenario scenario;
+		scenario.profile = PROFILE_SINE;
+		scenario.roll_amplitude = 0.3;
+		scenario.period = 20;
+		ClosedLoop loop;
+		if (!loop.Start(scenario, dt))
+		{
+			fprintf(stderr, "the FBW never reached flight mode\n");
+			return 1;
+		}
+		EnvelopeExcursion worst;
+		const auto start = std::chrono::steady_clock::now();
+		for (auto frame = 0L; frame < frames; frame++) worst.Merge(loop.Step(scenario, frame * dt, dt));
+		const auto elapsed = Seconds(start);
+		printf("closed loop: %.0f s simulated in %.3f s, %.0fx real time (", seconds, elapsed, seconds / elapsed);
+		if (worst.Any())
+		{
+			printf("left the envelope: ");
+			PrintExcursion(worst);
+		}
+		else printf("within the envelope");
+		printf(")\n");
+		reference_left = worst.Any();
+	}
+	return light_left > 0 || reference_left ? 1 : 0;
+}
\ No newline at end of file
@@ -0,0 +1,449 @@
+// Checks invariants of the normal law protections (see protections.h, pitch.h and roll.h) over millions of randomized
+// short flights on every core. Each case is a random aircraft state, sidestick input and control step length for a few
+// consecutive steps, flown by a fresh FBW system from flight mode; the invariants are checked after every step.
+// The first case that breaks one is shrunk to the simplest case found that breaks it too, and printed step by step.
+// Exits with 1 if any invariant is broken.
+//
+// Usage: protection_check [cases] [--seed n] [--threads n] [--mpc]
+//   cases    number of cases to check (default 1000000)
+//   seed     selects the set of cases; the same seed always checks the same cases (default 1)
+//   threads  worker threads (default: one per core)
+//   mpc      fly the model predictive pitch law (see mpc.h) instead of the PID one
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include "../fbw_instance.h"
+#include "property_check.h"
+
+namespace
+{
+	constexpr int max_steps = 6;
+	constexpr double tolerance = 1e-9; // On the elevator movement, as ControlSurfaces::Output() rounds as it blends
+
+	// One control step: the state the aircraft is in at its end, in the FBW's sign conventions, and the sidestick
+	struct ProtectionStep
+	{
+		double dt; // Seconds
+		double yoke_x; // -1 to +1, + is right
+		double yoke_y; // -1 to +1, + is back
+		double pitch_rate; // Degrees/second over the step, which moves the pitch attitude (+ is up)
+		double roll; // Degrees (+ is right)
+		double aoa; // Degrees
+		double gforce;
+		double ias; // Knots
+		double mach;
+		double vfpa; // Degrees
+		double radio_height; // Feet
+	};
+
+	struct ProtectionCase
+	{
+		int flaps;
+		double pitch; // Degrees at the start of the first step (+ is up)
+		double bank_demand; // Degrees the sidestick asked for before the first step (+ is right)
+		double altitude; // Feet
+		double vmo; // Knots
+		double mmo; // Mach
+		double weight; // Kilograms
+		int steps;
+		ProtectionStep step[max_steps];
+	};
+
+	// The fields of a step, with the value each one shrinks towards and the units it is printed in
+	struct StepField
+	{
+		const char* name;
+		double ProtectionStep::* field;
+		double simplest;
+	};
+	constexpr StepField step_fields[] = {
+		{ "dt", &ProtectionStep::dt, 1 / 60.0 },
+		{ "yoke_x", &ProtectionStep::yoke_x, 0 },
+		{ "yoke_y", &ProtectionStep::yoke_y, 0 },
+		{ "pitch_rate", &ProtectionStep::pitch_rate, 0 },
+		{ "roll", &ProtectionStep::roll, 0 },
+		{ "aoa", &ProtectionStep::aoa, 2 },
+		{ "gforce", &ProtectionStep::gforce, 1 },
+		{ "ias", &ProtectionStep::ias, 250 },
+		{ "mach", &ProtectionStep::mach, 0.5 },
+		{ "vfpa", &ProtectionStep::vfpa, 0 },
+		{ "radio_height", &ProtectionStep::radio_height, 3000 },
+	};
+
+	enum INVARIANT
+	{
+		SURFACES_IN_TRAVEL,
+		BANK_DEMAND_WITHIN_MAX_BANK,
+		BANK_LIMITS_FOLLOW_PROTECTIONS,
+		LIMITS_FOLLOW_FLAPS,
+		ALPHA_MAX_ENGAGES_AOA_DEMAND,
+		NO_NOSE_UP_ABOVE_MAX_PITCH,
+		NO_NOSE_DOWN_BELOW_MIN_PITCH,
+		NO_NOSE_UP_ABOVE_MAX_LOAD_FACTOR,
+		NO_NOSE_DOWN_BELOW_MIN_LOAD_FACTOR,
+		NO_NOSE_DOWN_BEYOND_VMO_AUTHORITY,
+		INVARIANT_COUNT
+	};
+	constexpr const char* invariant_names[INVARIANT_COUNT] = {
+		"the surfaces stay finite and within their travel",
+		"the bank demand stays within MaxBankAngle",
+		"the bank limits follow the protections that are active",
+		"the load factor and pitch limits follow the flaps, the maximum pitch reduced from V alpha prot to V alpha max",
+		"alpha max engages AoA demand unless the sidestick is pushed",
+		"the elevator never moves nose up while the pitch attitude is above its maximum and rising",
+		"the elevator never moves nose down while the pitch attitude is below its minimum and falling",
+		"the elevator never moves nose up while the load factor is above its maximum, within the pitch limits",
+		"the elevator never moves nose down while the load factor is below its minimum, within the pitch limits",
+		"the elevator never moves nose down past Vmo + 8 kts or Mmo + 0.012 while the nose is not rising, within the other limits",
+	};
+	std::atomic<uint64_t> exercised[INVARIANT_COUNT] = {}; // Cases each invariant applied to, in at least one step
+
+	double Uniform(std::mt19937_64& random, const double min, const double max)
+	{
+		return min + (max - min) * std::uniform_real_distribution<double>(0, 1)(random);
+	}
+	bool Chance(std::mt19937_64& random, const double probability)
+	{
+		return std::uniform_real_distribution<double>(0, 1)(random) < probability;
+	}
+	// Mostly uniform over [min, max], but often close to a limit on either side, where the protections switch
+	double NearLimits(std::mt19937_64& random, const double min, const double max, const double low_limit, const double high_limit, const double spread)
+	{
+		if (Chance(random, 0.2)) return low_limit + Uniform(random, -spread, spread);
+		if (Chance(random, 0.25)) return high_limit + Uniform(random, -spread, spread);
+		return Uniform(random, min, max);
+	}
+
+	void Generate(std::mt19937_64& random, ProtectionCase& c)
+	{
+		static constexpr double max_pitch[5] = { 30, 30, 30, 30, 25 };
+		static constexpr double max_load_factor[5] = { 2.5, 2, 2, 2, 2 };
+		static constexpr double min_load_factor[5] = { -1, 0, 0, 0, 0 };
+
+		c.flaps = std::uniform_int_distribution<int>(0, 4)(random);
+		c.pitch = NearLimits(random, -30, 40, -15, max_pitch[c.flaps], 2);
+		c.bank_demand = Chance(random, 0.3) ? 0 : NearLimits(random, -67, 67, -45, 45, 22);
+		c.altitude = Uniform(random, 0, 40000);
+		c.vmo = Chance(random, 0.5) ? 350 : Uniform(random, 150, 350);
+		c.mmo = Chance(random, 0.5) ? 0.82 : Uniform(random, 0.5, 0.82);
+		c.weight = Uniform(random, 40000, 80000);
+		c.steps = std::uniform_int_distribution<int>(1, max_steps)(random);
+		for (auto i = 0; i < c.steps; i++)
+		{
+			auto& step = c.step[i];
+			step.dt = Chance(random, 0.5) ? 1 / 60.0 : Uniform(random, 0.002, 0.1);
+			step.yoke_x = Chance(random, 0.4) ? 0 : Uniform(random, -1, 1);
+			step.yoke_y = Chance(random, 0.4) ? 0 : Uniform(random, -1, 1);
+			step.pitch_rate = Chance(random, 0.2) ? 0 : Uniform(random, -15, 15);
+			step.roll = NearLimits(random, -90, 90, -45, 45, 25);
+			step.mach = NearLimits(random, 0.2, 0.95, c.mmo - 0.1, c.mmo + 0.024, 0.02);
+			const auto envelope = WithFcomAlpha(LookUpEnvelope(default_envelope_table, c.flaps, c.weight, step.mach), c.flaps);
+			step.aoa = NearLimits(random, -5, 25, envelope.alpha_prot, envelope.alpha_max, 1);
+			step.gforce = NearLimits(random, -2, 4, min_load_factor[c.flaps], max_load_factor[c.flaps], 0.3);
+			step.ias = Chance(random, 0.2) ? Uniform(random, envelope.v_alpha_max - 10, envelope.v_alpha_prot + 10)
+				: NearLimits(random, 100, 420, c.vmo, c.vmo + 16, 10);
+			step.vfpa = Uniform(random, -20, 20);
+			step.radio_height = Chance(random, 0.1) ? Uniform(random, 0, 100) : Uniform(random, 100, 5000);
+		}
+	}
+
+	// The sample the simulator would report at the end of a step
+	AircraftDataSample Sample(const ProtectionCase& c, const ProtectionStep& step, const double pitch)
+	{
+		AircraftDataSample sample;
+		const auto speed = step.ias * 1.68781; // Feet/second, ignoring the altitude
+		sample.altitude = c.altitude;
+		sample.aoa = step.aoa;
+		sample.flaps = c.flaps;
+		sample.gforce = step.gforce;
+		sample.ias = step.ias;
+		sample.longitudinal_speed = speed * cos(radians(step.vfpa));
+		sample.vertical_speed = speed * sin(radians(step.vfpa));
+		sample.mach = step.mach;
+		sample.mmo = c.mmo;
+		sample.on_ground = FALSE;
+		sample.pitch = -pitch;
+		sample.pitch_velocity = -step.pitch_rate;
+		sample.radio_height = step.radio_height;
+		sample.roll = -step.roll;
+		sample.vmo = c.vmo;
+		sample.weight = c.weight * 2.20462;
+		return sample;
+	}
+
+	// What happened in a step, for the invariants and the report
+	struct StepOutcome
+	{
+		double elevator_before;
+		CONTROL_SURFACES_DATA surfaces;
+	};
+
+	// Flies the case from flight mode, calling visit(step, fbw, outcome) after every step until it returns false
+	template <typename Visit>
+	void Fly(const ProtectionCase& c, const bool model_predictive, Visit visit)
+	{
+		FbwInstance fbw;
+		auto& aircraft = fbw.Aircraft();
+		auto& surfaces = fbw.Surfaces();
+		// The rates then come from the attitudes of consecutive steps exactly
+		aircraft.SetEstimatorMode(ESTIMATOR_FINITE_DIFFERENCE);
+		surfaces.Pitch().SetModelPredictive(model_predictive);
+
+		// Blend into flight mode at once, over one long update high above the ground
+		auto pitch = c.pitch;
+		auto warm_up = Sample(c, c.step[0], pitch);
+		warm_up.radio_height = 1000;
+		aircraft.Update(warm_up, 0, 5);
+		fbw.PitchMode().Update(0, 5);
+		// Then hold the sidestick fully over for as long as it takes the bank demand to get there
+		if (c.bank_demand != 0)
+		{
+			fbw.Input().SetYokeX(c.bank_demand > 0 ? 1 : -1);
+			surfaces.Roll().Calculate(0, 0, fabs(c.bank_demand) / 15);
+		}
+
+		auto t = 0.0;
+		for (auto i = 0; i < c.steps; i++)
+		{
+			const auto& step = c.step[i];
+			t += step.dt;
+			pitch += step.pitch_rate * step.dt;
+			fbw.Input().SetYokeX(step.yoke_x);
+			fbw.Input().SetYokeY(step.yoke_y);
+			fbw.Input().Update(t);
+			aircraft.Update(Sample(c, step, pitch), t, step.dt);
+			fbw.PitchMode().Update(t, step.dt);
+			fbw.Protections().Update(t, step.dt);
+			StepOutcome outcome;
+			outcome.elevator_before = surfaces.Output(1).elevator;
+			surfaces.Update(t, step.dt);
+			outcome.surfaces = surfaces.Output(1);
+			if (!visit(i, fbw, outcome)) return;
+		}
+	}
+
+	// The first invariant the step breaks, or INVARIANT_COUNT; the invariants that applied are added to applied
+	INVARIANT Broken(FbwInstance& fbw, const ProtectionStep& step, const bool model_predictive, const StepOutcome& outcome, uint32_t& applied)
+	{
+		auto& aircraft = fbw.Aircraft();
+		auto& protections = fbw.Protections();
+		auto& mode = fbw.PitchMode();
+		const auto& surfaces = outcome.surfaces;
+		const auto delta_elevator = surfaces.elevator - outcome.elevator_before;
+		const auto pitch = aircraft.Pitch();
+		const auto pitch_rate = aircraft.PitchRate();
+		const auto gforce = aircraft.GForce();
+		const auto within_pitch = pitch >= protections.MinPitchAngle() && pitch <= protections.MaxPitchAngle();
+		const auto within_load_factor = gforce >= protections.MinLoadFactor() && gforce <= protections.MaxLoadFactor();
+		const auto apply = [&applied](const INVARIANT invariant) { applied |= 1u << invariant; };
+
+		apply(SURFACES_IN_TRAVEL);
+		for (const auto value : { surfaces.elevator, surfaces.ailerons, surfaces.rudder })
+		{
+			if (!std::isfinite(value) || fabs(value) > 1) return SURFACES_IN_TRAVEL;
+		}
+
+		if (mode.Mode() != GROUND_MODE)
+		{
+			apply(BANK_DEMAND_WITHIN_MAX_BANK);
+			if (fabs(fbw.Surfaces().Roll().TargetBank()) > protections.MaxBankAngle()) return BANK_DEMAND_WITHIN_MAX_BANK;
+		}
+
+		apply(BANK_LIMITS_FOLLOW_PROTECTIONS);
+		const auto protected_bank = protections.AoaDemandActive() || protections.HighSpeedProtActive();
+		if (protections.MaxBankAngle() != (protected_bank ? 45 : 67) || protections.NominalBankAngle() != (protected_bank ? 0 : 33))
+		{
+			return BANK_LIMITS_FOLLOW_PROTECTIONS;
+		}
+
+		apply(LIMITS_FOLLOW_FLAPS);
+		const auto clean = aircraft.Flaps() == 0;
+		const auto max_pitch = aircraft.Flaps() == 4 ? 25 : 30;
+		const auto reduced_max_pitch = aircraft.IAS() <= aircraft.VAlphaMax() ? max_pitch - 5
+			: aircraft.IAS() >= aircraft.VAlphaProt() ? max_pitch : protections.MaxPitchAngle();
+		if (protections.MinLoadFactor() != (clean ? -1 : 0) || protections.MaxLoadFactor() != (clean ? 2.5 : 2)
+			|| protections.MaxPitchAngle() != reduced_max_pitch || protections.MaxPitchAngle() < max_pitch - 5
+			|| protections.MaxPitchAngle() > max_pitch || protections.MinPitchAngle() != -15)
+		{
+			return LIMITS_FOLLOW_FLAPS;
+		}
+
+		if (aircraft.Alpha() >= aircraft.AlphaMax() && fbw.Input().YokeY() > -0.5)
+		{
+			apply(ALPHA_MAX_ENGAGES_AOA_DEMAND);
+			if (!protections.AoaDemandActive()) return ALPHA_MAX_ENGAGES_AOA_DEMAND;
+		}
+
+		// The laws that apply the pitch attitude and load factor protections: AoA demand, and the PID flight law
+		const auto aoa_demand = protections.AoaDemandActive();
+		const auto pid_flight_law = !aoa_demand && mode.FlareEffect() == 0 && !model_predictive;
+		if (mode.Mode() == GROUND_MODE || !(aoa_demand || pid_flight_law)) return INVARIANT_COUNT;
+
+		if (pitch > protections.MaxPitchAngle() && pitch_rate >= 0)
+		{
+			apply(NO_NOSE_UP_ABOVE_MAX_PITCH);
+			if (delta_elevator > tolerance) return NO_NOSE_UP_ABOVE_MAX_PITCH;
+		}
+		if (pitch < protections.MinPitchAngle() && pitch_rate <= 0)
+		{
+			apply(NO_NOSE_DOWN_BELOW_MIN_PITCH);
+			if (delta_elevator < -tolerance) return NO_NOSE_DOWN_BELOW_MIN_PITCH;
+		}
+		if (within_pitch && gforce > protections.MaxLoadFactor())
+		{
+			apply(NO_NOSE_UP_ABOVE_MAX_LOAD_FACTOR);
+			if (delta_elevator > tolerance) return NO_NOSE_UP_ABOVE_MAX_LOAD_FACTOR;
+		}
+		if (within_pitch && gforce < protections.MinLoadFactor())
+		{
+			apply(NO_NOSE_DOWN_BELOW_MIN_LOAD_FACTOR);
+			if (delta_elevator < -tolerance) return NO_NOSE_DOWN_BELOW_MIN_LOAD_FACTOR;
+		}
+		const auto beyond_authority = aircraft.IAS() > aircraft.Vmo() + 8 || aircraft.Mach() > aircraft.Mmo() + 0.012;
+		if (pid_flight_law && within_pitch && within_load_factor && beyond_authority && pitch_rate <= 0)
+		{
+			apply(NO_NOSE_DOWN_BEYOND_VMO_AUTHORITY);
+			if (delta_elevator < -tolerance) return NO_NOSE_DOWN_BEYOND_VMO_AUTHORITY;
+		}
+		return INVARIANT_COUNT;
+	}
+
+	const char* Check(const ProtectionCase& c, const bool model_predictive)
+	{
+		auto broken = INVARIANT_COUNT;
+		uint32_t applied = 0;
+		Fly(c, model_predictive, [&](const int i, FbwInstance& fbw, const StepOutcome& outcome)
+		{
+			broken = Broken(fbw, c.step[i], model_predictive, outcome, applied);
+			return broken == INVARIANT_COUNT;
+		});
+		for (auto invariant = 0; invariant < INVARIANT_COUNT; invariant++)
+		{
+			if (applied & (1u << invariant)) exercised[invariant].fetch_add(1, std::memory_order_relaxed);
+		}
+		return broken == INVARIANT_COUNT ? nullptr : invariant_names[broken];
+	}
+
+	// Offers fewer steps first, then each value moved to its simplest, halfway there, and rounded
+	template <typename Offer>
+	void Shrink(const ProtectionCase& c, const Offer& offer)
+	{
+		for (auto steps = 1; steps < c.steps; steps++)
+		{
+			auto variant = c;
+			variant.steps = steps;
+			if (offer(variant)) return;
+		}
+		for (auto removed = 0; removed < c.steps && c.steps > 1; removed++)
+		{
+			auto variant = c;
+			for (auto i = removed; i + 1 < c.steps; i++) variant.step[i] = c.step[i + 1];
+			variant.steps--;
+			if (offer(variant)) return;
+		}
+
+		const auto simpler = [&offer](const ProtectionCase& from, double& value, const double simplest)
+		{
+			const auto original = value;
+			if (original == simplest) return false;
+			const double candidates[3] = { simplest, (original + simplest) / 2, round(original * 10) / 10 };
+			for (const auto candidate : candidates)
+			{
+				if (candidate == original) continue;
+				value = candidate;
+				if (offer(from)) return true;
+			}
+			value = original;
+			return false;
+		};
+		auto variant = c;
+		if (simpler(variant, variant.pitch, 0) || simpler(variant, variant.bank_demand, 0) || simpler(variant, variant.altitude, 10000) || simpler(variant, variant.vmo, 350)
+			|| simpler(variant, variant.mmo, 0.82))
+		{
+			return;
+		}
+		for (auto i = 0; i < c.steps; i++)
+		{
+			for (const auto& field : step_fields)
+			{
+				if (simpler(variant, variant.step[i].*field.field, field.simplest)) return;
+			}
+		}
+		if (variant.flaps != 0)
+		{
+			variant.flaps = 0;
+			offer(variant);
+		}
+	}
+
+	void PrintCase(const ProtectionCase& c, const bool model_predictive)
+	{
+		printf("  flaps %d, pitch %g, bank demand %g, altitude %g, Vmo %g, Mmo %g, weight %g\n", c.flaps, c.pitch, c.bank_demand, c.altitude, c.vmo,
+			c.mmo, c.weight);
+		Fly(c, model_predictive, [&c](const int i, FbwInstance& fbw, const StepOutcome& outcome)
+		{
+			printf("  step %d:", i + 1);
+			for (const auto& field : step_fields) printf(" %s %g", field.name, c.step[i].*field.field);
+			auto& aircraft = fbw.Aircraft();
+			auto& protections = fbw.Protections();
+			printf("\n    -> pitch %g, pitch rate %g, load factor %g, alpha max %g, elevator %+g (%+g), ailerons %+g, bank demand %g,"
+				" limits pitch %g/%g load factor %g/%g bank %g/%g%s%s%s\n",
+				aircraft.Pitch(), aircraft.PitchRate(), aircraft.GForce(), aircraft.AlphaMax(), outcome.surfaces.elevator,
+				outcome.surfaces.elevator - outcome.elevator_before, outcome.surfaces.ailerons, fbw.Surfaces().Roll().TargetBank(),
+				protections.MinPitchAngle(), protections.MaxPitchAngle(), protections.MinLoadFactor(), protections.MaxLoadFactor(),
+				protections.NominalBankAngle(), protections.MaxBankAngle(), protections.AoaDemandActive() ? ", AoA demand" : "",
+				protections.HighSpeedProtActive() ? ", high speed protection" : "", fbw.PitchMode().FlareEffect() > 0 ? ", flare" : "");
+			return true;
+		});
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	auto cases = 1000000ull;
+	auto seed = 1ull;
+	auto threads = 0;
+	auto model_predictive = false;
+	for (auto i = 1; i < argc; i++)
+	{
+		const auto has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--seed") == 0 && has_value) seed = strtoull(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--threads") == 0 && has_value) threads = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--mpc") == 0) model_predictive = true;
+		else if (argv[i][0] != '-') cases = strtoull(argv[i], nullptr, 10);
+		else cases = 0;
+	}
+	if (cases == 0 || threads < 0)
+	{
+		fprintf(stderr, "usage: %s [cases] [--seed n] [--threads n] [--mpc]\n", argv[0]);
+		return 1;
+	}
+
+	ThreadPool pool(threads);
+	Counterexample<ProtectionCase> counterexample;
+	const auto check = [model_predictive](const ProtectionCase& c) { return Check(c, model_predictive); };
+	const auto start = std::chrono::steady_clock::now();
+	const auto shrink = [](const ProtectionCase& c, const auto& offer) { Shrink(c, offer); };
+	const auto held = CheckProperty(pool, cases, seed, Generate, check, shrink, counterexample);
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	if (held)
+	{
+		printf("%llu cases held in %.2f s on %zu threads (%.0f cases/s)\n", static_cast<unsigned long long>(cases), elapsed,
+			pool.Size(), cases / elapsed);
+	}
+	else printf("stopped after %.2f s on %zu threads\n", elapsed, pool.Size());
+	for (auto invariant = 0; invariant < INVARIANT_COUNT; invariant++)
+	{
+		printf("  %10llu cases: %s\n", static_cast<unsigned long long>(exercised[invariant].load()), invariant_names[invariant]);
+	}
+	if (held) return 0;
+
+	printf("case #%llu breaks: %s\n", static_cast<unsigned long long>(counterexample.index), counterexample.violation);
+	PrintCase(counterexample.original, model_predictive);
+	printf("shrunk in %d steps to:\n", counterexample.shrink_steps);
+	PrintCase(counterexample.shrunk, model_predictive);
+	return 1;
+}
\ No newline at end of file
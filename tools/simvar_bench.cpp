@@ -0,0 +1,83 @@
+// Compares the cost of acquiring one frame of aircraft data through the legacy per-SimVar string lookups
+// against the SimData acquisition layer, using the host stand-in for aircraft_varget.
+#include <chrono>
+#include <vector>
+
+#include "../sim_data.h"
+#include "sim_host.h"
+
+namespace
+{
+	constexpr int frames = 1000000;
+
+	double LegacyFetchSimVar(const char * name, const char * units, const int index, const double fallback)
+	{
+		const auto value = aircraft_varget(get_aircraft_var_enum(name), get_units_enum(units), index);
+		return isnan(value) ? fallback : value;
+	}
+
+	// The acquisition as AircraftData::Update used to do it
+	void LegacyFetch(AircraftDataSample& sample)
+	{
+		sample.aoa = LegacyFetchSimVar("INCIDENCE ALPHA", "Degrees", 0, 0);
+		sample.autopilot = LegacyFetchSimVar("AUTOPILOT MASTER", "Bool", 0, FALSE);
+		sample.flaps = LegacyFetchSimVar("FLAPS HANDLE INDEX", "Number", 0, 0);
+		sample.gforce = LegacyFetchSimVar("G FORCE", "GForce", 0, 0);
+		sample.ias = LegacyFetchSimVar("AIRSPEED INDICATED", "Knots", 0, 0);
+		sample.lateral_speed = LegacyFetchSimVar("VELOCITY WORLD Z", "Feet per second", 0, 0);
+		sample.longitudinal_speed = LegacyFetchSimVar("VELOCITY WORLD X", "Feet per second", 0, 0);
+		sample.mach = LegacyFetchSimVar("AIRSPEED MACH", "Mach", 0, 0);
+		sample.mmo = LegacyFetchSimVar("BARBER POLE MACH", "Mach", 0, DBL_MAX);
+		sample.on_ground = LegacyFetchSimVar("SIM ON GROUND", "Bool", 0, FALSE);
+		sample.pitch = LegacyFetchSimVar("PLANE PITCH DEGREES", "Degrees", 0, 0);
+		sample.radio_height = LegacyFetchSimVar("RADIO HEIGHT", "Feet", 0, 0);
+		sample.roll = LegacyFetchSimVar("PLANE BANK DEGREES", "Degrees", 0, 0);
+		sample.vertical_speed = LegacyFetchSimVar("VELOCITY WORLD Y", "Feet per second", 0, 0);
+		sample.vmo = LegacyFetchSimVar("AIRSPEED BARBER POLE", "Knots", 0, DBL_MAX);
+	}
+
+	template <typename Fetch>
+	void Run(const char * name, Fetch fetch)
+	{
+		auto checksum = 0.0;
+		const auto start = std::chrono::steady_clock::now();
+		for (auto i = 0; i < frames; i++)
+		{
+			checksum += fetch().ias;
+		}
+		const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+		printf("%-28s %8.1f ns/frame (checksum %g)\n", name, elapsed / frames, checksum);
+	}
+}
+
+int main()
+{
+	for (size_t i = 0; i < aircraft_simvar_count; i++)
+	{
+		SimHostSetVar(aircraft_simvars[i].name, static_cast<double>(i + 1));
+	}
+
+	// Build the packet the simulator sends for AIRCRAFT_DATA_DEFINITION every sim frame
+	const auto header_size = sizeof(SIMCONNECT_RECV_SIMOBJECT_DATA) - sizeof(DWORD); // The payload starts at dwData
+	std::vector<char> packet(header_size + aircraft_simvar_count * sizeof(double));
+	auto* data = reinterpret_cast<SIMCONNECT_RECV_SIMOBJECT_DATA*>(packet.data());
+	data->dwSize = static_cast<DWORD>(packet.size());
+	data->dwID = SIMCONNECT_RECV_ID_SIMOBJECT_DATA;
+	data->dwRequestID = AIRCRAFT_DATA_REQUEST;
+	data->dwDefineID = AIRCRAFT_DATA_DEFINITION;
+	for (size_t i = 0; i < aircraft_simvar_count; i++)
+	{
+		const auto value = static_cast<double>(i + 1);
+		memcpy(packet.data() + header_size + i * sizeof(double), &value, sizeof(value));
+	}
+
+	SimData sim_data;
+	sim_data.Init(nullptr);
+	printf("Acquiring %zu SimVars per frame over %d frames\n", aircraft_simvar_count, frames);
+
+	AircraftDataSample legacy_sample;
+	Run("legacy string lookups", [&]() -> const AircraftDataSample& { LegacyFetch(legacy_sample); return legacy_sample; });
+	Run("resolved enums", [&]() -> const AircraftDataSample& { sim_data.FetchSample(); return sim_data.Sample(); });
+	Run("data definition packet", [&]() -> const AircraftDataSample& { sim_data.OnSimObjectData(data, data->dwSize); return sim_data.Sample(); });
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+// Converts a text pitch trace (see host/text_trace.h), as printed by trace_decode or captured from the console of the
+// gauge, into a column file of its frames (see host/trace_columns.h) and the index of its branches next to it, for
+// trace_query. The trace is mapped and scanned in one pass; lines that are not frames are skipped and counted.
+//
+// Usage: trace_convert <text trace> <column file>
+//   writes the frames to <column file> and the branch index to <column file>.branches
+#include <chrono>
+#include <string>
+
+#include "mapped_file.h"
+#include "text_trace.h"
+#include "trace_columns.h"
+
+int main(int argc, char* argv[])
+{
+	if (argc != 3)
+	{
+		fprintf(stderr, "usage: %s <text trace> <column file>\n", argv[0]);
+		return 1;
+	}
+	const auto start = std::chrono::steady_clock::now();
+	MappedFile trace;
+	if (!trace.Open(argv[1]))
+	{
+		fprintf(stderr, "cannot read %s\n", argv[1]);
+		return 1;
+	}
+
+	ColumnDescriptor descriptors[TRACE_COLUMN_COUNT];
+	TraceColumnDescriptors(descriptors);
+	ColumnWriter frames;
+	TraceRunWriter branches;
+	const auto branches_path = std::string(argv[2]) + ".branches";
+	if (!frames.Open(argv[2], descriptors, TRACE_COLUMN_COUNT) || !branches.Open(branches_path.c_str()))
+	{
+		fprintf(stderr, "cannot create %s\n", argv[2]);
+		return 1;
+	}
+
+	TextTraceParser parser;
+	parser.Parse(trace.Data(), trace.Size(), [&](const PitchTraceRecord& record)
+	{
+		WriteTraceRecord(frames, record);
+		branches.Add(record);
+	});
+	if (!frames.Close() || !branches.Close())
+	{
+		fprintf(stderr, "writing %s failed\n", argv[2]);
+		return 1;
+	}
+
+	const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	printf("%llu lines, %llu frames, %llu skipped; %.1f MB in %.2f s, %.0f MB/s\n",
+		static_cast<unsigned long long>(parser.Lines()), static_cast<unsigned long long>(parser.Records()),
+		static_cast<unsigned long long>(parser.Skipped()), trace.Size() / 1e6, seconds, trace.Size() / 1e6 / seconds);
+	return 0;
+}
\ No newline at end of file
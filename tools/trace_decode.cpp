@@ -0,0 +1,76 @@
+// Turns a binary pitch trace (written by PitchTraceWriter while A32NX_FBW_TRACE is set) back into the text form
+// the gauge used to print on the console, one line per frame.
+//
+// Usage: trace_decode <trace file> [--time]
+//   --time  prefix every line with the simulation time
+#include <cstring>
+
+#include "text_trace.h"
+
+int main(int argc, char* argv[])
+{
+	const char * path = nullptr;
+	auto time = false;
+	for (auto i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--time") == 0) time = true;
+		else path = argv[i];
+	}
+	if (!path)
+	{
+		fprintf(stderr, "usage: %s <trace file> [--time]\n", argv[0]);
+		return 1;
+	}
+
+	auto* file = fopen(path, "rb");
+	if (!file)
+	{
+		fprintf(stderr, "could not open %s\n", path);
+		return 1;
+	}
+
+	// The file is a sequence of sessions, each a header followed by blocks of records. A trailing partial block (from a
+	// gauge that did not shut down cleanly) is ignored.
+	auto sessions = 0;
+	auto records = 0L;
+	char magic[4];
+	while (fread(magic, sizeof(magic), 1, file) == 1)
+	{
+		if (memcmp(magic, "FBWT", sizeof(magic)) == 0)
+		{
+			PitchTraceHeader header;
+			memcpy(header.magic, magic, sizeof(magic));
+			if (fread(reinterpret_cast<char*>(&header) + sizeof(magic), sizeof(header) - sizeof(magic), 1, file) != 1) break;
+			if (header.version != pitch_trace_version || header.record_size != sizeof(PitchTraceRecord))
+			{
+				fprintf(stderr, "unsupported trace version %u (record size %u)\n", header.version, header.record_size);
+				fclose(file);
+				return 1;
+			}
+			sessions++;
+			continue;
+		}
+		if (memcmp(magic, "FBWB", sizeof(magic)) != 0 || sessions == 0)
+		{
+			if (sessions == 0) fprintf(stderr, "%s is not a pitch trace\n", path);
+			else fprintf(stderr, "corrupt block at offset %ld\n", ftell(file) - static_cast<long>(sizeof(magic)));
+			fclose(file);
+			return 1;
+		}
+
+		PitchTraceBlockHeader header;
+		memcpy(header.magic, magic, sizeof(magic));
+		if (fread(reinterpret_cast<char*>(&header) + sizeof(magic), sizeof(header) - sizeof(magic), 1, file) != 1) break;
+		PitchTraceRecord record;
+		uint32_t i = 0;
+		for (; i < header.record_count && fread(&record, sizeof(record), 1, file) == 1; i++)
+		{
+			PrintPitchTraceRecord(stdout, record, time);
+			records++;
+		}
+		if (i < header.record_count) break;
+	}
+	fclose(file);
+	fprintf(stderr, "%ld records in %d sessions\n", records, sessions);
+	return 0;
+}
\ No newline at end of file
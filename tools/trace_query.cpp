@@ -0,0 +1,192 @@
+// Prints the frames of a converted pitch trace (see tools/trace_convert.cpp) in a demand branch or protection and/or a
+// range of times, reading only the blocks of the frames that can hold them: the branch index gives the runs of frames in
+// the branch, and the time range of every block those in the range of times.
+//
+// Usage: trace_query <column file> [--branch tag] [--from t] [--to t] [--count] [--columns name,...]
+//   branch   the tag of a demand branch or protection (e.g. OVSPD, CMD_LF), or NONE for frames without demand
+//   from/to  the range of times, which leaves out the frames of traces without times
+//   count    print the number of frames only
+//   columns  print the given columns of every frame as CSV instead of the frames in their text form
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "text_trace.h"
+#include "trace_columns.h"
+
+namespace
+{
+	struct RowRange
+	{
+		uint64_t first;
+		uint64_t end;
+	};
+}
+
+int main(int argc, char* argv[])
+{
+	const char* path = nullptr;
+	const char* branch_name = nullptr;
+	auto from = -INFINITY;
+	auto to = INFINITY;
+	auto count_only = false;
+	std::vector<std::string> column_names;
+	auto usage = false;
+	for (auto i = 1; i < argc; i++)
+	{
+		const auto has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--branch") == 0 && has_value) branch_name = argv[++i];
+		else if (strcmp(argv[i], "--from") == 0 && has_value) from = atof(argv[++i]);
+		else if (strcmp(argv[i], "--to") == 0 && has_value) to = atof(argv[++i]);
+		else if (strcmp(argv[i], "--count") == 0) count_only = true;
+		else if (strcmp(argv[i], "--columns") == 0 && has_value)
+		{
+			std::string list = argv[++i];
+			for (size_t start = 0, end; start <= list.size(); start = end + 1)
+			{
+				end = list.find(',', start);
+				if (end == std::string::npos) end = list.size();
+				column_names.push_back(list.substr(start, end - start));
+			}
+		}
+		else if (argv[i][0] == '-' || path) usage = true;
+		else path = argv[i];
+	}
+	if (usage || !path)
+	{
+		fprintf(stderr, "usage: %s <column file> [--branch tag] [--from t] [--to t] [--count] [--columns name,...]\n", argv[0]);
+		return 1;
+	}
+	const auto start = std::chrono::steady_clock::now();
+	const auto by_time = from > -INFINITY || to < INFINITY;
+
+	std::string error;
+	ColumnReader frames;
+	if (!frames.Open(path, error))
+	{
+		fprintf(stderr, "%s\n", error.c_str());
+		return 1;
+	}
+	if (frames.ColumnCount() != TRACE_COLUMN_COUNT || frames.Find("elevator") != TRACE_COLUMN_ELEVATOR)
+	{
+		fprintf(stderr, "%s is not a converted pitch trace\n", path);
+		return 1;
+	}
+	std::vector<uint32_t> columns;
+	for (const auto& name : column_names)
+	{
+		const auto column = frames.Find(name.c_str());
+		if (column < 0)
+		{
+			fprintf(stderr, "no column %s in %s\n", name.c_str(), path);
+			return 1;
+		}
+		columns.push_back(column);
+	}
+
+	// The ranges of rows that can hold the frames asked for
+	std::vector<RowRange> ranges;
+	if (branch_name)
+	{
+		auto branch = -1;
+		for (auto candidate = 0; candidate < TRACE_ID_COUNT; candidate++)
+		{
+			if (strcmp(branch_name, TraceBranchName(candidate)) == 0) branch = candidate;
+		}
+		if (branch < 0)
+		{
+			fprintf(stderr, "unknown branch %s\n", branch_name);
+			return 1;
+		}
+		const auto index_path = std::string(path) + ".branches";
+		ColumnReader index;
+		if (!index.Open(index_path.c_str(), error))
+		{
+			fprintf(stderr, "%s\n", error.c_str());
+			return 1;
+		}
+		for (size_t block = 0; block < index.BlockCount(); block++)
+		{
+			const auto& branches = index.Chunk(block, TRACE_RUN_BRANCH);
+			if (branch < branches.min || branch > branches.max) continue;
+			for (uint32_t row = 0; row < index.BlockRows(block); row++)
+			{
+				if (index.Value(block, TRACE_RUN_BRANCH, row) != branch) continue;
+				if (by_time && !(index.Value(block, TRACE_RUN_T_MAX, row) >= from && index.Value(block, TRACE_RUN_T_MIN, row) <= to)) continue;
+				const auto first = static_cast<uint64_t>(index.Value(block, TRACE_RUN_FIRST_ROW, row));
+				ranges.push_back({ first, first + static_cast<uint64_t>(index.Value(block, TRACE_RUN_ROWS, row)) });
+			}
+		}
+	}
+	else
+	{
+		for (size_t block = 0; block < frames.BlockCount(); block++)
+		{
+			const auto& times = frames.Chunk(block, TRACE_COLUMN_T);
+			if (by_time && !(times.max >= from && times.min <= to)) continue;
+			ranges.push_back({ frames.BlockFirstRow(block), frames.BlockFirstRow(block) + frames.BlockRows(block) });
+		}
+	}
+
+	static char buffer[1 << 16];
+	setvbuf(stdout, buffer, _IOFBF, sizeof(buffer));
+	if (!columns.empty())
+	{
+		for (size_t i = 0; i < columns.size(); i++) printf("%s%s", i > 0 ? "," : "", frames.Column(columns[i]).name);
+		printf("\n");
+	}
+	uint64_t matches = 0;
+	for (const auto& range : ranges)
+	{
+		if (count_only && !by_time)
+		{
+			matches += range.end - range.first;
+			continue;
+		}
+		for (auto row = range.first; row < range.end;)
+		{
+			const auto block = frames.BlockOf(row);
+			const auto block_end = std::min<uint64_t>(range.end, frames.BlockFirstRow(block) + frames.BlockRows(block));
+			if (by_time)
+			{
+				const auto& times = frames.Chunk(block, TRACE_COLUMN_T);
+				if (!(times.max >= from && times.min <= to))
+				{
+					row = block_end;
+					continue;
+				}
+			}
+			for (; row < block_end; row++)
+			{
+				const auto block_row = static_cast<uint32_t>(row - frames.BlockFirstRow(block));
+				const auto t = frames.Value(block, TRACE_COLUMN_T, block_row);
+				if (by_time && !(t >= from && t <= to)) continue;
+				matches++;
+				if (count_only) continue;
+				if (columns.empty())
+				{
+					PitchTraceRecord record;
+					ReadTraceRecord(frames, block, block_row, record);
+					PrintPitchTraceRecord(stdout, record, !std::isnan(record.t));
+					continue;
+				}
+				for (size_t i = 0; i < columns.size(); i++)
+				{
+					const auto value = frames.Value(block, columns[i], block_row);
+					printf(frames.Column(columns[i]).type == COLUMN_F64 ? "%s%lf" : "%s%.0f", i > 0 ? "," : "", value);
+				}
+				printf("\n");
+			}
+		}
+	}
+	if (count_only) printf("%llu\n", static_cast<unsigned long long>(matches));
+	fflush(stdout);
+
+	const auto milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	fprintf(stderr, "%llu of %llu frames in %zu ranges, %.2f ms\n", static_cast<unsigned long long>(matches),
+		static_cast<unsigned long long>(frames.Rows()), ranges.size(), milliseconds);
+	return 0;
+}
\ No newline at end of file